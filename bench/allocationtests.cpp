@@ -0,0 +1,108 @@
+#include "benchmark.h"
+
+#include "autosave.h"
+#include "cpurenderer.h"
+#include "editjournal.h"
+#include "profiler.h"
+
+#include <cmath>
+#include <filesystem>
+
+#define ALLOCATION_TEST_AUTOSAVE_DIRECTORY "benchmark_autosave"
+#define ALLOCATION_TEST_WARMUP_FRAMES 16
+
+// Runs the per-frame work of the editor that does not involve the GPU on an unchanged scene: profiler and allocation
+// statistics, journal and autosave upkeep, snapshot publication and a CPU render. Such a frame must not allocate
+static void RunSteadyStateFrameTest(BenchmarkRunner& runner)
+{
+    const char* name = "Allocation/SteadyStateFrame";
+    if (!runner.IsSelected(name))
+        return;
+
+    Scene scene = CreateBenchmarkScene(2, 5, 50, 5);
+    EditJournal journal;
+    AutosaveJournal autosave;
+    if (!autosave.Start(ALLOCATION_TEST_AUTOSAVE_DIRECTORY, scene))
+    {
+        runner.ReportFailure(std::string(name) + ": failed to start the autosave journal");
+        return;
+    }
+    journal.SetListener(&autosave);
+
+    SceneSnapshotPublisher publisher;
+    std::shared_ptr<const SceneSnapshot> lastSnapshot;
+    JobSystem jobSystem(runner.GetOptions().MaxThreads);
+    CpuRenderer renderer(jobSystem);
+    CpuImage image;
+
+    bool profilerEnabled = Profiler::IsEnabled();
+    Profiler::SetEnabled(true);
+
+    auto frame = [&]()
+    {
+        Profiler::Update();
+        AllocationTracker::Update();
+
+        PROFILE_SCOPE("Frame");
+        {
+            ALLOCATION_TAG("Journal");
+            journal.EndCommand(scene);
+            autosave.Update(scene);
+        }
+
+        {
+            ALLOCATION_TAG("Scene Snapshot");
+            std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(scene, lastSnapshot);
+            if (snapshot != lastSnapshot)
+            {
+                lastSnapshot = snapshot;
+                publisher.Publish(std::move(snapshot));
+            }
+        }
+
+        ALLOCATION_TAG("CPU Renderer");
+        std::shared_ptr<const SceneSnapshot> acquired = publisher.Acquire();
+        renderer.Render(*acquired, 640, 360, image);
+        DoNotOptimize(image.Pixels.data());
+    };
+
+    // The first frames create the snapshot, size the renderer buffers and register the profiler threads
+    for (uint32_t i = 0; i < ALLOCATION_TEST_WARMUP_FRAMES; i++)
+        frame();
+
+    runner.Run(name, 1.0, frame);
+
+    double allocationsPerFrame = runner.GetLastResult().AllocationsPerIteration;
+    runner.AddCounter("AllocationsPerFrame", allocationsPerFrame);
+    if (allocationsPerFrame > 0.0)
+    {
+        AllocationTracker::Update();
+        const std::vector<AllocationTagStats>& tags = AllocationTracker::GetTagStats();
+        std::string tag = tags.empty() || tags[0].FrameAllocations == 0 ? "untagged code" : tags[0].Name;
+        runner.ReportFailure(std::string(name) + ": " + std::to_string((uint64_t)std::ceil(allocationsPerFrame)) + " heap allocations per frame, most in " + tag);
+    }
+
+    Profiler::SetEnabled(profilerEnabled);
+    journal.SetListener(nullptr);
+    autosave.Stop(true);
+
+    std::error_code error;
+    std::filesystem::remove_all(ALLOCATION_TEST_AUTOSAVE_DIRECTORY, error);
+}
+
+void RunAllocationTests(BenchmarkRunner& runner)
+{
+    // Cost of the tracking hooks on top of the system allocator
+    static const size_t s_Sizes[] = { 16, 256, 4096 };
+    for (size_t size : s_Sizes)
+    {
+        runner.Run("Allocation/NewDelete/Size:" + std::to_string(size), 1.0, [size]()
+        {
+            void* pointer = operator new(size);
+            DoNotOptimize(pointer);
+            operator delete(pointer);
+        });
+    }
+
+    RunSteadyStateFrameTest(runner);
+}
@@ -0,0 +1,171 @@
+#include "benchmark.h"
+
+#include "animation.h"
+#include "framestreamer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <streambuf>
+#include <thread>
+
+#define ANIMATION_BENCHMARK_KEYFRAMES 8
+// Frames evaluated per iteration, spread over all keyframe spans
+#define ANIMATION_BENCHMARK_EVALUATIONS 64
+#define ANIMATION_BENCHMARK_STREAM_FRAMES 8
+
+// Discards what is written to it, keeping a hash of the bytes so streams can be compared without storing them
+class HashingStreamBuffer : public std::streambuf
+{
+public:
+    uint64_t GetHash() const { return m_Hash; }
+    uint64_t GetNumBytes() const { return m_NumBytes; }
+protected:
+    int_type overflow(int_type c) override
+    {
+        if (c != traits_type::eof())
+        {
+            char byte = traits_type::to_char_type(c);
+            xsputn(&byte, 1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize count) override
+    {
+        // FNV-1a
+        for (std::streamsize i = 0; i < count; i++)
+            m_Hash = (m_Hash ^ uint8_t(data[i])) * 1099511628211ull;
+        m_NumBytes += count;
+        return count;
+    }
+private:
+    uint64_t m_Hash = 14695981039346656037ull;
+    uint64_t m_NumBytes = 0;
+};
+
+// Keyframes one second apart, each moving the control points of the scene a little and shifting their colors and T1
+static SceneAnimation CreateBenchmarkAnimation(const Scene& scene, uint32_t numKeyframes, uint32_t seed, std::vector<Scene>* poses = nullptr)
+{
+    BenchmarkRandom random(seed);
+    SceneAnimation animation;
+    Scene pose = scene;
+    for (uint32_t k = 0; k < numKeyframes; k++)
+    {
+        for (uint32_t i = 0; i < pose.Positions.size(); i++)
+        {
+            pose.Positions[i] = scene.Positions[i] + glm::vec2(random.NextFloat(-0.1f, 0.1f), random.NextFloat(-0.1f, 0.1f));
+            pose.Colors[i] = glm::vec3(random.NextFloat(0.0f, 1.0f), random.NextFloat(0.0f, 1.0f), random.NextFloat(0.0f, 1.0f));
+        }
+        pose.Settings.T1 = random.NextFloat(0.0f, 1.0f);
+
+        animation.SetKeyframe(float(k), pose);
+        if (poses)
+            poses->push_back(pose);
+    }
+
+    return animation;
+}
+
+static void RunEvaluationBenchmark(BenchmarkRunner& runner, uint32_t numCurves, uint32_t numControlPoints)
+{
+    std::string name = "Animation/Evaluate/ControlPoints:" + std::to_string(numCurves * numControlPoints);
+    if (!runner.IsSelected(name))
+        return;
+
+    Scene scene = CreateBenchmarkScene(numCurves, numControlPoints, 0, 170);
+    std::vector<Scene> poses;
+    SceneAnimation animation = CreateBenchmarkAnimation(scene, ANIMATION_BENCHMARK_KEYFRAMES, 171, &poses);
+
+    float duration = animation.GetEndTime() - animation.GetStartTime();
+    runner.Run(name, double(numCurves) * numControlPoints * ANIMATION_BENCHMARK_EVALUATIONS, [&]()
+    {
+        for (uint32_t i = 0; i < ANIMATION_BENCHMARK_EVALUATIONS; i++)
+        {
+            animation.Evaluate(animation.GetStartTime() + duration * i / (ANIMATION_BENCHMARK_EVALUATIONS - 1), scene);
+            DoNotOptimize(scene.Positions.data());
+            ClobberMemory();
+        }
+    });
+
+    // The spline passes through the keyframes
+    for (uint32_t k = 0; k < ANIMATION_BENCHMARK_KEYFRAMES; k++)
+    {
+        animation.Evaluate(animation.GetKeyframeTime(k), scene);
+        bool isSame = std::memcmp(scene.Positions.data(), poses[k].Positions.data(), scene.Positions.size() * sizeof(glm::vec2)) == 0 &&
+            std::memcmp(scene.Colors.data(), poses[k].Colors.data(), scene.Colors.size() * sizeof(glm::vec3)) == 0 &&
+            scene.Settings.T1 == poses[k].Settings.T1;
+        if (!isSame)
+            runner.ReportFailure(name + ": the pose at keyframe " + std::to_string(k) + " differs from the keyed one");
+    }
+}
+
+static void RunStreamBenchmark(BenchmarkRunner& runner, FrameFormat format)
+{
+    std::string prefix = std::string("Animation/Stream/") + (format == FrameFormat_Y4m ? "Y4m" : "Rgba") + "/1080p/Frames:" +
+        std::to_string(ANIMATION_BENCHMARK_STREAM_FRAMES);
+
+    // The scene of the render benchmarks
+    Scene scene = CreateBenchmarkScene(64, 6, 100, 2);
+    SceneAnimation animation = CreateBenchmarkAnimation(scene, 4, 172);
+
+    FrameStreamSettings settings;
+    settings.Width = 1920;
+    settings.Height = 1080;
+    settings.NumFrames = ANIMATION_BENCHMARK_STREAM_FRAMES;
+    settings.FramesPerSecond = 5;
+    settings.Format = format;
+
+    uint32_t maxThreads = runner.GetOptions().MaxThreads;
+    if (maxThreads == 0)
+        maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    double singleThreadTime = 0.0;
+    uint64_t singleThreadHash = 0;
+    for (uint32_t numThreads : { 1u, maxThreads })
+    {
+        std::string name = prefix + "/Threads:" + std::to_string(numThreads);
+        if (!runner.IsSelected(name))
+            continue;
+
+        settings.NumThreads = numThreads;
+        HashingStreamBuffer buffer;
+        FrameStreamStats stats;
+        bool succeeded = true;
+        runner.Run(name, ANIMATION_BENCHMARK_STREAM_FRAMES, [&]()
+        {
+            buffer = HashingStreamBuffer();
+            std::ostream output(&buffer);
+            succeeded = StreamAnimationFrames(animation, scene, settings, output, stats) && succeeded;
+        });
+
+        double medianTime = runner.GetLastResult().Median;
+        runner.AddCounter("FramesPerSecond", ANIMATION_BENCHMARK_STREAM_FRAMES / (medianTime * 1e-9));
+        runner.AddCounter("PeakFramesInFlight", stats.PeakFramesInFlight);
+        if (!succeeded || stats.NumFrames != ANIMATION_BENCHMARK_STREAM_FRAMES || stats.NumBytes != buffer.GetNumBytes())
+            runner.ReportFailure(name + ": the stream is incomplete");
+
+        // Frames are rendered by whichever thread is free, the stream must not depend on it
+        if (numThreads == 1)
+        {
+            singleThreadTime = medianTime;
+            singleThreadHash = buffer.GetHash();
+        }
+        else if (singleThreadTime > 0.0)
+        {
+            runner.AddCounter("SpeedupOverOneThread", singleThreadTime / medianTime);
+            if (buffer.GetHash() != singleThreadHash)
+                runner.ReportFailure(name + ": the stream differs from the one written with one thread");
+        }
+
+        if (maxThreads == 1)
+            break;
+    }
+}
+
+void RunAnimationBenchmarks(BenchmarkRunner& runner)
+{
+    RunEvaluationBenchmark(runner, 64, 6);
+    RunEvaluationBenchmark(runner, 4096, 16);
+    RunStreamBenchmark(runner, FrameFormat_Y4m);
+    RunStreamBenchmark(runner, FrameFormat_Rgba);
+}
@@ -0,0 +1,155 @@
+#include "benchmark.h"
+
+#include "bezier.h"
+#include "framearena.h"
+
+#include <cstring>
+
+#define ARENA_BENCHMARK_CURVES 64
+#define ARENA_BENCHMARK_CONTROL_POINTS 6
+#define ARENA_BENCHMARK_SAMPLES 100
+#define ARENA_BENCHMARK_TILES 2040
+
+// One frame of transient data as the editor produces it: a removal list, a tessellated polyline per curve and a list of
+// primitives per screen tile. Vector is either a heap or a frame arena vector, so both allocators run the same code
+template<typename Vector, typename MakeVector>
+static uint64_t BuildFrame(const Scene& scene, BenchmarkRandom& random, const MakeVector& makeVector)
+{
+    uint64_t checksum = 0;
+
+    Vector pointsToRemove = makeVector();
+    for (uint32_t i = 0; i < ARENA_BENCHMARK_CONTROL_POINTS; i++)
+    {
+        if (random.NextUInt() % 4 == 0)
+            pointsToRemove.push_back(i);
+    }
+    checksum += pointsToRemove.size();
+
+    for (const SceneCurve& curve : scene.Curves)
+    {
+        // Polylines hold sample coordinates as raw words, so one vector type serves all three workloads
+        Vector polyline = makeVector();
+        polyline.resize(ARENA_BENCHMARK_SAMPLES * 2);
+        TessellateBezier(scene.Positions.data() + curve.FirstControlPoint, curve.NumControlPoints, ARENA_BENCHMARK_SAMPLES, (glm::vec2*)polyline.data());
+        checksum += polyline[ARENA_BENCHMARK_SAMPLES];
+    }
+
+    // Bin lists grow one entry at a time, the pattern that hurts a general purpose allocator most
+    std::vector<Vector> tiles;
+    tiles.reserve(ARENA_BENCHMARK_TILES);
+    for (uint32_t i = 0; i < ARENA_BENCHMARK_TILES; i++)
+        tiles.push_back(makeVector());
+
+    for (uint32_t i = 0; i < ARENA_BENCHMARK_TILES * 4; i++)
+        tiles[random.NextUInt() % ARENA_BENCHMARK_TILES].push_back(i);
+
+    for (const Vector& tile : tiles)
+        checksum += tile.size();
+
+    return checksum;
+}
+
+#if defined(FRAME_ARENA_POISON_ENABLED)
+// Reading a frame's data after Reset finds poison in every byte. The frame fits into the first block, which Reset keeps, so
+// the memory read is still the arena's
+static void RunPoisonTest(BenchmarkRunner& runner)
+{
+    std::string name = "Arena/PoisonOnReset";
+    if (!runner.IsSelected(name))
+        return;
+
+    const size_t allocationSize = 512;
+    const uint32_t numAllocations = 8;
+    FrameArena arena(numAllocations * allocationSize);
+    uint8_t* allocations[numAllocations];
+    bool isPoisoned = true;
+    runner.Run(name, numAllocations, [&]()
+    {
+        for (uint32_t i = 0; i < numAllocations; i++)
+        {
+            allocations[i] = arena.AllocateArray<uint8_t>(allocationSize);
+            memset(allocations[i], 0x11, allocationSize);
+        }
+
+        arena.Reset();
+        for (uint32_t i = 0; i < numAllocations; i++)
+        {
+            for (size_t j = 0; j < allocationSize; j++)
+                isPoisoned = isPoisoned && allocations[i][j] == FRAME_ARENA_POISON;
+        }
+    });
+
+    if (!isPoisoned)
+        runner.ReportFailure(name + ": memory released by Reset still held the data of its frame");
+}
+#endif
+
+void RunArenaBenchmarks(BenchmarkRunner& runner)
+{
+#if defined(FRAME_ARENA_POISON_ENABLED)
+    RunPoisonTest(runner);
+#endif
+
+    Scene scene = CreateBenchmarkScene(ARENA_BENCHMARK_CURVES, ARENA_BENCHMARK_CONTROL_POINTS, ARENA_BENCHMARK_SAMPLES, 6);
+
+    // The outer tile list comes from the heap in every variant, only the vectors it holds change allocator
+    {
+        BenchmarkRandom random(7);
+        runner.Run("Arena/Frame/Heap", 1.0, [&]()
+        {
+            uint64_t checksum = BuildFrame<std::vector<uint32_t>>(scene, random, []() { return std::vector<uint32_t>(); });
+            DoNotOptimize(checksum);
+        });
+    }
+
+    {
+        BenchmarkRandom random(7);
+        FrameArena arena;
+        runner.Run("Arena/Frame/FrameArena", 1.0, [&]()
+        {
+            uint64_t checksum = BuildFrame<FrameVector<uint32_t>>(scene, random, [&]() { return FrameVector<uint32_t>(FrameArenaAllocator<uint32_t>(arena)); });
+            DoNotOptimize(checksum);
+            arena.Reset();
+        });
+        runner.AddCounter("ArenaPeakBytes", arena.GetPeakBytesUsed());
+    }
+
+    // Raw allocation throughput, 256 small blocks per frame
+    runner.Run("Arena/SmallBlocks/Heap", 256.0, []()
+    {
+        void* blocks[256];
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            blocks[i] = operator new(16 + (i % 8) * 16);
+            DoNotOptimize(blocks[i]);
+        }
+        for (uint32_t i = 0; i < 256; i++)
+            operator delete(blocks[i]);
+    });
+
+    {
+        FrameArena arena;
+        runner.Run("Arena/SmallBlocks/FrameArena", 256.0, [&]()
+        {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                void* block = arena.Allocate(16 + (i % 8) * 16);
+                DoNotOptimize(block);
+            }
+            arena.Reset();
+        });
+    }
+
+    // Data kept alive for one more frame, as for a consumer on another thread, costs a second arena but no extra work
+    {
+        BenchmarkRandom random(7);
+        DoubleBufferedFrameArena arenas;
+        runner.Run("Arena/Frame/DoubleBufferedFrameArena", 1.0, [&]()
+        {
+            FrameArena& arena = arenas.GetCurrent();
+            uint64_t checksum = BuildFrame<FrameVector<uint32_t>>(scene, random, [&]() { return FrameVector<uint32_t>(FrameArenaAllocator<uint32_t>(arena)); });
+            DoNotOptimize(checksum);
+            arenas.Swap();
+        });
+    }
+}
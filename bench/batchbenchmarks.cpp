@@ -0,0 +1,211 @@
+#include "benchmark.h"
+
+#include "batchrender.h"
+#include "cpurenderer.h"
+#include "imagefile.h"
+#include "scenefile.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#define BATCH_BENCHMARK_DIRECTORY "benchmark_batch"
+#define BATCH_BENCHMARK_SCENES 16
+#define BATCH_BENCHMARK_WIDTH 640
+#define BATCH_BENCHMARK_HEIGHT 360
+// A band of the default height this wide has more tiles than a thread has job slots
+#define BATCH_WIDE_TEST_WIDTH 20480
+#define BATCH_WIDE_TEST_HEIGHT 256
+// Tiles of the reference renderer, large enough that the whole image only takes a few dozen of them
+#define BATCH_WIDE_TEST_REFERENCE_TILE_SIZE 256
+
+static std::string GetBatchBenchmarkName(uint32_t numScenes, uint32_t numThreads)
+{
+    return "Batch/Scenes:" + std::to_string(numScenes) + "/" + std::to_string(BATCH_BENCHMARK_WIDTH) + "x" + std::to_string(BATCH_BENCHMARK_HEIGHT) +
+        "/Threads:" + std::to_string(numThreads);
+}
+
+static std::vector<uint8_t> ReadFile(const std::string& filepath)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Renders a directory of scene files of different sizes, every image must be the one the scene renders to at once. Setting
+// up the workers must cost little next to rendering the scenes
+static void RunBatchBenchmark(BenchmarkRunner& runner, const std::vector<std::string>& scenePaths, uint32_t numThreads)
+{
+    std::string name = GetBatchBenchmarkName((uint32_t)scenePaths.size(), numThreads);
+    if (!runner.IsSelected(name))
+        return;
+
+    BatchRenderSettings settings;
+    settings.Width = BATCH_BENCHMARK_WIDTH;
+    settings.Height = BATCH_BENCHMARK_HEIGHT;
+    settings.OutputDirectory = BATCH_BENCHMARK_DIRECTORY "/images";
+    settings.NumThreads = numThreads;
+    settings.Verbose = false;
+
+    BatchRenderStats stats;
+    bool succeeded = true;
+    float startupTime = 0.0f;
+    runner.Run(name, scenePaths.size(), [&]()
+    {
+        succeeded = RenderSceneBatch(scenePaths, settings, stats) && succeeded;
+        startupTime = std::max(startupTime, stats.StartupTime);
+    });
+
+    float sceneTime = 0.0f;
+    for (const BatchSceneStats& scene : stats.Scenes)
+        sceneTime += scene.LoadTime + scene.RenderTime + scene.WriteTime;
+    sceneTime /= std::max<size_t>(stats.Scenes.size(), 1);
+
+    runner.AddCounter("ScenesPerSecond", stats.ScenesPerSecond);
+    runner.AddCounter("MegapixelsPerSecond", stats.MegapixelsPerSecond);
+    runner.AddCounter("MsPerScene", sceneTime);
+    runner.AddCounter("StartupMs", startupTime * 1000.0f);
+    runner.AddCounter("BandMB", stats.BandBytes / (1024.0 * 1024.0));
+    runner.AddCounter("PeakRssMB", stats.PeakResidentBytes / (1024.0 * 1024.0));
+
+    if (!succeeded)
+        runner.ReportFailure(name + ": scenes failed to render");
+
+    JobSystem jobSystem(runner.GetOptions().MaxThreads);
+    CpuRenderer renderer(jobSystem);
+    renderer.SetSampleTolerance(settings.SampleTolerance);
+    ViewTransform view = ViewCamera().GetViewTransform(settings.Width, settings.Height);
+    Scene scene;
+    CpuImage image;
+    for (const BatchSceneStats& sceneStats : stats.Scenes)
+    {
+        SceneFile sceneFile;
+        if (!sceneFile.Open(sceneStats.ScenePath))
+            continue;
+
+        scene.CopyFrom(sceneFile.GetView());
+        renderer.Render(*SceneSnapshot::Create(scene), settings.Width, settings.Height, image, view);
+
+        std::vector<uint8_t> expected;
+        EncodeTgaHeader(image.Width, image.Height, expected);
+        EncodeTgaRows(image.Pixels.data(), image.Width, image.Height, expected);
+        if (ReadFile(sceneStats.ImagePath) != expected)
+        {
+            runner.ReportFailure(name + ": " + sceneStats.ImagePath + " differs from the scene rendered at once");
+            break;
+        }
+    }
+
+    // Worker threads and their job systems are set up once per batch, not once per scene
+    if (startupTime * 1000.0f > 0.1f * sceneTime)
+        runner.ReportFailure(name + ": starting the workers took more than a tenth of rendering a scene");
+}
+
+// A scene that fails to load is reported and the others are still rendered
+static void RunBatchFailureTest(BenchmarkRunner& runner, const std::vector<std::string>& scenePaths)
+{
+    std::string name = "Batch/MissingScene";
+    std::vector<std::string> paths = { scenePaths[0], BATCH_BENCHMARK_DIRECTORY "/missing.bzs", scenePaths[1] };
+    BatchRenderSettings settings;
+    settings.Width = 64;
+    settings.Height = 64;
+    settings.OutputDirectory = BATCH_BENCHMARK_DIRECTORY "/missing";
+    settings.NumThreads = runner.GetOptions().MaxThreads;
+    settings.Verbose = false;
+
+    BatchRenderStats stats;
+    bool succeeded = true;
+    runner.Run(name, paths.size(), [&]()
+    {
+        succeeded = RenderSceneBatch(paths, settings, stats);
+    });
+
+    if (succeeded || stats.NumFailed != 1 || stats.Scenes[1].Succeeded || !stats.Scenes[0].Succeeded || !stats.Scenes[2].Succeeded)
+        runner.ReportFailure(name + ": the missing scene was not the only one to fail");
+}
+
+// A panorama at the default band height, compared with a renderer with a few large tiles that draws it at once
+static void RunBatchWideTest(BenchmarkRunner& runner, const std::string& scenePath)
+{
+    std::string name = "Batch/Wide/" + std::to_string(BATCH_WIDE_TEST_WIDTH) + "x" + std::to_string(BATCH_WIDE_TEST_HEIGHT);
+    BatchRenderSettings settings;
+    settings.Width = BATCH_WIDE_TEST_WIDTH;
+    settings.Height = BATCH_WIDE_TEST_HEIGHT;
+    settings.Format = ImageFileFormat_Ppm;
+    settings.OutputDirectory = BATCH_BENCHMARK_DIRECTORY "/wide";
+    settings.NumThreads = runner.GetOptions().MaxThreads;
+    settings.Verbose = false;
+
+    BatchRenderStats stats;
+    bool succeeded = true;
+    runner.Run(name, double(settings.Width) * settings.Height, [&]()
+    {
+        succeeded = RenderSceneBatch({ scenePath }, settings, stats) && succeeded;
+    });
+
+    SceneFile sceneFile;
+    if (!succeeded || !sceneFile.Open(scenePath))
+    {
+        runner.ReportFailure(name + ": the scene failed to render");
+        return;
+    }
+
+    Scene scene;
+    scene.CopyFrom(sceneFile.GetView());
+    JobSystem jobSystem(runner.GetOptions().MaxThreads);
+    CpuRenderer renderer(jobSystem);
+    renderer.SetSampleTolerance(settings.SampleTolerance);
+    renderer.SetTileSize(BATCH_WIDE_TEST_REFERENCE_TILE_SIZE);
+    CpuImage image;
+    renderer.Render(*SceneSnapshot::Create(scene), settings.Width, settings.Height, image, ViewCamera().GetViewTransform(settings.Width, settings.Height));
+
+    std::vector<uint8_t> expected;
+    EncodePpmHeader(image.Width, image.Height, expected);
+    EncodePpmRows(image.Pixels.data(), image.Width, image.Height, expected);
+    if (ReadFile(stats.Scenes[0].ImagePath) != expected)
+        runner.ReportFailure(name + ": the image differs from the one rendered at once");
+}
+
+void RunBatchBenchmarks(BenchmarkRunner& runner)
+{
+    uint32_t maxThreads = runner.GetOptions().MaxThreads;
+    if (maxThreads == 0)
+        maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // The scene files are only written when a benchmark needs them
+    std::string wideName = "Batch/Wide/" + std::to_string(BATCH_WIDE_TEST_WIDTH) + "x" + std::to_string(BATCH_WIDE_TEST_HEIGHT);
+    bool isSelected = runner.IsSelected("Batch/MissingScene") || runner.IsSelected(wideName);
+    for (uint32_t numThreads : { 1u, maxThreads })
+        isSelected = isSelected || runner.IsSelected(GetBatchBenchmarkName(BATCH_BENCHMARK_SCENES, numThreads));
+    if (!isSelected)
+        return;
+
+    std::error_code error;
+    std::filesystem::create_directories(BATCH_BENCHMARK_DIRECTORY, error);
+
+    std::vector<std::string> scenePaths;
+    for (uint32_t i = 0; i < BATCH_BENCHMARK_SCENES; i++)
+    {
+        std::string filepath = BATCH_BENCHMARK_DIRECTORY "/scene" + std::to_string(i) + ".bzs";
+        Scene scene = CreateBenchmarkScene(16 << (i % 4), 4 + i % 4, 100, 300 + i);
+        if (!SaveSceneFile(filepath, scene.GetView()))
+        {
+            runner.ReportFailure("Batch: failed to write " + filepath);
+            return;
+        }
+
+        scenePaths.push_back(filepath);
+    }
+
+    for (uint32_t numThreads : { 1u, maxThreads })
+        RunBatchBenchmark(runner, scenePaths, numThreads);
+
+    if (runner.IsSelected("Batch/MissingScene"))
+        RunBatchFailureTest(runner, scenePaths);
+
+    if (runner.IsSelected(wideName))
+        RunBatchWideTest(runner, scenePaths[3]);
+
+    std::filesystem::remove_all(BATCH_BENCHMARK_DIRECTORY, error);
+}
@@ -0,0 +1,205 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+void UseCharPointer(const volatile char* pointer)
+{
+    (void)pointer;
+}
+
+static double GetPercentile(const std::vector<double>& sortedTimes, double percentile)
+{
+    // Linear interpolation between the closest ranks
+    double rank = percentile * (sortedTimes.size() - 1);
+    size_t lower = (size_t)rank;
+    size_t upper = std::min(lower + 1, sortedTimes.size() - 1);
+    return sortedTimes[lower] + (sortedTimes[upper] - sortedTimes[lower]) * (rank - lower);
+}
+
+static std::string FormatTime(double nanoseconds)
+{
+    char text[32];
+    if (nanoseconds < 1e3)
+        snprintf(text, sizeof(text), "%.2f ns", nanoseconds);
+    else if (nanoseconds < 1e6)
+        snprintf(text, sizeof(text), "%.2f us", nanoseconds * 1e-3);
+    else
+        snprintf(text, sizeof(text), "%.2f ms", nanoseconds * 1e-6);
+    return text;
+}
+
+BenchmarkRunner::BenchmarkRunner(const BenchmarkOptions& options)
+    : m_Options(options)
+{
+    m_Options.Repetitions = std::max(m_Options.Repetitions, 1u);
+}
+
+bool BenchmarkRunner::IsSelected(const std::string& name) const
+{
+    return m_Options.Filter.empty() || name.find(m_Options.Filter) != std::string::npos;
+}
+
+void BenchmarkRunner::AddResult(const std::string& name, double itemsPerIteration, uint64_t iterationsPerRepetition, std::vector<double>& times, double allocationsPerIteration)
+{
+    if (times.empty())
+        return;
+
+    std::sort(times.begin(), times.end());
+
+    BenchmarkResult& result = m_Results.emplace_back();
+    result.Name = name;
+    result.Repetitions = times.size();
+    result.IterationsPerRepetition = iterationsPerRepetition;
+    result.ItemsPerIteration = itemsPerIteration;
+    result.AllocationsPerIteration = allocationsPerIteration;
+    result.Min = times.front();
+    result.Max = times.back();
+    result.Median = GetPercentile(times, 0.5);
+    result.P10 = GetPercentile(times, 0.1);
+    result.P90 = GetPercentile(times, 0.9);
+    result.P99 = GetPercentile(times, 0.99);
+
+    for (double time : times)
+        result.Mean += time;
+    result.Mean /= times.size();
+
+    for (double time : times)
+        result.StdDev += (time - result.Mean) * (time - result.Mean);
+    result.StdDev = std::sqrt(result.StdDev / times.size());
+
+    std::cout << std::left << std::setw(52) << name << " median " << std::setw(12) << FormatTime(result.Median) << " p10 " << std::setw(12) << FormatTime(result.P10)
+              << " p90 " << std::setw(12) << FormatTime(result.P90) << " p99 " << std::setw(12) << FormatTime(result.P99);
+    if (itemsPerIteration > 0.0)
+        std::cout << " " << std::setprecision(4) << itemsPerIteration / result.Median * 1e3 << " M items/s";
+    if (allocationsPerIteration > 0.0)
+        std::cout << " " << std::setprecision(4) << allocationsPerIteration << " allocs";
+    std::cout << std::endl;
+}
+
+void BenchmarkRunner::AddCounter(const std::string& name, double value)
+{
+    if (m_Results.empty())
+        return;
+
+    m_Results.back().Counters.emplace_back(name, value);
+    std::cout << "    " << name << ": " << value << std::endl;
+}
+
+void BenchmarkRunner::ReportFailure(const std::string& message)
+{
+    m_Failures.push_back(message);
+    m_NumFailures++;
+    std::cout << "FAILED: " << message << std::endl;
+}
+
+static void WriteJsonString(std::ostream& stream, const std::string& string)
+{
+    stream << '"';
+    for (char c : string)
+    {
+        if (c == '"' || c == '\\')
+            stream << '\\';
+
+        if ((unsigned char)c >= 0x20)
+            stream << c;
+    }
+    stream << '"';
+}
+
+bool BenchmarkRunner::WriteJson(const std::string& filepath) const
+{
+    std::ofstream file(filepath, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cout << "Failed to create benchmark results file: " << filepath << std::endl;
+        return false;
+    }
+
+    file << std::setprecision(10);
+    file << "{\n  \"context\": {\n";
+    file << "    \"repetitions\": " << m_Options.Repetitions << ",\n";
+    file << "    \"min_repetition_time\": " << m_Options.MinRepetitionTime << ",\n";
+#if defined(NDEBUG)
+    file << "    \"build\": \"release\"\n";
+#else
+    file << "    \"build\": \"debug\"\n";
+#endif
+    file << "  },\n  \"benchmarks\": [";
+
+    for (size_t i = 0; i < m_Results.size(); i++)
+    {
+        const BenchmarkResult& result = m_Results[i];
+        file << (i > 0 ? "," : "") << "\n    {\"name\": ";
+        WriteJsonString(file, result.Name);
+        file << ", \"repetitions\": " << result.Repetitions << ", \"iterations\": " << result.IterationsPerRepetition;
+        file << ", \"time_unit\": \"ns\", \"mean\": " << result.Mean << ", \"stddev\": " << result.StdDev << ", \"min\": " << result.Min;
+        file << ", \"median\": " << result.Median << ", \"p10\": " << result.P10 << ", \"p90\": " << result.P90 << ", \"p99\": " << result.P99 << ", \"max\": " << result.Max;
+        if (result.ItemsPerIteration > 0.0)
+            file << ", \"items_per_second\": " << result.ItemsPerIteration / result.Median * 1e9;
+        file << ", \"allocations_per_iteration\": " << result.AllocationsPerIteration;
+
+        for (const std::pair<std::string, double>& counter : result.Counters)
+        {
+            file << ", ";
+            WriteJsonString(file, counter.first);
+            file << ": " << counter.second;
+        }
+        file << "}";
+    }
+
+    file << "\n  ],\n  \"failures\": [";
+    for (size_t i = 0; i < m_Failures.size(); i++)
+    {
+        file << (i > 0 ? ", " : "");
+        WriteJsonString(file, m_Failures[i]);
+    }
+    file << "]\n}\n";
+
+    if (!file.good())
+    {
+        std::cout << "Failed writing benchmark results file: " << filepath << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+uint32_t BenchmarkRandom::NextUInt()
+{
+    // PCG-RXS-M-XS
+    uint32_t state = m_State;
+    m_State = m_State * 747796405u + 2891336453u;
+    uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+float BenchmarkRandom::NextFloat(float min, float max)
+{
+    return min + (max - min) * ((NextUInt() >> 8) * (1.0f / 16777216.0f));
+}
+
+Scene CreateBenchmarkScene(uint32_t numCurves, uint32_t numControlPoints, int numSamples, uint32_t seed)
+{
+    BenchmarkRandom random(seed);
+
+    Scene scene;
+    scene.Settings.NumSamples = numSamples;
+    for (uint32_t i = 0; i < numCurves; i++)
+    {
+        glm::vec3 color = glm::vec3(random.NextFloat(0.2f, 1.0f), random.NextFloat(0.2f, 1.0f), random.NextFloat(0.2f, 1.0f));
+        scene.AddCurve(color, random.NextFloat(0.5f, 3.0f));
+
+        for (uint32_t j = 0; j < numControlPoints; j++)
+        {
+            glm::vec2 position = glm::vec2(random.NextFloat(-0.9f, 0.9f), random.NextFloat(-0.9f, 0.9f));
+            scene.AddControlPoint(position, glm::vec3(1.0f, 0.0f, 0.0f));
+        }
+    }
+
+    return scene;
+}
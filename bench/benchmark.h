@@ -0,0 +1,206 @@
+#pragma once
+
+#include "allocationtracker.h"
+#include "scene.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+struct BenchmarkOptions
+{
+    std::string Filter;
+    std::string JsonPath;
+    uint32_t Repetitions = 30;
+    double WarmupTime = 0.1;
+    // Fast kernels are looped until a repetition takes at least this long, so timer resolution does not dominate
+    double MinRepetitionTime = 0.002;
+    uint32_t MaxThreads = 0;
+    // Golden image tests only run when a directory is given
+    std::string GoldenDirectory;
+    bool UpdateGolden = false;
+};
+
+// Times are in nanoseconds per iteration
+struct BenchmarkResult
+{
+    std::string Name;
+    uint32_t Repetitions = 0;
+    uint64_t IterationsPerRepetition = 0;
+    double ItemsPerIteration = 0.0;
+    double Mean = 0.0;
+    double StdDev = 0.0;
+    double Min = 0.0;
+    double Median = 0.0;
+    double P10 = 0.0;
+    double P90 = 0.0;
+    double P99 = 0.0;
+    double Max = 0.0;
+    double AllocationsPerIteration = 0.0;
+    std::vector<std::pair<std::string, double>> Counters;
+};
+
+// Defined in another translation unit, so the compiler has to assume the pointed to value is read
+void UseCharPointer(const volatile char* pointer);
+
+// Keeps a computed value alive without changing the code that produces it
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+    UseCharPointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// Forces pending writes to memory to be treated as observable
+inline void ClobberMemory()
+{
+#if defined(_MSC_VER)
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : : "memory");
+#endif
+}
+
+class BenchmarkRunner
+{
+public:
+    explicit BenchmarkRunner(const BenchmarkOptions& options);
+
+    bool IsSelected(const std::string& name) const;
+
+    // Measures function(), which performs one iteration. itemsPerIteration scales the reported throughput
+    template<typename Function>
+    void Run(const std::string& name, double itemsPerIteration, const Function& function);
+
+    // Results of benchmarks with their own measurement loop, e.g. multithreaded stress tests
+    void AddResult(const std::string& name, double itemsPerIteration, uint64_t iterationsPerRepetition, std::vector<double>& times, double allocationsPerIteration = 0.0);
+    // Attaches a named value to the last result
+    void AddCounter(const std::string& name, double value);
+    void ReportFailure(const std::string& message);
+
+    const BenchmarkOptions& GetOptions() const { return m_Options; }
+    // Only valid after a result was added
+    const BenchmarkResult& GetLastResult() const { return m_Results.back(); }
+    bool HasFailures() const { return m_NumFailures > 0; }
+    bool WriteJson(const std::string& filepath) const;
+private:
+    using Clock = std::chrono::steady_clock;
+
+    BenchmarkOptions m_Options;
+    std::vector<BenchmarkResult> m_Results;
+    std::vector<std::string> m_Failures;
+    uint32_t m_NumFailures = 0;
+};
+
+template<typename Function>
+void BenchmarkRunner::Run(const std::string& name, double itemsPerIteration, const Function& function)
+{
+    if (!IsSelected(name))
+        return;
+
+    // Warm up caches and branch predictors while finding how many iterations fill a repetition
+    uint64_t numIterations = 1;
+    Clock::time_point warmupStart = Clock::now();
+    while (true)
+    {
+        Clock::time_point start = Clock::now();
+        for (uint64_t i = 0; i < numIterations; i++)
+            function();
+        double time = std::chrono::duration<double>(Clock::now() - start).count();
+
+        bool warm = std::chrono::duration<double>(Clock::now() - warmupStart).count() >= m_Options.WarmupTime;
+        if (time < m_Options.MinRepetitionTime && numIterations < (1ull << 30))
+            numIterations *= 2;
+        else if (warm)
+            break;
+    }
+
+    std::vector<double> times(m_Options.Repetitions);
+    uint64_t numAllocations = AllocationTracker::GetTotalStats().NumAllocations;
+    for (double& time : times)
+    {
+        Clock::time_point start = Clock::now();
+        for (uint64_t i = 0; i < numIterations; i++)
+            function();
+        time = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / numIterations;
+    }
+
+    // Heap traffic of the measured code is reported with its timings, the times vector was allocated up front
+    double allocationsPerIteration = (double)(AllocationTracker::GetTotalStats().NumAllocations - numAllocations) / ((double)numIterations * times.size());
+    AddResult(name, itemsPerIteration, numIterations, times, allocationsPerIteration);
+}
+
+// Deterministic on every platform, unlike the standard distributions
+class BenchmarkRandom
+{
+public:
+    explicit BenchmarkRandom(uint32_t seed) : m_State(seed * 747796405u + 2891336453u) {}
+
+    uint32_t NextUInt();
+    // Uniform in [min, max)
+    float NextFloat(float min, float max);
+private:
+    uint32_t m_State;
+};
+
+// Reproducible scene of random curves inside the [-1, 1] square, used as the common workload of the benchmarks
+Scene CreateBenchmarkScene(uint32_t numCurves, uint32_t numControlPoints, int numSamples, uint32_t seed);
+
+// Each suite registers its benchmarks with the runner, the filter decides which ones actually run
+void RunCurveBenchmarks(BenchmarkRunner& runner);
+// Splits ParallelFor ranges into more jobs than a thread has slots, fails when an iteration is skipped or repeated
+void RunJobBenchmarks(BenchmarkRunner& runner);
+// Renders images up to 4K, fails when an image rendered at once differs from the same image rendered in bands
+void RunRenderBenchmarks(BenchmarkRunner& runner);
+void RunSnapshotBenchmarks(BenchmarkRunner& runner);
+// Opens a generated scene file of about 2.3 GB, fails when it does not load whole or its checksums do not verify, or when
+// files with settings the renderer cannot use are opened
+void RunSceneFileBenchmarks(BenchmarkRunner& runner);
+// Parses 100 MB of SVG path data and writes scenes as SVG, fails when a segment is lost or a written cubic does not read back
+void RunSvgPathBenchmarks(BenchmarkRunner& runner);
+// Edits through the journal every frame and records 10k-step histories of a 1M-point scene, fails when a history holds more
+// memory than its budget or jumping through it does not give back the edited scene
+void RunEditBenchmarks(BenchmarkRunner& runner);
+void RunArenaBenchmarks(BenchmarkRunner& runner);
+// Nearest point queries, fails when a projection is less accurate than exhaustive sampling
+void RunProjectionBenchmarks(BenchmarkRunner& runner);
+// Curve pairs and dense scenes, fails when the broad phase misses intersections that testing all pairs finds
+void RunIntersectionBenchmarks(BenchmarkRunner& runner);
+// Exact curve bounds against dense sampling and the SIMD scene batch against the scalar path, fails on any mismatch
+void RunBoundsBenchmarks(BenchmarkRunner& runner);
+// Replays long strokes through the curve fitter, fails when a sample ends up farther from the fit than the tolerance
+void RunFitterBenchmarks(BenchmarkRunner& runner);
+// Offsets curves of growing degree and distance, fails when an offset strays from the exact one by more than the tolerance
+void RunOffsetBenchmarks(BenchmarkRunner& runner);
+// Converts curves between degrees, fails when a reduced segment strays from the curve by more than its error bound
+void RunDegreeBenchmarks(BenchmarkRunner& runner);
+// Splits curves at several parameters one by one and in batches, fails when the batch differs from the scalar path
+void RunSubdivisionBenchmarks(BenchmarkRunner& runner);
+// Evaluates tangents, normals and curvature a million at a time, fails when the SIMD path differs from the scalar one
+void RunCurvatureBenchmarks(BenchmarkRunner& runner);
+// Evaluates keyframed poses and streams animations at 1080p, fails when the stream depends on the number of threads
+void RunAnimationBenchmarks(BenchmarkRunner& runner);
+// Renders a scene while zooming into it with fixed and adaptive sample counts, fails when a curve is flattened too coarsely
+void RunViewBenchmarks(BenchmarkRunner& runner);
+// Exports large images in bands, fails when the bands differ from the image rendered at once or hold too much memory
+void RunStripBenchmarks(BenchmarkRunner& runner);
+// Drags a control point in growing scenes within a frame budget and refines a 4K viewport, fails when half of the edit frames
+// overrun the budget or when a refined image differs from the one rendered at once
+void RunProgressiveBenchmarks(BenchmarkRunner& runner);
+// Renders a directory of scene files with the headless batch renderer, fails when an image differs from the scene rendered at
+// once, when a missing scene stops the others or when starting the workers costs more than a tenth of a scene
+void RunBatchBenchmarks(BenchmarkRunner& runner);
+// Renders a catalog of scenes and compares them against the golden images, or rewrites them with UpdateGolden
+void RunGoldenImageTests(BenchmarkRunner& runner);
+// Fails when the per-frame work of the editor allocates on an unchanged scene
+void RunAllocationTests(BenchmarkRunner& runner);
@@ -0,0 +1,138 @@
+#include "benchmark.h"
+
+#include "bezier.h"
+#include "curvebounds.h"
+
+#include <algorithm>
+#include <cstring>
+
+#define BOUNDS_BENCHMARK_CURVES 1024
+// Dense tessellation the exact bounds are checked against
+#define BOUNDS_REFERENCE_SAMPLES 16384
+// Exact bounds may miss a sample or exceed the sampled bounds by at most this much
+#define BOUNDS_ERROR_TOLERANCE 1e-5
+
+static Scene CreateBoundsScene(uint32_t numCurves, uint32_t numControlPoints, uint32_t seed)
+{
+    BenchmarkRandom random(seed);
+
+    Scene scene;
+    for (uint32_t i = 0; i < numCurves; i++)
+    {
+        scene.AddCurve();
+        for (uint32_t j = 0; j < numControlPoints; j++)
+            scene.AddControlPoint(glm::vec2(random.NextFloat(-0.9f, 0.9f), random.NextFloat(-0.9f, 0.9f)));
+    }
+
+    return scene;
+}
+
+static double GetArea(const glm::vec2& boundsMin, const glm::vec2& boundsMax)
+{
+    glm::vec2 size = boundsMax - boundsMin;
+    return (double)size.x * size.y;
+}
+
+static void RunDegreeBenchmarks(BenchmarkRunner& runner, uint32_t degree)
+{
+    Scene scene = CreateBoundsScene(BOUNDS_BENCHMARK_CURVES, degree + 1, degree + 80);
+    std::vector<glm::vec2> boundsMin(scene.Curves.size());
+    std::vector<glm::vec2> boundsMax(scene.Curves.size());
+    std::string prefix = "Bounds/Degree:" + std::to_string(degree);
+
+    runner.Run(prefix + "/ControlPoints", scene.Curves.size(), [&]()
+    {
+        for (size_t i = 0; i < scene.Curves.size(); i++)
+            GetControlPointBounds(&scene.Positions[scene.Curves[i].FirstControlPoint], degree + 1, boundsMin[i], boundsMax[i]);
+        DoNotOptimize(boundsMin.data());
+        DoNotOptimize(boundsMax.data());
+        ClobberMemory();
+    });
+
+    runner.Run(prefix + "/Exact", scene.Curves.size(), [&]()
+    {
+        for (size_t i = 0; i < scene.Curves.size(); i++)
+            GetBezierBounds(&scene.Positions[scene.Curves[i].FirstControlPoint], degree + 1, boundsMin[i], boundsMax[i]);
+        DoNotOptimize(boundsMin.data());
+        DoNotOptimize(boundsMax.data());
+        ClobberMemory();
+    });
+
+    if (!runner.IsSelected(prefix + "/Exact"))
+        return;
+
+    // Exact bounds have to contain the tessellated curve and must not be larger than it by more than rounding
+    std::vector<glm::vec2> samples(BOUNDS_REFERENCE_SAMPLES);
+    double maxError = 0.0;
+    double sumAreaRatio = 0.0;
+    for (size_t i = 0; i < scene.Curves.size(); i++)
+    {
+        const glm::vec2* controlPoints = &scene.Positions[scene.Curves[i].FirstControlPoint];
+        GetBezierBounds(controlPoints, degree + 1, boundsMin[i], boundsMax[i]);
+        TessellateBezier(controlPoints, degree + 1, samples.size(), samples.data());
+
+        glm::vec2 sampledMin, sampledMax;
+        GetControlPointBounds(samples.data(), samples.size(), sampledMin, sampledMax);
+        glm::vec2 missed = glm::max(boundsMin[i] - sampledMin, sampledMax - boundsMax[i]);
+        glm::vec2 excess = glm::max(sampledMin - boundsMin[i], boundsMax[i] - sampledMax);
+        maxError = std::max({ maxError, (double)missed.x, (double)missed.y, (double)excess.x, (double)excess.y });
+
+        glm::vec2 hullMin, hullMax;
+        GetControlPointBounds(controlPoints, degree + 1, hullMin, hullMax);
+        sumAreaRatio += GetArea(boundsMin[i], boundsMax[i]) / GetArea(hullMin, hullMax);
+    }
+
+    runner.AddCounter("MaxError", maxError);
+    runner.AddCounter("AreaOfControlPointBounds", sumAreaRatio / scene.Curves.size());
+    if (maxError > BOUNDS_ERROR_TOLERANCE)
+        runner.ReportFailure(prefix + ": exact bounds are off by " + std::to_string(maxError));
+}
+
+// Bounds of a whole scene of cubic curves, the batch path bounds four curves at a time
+static void RunSceneBenchmarks(BenchmarkRunner& runner)
+{
+    const uint32_t numCurves = 16384;
+    Scene scene = CreateBoundsScene(numCurves, 4, 90);
+    SceneView view = scene.GetView();
+    std::string prefix = "Bounds/Scene/Curves:" + std::to_string(numCurves);
+
+    std::vector<glm::vec2> boundsMin(numCurves);
+    std::vector<glm::vec2> boundsMax(numCurves);
+    runner.Run(prefix + "/Scalar", numCurves, [&]()
+    {
+        for (uint32_t i = 0; i < numCurves; i++)
+            GetBezierBounds(&scene.Positions[scene.Curves[i].FirstControlPoint], 4, boundsMin[i], boundsMax[i]);
+        DoNotOptimize(boundsMin.data());
+        DoNotOptimize(boundsMax.data());
+        ClobberMemory();
+    });
+    double scalarTime = runner.IsSelected(prefix + "/Scalar") ? runner.GetLastResult().Median : 0.0;
+
+    std::vector<glm::vec2> batchMin(numCurves);
+    std::vector<glm::vec2> batchMax(numCurves);
+    runner.Run(prefix + "/Batch", numCurves, [&]()
+    {
+        ComputeSceneBounds(view, batchMin.data(), batchMax.data());
+        DoNotOptimize(batchMin.data());
+        DoNotOptimize(batchMax.data());
+        ClobberMemory();
+    });
+
+    if (scalarTime > 0.0 && runner.IsSelected(prefix + "/Batch"))
+    {
+        runner.AddCounter("SpeedupOverScalar", scalarTime / runner.GetLastResult().Median);
+
+        // Both paths perform the same operations, snapshots and scene queries may mix them freely
+        if (memcmp(boundsMin.data(), batchMin.data(), numCurves * sizeof(glm::vec2)) != 0 || memcmp(boundsMax.data(), batchMax.data(), numCurves * sizeof(glm::vec2)) != 0)
+            runner.ReportFailure(prefix + ": batch bounds do not match the scalar bounds");
+    }
+}
+
+void RunBoundsBenchmarks(BenchmarkRunner& runner)
+{
+    static const uint32_t s_Degrees[] = { 2, 3, 4, 7, 12 };
+    for (uint32_t degree : s_Degrees)
+        RunDegreeBenchmarks(runner, degree);
+
+    RunSceneBenchmarks(runner);
+}
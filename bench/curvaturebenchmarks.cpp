@@ -0,0 +1,135 @@
+#include "benchmark.h"
+
+#include "curvature.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#define CURVATURE_BENCHMARK_CURVES 1024
+// Parameters per curve, a million evaluations per iteration
+#define CURVATURE_BENCHMARK_PARAMETERS 1024
+// Every this many frames is checked against a double precision evaluation of the hodographs
+#define CURVATURE_CHECK_STRIDE 16
+// Curvature error relative to the larger of the curvature and the inverse extent of the scene. Float rounding of the
+// second derivative grows with the degree and reaches about 1e-3 at degree 9, it blows up right at stationary points,
+// which are skipped
+#define CURVATURE_ERROR_TOLERANCE 5e-3
+#define CURVATURE_MIN_CHECKED_SPEED 1e-2
+
+static glm::dvec2 EvaluateBezierDouble(const glm::vec2* controlPoints, uint32_t numControlPoints, double t)
+{
+    glm::dvec2 scratch[CURVATURE_SIMD_MAX_POINTS];
+    for (uint32_t i = 0; i < numControlPoints; i++)
+        scratch[i] = glm::dvec2(controlPoints[i]);
+
+    for (uint32_t n = 1; n < numControlPoints; n++)
+    {
+        for (uint32_t i = 0; i < numControlPoints - n; i++)
+            scratch[i] = scratch[i] + (scratch[i + 1] - scratch[i]) * t;
+    }
+
+    return scratch[0];
+}
+
+// Largest curvature error of the frames against the first and second hodograph evaluated in double precision
+static double GetMaxCurvatureError(const Scene& scene, const float* parameters, const CurveFrame* frames)
+{
+    double maxError = 0.0;
+    for (uint32_t i = 0; i < scene.Curves.size(); i++)
+    {
+        const SceneCurve& curve = scene.Curves[i];
+        glm::vec2 firstHodograph[CURVATURE_SIMD_MAX_POINTS];
+        glm::vec2 secondHodograph[CURVATURE_SIMD_MAX_POINTS];
+        ComputeBezierHodograph(&scene.Positions[curve.FirstControlPoint], curve.NumControlPoints, firstHodograph);
+        ComputeBezierHodograph(firstHodograph, curve.NumControlPoints - 1, secondHodograph);
+
+        for (uint32_t j = 0; j < CURVATURE_BENCHMARK_PARAMETERS; j += CURVATURE_CHECK_STRIDE)
+        {
+            double t = parameters[j];
+            glm::dvec2 firstDerivative = EvaluateBezierDouble(firstHodograph, curve.NumControlPoints - 1, t);
+            glm::dvec2 secondDerivative = EvaluateBezierDouble(secondHodograph, curve.NumControlPoints - 2, t);
+            double speed = glm::length(firstDerivative);
+            if (speed < CURVATURE_MIN_CHECKED_SPEED)
+                continue;
+
+            double curvature = (firstDerivative.x * secondDerivative.y - firstDerivative.y * secondDerivative.x) / (speed * speed * speed);
+            double error = std::abs(frames[i * CURVATURE_BENCHMARK_PARAMETERS + j].Curvature - curvature) / std::max(std::abs(curvature), 1.0);
+            maxError = std::max(maxError, error);
+        }
+    }
+
+    return maxError;
+}
+
+static void RunCurvatureBenchmark(BenchmarkRunner& runner, uint32_t numControlPoints)
+{
+    std::string prefix = "Curvature/Points:" + std::to_string(numControlPoints) + "/Evaluations:1M";
+    std::string scalarName = prefix + "/Scalar";
+    std::string batchName = prefix + "/Batch";
+    if (!runner.IsSelected(scalarName) && !runner.IsSelected(batchName))
+        return;
+
+    Scene scene = CreateBenchmarkScene(CURVATURE_BENCHMARK_CURVES, numControlPoints, 0, 160 + numControlPoints);
+    std::vector<float> parameters(CURVATURE_BENCHMARK_PARAMETERS);
+    for (uint32_t j = 0; j < CURVATURE_BENCHMARK_PARAMETERS; j++)
+        parameters[j] = float(j) / (CURVATURE_BENCHMARK_PARAMETERS - 1);
+
+    uint32_t numFrames = CURVATURE_BENCHMARK_CURVES * CURVATURE_BENCHMARK_PARAMETERS;
+    std::vector<CurveFrame> scalarFrames(numFrames);
+    std::vector<CurveFrame> batchFrames(numFrames);
+    auto evaluateScalar = [&]()
+    {
+        glm::vec2 scratch[CURVATURE_SIMD_MAX_POINTS];
+        for (uint32_t i = 0; i < CURVATURE_BENCHMARK_CURVES; i++)
+        {
+            const glm::vec2* controlPoints = &scene.Positions[scene.Curves[i].FirstControlPoint];
+            for (uint32_t j = 0; j < CURVATURE_BENCHMARK_PARAMETERS; j++)
+                scalarFrames[i * CURVATURE_BENCHMARK_PARAMETERS + j] = EvaluateCurveFrame(controlPoints, numControlPoints, parameters[j], scratch);
+        }
+    };
+
+    double scalarTime = 0.0;
+    runner.Run(scalarName, numFrames, [&]()
+    {
+        evaluateScalar();
+        DoNotOptimize(scalarFrames.data());
+        ClobberMemory();
+    });
+    if (runner.IsSelected(scalarName))
+        scalarTime = runner.GetLastResult().Median;
+
+    if (!runner.IsSelected(batchName))
+        return;
+
+    runner.Run(batchName, numFrames, [&]()
+    {
+        for (uint32_t i = 0; i < CURVATURE_BENCHMARK_CURVES; i++)
+        {
+            const glm::vec2* controlPoints = &scene.Positions[scene.Curves[i].FirstControlPoint];
+            EvaluateCurveFrames(controlPoints, numControlPoints, parameters.data(), CURVATURE_BENCHMARK_PARAMETERS, &batchFrames[i * CURVATURE_BENCHMARK_PARAMETERS]);
+        }
+        DoNotOptimize(batchFrames.data());
+        ClobberMemory();
+    });
+    if (scalarTime > 0.0)
+        runner.AddCounter("SpeedupOverScalar", scalarTime / runner.GetLastResult().Median);
+
+    // The batch performs the same operations in the same order as the scalar path
+    if (scalarTime == 0.0)
+        evaluateScalar();
+    if (std::memcmp(scalarFrames.data(), batchFrames.data(), numFrames * sizeof(CurveFrame)) != 0)
+        runner.ReportFailure(batchName + ": the frames differ from the scalar path");
+
+    double maxError = GetMaxCurvatureError(scene, parameters.data(), batchFrames.data());
+    runner.AddCounter("MaxCurvatureError", maxError);
+    if (maxError > CURVATURE_ERROR_TOLERANCE)
+        runner.ReportFailure(batchName + ": a curvature is off by " + std::to_string(maxError) + " relative to the exact one");
+}
+
+void RunCurvatureBenchmarks(BenchmarkRunner& runner)
+{
+    static const uint32_t s_ControlPoints[] = { 3, 4, 6, 10 };
+    for (uint32_t numControlPoints : s_ControlPoints)
+        RunCurvatureBenchmark(runner, numControlPoints);
+}
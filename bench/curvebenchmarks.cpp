@@ -0,0 +1,148 @@
+#include "benchmark.h"
+
+#include "bezier.h"
+
+#include <cstring>
+
+static std::vector<glm::vec2> CreateControlPoints(uint32_t numControlPoints, uint32_t seed)
+{
+    BenchmarkRandom random(seed);
+
+    std::vector<glm::vec2> controlPoints(numControlPoints);
+    for (glm::vec2& controlPoint : controlPoints)
+        controlPoint = glm::vec2(random.NextFloat(-0.9f, 0.9f), random.NextFloat(-0.9f, 0.9f));
+    return controlPoints;
+}
+
+static void RunEvaluateBenchmarks(BenchmarkRunner& runner)
+{
+    static const uint32_t s_Degrees[] = { 1, 2, 3, 5, 7, 10, 15 };
+    for (uint32_t degree : s_Degrees)
+    {
+        std::vector<glm::vec2> controlPoints = CreateControlPoints(degree + 1, degree);
+        std::vector<glm::vec2> scratch(degree + 1);
+
+        // A varying parameter keeps the evaluation from being hoisted out of the loop
+        float t = 0.0f;
+        runner.Run("DeCasteljau/Degree:" + std::to_string(degree), 1.0, [&]()
+        {
+            glm::vec2 point = EvaluateBezier(controlPoints.data(), degree + 1, t, scratch.data());
+            DoNotOptimize(point);
+            t = t < 1.0f ? t + 0.001f : 0.0f;
+        });
+
+        std::vector<glm::vec2> polarPoints(degree);
+        runner.Run("Polar/Degree:" + std::to_string(degree), 1.0, [&]()
+        {
+            ComputeBezierPolar(controlPoints.data(), degree + 1, t, polarPoints.data());
+            DoNotOptimize(polarPoints.data());
+            ClobberMemory();
+            t = t < 1.0f ? t + 0.001f : 0.0f;
+        });
+    }
+}
+
+static void RunTessellateBenchmarks(BenchmarkRunner& runner)
+{
+    static const uint32_t s_Degrees[] = { 3, 7, 15 };
+    static const uint32_t s_SampleCounts[] = { 16, 64, 256, 1024 };
+    for (uint32_t degree : s_Degrees)
+    {
+        std::vector<glm::vec2> controlPoints = CreateControlPoints(degree + 1, degree);
+
+        for (uint32_t numSamples : s_SampleCounts)
+        {
+            std::vector<glm::vec2> samples(numSamples);
+            runner.Run("Tessellate/Degree:" + std::to_string(degree) + "/Samples:" + std::to_string(numSamples), numSamples, [&]()
+            {
+                TessellateBezier(controlPoints.data(), degree + 1, numSamples, samples.data());
+                DoNotOptimize(samples.data());
+                ClobberMemory();
+            });
+        }
+    }
+}
+
+template<int Degree>
+static void EvaluateBernsteinSamples(const glm::vec2* controlPoints, uint32_t numSamples, glm::vec2* samples)
+{
+    for (uint32_t i = 0; i < numSamples; i++)
+        samples[i] = EvaluateBezierBernstein<Degree>(controlPoints, float(i) / float(numSamples - 1));
+}
+
+template<int Degree>
+static void RunBulkEvaluateBenchmarks(BenchmarkRunner& runner)
+{
+    const uint32_t numSamples = 4096;
+    std::vector<glm::vec2> controlPoints = CreateControlPoints(Degree + 1, Degree);
+    std::vector<glm::vec2> samples(numSamples);
+    std::string prefix = "BulkEvaluate/Degree:" + std::to_string(Degree);
+
+    runner.Run(prefix + "/Generic", numSamples, [&]()
+    {
+        EvaluateBezierSamplesGeneric(controlPoints.data(), Degree + 1, numSamples, 0, numSamples, samples.data());
+        DoNotOptimize(samples.data());
+        ClobberMemory();
+    });
+    double genericTime = runner.IsSelected(prefix + "/Generic") ? runner.GetLastResult().Median : 0.0;
+
+    std::vector<glm::vec2> specializedSamples(numSamples);
+    runner.Run(prefix + "/Specialized", numSamples, [&]()
+    {
+        EvaluateBezierSamples(controlPoints.data(), Degree + 1, numSamples, 0, numSamples, specializedSamples.data());
+        DoNotOptimize(specializedSamples.data());
+        ClobberMemory();
+    });
+
+    if (genericTime > 0.0 && runner.IsSelected(prefix + "/Specialized"))
+    {
+        runner.AddCounter("SpeedupOverGeneric", genericTime / runner.GetLastResult().Median);
+
+        // The renderer relies on the specialized kernels rounding exactly like the generic loop and the shader
+        if (memcmp(samples.data(), specializedSamples.data(), numSamples * sizeof(glm::vec2)) != 0)
+            runner.ReportFailure(prefix + ": specialized kernel does not match the generic evaluation");
+    }
+
+    runner.Run(prefix + "/Bernstein", numSamples, [&]()
+    {
+        EvaluateBernsteinSamples<Degree>(controlPoints.data(), numSamples, samples.data());
+        DoNotOptimize(samples.data());
+        ClobberMemory();
+    });
+}
+
+static void RunDistanceBenchmarks(BenchmarkRunner& runner)
+{
+    static const uint32_t s_SampleCounts[] = { 16, 64, 256, 1024 };
+
+    std::vector<glm::vec2> controlPoints = CreateControlPoints(4, 3);
+
+    // Query points are generated up front so the random number generator is not part of the measurement
+    std::vector<glm::vec2> queries = CreateControlPoints(1024, 17);
+
+    for (uint32_t numSamples : s_SampleCounts)
+    {
+        std::vector<glm::vec2> samples(numSamples);
+        TessellateBezier(controlPoints.data(), controlPoints.size(), numSamples, samples.data());
+
+        size_t queryIndex = 0;
+        runner.Run("PolylineDistance/Samples:" + std::to_string(numSamples), 1.0, [&]()
+        {
+            float distance = GetPolylineDistance(queries[queryIndex], samples.data(), numSamples);
+            DoNotOptimize(distance);
+            queryIndex = (queryIndex + 1) % queries.size();
+        });
+    }
+}
+
+void RunCurveBenchmarks(BenchmarkRunner& runner)
+{
+    RunEvaluateBenchmarks(runner);
+    RunTessellateBenchmarks(runner);
+    RunBulkEvaluateBenchmarks<1>(runner);
+    RunBulkEvaluateBenchmarks<2>(runner);
+    RunBulkEvaluateBenchmarks<3>(runner);
+    RunBulkEvaluateBenchmarks<5>(runner);
+    RunBulkEvaluateBenchmarks<8>(runner);
+    RunDistanceBenchmarks(runner);
+}
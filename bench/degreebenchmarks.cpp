@@ -0,0 +1,276 @@
+#include "benchmark.h"
+
+#include "bezier.h"
+#include "curvedegree.h"
+#include "jobsystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#define DEGREE_BENCHMARK_CURVES 1024
+// Parameters every source curve is evaluated at, both directly and through its converted segments
+#define DEGREE_BENCHMARK_SAMPLES 256
+// The error bound holds exactly, the slack only absorbs the float rounding of evaluating a high degree curve, which is
+// about a tenth of the smallest tolerance
+#define DEGREE_BENCHMARK_ERROR_SLACK 1.1f
+
+// Evaluates every converted curve at the parameters of its source curve: sample k of a source curve is at k / (numSamples
+// - 1), which falls into the segment starting at or before it and is mapped into that segment's own parameter range
+template<int Degree>
+static void EvaluateConvertedScene(const CurveDegreeConverter& converter, uint32_t numSourceCurves, uint32_t numSamples, glm::vec2* samples)
+{
+    const Scene& scene = converter.GetScene();
+    for (uint32_t i = 0; i < numSourceCurves; i++)
+    {
+        uint32_t firstCurve = converter.GetFirstCurve(i);
+        uint32_t endCurve = converter.GetFirstCurve(i + 1);
+        uint32_t segment = firstCurve;
+        float t0 = converter.GetStartParameter(segment);
+        float t1 = segment + 1 < endCurve ? converter.GetStartParameter(segment + 1) : 1.0f;
+        float scale = 1.0f / (t1 - t0);
+        for (uint32_t k = 0; k < numSamples; k++)
+        {
+            float t = float(k) / (numSamples - 1);
+            while (t > t1 && segment + 1 < endCurve)
+            {
+                segment++;
+                t0 = t1;
+                t1 = segment + 1 < endCurve ? converter.GetStartParameter(segment + 1) : 1.0f;
+                scale = 1.0f / (t1 - t0);
+            }
+
+            const glm::vec2* controlPoints = &scene.Positions[scene.Curves[segment].FirstControlPoint];
+            samples[i * numSamples + k] = EvaluateBezier<Degree>(controlPoints, (t - t0) * scale);
+        }
+    }
+}
+
+static void EvaluateSourceScene(const Scene& scene, uint32_t numSamples, glm::vec2* samples)
+{
+    for (uint32_t i = 0; i < scene.Curves.size(); i++)
+    {
+        const SceneCurve& curve = scene.Curves[i];
+        EvaluateBezierSamples(&scene.Positions[curve.FirstControlPoint], curve.NumControlPoints, numSamples, 0, numSamples, &samples[i * numSamples]);
+    }
+}
+
+static void RunElevationBenchmark(BenchmarkRunner& runner, uint32_t numControlPoints, uint32_t numElevatedPoints)
+{
+    std::string name = "Degree/Elevate/Points:" + std::to_string(numControlPoints) + "to" + std::to_string(numElevatedPoints);
+    if (!runner.IsSelected(name))
+        return;
+
+    Scene scene = CreateBenchmarkScene(DEGREE_BENCHMARK_CURVES, numControlPoints, 0, 140);
+    std::vector<glm::vec2> elevated(DEGREE_BENCHMARK_CURVES * numElevatedPoints);
+    runner.Run(name, DEGREE_BENCHMARK_CURVES, [&]()
+    {
+        for (uint32_t i = 0; i < DEGREE_BENCHMARK_CURVES; i++)
+            ElevateBezierDegree(&scene.Positions[scene.Curves[i].FirstControlPoint], numControlPoints, numElevatedPoints, &elevated[i * numElevatedPoints]);
+        DoNotOptimize(elevated.data());
+        ClobberMemory();
+    });
+
+    // Elevation does not change the curve, only rounding separates the two
+    std::vector<glm::vec2> samples(DEGREE_BENCHMARK_SAMPLES);
+    std::vector<glm::vec2> elevatedSamples(DEGREE_BENCHMARK_SAMPLES);
+    float maxError = 0.0f;
+    for (uint32_t i = 0; i < DEGREE_BENCHMARK_CURVES; i++)
+    {
+        TessellateBezier(&scene.Positions[scene.Curves[i].FirstControlPoint], numControlPoints, DEGREE_BENCHMARK_SAMPLES, samples.data());
+        TessellateBezier(&elevated[i * numElevatedPoints], numElevatedPoints, DEGREE_BENCHMARK_SAMPLES, elevatedSamples.data());
+        for (uint32_t k = 0; k < DEGREE_BENCHMARK_SAMPLES; k++)
+            maxError = std::max(maxError, glm::distance(samples[k], elevatedSamples[k]));
+    }
+
+    runner.AddCounter("MaxError", maxError);
+    if (maxError > 1e-5f)
+        runner.ReportFailure(name + ": the elevated curve is " + std::to_string(maxError) + " away from the curve");
+}
+
+static void RunReductionBenchmark(BenchmarkRunner& runner, uint32_t numControlPoints, uint32_t numTargetPoints, uint32_t continuity, float tolerance)
+{
+    char toleranceText[32];
+    snprintf(toleranceText, sizeof(toleranceText), "%.5f", tolerance);
+    std::string name = "Degree/Reduce/Points:" + std::to_string(numControlPoints) + "to" + std::to_string(numTargetPoints) + "/Continuity:" +
+        std::to_string(continuity) + "/Tolerance:" + toleranceText;
+    if (!runner.IsSelected(name))
+        return;
+
+    Scene scene = CreateBenchmarkScene(DEGREE_BENCHMARK_CURVES, numControlPoints, 0, 141);
+    std::vector<glm::vec2> segments;
+    std::vector<float> parameters;
+    CurveDegreeStats stats;
+    runner.Run(name, DEGREE_BENCHMARK_CURVES, [&]()
+    {
+        segments.clear();
+        parameters.clear();
+        stats = CurveDegreeStats();
+        for (const SceneCurve& curve : scene.Curves)
+            ConvertBezierDegree(&scene.Positions[curve.FirstControlPoint], curve.NumControlPoints, numTargetPoints, tolerance, continuity, segments, parameters, stats);
+        DoNotOptimize(segments.data());
+        ClobberMemory();
+    });
+
+    // Distance between the curve and its segments at the same parameter, which the reported error bounds from above. Every
+    // curve is converted again on its own to know which segments belong to it
+    std::vector<glm::vec2> scratch(numControlPoints);
+    float maxError = 0.0f;
+    for (const SceneCurve& curve : scene.Curves)
+    {
+        const glm::vec2* controlPoints = &scene.Positions[curve.FirstControlPoint];
+        std::vector<glm::vec2> curveSegments;
+        std::vector<float> curveParameters;
+        CurveDegreeStats curveStats;
+        ConvertBezierDegree(controlPoints, numControlPoints, numTargetPoints, tolerance, continuity, curveSegments, curveParameters, curveStats);
+
+        for (uint32_t j = 0; j < curveParameters.size(); j++)
+        {
+            float t0 = curveParameters[j];
+            float t1 = j + 1 < curveParameters.size() ? curveParameters[j + 1] : 1.0f;
+            for (uint32_t k = 0; k < DEGREE_BENCHMARK_SAMPLES; k++)
+            {
+                float u = float(k) / (DEGREE_BENCHMARK_SAMPLES - 1);
+                glm::vec2 point = EvaluateBezier(controlPoints, numControlPoints, t0 + (t1 - t0) * u, scratch.data());
+                glm::vec2 segmentPoint = EvaluateBezier(&curveSegments[j * numTargetPoints], numTargetPoints, u, scratch.data());
+                maxError = std::max(maxError, glm::distance(point, segmentPoint));
+            }
+        }
+    }
+
+    runner.AddCounter("SegmentsPerCurve", float(stats.NumSegments) / DEGREE_BENCHMARK_CURVES);
+    runner.AddCounter("ReductionsPerSegment", float(stats.NumReductions) / stats.NumSegments);
+    runner.AddCounter("ErrorBound", stats.MaxError);
+    runner.AddCounter("MaxError", maxError);
+    if (maxError > DEGREE_BENCHMARK_ERROR_SLACK * std::max(tolerance, stats.MaxError))
+        runner.ReportFailure(name + ": a segment is " + std::to_string(maxError) + " away from the curve, above its error bound");
+    if (stats.MaxError > tolerance)
+        runner.ReportFailure(name + ": a segment misses the tolerance with an error bound of " + std::to_string(stats.MaxError));
+}
+
+// Evaluation of a scene of degree 20 curves at the renderer's sample count against converting it to cubics and evaluating
+// those at the same parameters, the conversion pays off once the scene is evaluated a few times
+static void RunSceneBenchmark(BenchmarkRunner& runner)
+{
+    const uint32_t numControlPoints = 21;
+    const uint32_t numSamples = 64;
+    Scene scene = CreateBenchmarkScene(DEGREE_BENCHMARK_CURVES, numControlPoints, numSamples, 142);
+    std::vector<glm::vec2> samples(DEGREE_BENCHMARK_CURVES * numSamples);
+    std::vector<glm::vec2> convertedSamples(DEGREE_BENCHMARK_CURVES * numSamples);
+    std::string prefix = "Degree/Scene/Points:" + std::to_string(numControlPoints);
+
+    double sourceTime = 0.0;
+    std::string sourceName = prefix + "/Evaluate";
+    runner.Run(sourceName, DEGREE_BENCHMARK_CURVES * numSamples, [&]()
+    {
+        EvaluateSourceScene(scene, numSamples, samples.data());
+        DoNotOptimize(samples.data());
+        ClobberMemory();
+    });
+    if (runner.IsSelected(sourceName))
+        sourceTime = runner.GetLastResult().Median;
+
+    JobSystem jobSystem(1);
+    CurveDegreeConverter converter;
+    double convertTime = 0.0;
+    std::string convertName = prefix + "/ConvertToCubics";
+    runner.Run(convertName, DEGREE_BENCHMARK_CURVES, [&]()
+    {
+        converter.ConvertScene(jobSystem, scene.GetView(), 4);
+        DoNotOptimize(converter.GetScene().Positions.data());
+        ClobberMemory();
+    });
+    if (runner.IsSelected(convertName))
+    {
+        convertTime = runner.GetLastResult().Median;
+        runner.AddCounter("SegmentsPerCurve", float(converter.GetStats().NumSegments) / DEGREE_BENCHMARK_CURVES);
+        runner.AddCounter("ErrorBound", converter.GetStats().MaxError);
+    }
+
+    std::string cubicName = prefix + "/EvaluateCubics";
+    if (!runner.IsSelected(cubicName))
+        return;
+
+    if (!runner.IsSelected(convertName))
+        converter.ConvertScene(jobSystem, scene.GetView(), 4);
+    runner.Run(cubicName, DEGREE_BENCHMARK_CURVES * numSamples, [&]()
+    {
+        EvaluateConvertedScene<3>(converter, DEGREE_BENCHMARK_CURVES, numSamples, convertedSamples.data());
+        DoNotOptimize(convertedSamples.data());
+        ClobberMemory();
+    });
+
+    double cubicTime = runner.GetLastResult().Median;
+    if (sourceTime > 0.0)
+    {
+        runner.AddCounter("SpeedupOverSource", sourceTime / cubicTime);
+        if (convertTime > 0.0 && sourceTime > cubicTime)
+            runner.AddCounter("BreakEvenEvaluations", convertTime / (sourceTime - cubicTime));
+    }
+
+    // Same parameters on both sides, so the samples differ by at most the error bound
+    EvaluateSourceScene(scene, numSamples, samples.data());
+    float maxError = 0.0f;
+    for (uint32_t i = 0; i < samples.size(); i++)
+        maxError = std::max(maxError, glm::distance(samples[i], convertedSamples[i]));
+    runner.AddCounter("MaxError", maxError);
+    if (maxError > DEGREE_BENCHMARK_ERROR_SLACK * CURVE_DEGREE_DEFAULT_TOLERANCE)
+        runner.ReportFailure(cubicName + ": a sample is " + std::to_string(maxError) + " away from the source curve");
+}
+
+static void RunParallelConversionBenchmark(BenchmarkRunner& runner)
+{
+    const uint32_t numCurves = 8192;
+    Scene scene = CreateBenchmarkScene(numCurves, 21, 0, 143);
+    SceneView view = scene.GetView();
+
+    uint32_t maxThreads = runner.GetOptions().MaxThreads;
+    if (maxThreads == 0)
+        maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    CurveDegreeConverter converter;
+    double singleThreadTime = 0.0;
+    for (uint32_t numThreads : { 1u, maxThreads })
+    {
+        std::string name = "Degree/Convert/Curves:" + std::to_string(numCurves) + "/Threads:" + std::to_string(numThreads);
+        if (!runner.IsSelected(name))
+            continue;
+
+        JobSystem jobSystem(numThreads);
+        runner.Run(name, numCurves, [&]()
+        {
+            converter.ConvertScene(jobSystem, view, 4);
+            DoNotOptimize(converter.GetScene().Positions.data());
+            ClobberMemory();
+        });
+
+        runner.AddCounter("Segments", converter.GetStats().NumSegments);
+        if (numThreads == 1)
+            singleThreadTime = runner.GetLastResult().Median;
+        else if (singleThreadTime > 0.0)
+            runner.AddCounter("SpeedupOverOneThread", singleThreadTime / runner.GetLastResult().Median);
+
+        if (maxThreads == 1)
+            break;
+    }
+}
+
+void RunDegreeBenchmarks(BenchmarkRunner& runner)
+{
+    RunElevationBenchmark(runner, 4, 21);
+
+    // Segment count against error against time, over the source and target degree, the continuity and the tolerance
+    static const uint32_t s_SourcePoints[] = { 6, 11, 21 };
+    for (uint32_t numControlPoints : s_SourcePoints)
+    {
+        RunReductionBenchmark(runner, numControlPoints, 4, 0, CURVE_DEGREE_DEFAULT_TOLERANCE);
+        RunReductionBenchmark(runner, numControlPoints, 4, 1, CURVE_DEGREE_DEFAULT_TOLERANCE);
+    }
+    RunReductionBenchmark(runner, 21, 6, 2, CURVE_DEGREE_DEFAULT_TOLERANCE);
+    RunReductionBenchmark(runner, 21, 4, 1, 1e-3f);
+    RunReductionBenchmark(runner, 21, 4, 1, 1e-4f);
+    RunReductionBenchmark(runner, 21, 4, 1, 1e-5f);
+
+    RunSceneBenchmark(runner);
+    RunParallelConversionBenchmark(runner);
+}
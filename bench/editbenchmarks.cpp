@@ -0,0 +1,199 @@
+#include "benchmark.h"
+
+#include "autosave.h"
+#include "editjournal.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#define EDIT_BENCHMARK_AUTOSAVE_DIRECTORY "benchmark_autosave"
+#define EDIT_HISTORY_STEPS 10000
+// 1024 curves of 1024 control points, 20 MB of positions and colors
+#define EDIT_HISTORY_CURVES 1024
+#define EDIT_HISTORY_CURVE_POINTS 1024
+// Longest run of control points a history step moves together, like dragging a selection
+#define EDIT_HISTORY_MAX_MOVED_POINTS 64
+
+// Simulates frames of an editing session: every frame drags control points and seals the command, like the editor does
+// when the mouse is released. The autosave variants measure what the journal costs the UI thread on top of the edit itself
+static void RunEditFrames(BenchmarkRunner& runner, const std::string& name, uint32_t editsPerFrame, AutosaveJournal* autosave)
+{
+    if (!runner.IsSelected(name))
+        return;
+
+    Scene scene = CreateBenchmarkScene(2, 16, 50, 3);
+    EditJournal journal;
+    if (autosave)
+    {
+        if (!autosave->Start(EDIT_BENCHMARK_AUTOSAVE_DIRECTORY, scene))
+        {
+            runner.ReportFailure(name + ": failed to start the autosave journal");
+            return;
+        }
+        journal.SetListener(autosave);
+    }
+
+    BenchmarkRandom random(4);
+    runner.Run(name, editsPerFrame, [&]()
+    {
+        for (uint32_t i = 0; i < editsPerFrame; i++)
+        {
+            uint32_t index = random.NextUInt() % scene.Curves[0].NumControlPoints;
+            journal.SetControlPointPosition(scene, 0, index, glm::vec2(random.NextFloat(-0.9f, 0.9f), random.NextFloat(-0.9f, 0.9f)));
+        }
+        journal.EndCommand(scene);
+
+        if (autosave)
+            autosave->Update(scene);
+    });
+
+    if (autosave)
+    {
+        runner.AddCounter("RecordsWritten", autosave->GetNumRecordsWritten());
+        runner.AddCounter("Compactions", autosave->GetNumCompactions());
+        runner.AddCounter("Overflows", autosave->GetNumOverflows());
+
+        journal.SetListener(nullptr);
+        autosave->Stop(true);
+    }
+}
+
+// Heap bytes in use by the whole process, exact with the allocation tracker
+static uint64_t GetLiveHeapBytes()
+{
+    AllocationStats stats = AllocationTracker::GetTotalStats();
+    return stats.BytesAllocated - stats.BytesFreed;
+}
+
+static bool IsSameScene(const Scene& a, const Scene& b)
+{
+    return a.Curves.size() == b.Curves.size() && memcmp(a.Curves.data(), b.Curves.data(), a.Curves.size() * sizeof(SceneCurve)) == 0 &&
+        a.Positions == b.Positions && a.Colors == b.Colors;
+}
+
+// Records a long history of edits on a large scene under a memory budget. A step drags a run of control points, sometimes
+// recolors a curve and sometimes inserts or removes a point of the last curve, so structural edits do not shift the whole scene.
+// The scene has room for every insert up front, so the heap the process gains while recording is the journal's alone. Fails
+// when the usage the journal reports or the heap it holds exceed the budget after a step, or when jumping back to the first
+// step kept and forward again does not give back the edited scene
+static void RunEditHistory(BenchmarkRunner& runner, uint64_t memoryBudget)
+{
+    std::string suffix = "/Steps:" + std::to_string(EDIT_HISTORY_STEPS) + "/Points:1M/Budget:" + std::to_string(memoryBudget >> 20) + "MB";
+    std::string historyName = "EditHistory/Record" + suffix;
+    std::string jumpName = "EditHistory/JumpToFirstAndBack" + suffix;
+    if (!runner.IsSelected(historyName) && !runner.IsSelected(jumpName))
+        return;
+
+    Scene baseScene = CreateBenchmarkScene(EDIT_HISTORY_CURVES, EDIT_HISTORY_CURVE_POINTS, 50, 28);
+    Scene scene;
+    scene.Curves.reserve(baseScene.Curves.size());
+    scene.Positions.reserve(baseScene.Positions.size() + EDIT_HISTORY_STEPS);
+    scene.Colors.reserve(baseScene.Colors.size() + EDIT_HISTORY_STEPS);
+
+    EditJournal journal(memoryBudget);
+    uint64_t peakJournalBytes = 0;
+    uint64_t peakHeapBytes = 0;
+    auto recordHistory = [&]()
+    {
+        journal.Clear();
+        scene.Curves.assign(baseScene.Curves.begin(), baseScene.Curves.end());
+        scene.Positions.assign(baseScene.Positions.begin(), baseScene.Positions.end());
+        scene.Colors.assign(baseScene.Colors.begin(), baseScene.Colors.end());
+
+        BenchmarkRandom random(29);
+        uint64_t startHeapBytes = GetLiveHeapBytes();
+        uint32_t lastCurve = (uint32_t)scene.Curves.size() - 1;
+        for (uint32_t step = 0; step < EDIT_HISTORY_STEPS; step++)
+        {
+            uint32_t curve = random.NextUInt() % scene.Curves.size();
+            uint32_t numPoints = scene.Curves[curve].NumControlPoints;
+            uint32_t numMoved = std::min(1 + random.NextUInt() % EDIT_HISTORY_MAX_MOVED_POINTS, numPoints);
+            uint32_t first = random.NextUInt() % (numPoints - numMoved + 1);
+            glm::vec2 offset = glm::vec2(random.NextFloat(-0.01f, 0.01f), random.NextFloat(-0.01f, 0.01f));
+
+            // A drag moves the selection over several frames, each point ends up as one coalesced delta
+            for (uint32_t frame = 1; frame <= 4; frame++)
+            {
+                for (uint32_t i = first; i < first + numMoved; i++)
+                    journal.SetControlPointPosition(scene, curve, i, scene.Positions[scene.Curves[curve].FirstControlPoint + i] + offset * (1.0f / frame));
+            }
+
+            uint32_t kind = random.NextUInt() % 16;
+            if (kind == 0)
+                journal.SetCurveColor(scene, curve, glm::vec3(random.NextFloat(0.2f, 1.0f), random.NextFloat(0.2f, 1.0f), random.NextFloat(0.2f, 1.0f)));
+            else if (kind == 1)
+                journal.InsertControlPoint(scene, lastCurve, random.NextUInt() % scene.Curves[lastCurve].NumControlPoints, glm::vec2(0.0f), glm::vec3(1.0f));
+            else if (kind == 2 && scene.Curves[lastCurve].NumControlPoints > 4)
+                journal.RemoveControlPoint(scene, lastCurve, random.NextUInt() % scene.Curves[lastCurve].NumControlPoints);
+
+            journal.EndCommand(scene);
+            peakJournalBytes = std::max(peakJournalBytes, journal.GetMemoryUsage());
+            peakHeapBytes = std::max(peakHeapBytes, GetLiveHeapBytes() - startHeapBytes);
+        }
+    };
+
+    if (runner.IsSelected(historyName))
+    {
+        runner.Run(historyName, EDIT_HISTORY_STEPS, recordHistory);
+    }
+    else
+    {
+        recordHistory();
+    }
+
+    // Both counters go to the last result, whichever of the two benchmarks that is
+    auto addCounters = [&]()
+    {
+        runner.AddCounter("BudgetMB", memoryBudget / (1024.0 * 1024.0));
+        runner.AddCounter("PeakJournalMB", peakJournalBytes / (1024.0 * 1024.0));
+        runner.AddCounter("PeakHeapMB", peakHeapBytes / (1024.0 * 1024.0));
+        runner.AddCounter("StepsKept", (double)(journal.GetLastStep() - journal.GetFirstStep()));
+        runner.AddCounter("Keyframes", journal.GetNumKeyframes());
+    };
+
+    if (runner.IsSelected(historyName))
+        addCounters();
+
+    if (peakJournalBytes > memoryBudget || peakHeapBytes > memoryBudget)
+        runner.ReportFailure(historyName + ": the journal held " + std::to_string(peakJournalBytes) + " bytes by its own count and " + std::to_string(peakHeapBytes) +
+            " bytes of heap, more than its budget of " + std::to_string(memoryBudget));
+
+    if (!runner.IsSelected(jumpName))
+        return;
+
+    Scene editedScene = scene;
+    bool isSame = true;
+    runner.Run(jumpName, (double)(journal.GetLastStep() - journal.GetFirstStep()), [&]()
+    {
+        journal.JumpTo(scene, journal.GetFirstStep());
+        journal.JumpTo(scene, journal.GetLastStep());
+        isSame = isSame && IsSameScene(scene, editedScene);
+    });
+
+    if (!runner.IsSelected(historyName))
+        addCounters();
+
+    if (!isSame)
+        runner.ReportFailure(jumpName + ": jumping through the history did not give back the edited scene");
+}
+
+void RunEditBenchmarks(BenchmarkRunner& runner)
+{
+    static const uint32_t s_EditsPerFrame[] = { 1, 16, 256 };
+    for (uint32_t editsPerFrame : s_EditsPerFrame)
+    {
+        std::string suffix = "/EditsPerFrame:" + std::to_string(editsPerFrame);
+        RunEditFrames(runner, "EditFrame/Journal" + suffix, editsPerFrame, nullptr);
+
+        AutosaveJournal autosave;
+        RunEditFrames(runner, "EditFrame/JournalAutosave" + suffix, editsPerFrame, &autosave);
+    }
+
+    std::error_code error;
+    std::filesystem::remove_all(EDIT_BENCHMARK_AUTOSAVE_DIRECTORY, error);
+
+    // The small budget keeps a few thousand steps and no keyframes, the large one has to drop keyframes of the 20 MB scene
+    for (uint64_t memoryBudget : { 4ull << 20, 256ull << 20 })
+        RunEditHistory(runner, memoryBudget);
+}
@@ -0,0 +1,164 @@
+#include "benchmark.h"
+
+#include "curvefitter.h"
+#include "curveprojection.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// Pen movement per sample, about a pixel and a half in a 1000 pixel viewport
+#define FITTER_BENCHMARK_STEP 0.003f
+// Hand tremor added to every sample, well below the fitting tolerance
+#define FITTER_BENCHMARK_JITTER 0.0002f
+// The stroke turns sharply once every this many samples on average
+#define FITTER_BENCHMARK_CORNER_INTERVAL 400
+// Samples checked against the fitted segments
+#define FITTER_BENCHMARK_CHECKED_SAMPLES 100000
+// Timed replays of the stroke, a sample's stall is its fastest time over all of them
+#define FITTER_BENCHMARK_STALL_PASSES 3
+
+class SegmentCounter : public SvgPathSink
+{
+public:
+    virtual void OnSegment(const glm::vec2*, uint32_t) override { NumSegments++; }
+
+    uint32_t NumSegments = 0;
+};
+
+class SegmentCollector : public SvgPathSink
+{
+public:
+    virtual void OnSegment(const glm::vec2* controlPoints, uint32_t numControlPoints) override
+    {
+        ControlPoints.insert(ControlPoints.end(), controlPoints, controlPoints + numControlPoints);
+    }
+
+    std::vector<glm::vec2> ControlPoints;
+};
+
+// Recorded strokes are not part of the repository, this replays a synthetic one instead: the pen moves at a steady
+// speed, its heading drifts with a slowly changing curvature, turns sharply every now and then and bends back towards
+// the middle of the viewport when it gets close to the edge
+static std::vector<glm::vec2> CreateStroke(uint32_t numSamples, uint32_t seed, uint32_t& numCorners)
+{
+    BenchmarkRandom random(seed);
+    std::vector<glm::vec2> stroke(numSamples);
+
+    glm::vec2 position = glm::vec2(0.0f);
+    float heading = 0.0f;
+    float curvature = 0.0f;
+    numCorners = 0;
+    for (uint32_t i = 0; i < numSamples; i++)
+    {
+        curvature = std::clamp(curvature + random.NextFloat(-0.01f, 0.01f), -0.15f, 0.15f);
+        heading += curvature;
+        if (random.NextUInt() % FITTER_BENCHMARK_CORNER_INTERVAL == 0)
+        {
+            heading += random.NextFloat(1.8f, 2.6f) * (random.NextUInt() % 2 ? 1.0f : -1.0f);
+            numCorners++;
+        }
+
+        if (std::abs(position.x) > 0.8f || std::abs(position.y) > 0.8f)
+        {
+            float towardsCenter = std::atan2(-position.y, -position.x);
+            float difference = std::remainder(towardsCenter - heading, 6.2831853f);
+            heading += std::clamp(difference, -0.05f, 0.05f);
+        }
+
+        position += glm::vec2(std::cos(heading), std::sin(heading)) * FITTER_BENCHMARK_STEP;
+        glm::vec2 jitter = glm::vec2(random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f)) * FITTER_BENCHMARK_JITTER;
+        stroke[i] = position + jitter;
+    }
+
+    return stroke;
+}
+
+// Farthest distance of a stroke sample from the fitted segments. Segments are fitted to consecutive runs of samples and
+// each one starts exactly at a sample, the samples up to the start of the next segment are checked against it
+static float GetMaxStrokeDistance(const std::vector<glm::vec2>& stroke, uint32_t numSamples, const std::vector<glm::vec2>& controlPoints)
+{
+    uint32_t numSegments = controlPoints.size() / 4;
+    if (numSegments == 0)
+        return 0.0f;
+
+    CurveProjector projector(&controlPoints[0], 4);
+    float maxDistance = 0.0f;
+    uint32_t segment = 0;
+    for (uint32_t i = 0; i < numSamples; i++)
+    {
+        if (segment + 1 < numSegments && stroke[i] == controlPoints[4 * (segment + 1)])
+        {
+            segment++;
+            projector.SetCurve(&controlPoints[4 * segment], 4);
+        }
+
+        maxDistance = std::max(maxDistance, projector.Project(stroke[i]).Distance);
+    }
+
+    return maxDistance;
+}
+
+static void RunStrokeBenchmark(BenchmarkRunner& runner, uint32_t numSamples)
+{
+    uint32_t numGeneratedCorners;
+    std::vector<glm::vec2> stroke = CreateStroke(numSamples, 110, numGeneratedCorners);
+    std::string name = "Fitter/Stroke:" + std::to_string(numSamples) + "/Replay";
+
+    SegmentCounter counter;
+    CurveFitter fitter(counter);
+    runner.Run(name, numSamples, [&]()
+    {
+        fitter.BeginStroke();
+        for (const glm::vec2& sample : stroke)
+            fitter.AddSample(sample);
+        fitter.EndStroke();
+        DoNotOptimize(counter.NumSegments);
+    });
+
+    if (!runner.IsSelected(name))
+        return;
+
+    // Every sample timed on its own, the stall is the longest time the input thread would wait for one sample. The stroke
+    // is replayed a few times and each sample keeps its fastest time, so a preempted sample does not count as a stall
+    SegmentCollector collector;
+    collector.ControlPoints.reserve(numSamples);
+    std::vector<float> sampleTimes(numSamples, FLT_MAX);
+    CurveFitterStats stats;
+    for (uint32_t pass = 0; pass < FITTER_BENCHMARK_STALL_PASSES; pass++)
+    {
+        collector.ControlPoints.clear();
+        CurveFitter timedFitter(collector);
+        timedFitter.BeginStroke();
+        for (uint32_t i = 0; i < numSamples; i++)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            timedFitter.AddSample(stroke[i]);
+            float time = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+            sampleTimes[i] = std::min(sampleTimes[i], time);
+        }
+        timedFitter.EndStroke();
+        stats = timedFitter.GetStats();
+    }
+
+    std::sort(sampleTimes.begin(), sampleTimes.end());
+    runner.AddCounter("MaxSampleStallUs", sampleTimes.back());
+    runner.AddCounter("P999SampleStallUs", sampleTimes[(size_t)(sampleTimes.size() * 0.999)]);
+
+    runner.AddCounter("Segments", stats.NumSegments);
+    runner.AddCounter("Corners", stats.NumCorners);
+    runner.AddCounter("GeneratedCorners", numGeneratedCorners);
+
+    // Samples dropped for being too close to the previous one may lie up to a tenth of the tolerance off the fit
+    float maxDistance = GetMaxStrokeDistance(stroke, std::min<uint32_t>(numSamples, FITTER_BENCHMARK_CHECKED_SAMPLES), collector.ControlPoints);
+    runner.AddCounter("MaxDistance", maxDistance);
+    if (maxDistance > 1.1f * CURVE_FITTER_DEFAULT_TOLERANCE)
+        runner.ReportFailure(name + ": a sample is " + std::to_string(maxDistance) + " away from the fitted curve");
+}
+
+void RunFitterBenchmarks(BenchmarkRunner& runner)
+{
+    // The stall must not grow with the length of the stroke
+    RunStrokeBenchmark(runner, 10000);
+    RunStrokeBenchmark(runner, 1000000);
+}
@@ -0,0 +1,210 @@
+#include "benchmark.h"
+
+#include "cpurenderer.h"
+#include "imagefile.h"
+
+#include <algorithm>
+#include <filesystem>
+
+#define GOLDEN_IMAGE_SIZE 256
+#define GOLDEN_FAILURE_DIRECTORY "golden_failures"
+// Per pixel YIQ color difference, relative to the largest possible difference, above which two pixels differ
+#define GOLDEN_COLOR_THRESHOLD 0.1f
+// Fraction of differing pixels a render may have and still match its golden image
+#define GOLDEN_MAX_MISMATCH_RATIO 0.001f
+
+struct GoldenScene
+{
+    const char* Name;
+    uint32_t Degree;
+    float Thickness;
+    int NumSamples;
+    float T1;
+    bool DrawBezierCurve;
+    bool DrawPolar;
+};
+
+// Each entry varies one parameter of the default editor scene, a cubic with 50 samples drawn with its polar at 0.5
+static const GoldenScene s_GoldenScenes[] =
+{
+    { "Degree1", 1, 1.0f, 50, 0.5f, true, true },
+    { "Degree2", 2, 1.0f, 50, 0.5f, true, true },
+    { "Degree3", 3, 1.0f, 50, 0.5f, true, true },
+    { "Degree5", 5, 1.0f, 50, 0.5f, true, true },
+    { "Degree8", 8, 1.0f, 50, 0.5f, true, true },
+    { "Degree15", 15, 1.0f, 50, 0.5f, true, true },
+    { "ThicknessThin", 3, 0.25f, 50, 0.5f, true, true },
+    { "ThicknessThick", 3, 4.0f, 50, 0.5f, true, true },
+    { "Samples2", 3, 1.0f, 2, 0.5f, true, true },
+    { "Samples8", 3, 1.0f, 8, 0.5f, true, true },
+    { "Samples400", 3, 1.0f, 400, 0.5f, true, true },
+    { "T1Start", 3, 1.0f, 50, 0.0f, true, true },
+    { "T1Quarter", 3, 1.0f, 50, 0.25f, true, true },
+    { "T1End", 3, 1.0f, 50, 1.0f, true, true },
+    { "CurveOnly", 3, 1.0f, 50, 0.5f, true, false },
+    { "PolarOnly", 3, 1.0f, 50, 0.5f, false, true },
+    { "Nothing", 3, 1.0f, 50, 0.5f, false, false },
+};
+
+static Scene CreateGoldenScene(const GoldenScene& golden)
+{
+    Scene scene;
+    scene.Settings.DrawBezierCurve = golden.DrawBezierCurve;
+    scene.Settings.DrawPolar = golden.DrawPolar;
+    scene.Settings.NumSamples = golden.NumSamples;
+    scene.Settings.T1 = golden.T1;
+
+    // Same curve layout as the editor: the original curve followed by the curve holding the style of the polar
+    scene.AddCurve(glm::vec3(1.0f), golden.Thickness);
+    for (uint32_t i = 0; i <= golden.Degree; i++)
+    {
+        // Zigzag with exactly representable coordinates, so the scene is identical on every platform
+        float x = -0.75f + 1.5f * i / golden.Degree;
+        float y = (float)((i * 3) % 5) * 0.375f - 0.75f;
+        scene.AddControlPoint(glm::vec2(x, y));
+    }
+    scene.AddCurve(glm::vec3(0.2f, 0.9f, 0.4f), golden.Thickness);
+
+    return scene;
+}
+
+static glm::vec3 GetYiq(uint32_t pixel)
+{
+    float r = (float)(pixel & 0xFF);
+    float g = (float)((pixel >> 8) & 0xFF);
+    float b = (float)((pixel >> 16) & 0xFF);
+    return glm::vec3(r * 0.29889531f + g * 0.58662247f + b * 0.11448223f,
+                     r * 0.59597799f - g * 0.27417610f - b * 0.32180189f,
+                     r * 0.21147017f - g * 0.52261711f + b * 0.31114694f);
+}
+
+// Perceptual color difference in YIQ space, weighted as in "Measuring perceived color difference using YIQ NTSC
+// transmission color space in mobile applications" (Kotsalos et al.)
+static bool PixelsDiffer(uint32_t a, uint32_t b)
+{
+    if (a == b)
+        return false;
+
+    glm::vec3 delta = GetYiq(a) - GetYiq(b);
+    float difference = 0.5053f * delta.x * delta.x + 0.299f * delta.y * delta.y + 0.1957f * delta.z * delta.z;
+    return difference > 35215.0f * GOLDEN_COLOR_THRESHOLD * GOLDEN_COLOR_THRESHOLD;
+}
+
+// True when the pixel matches one of the neighbors of (x, y) in the other image
+static bool MatchesNeighborhood(uint32_t pixel, const CpuImage& image, uint32_t x, uint32_t y)
+{
+    for (uint32_t ny = std::max(y, 1u) - 1; ny <= std::min(y + 1, image.Height - 1); ny++)
+    {
+        for (uint32_t nx = std::max(x, 1u) - 1; nx <= std::min(x + 1, image.Width - 1); nx++)
+        {
+            if (!PixelsDiffer(pixel, image.Pixels[(size_t)ny * image.Width + nx]))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+// Counts the pixels that differ perceptually. Edges shifted by up to a pixel, as produced by small precision differences
+// in the distance computations, are tolerated and marked yellow in the diff image, real differences are marked red
+static uint32_t CompareImages(const CpuImage& actual, const CpuImage& golden, CpuImage& diff)
+{
+    diff.Width = golden.Width;
+    diff.Height = golden.Height;
+    diff.Pixels.resize(golden.Pixels.size());
+
+    uint32_t numMismatches = 0;
+    for (uint32_t y = 0; y < golden.Height; y++)
+    {
+        for (uint32_t x = 0; x < golden.Width; x++)
+        {
+            size_t index = (size_t)y * golden.Width + x;
+            uint32_t actualPixel = actual.Pixels[index];
+            uint32_t goldenPixel = golden.Pixels[index];
+
+            if (!PixelsDiffer(actualPixel, goldenPixel))
+            {
+                // Dimmed golden luminance as context
+                uint32_t luminance = (uint32_t)(GetYiq(goldenPixel).x * 0.25f);
+                diff.Pixels[index] = luminance | (luminance << 8) | (luminance << 16) | (255u << 24);
+            }
+            else if (MatchesNeighborhood(actualPixel, golden, x, y) && MatchesNeighborhood(goldenPixel, actual, x, y))
+            {
+                diff.Pixels[index] = 0xFF00FFFF;
+            }
+            else
+            {
+                diff.Pixels[index] = 0xFF0000FF;
+                numMismatches++;
+            }
+        }
+    }
+
+    return numMismatches;
+}
+
+void RunGoldenImageTests(BenchmarkRunner& runner)
+{
+    const BenchmarkOptions& options = runner.GetOptions();
+    if (options.GoldenDirectory.empty())
+        return;
+
+    std::error_code error;
+    if (options.UpdateGolden)
+        std::filesystem::create_directories(options.GoldenDirectory, error);
+
+    JobSystem jobSystem(options.MaxThreads);
+    CpuRenderer renderer(jobSystem);
+    CpuImage image;
+
+    for (const GoldenScene& golden : s_GoldenScenes)
+    {
+        std::string name = std::string("Golden/") + golden.Name;
+        if (!runner.IsSelected(name))
+            continue;
+
+        // Render time is recorded with the result, so speed and quality regressions show up in the same report
+        std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(CreateGoldenScene(golden));
+        runner.Run(name, (double)GOLDEN_IMAGE_SIZE * GOLDEN_IMAGE_SIZE, [&]()
+        {
+            renderer.Render(*snapshot, GOLDEN_IMAGE_SIZE, GOLDEN_IMAGE_SIZE, image);
+            DoNotOptimize(image.Pixels.data());
+            ClobberMemory();
+        });
+
+        std::string goldenPath = options.GoldenDirectory + "/" + golden.Name + ".tga";
+        if (options.UpdateGolden)
+        {
+            if (!SaveImageTga(goldenPath, image))
+                runner.ReportFailure(name + ": failed to write the golden image");
+            continue;
+        }
+
+        CpuImage goldenImage;
+        if (!LoadImageTga(goldenPath, goldenImage))
+        {
+            runner.ReportFailure(name + ": missing golden image, run with --update-golden to create it");
+            continue;
+        }
+
+        if (goldenImage.Width != image.Width || goldenImage.Height != image.Height)
+        {
+            runner.ReportFailure(name + ": golden image has a different size");
+            continue;
+        }
+
+        CpuImage diff;
+        uint32_t numMismatches = CompareImages(image, goldenImage, diff);
+        runner.AddCounter("MismatchedPixels", numMismatches);
+
+        if (numMismatches > GOLDEN_MAX_MISMATCH_RATIO * image.Pixels.size())
+        {
+            std::filesystem::create_directories(GOLDEN_FAILURE_DIRECTORY, error);
+            std::string failurePath = std::string(GOLDEN_FAILURE_DIRECTORY) + "/" + golden.Name;
+            SaveImageTga(failurePath + ".actual.tga", image);
+            SaveImageTga(failurePath + ".diff.tga", diff);
+
+            runner.ReportFailure(name + ": " + std::to_string(numMismatches) + " pixels differ from the golden image, see " + failurePath + ".diff.tga");
+        }
+    }
+}
@@ -0,0 +1,139 @@
+#include "benchmark.h"
+
+#include "bezier.h"
+#include "curveintersection.h"
+
+#define INTERSECTION_BENCHMARK_PAIRS 256
+// Size of the curves of the dense scenes, small enough that a curve only crosses its neighbors
+#define INTERSECTION_SCENE_CURVE_RADIUS 0.08f
+
+// Curves scattered over the [-1, 1] square, each within a small circle so the number of crossings grows with the density
+static Scene CreateCrossingScene(uint32_t numCurves, uint32_t numControlPoints, uint32_t seed)
+{
+    BenchmarkRandom random(seed);
+
+    Scene scene;
+    for (uint32_t i = 0; i < numCurves; i++)
+    {
+        scene.AddCurve();
+        glm::vec2 center = glm::vec2(random.NextFloat(-0.9f, 0.9f), random.NextFloat(-0.9f, 0.9f));
+        for (uint32_t j = 0; j < numControlPoints; j++)
+        {
+            glm::vec2 offset = glm::vec2(random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f)) * INTERSECTION_SCENE_CURVE_RADIUS;
+            scene.AddControlPoint(center + offset);
+        }
+    }
+
+    return scene;
+}
+
+static void RunPairBenchmarks(BenchmarkRunner& runner)
+{
+    static const uint32_t s_Degrees[] = { 1, 2, 3, 5 };
+    for (uint32_t degree : s_Degrees)
+    {
+        BenchmarkRandom random(degree + 60);
+        std::vector<glm::vec2> controlPoints((degree + 1) * 2 * INTERSECTION_BENCHMARK_PAIRS);
+        for (glm::vec2& controlPoint : controlPoints)
+            controlPoint = glm::vec2(random.NextFloat(-0.9f, 0.9f), random.NextFloat(-0.9f, 0.9f));
+
+        CurveIntersectionWorkspace workspace;
+        std::vector<CurveIntersection> intersections;
+        runner.Run("Intersection/Pair/Degree:" + std::to_string(degree), INTERSECTION_BENCHMARK_PAIRS, [&]()
+        {
+            intersections.clear();
+            for (uint32_t i = 0; i < INTERSECTION_BENCHMARK_PAIRS; i++)
+            {
+                const glm::vec2* curve0 = &controlPoints[(degree + 1) * 2 * i];
+                const glm::vec2* curve1 = curve0 + degree + 1;
+                IntersectCurves(curve0, degree + 1, curve1, degree + 1, CURVE_INTERSECTION_DEFAULT_TOLERANCE, intersections, workspace);
+            }
+            DoNotOptimize(intersections.data());
+        });
+
+        if (runner.IsSelected("Intersection/Pair/Degree:" + std::to_string(degree)))
+            runner.AddCounter("IntersectionsPerPair", (double)intersections.size() / INTERSECTION_BENCHMARK_PAIRS);
+    }
+
+    // The editor's case, a curve against its own polar, and the worst case, a curve against itself
+    glm::vec2 curve[5] = { { -0.8f, -0.5f }, { -0.4f, 0.9f }, { 0.1f, -0.6f }, { 0.5f, 0.8f }, { 0.9f, -0.2f } };
+    glm::vec2 polar[4];
+    ComputeBezierPolar(curve, 5, 0.5f, polar);
+
+    CurveIntersectionWorkspace workspace;
+    std::vector<CurveIntersection> intersections;
+    runner.Run("Intersection/Polar", 1.0, [&]()
+    {
+        intersections.clear();
+        IntersectCurves(curve, 5, polar, 4, CURVE_INTERSECTION_DEFAULT_TOLERANCE, intersections, workspace);
+        DoNotOptimize(intersections.data());
+    });
+
+    runner.Run("Intersection/Overlap", 1.0, [&]()
+    {
+        intersections.clear();
+        IntersectCurves(curve, 5, curve, 5, CURVE_INTERSECTION_DEFAULT_TOLERANCE, intersections, workspace);
+        DoNotOptimize(intersections.data());
+    });
+
+    if (runner.IsSelected("Intersection/Overlap") && (intersections.size() != 1 || !intersections[0].IsOverlap))
+        runner.ReportFailure("Intersection/Overlap: a curve intersected with itself is not reported as one overlap");
+}
+
+static void RunSceneBenchmarks(BenchmarkRunner& runner)
+{
+    static const uint32_t s_CurveCounts[] = { 1000, 4000 };
+    for (uint32_t numCurves : s_CurveCounts)
+    {
+        Scene scene = CreateCrossingScene(numCurves, 4, numCurves);
+        SceneView view = scene.GetView();
+
+        std::string name = "Intersection/Scene/Curves:" + std::to_string(numCurves);
+        CurveIntersector intersector;
+        std::vector<CurveIntersection> intersections;
+        runner.Run(name, numCurves, [&]()
+        {
+            intersector.FindIntersections(view, CURVE_INTERSECTION_DEFAULT_TOLERANCE, intersections);
+            DoNotOptimize(intersections.data());
+        });
+
+        if (!runner.IsSelected(name))
+            continue;
+
+        const CurveIntersectionStats& stats = intersector.GetStats();
+        runner.AddCounter("Intersections", stats.NumIntersections);
+        runner.AddCounter("CandidatePairs", stats.NumCandidatePairs);
+        runner.AddCounter("NarrowPhaseTasks", stats.NumTasks);
+
+        // All pairs without the broad phase must find the same intersections, checked on the smallest scene only
+        if (numCurves != s_CurveCounts[0])
+            continue;
+
+        std::vector<CurveIntersection> allPairs;
+        CurveIntersectionWorkspace workspace;
+        runner.Run(name + "/AllPairs", numCurves, [&]()
+        {
+            allPairs.clear();
+            for (uint32_t i = 0; i < numCurves; i++)
+            {
+                for (uint32_t j = i + 1; j < numCurves; j++)
+                {
+                    const SceneCurve& curve0 = scene.Curves[i];
+                    const SceneCurve& curve1 = scene.Curves[j];
+                    IntersectCurves(&scene.Positions[curve0.FirstControlPoint], curve0.NumControlPoints, &scene.Positions[curve1.FirstControlPoint], curve1.NumControlPoints,
+                        CURVE_INTERSECTION_DEFAULT_TOLERANCE, allPairs, workspace);
+                }
+            }
+            DoNotOptimize(allPairs.data());
+        });
+
+        if (allPairs.size() != intersections.size())
+            runner.ReportFailure(name + ": broad phase found " + std::to_string(intersections.size()) + " intersections, all pairs " + std::to_string(allPairs.size()));
+    }
+}
+
+void RunIntersectionBenchmarks(BenchmarkRunner& runner)
+{
+    RunPairBenchmarks(runner);
+    RunSceneBenchmarks(runner);
+}
@@ -0,0 +1,51 @@
+#include "benchmark.h"
+
+#include "jobsystem.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+// Splits ranges far beyond the MAX_JOBS_PER_THREAD slots of a thread into single iterations, every iteration must run
+// exactly once before ParallelFor returns
+static void RunParallelForTest(BenchmarkRunner& runner, JobSystem& jobSystem, uint32_t count)
+{
+    std::string name = "Jobs/ParallelFor/Ranges:" + std::to_string(count) + "/Threads:" + std::to_string(jobSystem.GetNumThreads());
+    if (!runner.IsSelected(name))
+        return;
+
+    std::unique_ptr<std::atomic<uint32_t>[]> visits(new std::atomic<uint32_t>[count]);
+    uint32_t numWrongIterations = 0;
+    runner.Run(name, count, [&]()
+    {
+        for (uint32_t i = 0; i < count; i++)
+            visits[i].store(0, std::memory_order_relaxed);
+
+        jobSystem.ParallelFor(count, 1, [&](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+                visits[i].fetch_add(1, std::memory_order_relaxed);
+        });
+
+        for (uint32_t i = 0; i < count; i++)
+            numWrongIterations += visits[i].load(std::memory_order_relaxed) != 1;
+    });
+
+    runner.AddCounter("WrongIterations", numWrongIterations);
+    if (numWrongIterations > 0)
+        runner.ReportFailure(name + ": iterations did not run exactly once");
+}
+
+void RunJobBenchmarks(BenchmarkRunner& runner)
+{
+    uint32_t maxThreads = runner.GetOptions().MaxThreads;
+    if (maxThreads == 0)
+        maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (uint32_t numThreads : { 1u, maxThreads })
+    {
+        JobSystem jobSystem(numThreads);
+        for (uint32_t count : { 5000u, 20000u, 1000000u })
+            RunParallelForTest(runner, jobSystem, count);
+    }
+}
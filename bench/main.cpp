@@ -0,0 +1,116 @@
+#include "benchmark.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static void PrintUsage()
+{
+    std::cout << "Usage: BezierCurveBenchmark [options]" << std::endl;
+    std::cout << "  --filter <text>        Only run benchmarks whose name contains text" << std::endl;
+    std::cout << "  --json <path>          Write the results as JSON" << std::endl;
+    std::cout << "  --repetitions <n>      Timed repetitions per benchmark (default 30)" << std::endl;
+    std::cout << "  --warmup <seconds>     Untimed warm-up per benchmark (default 0.1)" << std::endl;
+    std::cout << "  --min-time <seconds>   Minimum duration of a repetition (default 0.002)" << std::endl;
+    std::cout << "  --threads <n>          Worker threads of the render benchmarks (default all cores)" << std::endl;
+    std::cout << "  --golden <directory>   Compare renders against the golden images in directory" << std::endl;
+    std::cout << "  --update-golden        Overwrite the golden images with the current renders" << std::endl;
+}
+
+static bool ParseArguments(int argc, char** argv, BenchmarkOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char* argument = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (strcmp(argument, "--help") == 0)
+            return false;
+
+        if (strcmp(argument, "--update-golden") == 0)
+        {
+            options.UpdateGolden = true;
+            continue;
+        }
+
+        if (!value)
+        {
+            std::cout << "Missing value for " << argument << std::endl;
+            return false;
+        }
+
+        if (strcmp(argument, "--filter") == 0)
+            options.Filter = value;
+        else if (strcmp(argument, "--json") == 0)
+            options.JsonPath = value;
+        else if (strcmp(argument, "--repetitions") == 0)
+            options.Repetitions = strtoul(value, nullptr, 10);
+        else if (strcmp(argument, "--warmup") == 0)
+            options.WarmupTime = strtod(value, nullptr);
+        else if (strcmp(argument, "--min-time") == 0)
+            options.MinRepetitionTime = strtod(value, nullptr);
+        else if (strcmp(argument, "--threads") == 0)
+            options.MaxThreads = strtoul(value, nullptr, 10);
+        else if (strcmp(argument, "--golden") == 0)
+            options.GoldenDirectory = value;
+        else
+        {
+            std::cout << "Unknown option " << argument << std::endl;
+            return false;
+        }
+
+        i++;
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkOptions options;
+    if (!ParseArguments(argc, argv, options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    if (options.UpdateGolden && options.GoldenDirectory.empty())
+    {
+        std::cout << "--update-golden requires --golden" << std::endl;
+        return 1;
+    }
+
+#if !defined(NDEBUG)
+    std::cout << "Warning: benchmarks built without optimizations" << std::endl;
+#endif
+
+    BenchmarkRunner runner(options);
+    RunCurveBenchmarks(runner);
+    RunJobBenchmarks(runner);
+    RunRenderBenchmarks(runner);
+    RunSnapshotBenchmarks(runner);
+    RunSceneFileBenchmarks(runner);
+    RunSvgPathBenchmarks(runner);
+    RunEditBenchmarks(runner);
+    RunArenaBenchmarks(runner);
+    RunProjectionBenchmarks(runner);
+    RunIntersectionBenchmarks(runner);
+    RunBoundsBenchmarks(runner);
+    RunFitterBenchmarks(runner);
+    RunOffsetBenchmarks(runner);
+    RunDegreeBenchmarks(runner);
+    RunSubdivisionBenchmarks(runner);
+    RunCurvatureBenchmarks(runner);
+    RunAnimationBenchmarks(runner);
+    RunViewBenchmarks(runner);
+    RunStripBenchmarks(runner);
+    RunProgressiveBenchmarks(runner);
+    RunBatchBenchmarks(runner);
+    RunAllocationTests(runner);
+    RunGoldenImageTests(runner);
+
+    if (!options.JsonPath.empty() && !runner.WriteJson(options.JsonPath))
+        return 1;
+
+    return runner.HasFailures() ? 1 : 0;
+}
@@ -0,0 +1,282 @@
+#include "benchmark.h"
+
+#include "bezier.h"
+#include "curvebounds.h"
+#include "curveoffset.h"
+#include "curveprojection.h"
+#include "jobsystem.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <thread>
+
+#define OFFSET_BENCHMARK_CURVES 256
+// Curves whose offsets are checked against the reference
+#define OFFSET_CHECKED_CURVES 64
+// Dense sampling of the exact offset the segments are checked against. The offset sweeps around sharp turns of the curve
+// within tiny parameter ranges, intervals are split until their chords are short enough to stay close to the offset
+#define OFFSET_REFERENCE_SAMPLES 8192
+#define OFFSET_REFERENCE_MAX_DEPTH 16
+// Points per segment checked against the reference
+#define OFFSET_SEGMENT_SAMPLES 32
+// Reference samples bounded together, so most of them are skipped when looking for the closest one
+#define OFFSET_REFERENCE_CHUNK 32
+// The reference is a polyline, its chords cut the exact offset by a little
+#define OFFSET_ERROR_SLACK 1.1f
+
+static glm::vec2 EvaluateExactOffset(const glm::vec2* controlPoints, uint32_t numControlPoints, float t, float distance, glm::vec2* scratch)
+{
+    glm::vec2 firstDerivative, secondDerivative;
+    glm::vec2 point = EvaluateBezierDerivatives(controlPoints, numControlPoints, t, scratch, firstDerivative, secondDerivative);
+    glm::vec2 tangent = glm::normalize(firstDerivative);
+    return point + glm::vec2(-tangent.y, tangent.x) * distance;
+}
+
+static void AppendExactOffset(const glm::vec2* controlPoints, uint32_t numControlPoints, float distance, float maxChord, float t0, const glm::vec2& point0,
+    float t1, const glm::vec2& point1, uint32_t depth, glm::vec2* scratch, std::vector<glm::vec2>& reference)
+{
+    if (depth < OFFSET_REFERENCE_MAX_DEPTH && glm::distance(point0, point1) > maxChord)
+    {
+        float t = 0.5f * (t0 + t1);
+        glm::vec2 point = EvaluateExactOffset(controlPoints, numControlPoints, t, distance, scratch);
+        AppendExactOffset(controlPoints, numControlPoints, distance, maxChord, t0, point0, t, point, depth + 1, scratch, reference);
+        AppendExactOffset(controlPoints, numControlPoints, distance, maxChord, t, point, t1, point1, depth + 1, scratch, reference);
+        return;
+    }
+
+    reference.push_back(point1);
+}
+
+static float GetBoundsDistance(const glm::vec2& point, const glm::vec2& boundsMin, const glm::vec2& boundsMax)
+{
+    return glm::length(glm::max(glm::max(boundsMin - point, point - boundsMax), glm::vec2(0.0f)));
+}
+
+// Hausdorff distance between the segments and a dense sampling of the exact offset: the farthest a reference sample is
+// from the closest segment and the farthest a point of a segment is from the reference polyline. Curves with stationary
+// points are not checked, the round joins there are not part of the raw offset the reference samples
+static float GetOffsetError(const glm::vec2* controlPoints, uint32_t numControlPoints, float distance, float tolerance, const glm::vec2* segments, uint32_t numSegments)
+{
+    // A chord of length c cuts a circle of radius r by c^2 / 8r, which stays a small part of the tolerance down to radii
+    // of a few hundredths
+    float maxChord = 0.2f * std::sqrt(tolerance);
+    glm::vec2 scratch[CURVE_OFFSET_STACK_POINTS];
+    std::vector<glm::vec2> reference;
+    reference.push_back(EvaluateExactOffset(controlPoints, numControlPoints, 0.0f, distance, scratch));
+    for (uint32_t i = 1; i < OFFSET_REFERENCE_SAMPLES; i++)
+    {
+        float t0 = float(i - 1) / (OFFSET_REFERENCE_SAMPLES - 1);
+        float t1 = float(i) / (OFFSET_REFERENCE_SAMPLES - 1);
+        glm::vec2 point0 = reference.back();
+        glm::vec2 point1 = EvaluateExactOffset(controlPoints, numControlPoints, t1, distance, scratch);
+        AppendExactOffset(controlPoints, numControlPoints, distance, maxChord, t0, point0, t1, point1, 0, scratch, reference);
+    }
+
+    std::vector<CurveProjector> projectors(numSegments);
+    std::vector<glm::vec2> segmentMin(numSegments), segmentMax(numSegments);
+    for (uint32_t i = 0; i < numSegments; i++)
+    {
+        projectors[i].SetCurve(&segments[4 * i], 4);
+        GetControlPointBounds(&segments[4 * i], 4, segmentMin[i], segmentMax[i]);
+    }
+
+    float maxError = 0.0f;
+    uint32_t closestSegment = 0;
+    for (const glm::vec2& sample : reference)
+    {
+        float closest = projectors[closestSegment].Project(sample).Distance;
+        for (uint32_t i = 0; i < numSegments; i++)
+        {
+            if (i != closestSegment && GetBoundsDistance(sample, segmentMin[i], segmentMax[i]) < closest)
+            {
+                float segmentDistance = projectors[i].Project(sample).Distance;
+                if (segmentDistance < closest)
+                {
+                    closest = segmentDistance;
+                    closestSegment = i;
+                }
+            }
+        }
+
+        maxError = std::max(maxError, closest);
+    }
+
+    uint32_t numReference = reference.size();
+    uint32_t numChunks = (numReference - 1 + OFFSET_REFERENCE_CHUNK - 1) / OFFSET_REFERENCE_CHUNK;
+    std::vector<glm::vec2> chunkMin(numChunks), chunkMax(numChunks);
+    for (uint32_t i = 0; i < numChunks; i++)
+    {
+        uint32_t first = i * OFFSET_REFERENCE_CHUNK;
+        uint32_t last = std::min(first + OFFSET_REFERENCE_CHUNK, numReference - 1);
+        GetControlPointBounds(&reference[first], last - first + 1, chunkMin[i], chunkMax[i]);
+    }
+
+    for (uint32_t i = 0; i < numSegments; i++)
+    {
+        for (uint32_t j = 0; j < OFFSET_SEGMENT_SAMPLES; j++)
+        {
+            glm::vec2 point = EvaluateBezier<3>(&segments[4 * i], float(j) / (OFFSET_SEGMENT_SAMPLES - 1));
+            float closest = FLT_MAX;
+            for (uint32_t k = 0; k < numChunks; k++)
+            {
+                if (GetBoundsDistance(point, chunkMin[k], chunkMax[k]) >= closest)
+                    continue;
+
+                uint32_t first = k * OFFSET_REFERENCE_CHUNK;
+                uint32_t last = std::min(first + OFFSET_REFERENCE_CHUNK, numReference - 1);
+                closest = std::min(closest, GetPolylineDistance(point, &reference[first], last - first + 1));
+            }
+
+            maxError = std::max(maxError, closest);
+        }
+    }
+
+    return maxError;
+}
+
+static void RunOffsetBenchmark(BenchmarkRunner& runner, uint32_t degree, float distance, float tolerance)
+{
+    Scene scene = CreateBenchmarkScene(OFFSET_BENCHMARK_CURVES, degree + 1, 0, degree + 120);
+    std::string name = "Offset/Degree:" + std::to_string(degree) + "/Distance:" + std::to_string(distance).substr(0, 5) +
+        "/Tolerance:" + std::to_string(tolerance).substr(0, 7);
+
+    std::vector<glm::vec2> segments;
+    segments.reserve(64 * OFFSET_BENCHMARK_CURVES);
+    runner.Run(name, scene.Curves.size(), [&]()
+    {
+        segments.clear();
+        for (const SceneCurve& curve : scene.Curves)
+            OffsetBezier(&scene.Positions[curve.FirstControlPoint], curve.NumControlPoints, distance, tolerance, segments);
+        DoNotOptimize(segments.data());
+        ClobberMemory();
+    });
+
+    if (!runner.IsSelected(name))
+        return;
+
+    // Segment count and error of every curve, the time is the benchmark itself
+    CurveOffsetStats stats;
+    float maxError = 0.0f;
+    for (uint32_t i = 0; i < scene.Curves.size(); i++)
+    {
+        const SceneCurve& curve = scene.Curves[i];
+        CurveOffsetStats curveStats;
+        segments.clear();
+        OffsetBezier(&scene.Positions[curve.FirstControlPoint], curve.NumControlPoints, distance, tolerance, segments, curveStats);
+
+        stats.NumSegments += curveStats.NumSegments;
+        stats.NumCusps += curveStats.NumCusps;
+        stats.NumJoins += curveStats.NumJoins;
+        stats.NumFits += curveStats.NumFits;
+        if (i < OFFSET_CHECKED_CURVES && curveStats.NumJoins == 0)
+            maxError = std::max(maxError, GetOffsetError(&scene.Positions[curve.FirstControlPoint], curve.NumControlPoints, distance, tolerance, segments.data(), curveStats.NumSegments));
+    }
+
+    runner.AddCounter("SegmentsPerCurve", (double)stats.NumSegments / scene.Curves.size());
+    runner.AddCounter("MaxError", maxError);
+    runner.AddCounter("CuspsPerCurve", (double)stats.NumCusps / scene.Curves.size());
+    runner.AddCounter("FitsPerSegment", (double)stats.NumFits / stats.NumSegments);
+    if (maxError > OFFSET_ERROR_SLACK * tolerance)
+        runner.ReportFailure(name + ": offset is " + std::to_string(maxError) + " away from the exact offset");
+}
+
+// Curves whose control points lie on a line double back on themselves, their tangent flips where they stop and the offset
+// needs a round join
+static void RunStationaryBenchmark(BenchmarkRunner& runner)
+{
+    static const glm::vec2 s_ControlPoints[][4] =
+    {
+        { { -0.8f, 0.0f }, { 0.8f, 0.0f }, { -0.4f, 0.0f }, { 0.4f, 0.0f } },
+        { { -0.5f, -0.5f }, { 0.5f, 0.5f }, { 0.0f, 0.0f }, { 0.0f, 0.0f } },
+        { { -0.6f, 0.2f }, { 0.6f, 0.2f }, { -0.6f, 0.2f }, { 0.0f, 0.0f } },
+    };
+
+    std::string name = "Offset/Stationary";
+    std::vector<glm::vec2> segments;
+    runner.Run(name, std::size(s_ControlPoints), [&]()
+    {
+        segments.clear();
+        for (const auto& controlPoints : s_ControlPoints)
+            OffsetBezier(controlPoints, 4, 0.05f, CURVE_OFFSET_DEFAULT_TOLERANCE, segments);
+        DoNotOptimize(segments.data());
+        ClobberMemory();
+    });
+
+    if (!runner.IsSelected(name))
+        return;
+
+    // The offset has to stay connected across the joins
+    CurveOffsetStats stats;
+    float maxGap = 0.0f;
+    for (const auto& controlPoints : s_ControlPoints)
+    {
+        segments.clear();
+        OffsetBezier(controlPoints, 4, 0.05f, CURVE_OFFSET_DEFAULT_TOLERANCE, segments, stats);
+        for (size_t i = 4; i < segments.size(); i += 4)
+            maxGap = std::max(maxGap, glm::distance(segments[i - 1], segments[i]));
+    }
+
+    runner.AddCounter("Segments", stats.NumSegments);
+    runner.AddCounter("Joins", stats.NumJoins);
+    runner.AddCounter("MaxGap", maxGap);
+    if (stats.NumJoins == 0 || maxGap > CURVE_OFFSET_DEFAULT_TOLERANCE)
+        runner.ReportFailure(name + ": offset is not joined around stationary points");
+}
+
+// Offsets a scene on one thread and on all of them
+static void RunSceneBenchmark(BenchmarkRunner& runner)
+{
+    const uint32_t numCurves = 4096;
+    Scene scene = CreateBenchmarkScene(numCurves, 4, 0, 130);
+    SceneView view = scene.GetView();
+
+    uint32_t maxThreads = runner.GetOptions().MaxThreads;
+    if (maxThreads == 0)
+        maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    CurveOffsetter offsetter;
+    double singleThreadTime = 0.0;
+    for (uint32_t numThreads : { 1u, maxThreads })
+    {
+        std::string name = "Offset/Scene/Curves:" + std::to_string(numCurves) + "/Threads:" + std::to_string(numThreads);
+        if (!runner.IsSelected(name))
+            continue;
+
+        JobSystem jobSystem(numThreads);
+        runner.Run(name, numCurves, [&]()
+        {
+            offsetter.OffsetScene(jobSystem, view, 0.05f, CURVE_OFFSET_DEFAULT_TOLERANCE);
+            DoNotOptimize(offsetter.GetControlPoints().data());
+            ClobberMemory();
+        });
+
+        runner.AddCounter("Segments", offsetter.GetNumSegments());
+        if (numThreads == 1)
+            singleThreadTime = runner.GetLastResult().Median;
+        else if (singleThreadTime > 0.0)
+            runner.AddCounter("SpeedupOverOneThread", singleThreadTime / runner.GetLastResult().Median);
+
+        if (maxThreads == 1)
+            break;
+    }
+}
+
+void RunOffsetBenchmarks(BenchmarkRunner& runner)
+{
+    // Segment count against error against time, over the degree, the distance, where cusps become common, and the tolerance
+    static const uint32_t s_Degrees[] = { 2, 3, 4 };
+    static const float s_Distances[] = { 0.01f, 0.05f, 0.2f };
+    for (uint32_t degree : s_Degrees)
+    {
+        for (float distance : s_Distances)
+            RunOffsetBenchmark(runner, degree, distance, CURVE_OFFSET_DEFAULT_TOLERANCE);
+    }
+
+    static const float s_Tolerances[] = { 1e-3f, 1e-4f, 1e-5f };
+    for (float tolerance : s_Tolerances)
+        RunOffsetBenchmark(runner, 3, 0.05f, tolerance);
+
+    RunStationaryBenchmark(runner);
+    RunSceneBenchmark(runner);
+}
@@ -0,0 +1,148 @@
+#include "benchmark.h"
+
+#include "cpurenderer.h"
+#include "progressiverenderer.h"
+
+#include <cstring>
+
+#define PROGRESSIVE_BENCHMARK_WIDTH 640
+#define PROGRESSIVE_BENCHMARK_HEIGHT 360
+// Frames of dragging a control point, each one an edit that restarts the image
+#define PROGRESSIVE_BENCHMARK_EDITS 30
+// Idle frames after which an image that is still not refined fails
+#define PROGRESSIVE_BENCHMARK_MAX_IDLE_FRAMES 100000
+// A 4K viewport has more tiles than a thread has job slots, in the coarse pass as well as when it is rendered at once
+#define PROGRESSIVE_LARGE_TEST_WIDTH 3840
+#define PROGRESSIVE_LARGE_TEST_HEIGHT 2160
+
+// Drags a control point for a number of frames and then leaves the scene alone until the image is refined. The frames of
+// the drag must stay near the budget as the scene grows, where rendering each frame whole does not, and the refined image
+// must be the one rendered at once
+static void RunInteractionBenchmark(BenchmarkRunner& runner, uint32_t numCurves)
+{
+    std::string name = "Progressive/Interaction/Curves:" + std::to_string(numCurves);
+    if (!runner.IsSelected(name))
+        return;
+
+    Scene scene = CreateBenchmarkScene(numCurves, 6, 100, 200);
+    glm::vec2 draggedPosition = scene.Positions[0];
+
+    JobSystem jobSystem(runner.GetOptions().MaxThreads);
+    ProgressiveRenderer renderer(jobSystem);
+    renderer.SetSampleTolerance(VIEW_DEFAULT_SAMPLE_TOLERANCE);
+    FrameTimeHistogram editHistogram;
+    std::shared_ptr<const SceneSnapshot> snapshot;
+    uint32_t numIdleFrames = 0;
+    float refineTime = 0.0f;
+    runner.Run(name, PROGRESSIVE_BENCHMARK_EDITS, [&]()
+    {
+        editHistogram.Reset(4.0f * PROGRESSIVE_DEFAULT_FRAME_BUDGET);
+        for (uint32_t i = 0; i < PROGRESSIVE_BENCHMARK_EDITS; i++)
+        {
+            scene.Positions[0] = draggedPosition + glm::vec2(0.01f * i, 0.005f * i);
+            snapshot = SceneSnapshot::Create(scene, snapshot);
+            renderer.Update(snapshot, PROGRESSIVE_BENCHMARK_WIDTH, PROGRESSIVE_BENCHMARK_HEIGHT);
+            editHistogram.Add(renderer.GetStats().FrameTime);
+        }
+
+        numIdleFrames = 0;
+        refineTime = 0.0f;
+        while (!renderer.IsComplete() && numIdleFrames < PROGRESSIVE_BENCHMARK_MAX_IDLE_FRAMES)
+        {
+            renderer.Update(snapshot, PROGRESSIVE_BENCHMARK_WIDTH, PROGRESSIVE_BENCHMARK_HEIGHT);
+            refineTime += renderer.GetStats().FrameTime;
+            numIdleFrames++;
+        }
+    });
+
+    // The old way, every frame rendered whole
+    CpuRenderer fullRenderer(jobSystem);
+    fullRenderer.SetSampleTolerance(VIEW_DEFAULT_SAMPLE_TOLERANCE);
+    CpuImage image;
+    FrameTimeHistogram fullHistogram;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        fullRenderer.Render(*snapshot, PROGRESSIVE_BENCHMARK_WIDTH, PROGRESSIVE_BENCHMARK_HEIGHT, image);
+        const CpuRenderStats& stats = fullRenderer.GetStats();
+        fullHistogram.Add(stats.EvaluateTime + stats.TessellateTime + stats.BinTime + stats.RasterizeTime);
+    }
+
+    runner.AddCounter("EditFrameP50Ms", editHistogram.GetPercentile(0.5f));
+    runner.AddCounter("EditFrameP90Ms", editHistogram.GetPercentile(0.9f));
+    runner.AddCounter("EditFrameMaxMs", editHistogram.GetLongestFrame());
+    runner.AddCounter("FullFrameMs", fullHistogram.GetPercentile(0.5f));
+    runner.AddCounter("CoarseScale", renderer.GetStats().CoarseScale);
+    runner.AddCounter("CoarsePassFrames", renderer.GetStats().CoarsePassFrames);
+    runner.AddCounter("IdleFramesToRefine", numIdleFrames);
+    runner.AddCounter("RefineMs", refineTime);
+
+    // Refining a few rows at a time must end with the image rendered at once
+    const CpuImage& refined = renderer.GetImage();
+    if (!renderer.IsComplete() || refined.Pixels.size() != image.Pixels.size() ||
+        std::memcmp(refined.Pixels.data(), image.Pixels.data(), image.Pixels.size() * sizeof(uint32_t)) != 0)
+        runner.ReportFailure(name + ": the refined image differs from the one rendered at once");
+
+    // The budget holds for most frames of the drag whatever the scene, a coarse pass that does not fit is spread over frames
+    if (editHistogram.GetPercentile(0.5f) > PROGRESSIVE_DEFAULT_FRAME_BUDGET)
+        runner.ReportFailure(name + ": half of the edit frames took more than the budget");
+}
+
+static bool IsSameImage(const CpuImage& a, const CpuImage& b)
+{
+    return a.Width == b.Width && a.Height == b.Height && std::memcmp(a.Pixels.data(), b.Pixels.data(), a.Pixels.size() * sizeof(uint32_t)) == 0;
+}
+
+// Refines a 4K viewport from its coarse pass, then edits the scene with a budget large enough that the image is rendered at
+// once. Both must give the image CpuRenderer::Render does
+static void RunLargeViewportTest(BenchmarkRunner& runner)
+{
+    std::string name = "Progressive/Refine/" + std::to_string(PROGRESSIVE_LARGE_TEST_WIDTH) + "x" + std::to_string(PROGRESSIVE_LARGE_TEST_HEIGHT);
+    if (!runner.IsSelected(name))
+        return;
+
+    const uint32_t width = PROGRESSIVE_LARGE_TEST_WIDTH;
+    const uint32_t height = PROGRESSIVE_LARGE_TEST_HEIGHT;
+    Scene scene = CreateBenchmarkScene(16, 6, 50, 201);
+    std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(scene);
+
+    JobSystem jobSystem(runner.GetOptions().MaxThreads);
+    ProgressiveRenderer renderer(jobSystem);
+    renderer.SetSampleTolerance(VIEW_DEFAULT_SAMPLE_TOLERANCE);
+    uint32_t numFrames = 0;
+    runner.Run(name, (double)width * height, [&]()
+    {
+        renderer.Restart();
+        numFrames = 0;
+        do
+        {
+            renderer.Update(snapshot, width, height);
+            numFrames++;
+        } while (!renderer.IsComplete() && numFrames < PROGRESSIVE_BENCHMARK_MAX_IDLE_FRAMES);
+    });
+
+    runner.AddCounter("FramesToRefine", numFrames);
+
+    CpuRenderer fullRenderer(jobSystem);
+    fullRenderer.SetSampleTolerance(VIEW_DEFAULT_SAMPLE_TOLERANCE);
+    CpuImage image;
+    fullRenderer.Render(*snapshot, width, height, image);
+    if (!renderer.IsComplete() || !IsSameImage(renderer.GetImage(), image))
+        runner.ReportFailure(name + ": the refined image differs from the one rendered at once");
+
+    // The last refined image took far less than this budget, so the edit skips the coarse pass
+    renderer.SetFrameBudget(1e6f);
+    scene.Positions[0] += glm::vec2(0.05f, 0.0f);
+    snapshot = SceneSnapshot::Create(scene, snapshot);
+    renderer.Update(snapshot, width, height);
+    fullRenderer.Render(*snapshot, width, height, image);
+    if (renderer.GetStats().CoarseScale != 1 || !renderer.IsComplete() || !IsSameImage(renderer.GetImage(), image))
+        runner.ReportFailure(name + ": the edited image rendered at once by the progressive renderer differs from CpuRenderer::Render");
+}
+
+void RunProgressiveBenchmarks(BenchmarkRunner& runner)
+{
+    RunInteractionBenchmark(runner, 64);
+    RunInteractionBenchmark(runner, 256);
+    RunInteractionBenchmark(runner, 1024);
+    RunLargeViewportTest(runner);
+}
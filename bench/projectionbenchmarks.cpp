@@ -0,0 +1,99 @@
+#include "benchmark.h"
+
+#include "bezier.h"
+#include "curveprojection.h"
+#include "jobsystem.h"
+
+#include <algorithm>
+
+#define PROJECTION_BENCHMARK_QUERIES 4096
+// Exhaustive reference the projections are checked against
+#define PROJECTION_REFERENCE_SAMPLES 65536
+// A projection may be farther from the query than the reference by at most this much
+#define PROJECTION_ERROR_TOLERANCE 1e-4
+
+static void RunProjectionBenchmark(BenchmarkRunner& runner, uint32_t degree, JobSystem& jobSystem)
+{
+    BenchmarkRandom random(degree + 40);
+    std::vector<glm::vec2> controlPoints(degree + 1);
+    for (glm::vec2& controlPoint : controlPoints)
+        controlPoint = glm::vec2(random.NextFloat(-0.9f, 0.9f), random.NextFloat(-0.9f, 0.9f));
+
+    // Queries cover the curve and the space around it, like the cursor over the viewport
+    std::vector<glm::vec2> queries(PROJECTION_BENCHMARK_QUERIES);
+    for (glm::vec2& query : queries)
+        query = glm::vec2(random.NextFloat(-1.2f, 1.2f), random.NextFloat(-1.2f, 1.2f));
+
+    std::string prefix = "Projection/Degree:" + std::to_string(degree);
+    std::vector<CurveProjection> results(queries.size());
+
+    CurveProjector projector;
+    runner.Run(prefix + "/Setup", 1.0, [&]()
+    {
+        projector.SetCurve(controlPoints.data(), controlPoints.size());
+        DoNotOptimize(projector);
+    });
+    projector.SetCurve(controlPoints.data(), controlPoints.size());
+
+    runner.Run(prefix + "/Batch", queries.size(), [&]()
+    {
+        projector.ProjectBatch(queries.data(), queries.size(), results.data());
+        DoNotOptimize(results.data());
+        ClobberMemory();
+    });
+
+    if (runner.IsSelected(prefix + "/Batch"))
+    {
+        runner.AddCounter("Spans", projector.GetNumSpans());
+
+        std::vector<glm::vec2> reference(PROJECTION_REFERENCE_SAMPLES);
+        TessellateBezier(controlPoints.data(), controlPoints.size(), reference.size(), reference.data());
+
+        // Positive errors are projections farther away than the closest reference sample
+        double maxError = 0.0;
+        double sumError = 0.0;
+        for (size_t i = 0; i < queries.size(); i++)
+        {
+            float referenceDistance = glm::distance(queries[i], reference[0]);
+            for (const glm::vec2& sample : reference)
+                referenceDistance = std::min(referenceDistance, glm::distance(queries[i], sample));
+
+            double error = (double)results[i].Distance - referenceDistance;
+            maxError = std::max(maxError, error);
+            sumError += std::abs(error);
+        }
+
+        runner.AddCounter("MaxDistanceError", maxError);
+        runner.AddCounter("MeanAbsDistanceError", sumError / queries.size());
+        if (maxError > PROJECTION_ERROR_TOLERANCE)
+            runner.ReportFailure(prefix + ": projection is " + std::to_string(maxError) + " farther than the exhaustive reference");
+    }
+
+    runner.Run(prefix + "/Parallel", queries.size(), [&]()
+    {
+        projector.ProjectBatch(jobSystem, queries.data(), queries.size(), results.data());
+        DoNotOptimize(results.data());
+        ClobberMemory();
+    });
+
+    // What picking costs without the projector, distance to a tessellation as fine as the editor draws
+    std::vector<glm::vec2> polyline(100);
+    TessellateBezier(controlPoints.data(), controlPoints.size(), polyline.size(), polyline.data());
+    runner.Run(prefix + "/Polyline:100", queries.size(), [&]()
+    {
+        for (const glm::vec2& query : queries)
+        {
+            float distance = GetPolylineDistance(query, polyline.data(), polyline.size());
+            DoNotOptimize(distance);
+        }
+    });
+}
+
+void RunProjectionBenchmarks(BenchmarkRunner& runner)
+{
+    JobSystem jobSystem(runner.GetOptions().MaxThreads);
+
+    static const uint32_t s_Degrees[] = { 2, 3, 4, 7, 12 };
+    for (uint32_t degree : s_Degrees)
+        RunProjectionBenchmark(runner, degree, jobSystem);
+}
@@ -0,0 +1,134 @@
+#include "benchmark.h"
+
+#include "cpurenderer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+// Parallel efficiency the tiled renderer is expected to reach on every thread count
+#define RENDER_EFFICIENCY_TARGET 0.7
+// Rows of the reference bands, few enough tiles per band that each one is a small job
+#define RENDER_REFERENCE_BAND_HEIGHT 64
+
+static void RunRasterizeBenchmarks(BenchmarkRunner& runner)
+{
+    struct ImageSize
+    {
+        uint32_t Width;
+        uint32_t Height;
+    };
+
+    static const ImageSize s_ImageSizes[] = { { 256, 256 }, { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+    static const int s_SampleCounts[] = { 50, 200 };
+
+    JobSystem jobSystem(runner.GetOptions().MaxThreads);
+    CpuRenderer renderer(jobSystem);
+    CpuImage image;
+
+    for (int numSamples : s_SampleCounts)
+    {
+        std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(CreateBenchmarkScene(16, 6, numSamples, 1));
+
+        for (const ImageSize& size : s_ImageSizes)
+        {
+            std::string name = "Render/Samples:" + std::to_string(numSamples) + "/Size:" + std::to_string(size.Width) + "x" + std::to_string(size.Height);
+            runner.Run(name, (double)size.Width * size.Height, [&]()
+            {
+                renderer.Render(*snapshot, size.Width, size.Height, image);
+                DoNotOptimize(image.Pixels.data());
+                ClobberMemory();
+            });
+        }
+    }
+}
+
+// A 4K frame has thousands of tiles, more than a thread has job slots. The frame rendered at once must be the one put
+// together from bands of a few hundred tiles each
+static void RunLargeImageTest(BenchmarkRunner& runner)
+{
+    std::string name = "Render/MatchesBands/3840x2160";
+    if (!runner.IsSelected(name))
+        return;
+
+    const uint32_t width = 3840;
+    const uint32_t height = 2160;
+    std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(CreateBenchmarkScene(16, 6, 50, 1));
+    JobSystem jobSystem(runner.GetOptions().MaxThreads);
+    CpuRenderer renderer(jobSystem);
+    CpuImage image;
+    runner.Run(name, (double)width * height, [&]()
+    {
+        renderer.Render(*snapshot, width, height, image);
+    });
+
+    CpuImage band;
+    uint32_t numMismatchedPixels = 0;
+    for (uint32_t firstRow = 0; firstRow < height; firstRow += RENDER_REFERENCE_BAND_HEIGHT)
+    {
+        renderer.RenderRows(*snapshot, width, height, firstRow, RENDER_REFERENCE_BAND_HEIGHT, band);
+        const uint32_t* rows = &image.Pixels[(size_t)firstRow * width];
+        for (size_t i = 0; i < band.Pixels.size(); i++)
+            numMismatchedPixels += band.Pixels[i] != rows[i];
+    }
+
+    runner.AddCounter("MismatchedPixels", numMismatchedPixels);
+    if (numMismatchedPixels > 0)
+        runner.ReportFailure(name + ": the image rendered at once differs from the one rendered in bands");
+}
+
+// Renders the same frame with 1..N threads. Efficiency is the speedup over one thread divided by the thread count
+static void RunScalingBenchmarks(BenchmarkRunner& runner)
+{
+    uint32_t maxThreads = runner.GetOptions().MaxThreads;
+    if (maxThreads == 0)
+        maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::vector<uint32_t> threadCounts;
+    for (uint32_t numThreads = 1; numThreads < maxThreads; numThreads *= 2)
+        threadCounts.push_back(numThreads);
+    threadCounts.push_back(maxThreads);
+
+    std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(CreateBenchmarkScene(64, 6, 100, 2));
+    CpuImage image;
+
+    double singleThreadTime = 0.0;
+    for (uint32_t numThreads : threadCounts)
+    {
+        std::string name = "RenderScaling/Threads:" + std::to_string(numThreads);
+        if (!runner.IsSelected(name))
+            continue;
+
+        JobSystem jobSystem(numThreads);
+        CpuRenderer renderer(jobSystem);
+
+        runner.Run(name, 1920.0 * 1080.0, [&]()
+        {
+            renderer.Render(*snapshot, 1920, 1080, image);
+            DoNotOptimize(image.Pixels.data());
+            ClobberMemory();
+        });
+
+        double medianTime = runner.GetLastResult().Median;
+        if (numThreads == 1)
+        {
+            singleThreadTime = medianTime;
+            continue;
+        }
+
+        if (singleThreadTime <= 0.0)
+            continue;
+
+        double efficiency = singleThreadTime / (medianTime * numThreads);
+        runner.AddCounter("ParallelEfficiency", efficiency);
+        if (efficiency < RENDER_EFFICIENCY_TARGET)
+            std::cout << "    Below the parallel efficiency target of " << RENDER_EFFICIENCY_TARGET << std::endl;
+    }
+}
+
+void RunRenderBenchmarks(BenchmarkRunner& runner)
+{
+    RunRasterizeBenchmarks(runner);
+    RunLargeImageTest(runner);
+    RunScalingBenchmarks(runner);
+}
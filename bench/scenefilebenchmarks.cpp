@@ -0,0 +1,177 @@
+#include "benchmark.h"
+
+#include "scenefile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#define SCENE_FILE_BENCHMARK_PATH "benchmark_large.bzscene"
+// Control points of the generated file, 20 bytes each plus a curve of SCENE_FILE_BENCHMARK_CURVE_POINTS points. About 2.3 GB
+#define SCENE_FILE_BENCHMARK_POINTS (96u << 20)
+#define SCENE_FILE_BENCHMARK_CURVE_POINTS 6
+// Pages the first touch reads one value of, the size of the smallest page of the platforms built for
+#define SCENE_FILE_BENCHMARK_PAGE_SIZE 4096
+
+using Clock = std::chrono::steady_clock;
+
+static void WriteLargeSceneFile(BenchmarkRunner& runner, uint64_t& fileSize)
+{
+    Clock::time_point start = Clock::now();
+
+    // Generated in place rather than through AddControlPoint, the scene is gone again once it is written
+    Scene scene;
+    uint32_t numCurves = SCENE_FILE_BENCHMARK_POINTS / SCENE_FILE_BENCHMARK_CURVE_POINTS;
+    scene.Curves.resize(numCurves);
+    scene.Positions.resize((size_t)numCurves * SCENE_FILE_BENCHMARK_CURVE_POINTS);
+    scene.Colors.resize(scene.Positions.size());
+    for (uint32_t i = 0; i < numCurves; i++)
+    {
+        SceneCurve& curve = scene.Curves[i];
+        curve.Color = glm::vec3((i & 0xFF) / 255.0f, 0.5f, 1.0f);
+        curve.Thickness = 1.0f + (i & 3);
+        curve.FirstControlPoint = i * SCENE_FILE_BENCHMARK_CURVE_POINTS;
+        curve.NumControlPoints = SCENE_FILE_BENCHMARK_CURVE_POINTS;
+    }
+
+    for (size_t i = 0; i < scene.Positions.size(); i++)
+    {
+        float t = (float)(i & 0xFFFF) / 65535.0f;
+        scene.Positions[i] = glm::vec2(t * 2.0f - 1.0f, 1.0f - t * t * 2.0f);
+        scene.Colors[i] = glm::vec3(t, 1.0f - t, 0.5f);
+    }
+
+    if (!SaveSceneFile(SCENE_FILE_BENCHMARK_PATH, scene.GetView()))
+    {
+        runner.ReportFailure("SceneFile: failed to write " SCENE_FILE_BENCHMARK_PATH);
+        return;
+    }
+
+    SceneFile file;
+    fileSize = file.Open(SCENE_FILE_BENCHMARK_PATH) ? file.GetFileSize() : 0;
+    std::cout << "Wrote a " << fileSize / (1024 * 1024) << " MB scene file in " << std::chrono::duration<float>(Clock::now() - start).count() << " s" << std::endl;
+}
+
+// Reads a value from every page of an array of the mapping, which faults the page in
+static float TouchPages(const void* data, uint64_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    float sum = 0.0f;
+    for (uint64_t offset = 0; offset < size; offset += SCENE_FILE_BENCHMARK_PAGE_SIZE)
+    {
+        float value;
+        memcpy(&value, bytes + offset, sizeof(value));
+        sum += value;
+    }
+
+    return sum;
+}
+
+// Settings the renderer cannot draw with fail to load instead of reaching it
+static void RunSettingsTest(BenchmarkRunner& runner)
+{
+    std::string name = "SceneFile/RejectSettings";
+    if (!runner.IsSelected(name))
+        return;
+
+    const GlobalSettings settings[] = {
+        { true, true, 1, 0.5f },
+        { true, true, 50, -0.1f },
+        { true, true, 50, 1.5f },
+        { true, true, 50, std::numeric_limits<float>::quiet_NaN() },
+        { true, true, 2, 1.0f },
+    };
+    const uint32_t numSettings = sizeof(settings) / sizeof(settings[0]);
+
+    Scene scene = CreateBenchmarkScene(4, 4, 10, 26);
+    bool opened[numSettings] = {};
+    runner.Run(name, numSettings, [&]()
+    {
+        for (uint32_t i = 0; i < numSettings; i++)
+        {
+            scene.Settings = settings[i];
+            SceneFile file;
+            opened[i] = SaveSceneFile(SCENE_FILE_BENCHMARK_PATH, scene.GetView()) && file.Open(SCENE_FILE_BENCHMARK_PATH);
+        }
+    });
+
+    std::remove(SCENE_FILE_BENCHMARK_PATH);
+    for (uint32_t i = 0; i + 1 < numSettings; i++)
+    {
+        if (opened[i])
+            runner.ReportFailure(name + ": a scene file with " + std::to_string(settings[i].NumSamples) + " samples and T1 " + std::to_string(settings[i].T1) + " was opened");
+    }
+
+    if (!opened[numSettings - 1])
+        runner.ReportFailure(name + ": a scene file with 2 samples and T1 1 failed to open");
+}
+
+// Opens a scene file of a few gigabytes. Mapping and validating the structure does not depend on its size, verifying the
+// checksums and touching the arrays for the first time read all of it. The file is in the page cache as saving left it, the
+// times are those of a file that was recently written or read
+void RunSceneFileBenchmarks(BenchmarkRunner& runner)
+{
+    RunSettingsTest(runner);
+
+    const char* prefix = "SceneFile/Load/2GB";
+    std::string openName = std::string(prefix) + "/Open";
+    std::string verifyName = std::string(prefix) + "/OpenVerify";
+    std::string touchName = std::string(prefix) + "/OpenFirstTouch";
+    if (!runner.IsSelected(openName) && !runner.IsSelected(verifyName) && !runner.IsSelected(touchName))
+        return;
+
+    uint64_t fileSize = 0;
+    WriteLargeSceneFile(runner, fileSize);
+    if (fileSize == 0)
+        return;
+
+    // Items are bytes, the throughput reads as MB/s
+    double fileMegabytes = fileSize / (1024.0 * 1024.0);
+    if (runner.IsSelected(openName))
+    {
+        uint32_t numControlPoints = 0;
+        runner.Run(openName, (double)fileSize, [&]()
+        {
+            SceneFile file;
+            file.Open(SCENE_FILE_BENCHMARK_PATH);
+            numControlPoints = file.GetView().NumControlPoints;
+        });
+
+        runner.AddCounter("FileMB", fileMegabytes);
+        runner.AddCounter("OpenMs", runner.GetLastResult().Median * 1e-6);
+        if (numControlPoints != SCENE_FILE_BENCHMARK_POINTS / SCENE_FILE_BENCHMARK_CURVE_POINTS * SCENE_FILE_BENCHMARK_CURVE_POINTS)
+            runner.ReportFailure(openName + ": the file did not load all of its control points");
+    }
+
+    if (runner.IsSelected(verifyName))
+    {
+        bool succeeded = true;
+        runner.Run(verifyName, (double)fileSize, [&]()
+        {
+            SceneFile file;
+            succeeded = file.Open(SCENE_FILE_BENCHMARK_PATH, SceneFileLoadFlags_VerifyChecksums) && succeeded;
+        });
+
+        if (!succeeded)
+            runner.ReportFailure(verifyName + ": the checksums of the file did not verify");
+    }
+
+    if (runner.IsSelected(touchName))
+    {
+        float sum = 0.0f;
+        runner.Run(touchName, (double)fileSize, [&]()
+        {
+            SceneFile file;
+            file.Open(SCENE_FILE_BENCHMARK_PATH);
+            const SceneView& view = file.GetView();
+            sum += TouchPages(view.Curves, (uint64_t)view.NumCurves * sizeof(SceneCurve));
+            sum += TouchPages(view.Positions, (uint64_t)view.NumControlPoints * sizeof(glm::vec2));
+            sum += TouchPages(view.Colors, (uint64_t)view.NumControlPoints * sizeof(glm::vec3));
+            DoNotOptimize(sum);
+        });
+    }
+
+    std::remove(SCENE_FILE_BENCHMARK_PATH);
+}
@@ -0,0 +1,142 @@
+#include "benchmark.h"
+
+#include "scenesnapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#define SNAPSHOT_STRESS_CURVES 8
+#define SNAPSHOT_STRESS_CONTROL_POINTS 16
+#define SNAPSHOT_STRESS_COMMITS 20000
+#define SNAPSHOT_STRESS_BATCH 256
+
+// Every commit rewrites all control points of one curve with the version of the snapshot it creates, so a reader can tell
+// a torn or out of order snapshot: the points of a curve must agree and no curve may be newer than its snapshot
+static bool ValidateSnapshot(const SceneSnapshot& snapshot, uint64_t previousVersion, std::string& error)
+{
+    if (snapshot.Version < previousVersion)
+    {
+        error = "snapshot version went backwards";
+        return false;
+    }
+
+    if (snapshot.Curves.size() != SNAPSHOT_STRESS_CURVES)
+    {
+        error = "snapshot has the wrong number of curves";
+        return false;
+    }
+
+    for (const std::shared_ptr<const SceneSnapshotCurve>& curve : snapshot.Curves)
+    {
+        float value = curve->Positions[0].x;
+        for (const glm::vec2& position : curve->Positions)
+        {
+            if (position.x != value || position.y != value)
+            {
+                error = "curve control points from different commits";
+                return false;
+            }
+        }
+
+        if (value > (float)snapshot.Version)
+        {
+            error = "curve is newer than its snapshot";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void RunSnapshotBenchmarks(BenchmarkRunner& runner)
+{
+    if (!runner.IsSelected("SnapshotStress"))
+        return;
+
+    using Clock = std::chrono::steady_clock;
+
+    Scene scene;
+    for (uint32_t i = 0; i < SNAPSHOT_STRESS_CURVES; i++)
+    {
+        scene.AddCurve();
+        for (uint32_t j = 0; j < SNAPSHOT_STRESS_CONTROL_POINTS; j++)
+            scene.AddControlPoint(glm::vec2(0.0f));
+    }
+
+    SceneSnapshotPublisher publisher;
+    std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(scene);
+    publisher.Publish(snapshot);
+
+    uint32_t numReaders = std::clamp(std::thread::hardware_concurrency(), 2u, 4u) - 1;
+    std::atomic<bool> writerDone{ false };
+    std::vector<std::vector<double>> readerTimes(numReaders);
+    std::vector<std::string> readerErrors(numReaders);
+    std::vector<std::thread> readers;
+
+    for (uint32_t i = 0; i < numReaders; i++)
+    {
+        readers.emplace_back([&, i]()
+        {
+            uint64_t version = 0;
+            while (!writerDone.load(std::memory_order_acquire))
+            {
+                Clock::time_point start = Clock::now();
+                for (uint32_t j = 0; j < SNAPSHOT_STRESS_BATCH; j++)
+                {
+                    std::shared_ptr<const SceneSnapshot> acquired = publisher.Acquire();
+                    if (!ValidateSnapshot(*acquired, version, readerErrors[i]))
+                        return;
+                    version = acquired->Version;
+                }
+                readerTimes[i].push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / SNAPSHOT_STRESS_BATCH);
+            }
+        });
+    }
+
+    std::vector<double> publishTimes;
+    uint64_t numSharedCurves = 0;
+    for (uint32_t commit = 1; commit <= SNAPSHOT_STRESS_COMMITS; commit++)
+    {
+        SceneCurve& curve = scene.Curves[commit % SNAPSHOT_STRESS_CURVES];
+        for (uint32_t j = 0; j < curve.NumControlPoints; j++)
+            scene.Positions[curve.FirstControlPoint + j] = glm::vec2((float)(snapshot->Version + 1));
+
+        Clock::time_point start = Clock::now();
+        std::shared_ptr<const SceneSnapshot> next = SceneSnapshot::Create(scene, snapshot);
+        publisher.Publish(next);
+        publishTimes.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+
+        for (uint32_t i = 0; i < SNAPSHOT_STRESS_CURVES; i++)
+            numSharedCurves += next->Curves[i] == snapshot->Curves[i];
+
+        // Readers compare the control points against the snapshot version
+        if (next->Version != snapshot->Version + 1)
+        {
+            runner.ReportFailure("SnapshotStress: snapshot version did not advance");
+            break;
+        }
+        snapshot = next;
+    }
+
+    writerDone.store(true, std::memory_order_release);
+    for (std::thread& reader : readers)
+        reader.join();
+
+    runner.AddResult("SnapshotStress/Publish", 1.0, 1, publishTimes);
+    runner.AddCounter("SharedCurveRatio", (double)numSharedCurves / ((double)SNAPSHOT_STRESS_COMMITS * SNAPSHOT_STRESS_CURVES));
+
+    std::vector<double> acquireTimes;
+    for (const std::vector<double>& times : readerTimes)
+        acquireTimes.insert(acquireTimes.end(), times.begin(), times.end());
+    runner.AddResult("SnapshotStress/Acquire", 1.0, SNAPSHOT_STRESS_BATCH, acquireTimes);
+    runner.AddCounter("Readers", numReaders);
+
+    for (const std::string& error : readerErrors)
+    {
+        if (!error.empty())
+            runner.ReportFailure("SnapshotStress: " + error);
+    }
+}
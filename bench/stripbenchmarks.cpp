@@ -0,0 +1,220 @@
+#include "benchmark.h"
+
+#include "cpurenderer.h"
+#include "imagefile.h"
+#include "stripexporter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <streambuf>
+#include <thread>
+
+// Band height of the comparison, not a multiple of the tile size so bands and tiles do not line up
+#define STRIP_TEST_BAND_HEIGHT 100
+#define STRIP_BENCHMARK_SIZE 4096
+// Wide enough that a band of the default height has more tiles than a thread has job slots
+#define STRIP_WIDE_TEST_WIDTH 20480
+#define STRIP_WIDE_TEST_HEIGHT 512
+// Tiles of the reference renderer, large enough that the whole image only takes a few hundred of them
+#define STRIP_WIDE_TEST_REFERENCE_TILE_SIZE 256
+
+// Discards what is written to it, counting the bytes
+class CountingStreamBuffer : public std::streambuf
+{
+public:
+    uint64_t GetNumBytes() const { return m_NumBytes; }
+protected:
+    int_type overflow(int_type c) override
+    {
+        if (c != traits_type::eof())
+            m_NumBytes++;
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char*, std::streamsize count) override
+    {
+        m_NumBytes += count;
+        return count;
+    }
+private:
+    uint64_t m_NumBytes = 0;
+};
+
+// Bands put together must be the image rendered at once, byte for byte in the file
+static void RunStripMatchTest(BenchmarkRunner& runner)
+{
+    std::string name = "Strip/MatchesRender/1024x768";
+    if (!runner.IsSelected(name))
+        return;
+
+    std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(CreateBenchmarkScene(256, 6, 100, 190));
+    ViewCamera camera;
+    camera.Center = glm::vec2(0.2f, -0.1f);
+    camera.Zoom = 1.5f;
+
+    StripExportSettings settings;
+    settings.Width = 1024;
+    settings.Height = 768;
+    settings.BandHeight = STRIP_TEST_BAND_HEIGHT;
+    settings.View = camera.GetViewTransform(settings.Width, settings.Height);
+    settings.NumThreads = runner.GetOptions().MaxThreads;
+
+    std::string exported;
+    StripExportStats stats;
+    bool succeeded = true;
+    runner.Run(name, double(settings.Width) * settings.Height, [&]()
+    {
+        std::ostringstream output;
+        succeeded = ExportImageStrips(*snapshot, settings, output, stats) && succeeded;
+        exported = output.str();
+    });
+    runner.AddCounter("Bands", stats.NumBands);
+
+    JobSystem jobSystem(runner.GetOptions().MaxThreads);
+    CpuRenderer renderer(jobSystem);
+    renderer.SetSampleTolerance(settings.SampleTolerance);
+    CpuImage image;
+    renderer.Render(*snapshot, settings.Width, settings.Height, image, settings.View);
+
+    std::vector<uint8_t> expected;
+    EncodeTgaHeader(image.Width, image.Height, expected);
+    EncodeTgaRows(image.Pixels.data(), image.Width, image.Height, expected);
+    if (!succeeded || exported.size() != expected.size() || std::memcmp(exported.data(), expected.data(), expected.size()) != 0)
+        runner.ReportFailure(name + ": the exported image differs from the one rendered at once");
+
+    std::ostringstream ppmOutput;
+    settings.Format = ImageFileFormat_Ppm;
+    succeeded = ExportImageStrips(*snapshot, settings, ppmOutput, stats);
+    std::string expectedPpm = "P6\n" + std::to_string(image.Width) + " " + std::to_string(image.Height) + "\n255\n";
+    for (uint32_t pixel : image.Pixels)
+    {
+        expectedPpm.push_back(char(pixel & 0xFF));
+        expectedPpm.push_back(char((pixel >> 8) & 0xFF));
+        expectedPpm.push_back(char((pixel >> 16) & 0xFF));
+    }
+    if (!succeeded || ppmOutput.str() != expectedPpm)
+        runner.ReportFailure(name + ": the exported PPM image differs from the one rendered at once");
+
+    // The same bands straight from the renderer, the culling of each band must not change its pixels
+    CpuImage band;
+    for (uint32_t firstRow = 0; firstRow < settings.Height; firstRow += STRIP_TEST_BAND_HEIGHT)
+    {
+        renderer.RenderRows(*snapshot, settings.Width, settings.Height, firstRow, STRIP_TEST_BAND_HEIGHT, band, settings.View);
+        if (std::memcmp(band.Pixels.data(), &image.Pixels[(size_t)firstRow * image.Width], band.Pixels.size() * sizeof(uint32_t)) != 0)
+        {
+            runner.ReportFailure(name + ": the band at row " + std::to_string(firstRow) + " differs from the image rendered at once");
+            break;
+        }
+    }
+}
+
+// Panoramas are exported at default settings, every band then has thousands of tiles. The image must be the one a renderer
+// with a few large tiles draws at once
+static void RunWideStripTest(BenchmarkRunner& runner)
+{
+    std::string name = "Strip/MatchesRender/" + std::to_string(STRIP_WIDE_TEST_WIDTH) + "x" + std::to_string(STRIP_WIDE_TEST_HEIGHT);
+    if (!runner.IsSelected(name))
+        return;
+
+    std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(CreateBenchmarkScene(64, 6, 100, 2));
+    StripExportSettings settings;
+    settings.Width = STRIP_WIDE_TEST_WIDTH;
+    settings.Height = STRIP_WIDE_TEST_HEIGHT;
+    settings.Format = ImageFileFormat_Ppm;
+    settings.NumThreads = runner.GetOptions().MaxThreads;
+
+    std::string exported;
+    StripExportStats stats;
+    bool succeeded = true;
+    runner.Run(name, double(settings.Width) * settings.Height, [&]()
+    {
+        std::ostringstream output;
+        succeeded = ExportImageStrips(*snapshot, settings, output, stats) && succeeded;
+        exported = output.str();
+    });
+
+    JobSystem jobSystem(runner.GetOptions().MaxThreads);
+    CpuRenderer renderer(jobSystem);
+    renderer.SetSampleTolerance(settings.SampleTolerance);
+    renderer.SetTileSize(STRIP_WIDE_TEST_REFERENCE_TILE_SIZE);
+    CpuImage image;
+    renderer.Render(*snapshot, settings.Width, settings.Height, image, settings.View);
+
+    std::vector<uint8_t> expected;
+    EncodePpmHeader(image.Width, image.Height, expected);
+    EncodePpmRows(image.Pixels.data(), image.Width, image.Height, expected);
+
+    uint32_t numMismatchedPixels = 0;
+    size_t headerSize = expected.size() - image.Pixels.size() * 3;
+    if (exported.size() == expected.size())
+    {
+        for (size_t i = headerSize; i < expected.size(); i += 3)
+            numMismatchedPixels += std::memcmp(exported.data() + i, expected.data() + i, 3) != 0;
+    }
+
+    runner.AddCounter("MismatchedPixels", numMismatchedPixels);
+    if (!succeeded || exported.size() != expected.size() || numMismatchedPixels > 0)
+        runner.ReportFailure(name + ": the exported image differs from the one rendered at once");
+}
+
+// The memory of the export depends on the band height, width and threads, not on the height of the image: its band
+// images and encoded bands must stay within twice what the bands in flight hold as raw pixels
+static void RunStripExportBenchmark(BenchmarkRunner& runner)
+{
+    std::string prefix = "Strip/Export/Tga/" + std::to_string(STRIP_BENCHMARK_SIZE) + "x" + std::to_string(STRIP_BENCHMARK_SIZE);
+
+    // The scene of the render benchmarks
+    std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(CreateBenchmarkScene(64, 6, 100, 2));
+
+    StripExportSettings settings;
+    settings.Width = STRIP_BENCHMARK_SIZE;
+    settings.Height = STRIP_BENCHMARK_SIZE;
+
+    uint32_t maxThreads = runner.GetOptions().MaxThreads;
+    if (maxThreads == 0)
+        maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    double fullImageBytes = double(settings.Width) * settings.Height * sizeof(uint32_t);
+    for (uint32_t numThreads : { 1u, maxThreads })
+    {
+        std::string name = prefix + "/Threads:" + std::to_string(numThreads);
+        if (!runner.IsSelected(name))
+            continue;
+
+        settings.NumThreads = numThreads;
+        CountingStreamBuffer buffer;
+        StripExportStats stats;
+        bool succeeded = true;
+        runner.Run(name, double(settings.Width) * settings.Height, [&]()
+        {
+            buffer = CountingStreamBuffer();
+            std::ostream output(&buffer);
+            succeeded = ExportImageStrips(*snapshot, settings, output, stats) && succeeded;
+        });
+
+        double medianTime = runner.GetLastResult().Median;
+        runner.AddCounter("MegapixelsPerSecond", double(settings.Width) * settings.Height * 1e-6 / (medianTime * 1e-9));
+        runner.AddCounter("PeakBandsInFlight", stats.PeakBandsInFlight);
+        runner.AddCounter("BandMB", stats.BandBytes * 1e-6);
+        runner.AddCounter("FullImageMB", fullImageBytes * 1e-6);
+        runner.AddCounter("PeakRssMB", stats.PeakResidentBytes * 1e-6);
+        if (!succeeded || stats.NumBytes != buffer.GetNumBytes())
+            runner.ReportFailure(name + ": the image is incomplete");
+
+        uint64_t bandBytes = uint64_t(settings.Width) * settings.BandHeight * sizeof(uint32_t);
+        uint64_t maxBandBytes = 2 * (numThreads + 2 * numThreads) * bandBytes;
+        if (stats.BandBytes > maxBandBytes)
+            runner.ReportFailure(name + ": the export held " + std::to_string(stats.BandBytes) + " bytes of bands");
+
+        if (maxThreads == 1)
+            break;
+    }
+}
+
+void RunStripBenchmarks(BenchmarkRunner& runner)
+{
+    RunStripMatchTest(runner);
+    RunWideStripTest(runner);
+    RunStripExportBenchmark(runner);
+}
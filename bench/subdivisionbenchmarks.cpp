@@ -0,0 +1,139 @@
+#include "benchmark.h"
+
+#include "bezier.h"
+
+#include <algorithm>
+#include <cstring>
+
+#define SUBDIVISION_BENCHMARK_CURVES 4096
+// A piece may start this far from the curve point at its parameter, the rounding of the chained splits
+#define SUBDIVISION_ERROR_TOLERANCE 1e-5f
+
+static std::vector<float> CreateParameters(uint32_t numCurves, uint32_t numParameters, uint32_t seed)
+{
+    BenchmarkRandom random(seed);
+    std::vector<float> parameters((size_t)numCurves * numParameters);
+    for (uint32_t i = 0; i < numCurves; i++)
+    {
+        float* curveParameters = &parameters[(size_t)i * numParameters];
+        for (uint32_t j = 0; j < numParameters; j++)
+            curveParameters[j] = random.NextFloat(0.0f, 1.0f);
+        std::sort(curveParameters, curveParameters + numParameters);
+    }
+
+    return parameters;
+}
+
+// What callers did before: every piece is cut out of the whole curve on its own, with one split at its end and one at its
+// start mapped into the left part
+static void SubdivideIndependently(const glm::vec2* controlPoints, uint32_t numControlPoints, const float* parameters, uint32_t numParameters, glm::vec2* pieces)
+{
+    glm::vec2 left[BEZIER_SIMD_MAX_POINTS];
+    glm::vec2 right[BEZIER_SIMD_MAX_POINTS];
+    for (uint32_t i = 0; i <= numParameters; i++)
+    {
+        float t0 = i > 0 ? parameters[i - 1] : 0.0f;
+        float t1 = i < numParameters ? parameters[i] : 1.0f;
+        SplitBezier(controlPoints, numControlPoints, t1, left, right);
+        SplitBezier(left, numControlPoints, t1 > 0.0f ? t0 / t1 : 0.0f, right, pieces + i * numControlPoints);
+    }
+}
+
+static void RunSubdivisionBenchmark(BenchmarkRunner& runner, uint32_t numControlPoints, uint32_t numParameters)
+{
+    std::string prefix = "Subdivision/Points:" + std::to_string(numControlPoints) + "/Parameters:" + std::to_string(numParameters);
+    std::string independentName = prefix + "/Independent";
+    std::string scalarName = prefix + "/Scalar";
+    std::string batchName = prefix + "/Batch";
+    if (!runner.IsSelected(independentName) && !runner.IsSelected(scalarName) && !runner.IsSelected(batchName))
+        return;
+
+    Scene scene = CreateBenchmarkScene(SUBDIVISION_BENCHMARK_CURVES, numControlPoints, 0, 150 + numControlPoints);
+    std::vector<float> parameters = CreateParameters(SUBDIVISION_BENCHMARK_CURVES, numParameters, 151 + numParameters);
+    uint32_t numPiecePoints = (numParameters + 1) * numControlPoints;
+    uint32_t numPieces = SUBDIVISION_BENCHMARK_CURVES * (numParameters + 1);
+    std::vector<glm::vec2> independentPieces((size_t)SUBDIVISION_BENCHMARK_CURVES * numPiecePoints);
+    std::vector<glm::vec2> scalarPieces((size_t)SUBDIVISION_BENCHMARK_CURVES * numPiecePoints);
+    std::vector<glm::vec2> batchPieces((size_t)SUBDIVISION_BENCHMARK_CURVES * numPiecePoints);
+    const glm::vec2* controlPoints = scene.Positions.data();
+
+    double independentTime = 0.0;
+    runner.Run(independentName, numPieces, [&]()
+    {
+        for (uint32_t i = 0; i < SUBDIVISION_BENCHMARK_CURVES; i++)
+            SubdivideIndependently(controlPoints + i * numControlPoints, numControlPoints, &parameters[i * numParameters], numParameters, &independentPieces[i * numPiecePoints]);
+        DoNotOptimize(independentPieces.data());
+        ClobberMemory();
+    });
+    if (runner.IsSelected(independentName))
+        independentTime = runner.GetLastResult().Median;
+
+    double scalarTime = 0.0;
+    runner.Run(scalarName, numPieces, [&]()
+    {
+        for (uint32_t i = 0; i < SUBDIVISION_BENCHMARK_CURVES; i++)
+            SubdivideBezier(controlPoints + i * numControlPoints, numControlPoints, &parameters[i * numParameters], numParameters, &scalarPieces[i * numPiecePoints]);
+        DoNotOptimize(scalarPieces.data());
+        ClobberMemory();
+    });
+    if (runner.IsSelected(scalarName))
+    {
+        scalarTime = runner.GetLastResult().Median;
+        if (independentTime > 0.0)
+            runner.AddCounter("SpeedupOverIndependent", independentTime / scalarTime);
+    }
+
+    if (!runner.IsSelected(batchName))
+        return;
+
+    runner.Run(batchName, numPieces, [&]()
+    {
+        SubdivideBezierCurves(controlPoints, SUBDIVISION_BENCHMARK_CURVES, numControlPoints, parameters.data(), numParameters, batchPieces.data());
+        DoNotOptimize(batchPieces.data());
+        ClobberMemory();
+    });
+    if (scalarTime > 0.0)
+        runner.AddCounter("SpeedupOverScalar", scalarTime / runner.GetLastResult().Median);
+
+    // The batch performs the same operations in the same order as the scalar path
+    if (scalarTime == 0.0)
+    {
+        for (uint32_t i = 0; i < SUBDIVISION_BENCHMARK_CURVES; i++)
+            SubdivideBezier(controlPoints + i * numControlPoints, numControlPoints, &parameters[i * numParameters], numParameters, &scalarPieces[i * numPiecePoints]);
+    }
+    if (std::memcmp(scalarPieces.data(), batchPieces.data(), scalarPieces.size() * sizeof(glm::vec2)) != 0)
+        runner.ReportFailure(batchName + ": the pieces differ from the scalar path");
+
+    // Pieces must join up and start at the curve point of their parameter
+    std::vector<glm::vec2> scratch(numControlPoints);
+    float maxError = 0.0f;
+    for (uint32_t i = 0; i < SUBDIVISION_BENCHMARK_CURVES; i++)
+    {
+        const glm::vec2* pieces = &batchPieces[i * numPiecePoints];
+        for (uint32_t j = 0; j <= numParameters; j++)
+        {
+            float t = j > 0 ? parameters[i * numParameters + j - 1] : 0.0f;
+            glm::vec2 point = EvaluateBezier(controlPoints + i * numControlPoints, numControlPoints, t, scratch.data());
+            maxError = std::max(maxError, glm::distance(point, pieces[j * numControlPoints]));
+            if (j > 0)
+                maxError = std::max(maxError, glm::distance(pieces[j * numControlPoints - 1], pieces[j * numControlPoints]));
+        }
+    }
+
+    runner.AddCounter("MaxError", maxError);
+    if (maxError > SUBDIVISION_ERROR_TOLERANCE)
+        runner.ReportFailure(batchName + ": a piece starts " + std::to_string(maxError) + " away from the curve");
+}
+
+void RunSubdivisionBenchmarks(BenchmarkRunner& runner)
+{
+    // Throughput over the degree and the number of cuts, the independent splits grow quadratically in the cuts' share of
+    // the work they repeat
+    static const uint32_t s_ControlPoints[] = { 3, 4, 8 };
+    static const uint32_t s_Parameters[] = { 1, 4, 16 };
+    for (uint32_t numControlPoints : s_ControlPoints)
+    {
+        for (uint32_t numParameters : s_Parameters)
+            RunSubdivisionBenchmark(runner, numControlPoints, numParameters);
+    }
+}
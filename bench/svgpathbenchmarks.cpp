@@ -0,0 +1,286 @@
+#include "benchmark.h"
+
+#include "svgpath.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <streambuf>
+
+#define SVG_PATH_BENCHMARK_PATH "benchmark_path.txt"
+#define SVG_PATH_BENCHMARK_EXPORT_PATH "benchmark_export.svg"
+#define SVG_PATH_BENCHMARK_SIZE (100u << 20)
+// Commands per subpath of the generated path data
+#define SVG_PATH_BENCHMARK_SUBPATH_COMMANDS 64
+// Blocks the in-memory data is handed to the parser in, the block size of ImportSvgFile
+#define SVG_PATH_BENCHMARK_BLOCK_SIZE (64 * 1024)
+#define SVG_PATH_BENCHMARK_WRITE_CURVES 100000
+
+using Clock = std::chrono::steady_clock;
+
+// Counts what the parser reports without storing it, so the benchmark measures the parser and not the scene
+class CountingSvgPathSink : public SvgPathSink
+{
+public:
+    virtual void OnSegment(const glm::vec2* controlPoints, uint32_t numControlPoints) override
+    {
+        NumSegments++;
+        NumControlPoints += numControlPoints;
+        Sum += controlPoints[numControlPoints - 1];
+    }
+
+    virtual void OnSubpathEnd(bool /*closed*/) override
+    {
+        NumSubpaths++;
+    }
+
+    uint64_t NumSegments = 0;
+    uint64_t NumControlPoints = 0;
+    uint64_t NumSubpaths = 0;
+    glm::vec2 Sum = glm::vec2(0.0f);
+};
+
+// Discards what is written through it, buffered like a file stream so the writer is measured and not the stream
+class NullStreamBuffer : public std::streambuf
+{
+public:
+    NullStreamBuffer()
+    {
+        setp(m_Buffer, m_Buffer + sizeof(m_Buffer));
+    }
+
+    uint64_t GetNumBytes() const { return m_NumBytes + (pptr() - pbase()); }
+protected:
+    virtual int_type overflow(int_type c) override
+    {
+        m_NumBytes += pptr() - pbase();
+        setp(m_Buffer, m_Buffer + sizeof(m_Buffer));
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+            m_Buffer[0] = traits_type::to_char_type(c);
+            pbump(1);
+        }
+
+        return traits_type::not_eof(c);
+    }
+private:
+    char m_Buffer[SVG_PATH_BENCHMARK_BLOCK_SIZE];
+    uint64_t m_NumBytes = 0;
+};
+
+static void AppendNumber(std::string& data, float value)
+{
+    char buffer[32];
+    int length = snprintf(buffer, sizeof(buffer), "%.3f", value);
+    data.append(buffer, length);
+}
+
+// Path data as drawing programs write it: numbers with three decimals, absolute and relative commands of every kind but arcs,
+// which split into a number of segments that depends on their sweep. Every command but the movetos reports one segment
+static std::string CreatePathData(uint64_t& numSegments, uint64_t& numSubpaths)
+{
+    static const char* commands[] = { "L", "l", "H", "h", "V", "v", "C", "c", "S", "s", "Q", "q", "T", "t" };
+    static const uint32_t argumentCounts[] = { 2, 2, 1, 1, 1, 1, 6, 6, 4, 4, 4, 4, 2, 2 };
+    const uint32_t numCommands = sizeof(argumentCounts) / sizeof(argumentCounts[0]);
+
+    BenchmarkRandom random(27);
+    std::string data;
+    data.reserve(SVG_PATH_BENCHMARK_SIZE + 256);
+    numSegments = 0;
+    numSubpaths = 0;
+    while (data.size() < SVG_PATH_BENCHMARK_SIZE)
+    {
+        data += "M";
+        AppendNumber(data, random.NextFloat(0.0f, 1000.0f));
+        data += ",";
+        AppendNumber(data, random.NextFloat(0.0f, 1000.0f));
+        numSubpaths++;
+
+        for (uint32_t i = 0; i < SVG_PATH_BENCHMARK_SUBPATH_COMMANDS; i++)
+        {
+            uint32_t command = random.NextUInt() % numCommands;
+            data += commands[command];
+            bool isRelative = commands[command][0] >= 'a';
+            for (uint32_t a = 0; a < argumentCounts[command]; a++)
+            {
+                if (a > 0)
+                    data += (a & 1) ? "," : " ";
+                AppendNumber(data, isRelative ? random.NextFloat(-20.0f, 20.0f) : random.NextFloat(0.0f, 1000.0f));
+            }
+
+            numSegments++;
+        }
+
+        data += "\n";
+    }
+
+    return data;
+}
+
+static void RunParseBenchmarks(BenchmarkRunner& runner, const std::string& parseName, const std::string& importName)
+{
+    Clock::time_point start = Clock::now();
+    uint64_t numSegments = 0;
+    uint64_t numSubpaths = 0;
+    std::string data = CreatePathData(numSegments, numSubpaths);
+    {
+        std::ofstream file(SVG_PATH_BENCHMARK_PATH, std::ios::binary);
+        file.write(data.data(), data.size());
+        if (!file)
+        {
+            runner.ReportFailure("SvgPath: failed to write " SVG_PATH_BENCHMARK_PATH);
+            return;
+        }
+    }
+
+    std::cout << "Wrote " << data.size() / (1024 * 1024) << " MB of path data in " << std::chrono::duration<float>(Clock::now() - start).count() << " s" << std::endl;
+
+    // Items are bytes, the throughput reads as MB/s
+    auto check = [&](const std::string& name, bool succeeded, const CountingSvgPathSink& sink)
+    {
+        if (!succeeded || sink.NumSegments != numSegments || sink.NumSubpaths != numSubpaths)
+            runner.ReportFailure(name + ": " + std::to_string(sink.NumSegments) + " segments in " + std::to_string(sink.NumSubpaths) + " subpaths were read, the data has " +
+                std::to_string(numSegments) + " in " + std::to_string(numSubpaths));
+    };
+
+    if (runner.IsSelected(parseName))
+    {
+        CountingSvgPathSink sink;
+        bool succeeded = true;
+        runner.Run(parseName, (double)data.size(), [&]()
+        {
+            sink = CountingSvgPathSink();
+            SvgPathParser parser(sink);
+            for (size_t offset = 0; offset < data.size(); offset += SVG_PATH_BENCHMARK_BLOCK_SIZE)
+                parser.Parse(data.data() + offset, std::min<size_t>(SVG_PATH_BENCHMARK_BLOCK_SIZE, data.size() - offset));
+            succeeded = parser.Finish();
+            DoNotOptimize(sink.Sum);
+        });
+
+        runner.AddCounter("FileMB", data.size() / (1024.0 * 1024.0));
+        check(parseName, succeeded, sink);
+    }
+
+    if (runner.IsSelected(importName))
+    {
+        CountingSvgPathSink sink;
+        bool succeeded = true;
+        runner.Run(importName, (double)data.size(), [&]()
+        {
+            sink = CountingSvgPathSink();
+            succeeded = ImportSvgFile(SVG_PATH_BENCHMARK_PATH, sink);
+            DoNotOptimize(sink.Sum);
+        });
+
+        runner.AddCounter("FileMB", data.size() / (1024.0 * 1024.0));
+        check(importName, succeeded, sink);
+    }
+
+    std::remove(SVG_PATH_BENCHMARK_PATH);
+}
+
+// Writes a scene as a document, cubics as they are and higher degrees flattened. The written numbers read back to the same
+// floats, so importing the export of a scene of cubics has to give back its control points exactly
+static void RunWriteBenchmark(BenchmarkRunner& runner, uint32_t numControlPoints)
+{
+    // A flattened curve is a few hundred points long, a tenth of the curves writes more than the cubics do
+    uint32_t numCurves = numControlPoints > 4 ? SVG_PATH_BENCHMARK_WRITE_CURVES / 10 : SVG_PATH_BENCHMARK_WRITE_CURVES;
+    std::string name = "SvgPath/Write/Curves:" + std::to_string(numCurves) + "/Points:" + std::to_string(numControlPoints);
+    if (!runner.IsSelected(name))
+        return;
+
+    Scene scene = CreateBenchmarkScene(numCurves, numControlPoints, 100, 270 + numControlPoints);
+    SceneView view = scene.GetView();
+    auto writeScene = [&](std::ostream& stream)
+    {
+        SvgPathWriter writer(stream);
+        writer.BeginDocument(glm::vec2(-1.0f), glm::vec2(1.0f));
+        for (uint32_t i = 0; i < view.NumCurves; i++)
+        {
+            const SceneCurve& curve = view.Curves[i];
+            writer.WriteCurve(view.Positions + curve.FirstControlPoint, curve.NumControlPoints, curve.Color, curve.Thickness);
+        }
+        writer.EndDocument();
+    };
+
+    uint64_t numBytes = 0;
+    {
+        NullStreamBuffer buffer;
+        std::ostream stream(&buffer);
+        writeScene(stream);
+        numBytes = buffer.GetNumBytes();
+    }
+
+    runner.Run(name, (double)numBytes, [&]()
+    {
+        NullStreamBuffer buffer;
+        std::ostream stream(&buffer);
+        writeScene(stream);
+        DoNotOptimize(buffer.GetNumBytes());
+    });
+
+    runner.AddCounter("FileMB", numBytes / (1024.0 * 1024.0));
+
+    if (!ExportSvgFile(SVG_PATH_BENCHMARK_EXPORT_PATH, view))
+    {
+        runner.ReportFailure(name + ": failed to write " SVG_PATH_BENCHMARK_EXPORT_PATH);
+        return;
+    }
+
+    Scene imported;
+    SceneSvgPathSink sink(imported);
+    bool succeeded = ImportSvgFile(SVG_PATH_BENCHMARK_EXPORT_PATH, sink);
+    std::remove(SVG_PATH_BENCHMARK_EXPORT_PATH);
+
+    bool isSame = succeeded && (numControlPoints > 4 || (imported.Curves.size() == scene.Curves.size() && imported.Positions == scene.Positions));
+    if (!isSame || imported.Curves.size() < scene.Curves.size())
+        runner.ReportFailure(name + ": importing the written document did not give back the curves of the scene");
+}
+
+// Numbers longer than the parser's buffer are one argument each. Fraction digits past it are dropped, integers that long are
+// outside the range of a float and fail the parse
+static void RunLongNumberTest(BenchmarkRunner& runner)
+{
+    std::string name = "SvgPath/LongNumbers";
+    if (!runner.IsSelected(name))
+        return;
+
+    std::string zeros(70, '0');
+    std::string data = "M0 0 L0." + zeros + "1 5 L12.5" + zeros + "-3";
+    std::string tooLong = "M0 0 L1" + zeros + " 5";
+    CountingSvgPathSink sink;
+    bool succeeded = false;
+    bool tooLongSucceeded = true;
+    runner.Run(name, (double)(data.size() + tooLong.size()), [&]()
+    {
+        sink = CountingSvgPathSink();
+        SvgPathParser parser(sink);
+        succeeded = parser.Parse(data.data(), data.size()) && parser.Finish();
+
+        CountingSvgPathSink tooLongSink;
+        SvgPathParser tooLongParser(tooLongSink);
+        tooLongSucceeded = tooLongParser.Parse(tooLong.data(), tooLong.size()) && tooLongParser.Finish();
+    });
+
+    if (!succeeded || sink.NumSegments != 2 || sink.Sum != glm::vec2(12.5f, 2.0f))
+        runner.ReportFailure(name + ": numbers past the length of the parser's buffer were not read as one argument each");
+    if (tooLongSucceeded)
+        runner.ReportFailure(name + ": an integer past the length of the parser's buffer was accepted");
+}
+
+// Parses 100 MB of generated path data from memory and through ImportSvgFile, numbers longer than the parser's buffer, and
+// writes scenes of cubics and of curves the writer has to flatten
+void RunSvgPathBenchmarks(BenchmarkRunner& runner)
+{
+    std::string parseName = "SvgPath/Parse/100MB";
+    std::string importName = "SvgPath/Import/100MB";
+    if (runner.IsSelected(parseName) || runner.IsSelected(importName))
+        RunParseBenchmarks(runner, parseName, importName);
+
+    RunLongNumberTest(runner);
+
+    for (uint32_t numControlPoints : { 4u, 6u })
+        RunWriteBenchmark(runner, numControlPoints);
+}
@@ -0,0 +1,163 @@
+#include "benchmark.h"
+
+#include "bezier.h"
+#include "cpurenderer.h"
+#include "viewcamera.h"
+
+#include <algorithm>
+#include <cstring>
+
+#define VIEW_BENCHMARK_SIZE 256
+// Scene position the sweep zooms into
+#define VIEW_BENCHMARK_CENTER_X 0.31f
+#define VIEW_BENCHMARK_CENTER_Y -0.17f
+// Parameters per polyline segment at which the flattening error is measured
+#define VIEW_FLATTENING_CHECKS 8
+
+static glm::dvec2 EvaluateBezierDouble(const glm::vec2* controlPoints, uint32_t numControlPoints, double t)
+{
+    glm::dvec2 scratch[BEZIER_SIMD_MAX_POINTS];
+    for (uint32_t i = 0; i < numControlPoints; i++)
+        scratch[i] = glm::dvec2(controlPoints[i]);
+
+    for (uint32_t n = 1; n < numControlPoints; n++)
+    {
+        for (uint32_t i = 0; i < numControlPoints - n; i++)
+            scratch[i] = scratch[i] + (scratch[i + 1] - scratch[i]) * t;
+    }
+
+    return scratch[0];
+}
+
+// Largest distance in pixels between the visible curves and their polylines, measured in double precision between points at
+// the same parameter. The polylines have numSamples samples, or as many as GetViewSampleCount asks for when it is 0
+static double GetMaxFlatteningError(const Scene& scene, const ViewTransform& view, uint32_t numSamples, float tolerance)
+{
+    glm::dvec2 pixelScale = glm::dvec2(view.Scale) * double(VIEW_BENCHMARK_SIZE) * 0.5;
+    glm::dvec2 pixelOffset = (glm::dvec2(view.Offset) + 1.0) * double(VIEW_BENCHMARK_SIZE) * 0.5;
+    double maxError = 0.0;
+    for (const SceneCurve& curve : scene.Curves)
+    {
+        const glm::vec2* controlPoints = &scene.Positions[curve.FirstControlPoint];
+        uint32_t numCurveSamples = numSamples;
+        if (numCurveSamples == 0)
+            numCurveSamples = GetViewSampleCount(controlPoints, curve.NumControlPoints, view, VIEW_BENCHMARK_SIZE, VIEW_BENCHMARK_SIZE, tolerance);
+        if (numSamples == 0 && numCurveSamples == VIEW_MAX_CURVE_SAMPLES)
+            continue;
+
+        for (uint32_t i = 0; i + 1 < numCurveSamples; i++)
+        {
+            double t0 = double(i) / double(numCurveSamples - 1);
+            double t1 = double(i + 1) / double(numCurveSamples - 1);
+            glm::dvec2 a = EvaluateBezierDouble(controlPoints, curve.NumControlPoints, t0) * pixelScale + pixelOffset;
+            glm::dvec2 b = EvaluateBezierDouble(controlPoints, curve.NumControlPoints, t1) * pixelScale + pixelOffset;
+
+            // Only segments touching the image are seen
+            glm::dvec2 segmentMin = glm::min(a, b);
+            glm::dvec2 segmentMax = glm::max(a, b);
+            if (segmentMax.x < 0.0 || segmentMax.y < 0.0 || segmentMin.x > VIEW_BENCHMARK_SIZE || segmentMin.y > VIEW_BENCHMARK_SIZE)
+                continue;
+
+            for (uint32_t j = 1; j < VIEW_FLATTENING_CHECKS; j++)
+            {
+                double u = double(j) / VIEW_FLATTENING_CHECKS;
+                glm::dvec2 point = EvaluateBezierDouble(controlPoints, curve.NumControlPoints, t0 + (t1 - t0) * u) * pixelScale + pixelOffset;
+                maxError = std::max(maxError, glm::length(point - (a + (b - a) * u)));
+            }
+        }
+    }
+
+    return maxError;
+}
+
+// Renders the same scene while zooming from the whole scene into a small part of it. With a fixed sample count every curve
+// costs the same at any zoom, so zooming out piles all samples into a few pixels and zooming in draws the few visible curves
+// as visibly straight segments. With adaptive samples the work follows what is on screen
+static void RunZoomSweepBenchmark(BenchmarkRunner& runner, bool isAdaptive)
+{
+    static const float s_Zooms[] = { 0.5f, 1.0f, 4.0f, 16.0f, 64.0f, 256.0f };
+    std::string prefix = std::string("View/ZoomSweep/") + (isAdaptive ? "Adaptive" : "Fixed");
+    bool isAnySelected = false;
+    for (float zoom : s_Zooms)
+        isAnySelected |= runner.IsSelected(prefix + "/Zoom:" + std::to_string(zoom));
+    if (!isAnySelected)
+        return;
+
+    Scene scene = CreateBenchmarkScene(512, 4, 100, 180);
+    std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(scene);
+
+    JobSystem jobSystem(runner.GetOptions().MaxThreads);
+    CpuRenderer renderer(jobSystem);
+    renderer.SetSampleTolerance(isAdaptive ? VIEW_DEFAULT_SAMPLE_TOLERANCE : 0.0f);
+    CpuImage image;
+
+    double minTime = 0.0;
+    double maxTime = 0.0;
+    for (float zoom : s_Zooms)
+    {
+        std::string name = prefix + "/Zoom:" + std::to_string(zoom);
+        if (!runner.IsSelected(name))
+            continue;
+
+        ViewCamera camera;
+        camera.Center = glm::vec2(VIEW_BENCHMARK_CENTER_X, VIEW_BENCHMARK_CENTER_Y);
+        camera.Zoom = zoom;
+        ViewTransform view = camera.GetViewTransform(VIEW_BENCHMARK_SIZE, VIEW_BENCHMARK_SIZE);
+
+        runner.Run(name, double(VIEW_BENCHMARK_SIZE) * VIEW_BENCHMARK_SIZE, [&]()
+        {
+            renderer.Render(*snapshot, VIEW_BENCHMARK_SIZE, VIEW_BENCHMARK_SIZE, image, view);
+            DoNotOptimize(image.Pixels.data());
+            ClobberMemory();
+        });
+
+        const CpuRenderStats& stats = renderer.GetStats();
+        runner.AddCounter("Samples", stats.NumSamples);
+        runner.AddCounter("CulledCurves", stats.NumCulledCurves);
+
+        double medianTime = runner.GetLastResult().Median;
+        minTime = minTime > 0.0 ? std::min(minTime, medianTime) : medianTime;
+        maxTime = std::max(maxTime, medianTime);
+
+        // A fixed sample count gets visibly straight segments as the zoom grows, adaptive samples stay within the tolerance
+        double flatteningError = GetMaxFlatteningError(scene, view, isAdaptive ? 0 : scene.Settings.NumSamples, VIEW_DEFAULT_SAMPLE_TOLERANCE);
+        runner.AddCounter("FlatteningError", flatteningError);
+        if (isAdaptive && flatteningError > VIEW_DEFAULT_SAMPLE_TOLERANCE * 1.001)
+            runner.ReportFailure(name + ": a polyline strays " + std::to_string(flatteningError) + " pixels from its curve");
+    }
+
+    // How far the frame cost moves over the sweep, 1 is a constant cost
+    if (minTime > 0.0)
+        runner.AddCounter("CostSpread", maxTime / minTime);
+}
+
+// The default view is the fixed mapping of the [-1, 1] square, a camera at the origin shows the same image on a square
+static void RunIdentityViewTest(BenchmarkRunner& runner)
+{
+    std::string name = "View/IdentityCamera";
+    if (!runner.IsSelected(name))
+        return;
+
+    std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(CreateBenchmarkScene(64, 6, 100, 181));
+    JobSystem jobSystem(runner.GetOptions().MaxThreads);
+    CpuRenderer renderer(jobSystem);
+    CpuImage defaultImage;
+    CpuImage cameraImage;
+    runner.Run(name, double(VIEW_BENCHMARK_SIZE) * VIEW_BENCHMARK_SIZE, [&]()
+    {
+        renderer.Render(*snapshot, VIEW_BENCHMARK_SIZE, VIEW_BENCHMARK_SIZE, cameraImage, ViewCamera().GetViewTransform(VIEW_BENCHMARK_SIZE, VIEW_BENCHMARK_SIZE));
+        DoNotOptimize(cameraImage.Pixels.data());
+        ClobberMemory();
+    });
+
+    renderer.Render(*snapshot, VIEW_BENCHMARK_SIZE, VIEW_BENCHMARK_SIZE, defaultImage);
+    if (std::memcmp(defaultImage.Pixels.data(), cameraImage.Pixels.data(), defaultImage.Pixels.size() * sizeof(uint32_t)) != 0)
+        runner.ReportFailure(name + ": the image differs from the one without a camera");
+}
+
+void RunViewBenchmarks(BenchmarkRunner& runner)
+{
+    RunIdentityViewTest(runner);
+    RunZoomSweepBenchmark(runner, false);
+    RunZoomSweepBenchmark(runner, true);
+}
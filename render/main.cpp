@@ -0,0 +1,295 @@
+#include "animation.h"
+#include "batchrender.h"
+#include "framestreamer.h"
+#include "scenefile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+// Longest time between keyframes of --animate, an hour of frames is more than any pipe is meant to take
+#define RENDER_MAX_KEYFRAME_INTERVAL 3600.0f
+#define RENDER_MAX_FRAMES_PER_SECOND 240
+
+// Settings of --animate, which streams the scene files as the keyframes of an animation instead of writing an image of each
+struct AnimationOptions
+{
+    // File the frames are written to, - writes them to stdout. Empty renders images
+    std::string OutputPath;
+    FrameFormat Format = FrameFormat_Y4m;
+    uint32_t FramesPerSecond = 30;
+    // Seconds from one keyframe to the next
+    float KeyframeInterval = 1.0f;
+};
+
+static void PrintUsage()
+{
+    std::cout << "Usage: BezierCurveRender [options] <scene files...>" << std::endl;
+    std::cout << "       BezierCurveRender --animate <file|-> [options] <keyframe scene files...>" << std::endl;
+    std::cout << "  --output <directory>   Directory the images are written to (default .)" << std::endl;
+    std::cout << "  --size <w>x<h>         Image size (default 1920x1080)" << std::endl;
+    std::cout << "  --format <tga|ppm>     Image format, TGA is limited to 65535 pixels on each side and PPM to " << BATCH_RENDER_MAX_SIZE << " (default tga)" << std::endl;
+    std::cout << "  --format <y4m|rgba>    Frame format of --animate, Y4M needs an even width and height (default y4m)" << std::endl;
+    std::cout << "  --threads <n>          Threads of the whole batch, 1 to " << BATCH_RENDER_MAX_THREADS << " (default all cores)" << std::endl;
+    std::cout << "  --tolerance <pixels>   Curve sample tolerance, 0 uses the sample count of the scene (default 0.25)" << std::endl;
+    std::cout << "  --band-height <rows>   Rows rendered at once per scene (default 256)" << std::endl;
+    std::cout << "  --list <path>          Also render the scene files listed in path, one per line" << std::endl;
+    std::cout << "  --quiet                Only print failures and the summary" << std::endl;
+    std::cout << "  --animate <file|->     Write the frames of an animation through the scene files instead, - writes them to stdout" << std::endl;
+    std::cout << "                         and the messages to stderr. The scenes must have the same curves" << std::endl;
+    std::cout << "  --fps <n>              Frames per second of --animate, 1 to " << RENDER_MAX_FRAMES_PER_SECOND << " (default 30)" << std::endl;
+    std::cout << "  --interval <seconds>   Time from one keyframe to the next in --animate (default 1)" << std::endl;
+}
+
+// Whole numbers in [min, max], anything else including signs and trailing characters is rejected. end receives the first
+// character after the number when the caller expects more
+static bool ParseUnsigned(const char* text, uint32_t min, uint32_t max, uint32_t& value, const char** end = nullptr)
+{
+    if (!isdigit((unsigned char)text[0]))
+        return false;
+
+    char* numberEnd = nullptr;
+    unsigned long long number = strtoull(text, &numberEnd, 10);
+    if (end)
+        *end = numberEnd;
+    else if (*numberEnd != '\0')
+        return false;
+
+    if (number < min || number > max)
+        return false;
+
+    value = (uint32_t)number;
+    return true;
+}
+
+static bool ReadSceneList(const char* filepath, std::vector<std::string>& scenePaths)
+{
+    std::ifstream file(filepath);
+    if (!file)
+    {
+        std::cout << "Failed to open " << filepath << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (!line.empty())
+            scenePaths.push_back(line);
+    }
+
+    return true;
+}
+
+static bool ParseArguments(int argc, char** argv, BatchRenderSettings& settings, AnimationOptions& animation, std::vector<std::string>& scenePaths)
+{
+    // Formats are checked once it is known whether images or frames are written
+    const char* format = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        const char* argument = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (strcmp(argument, "--help") == 0)
+            return false;
+
+        if (strcmp(argument, "--quiet") == 0)
+        {
+            settings.Verbose = false;
+            continue;
+        }
+
+        if (strncmp(argument, "--", 2) != 0)
+        {
+            scenePaths.push_back(argument);
+            continue;
+        }
+
+        if (!value)
+        {
+            std::cout << "Missing value for " << argument << std::endl;
+            return false;
+        }
+
+        bool isValid = true;
+        if (strcmp(argument, "--output") == 0)
+            settings.OutputDirectory = value;
+        else if (strcmp(argument, "--size") == 0)
+        {
+            const char* end = nullptr;
+            isValid = ParseUnsigned(value, 1, BATCH_RENDER_MAX_SIZE, settings.Width, &end) && *end == 'x' &&
+                ParseUnsigned(end + 1, 1, BATCH_RENDER_MAX_SIZE, settings.Height);
+        }
+        else if (strcmp(argument, "--format") == 0)
+            format = value;
+        else if (strcmp(argument, "--threads") == 0)
+            isValid = ParseUnsigned(value, 1, BATCH_RENDER_MAX_THREADS, settings.NumThreads);
+        else if (strcmp(argument, "--tolerance") == 0)
+        {
+            char* end = nullptr;
+            settings.SampleTolerance = strtof(value, &end);
+            isValid = end != value && *end == '\0' && std::isfinite(settings.SampleTolerance) && settings.SampleTolerance >= 0.0f;
+        }
+        else if (strcmp(argument, "--band-height") == 0)
+            isValid = ParseUnsigned(value, 1, BATCH_RENDER_MAX_SIZE, settings.BandHeight);
+        else if (strcmp(argument, "--list") == 0)
+        {
+            if (!ReadSceneList(value, scenePaths))
+                return false;
+        }
+        else if (strcmp(argument, "--animate") == 0)
+        {
+            animation.OutputPath = value;
+            isValid = !animation.OutputPath.empty();
+        }
+        else if (strcmp(argument, "--fps") == 0)
+            isValid = ParseUnsigned(value, 1, RENDER_MAX_FRAMES_PER_SECOND, animation.FramesPerSecond);
+        else if (strcmp(argument, "--interval") == 0)
+        {
+            char* end = nullptr;
+            animation.KeyframeInterval = strtof(value, &end);
+            isValid = end != value && *end == '\0' && animation.KeyframeInterval > 0.0f && animation.KeyframeInterval <= RENDER_MAX_KEYFRAME_INTERVAL;
+        }
+        else
+        {
+            std::cout << "Unknown option " << argument << std::endl;
+            return false;
+        }
+
+        if (!isValid)
+        {
+            std::cout << "Invalid value " << value << " for " << argument << std::endl;
+            return false;
+        }
+
+        i++;
+    }
+
+    if (!format)
+        return true;
+
+    bool isAnimating = !animation.OutputPath.empty();
+    if (!isAnimating && strcmp(format, "tga") == 0)
+        settings.Format = ImageFileFormat_Tga;
+    else if (!isAnimating && strcmp(format, "ppm") == 0)
+        settings.Format = ImageFileFormat_Ppm;
+    else if (isAnimating && strcmp(format, "y4m") == 0)
+        animation.Format = FrameFormat_Y4m;
+    else if (isAnimating && strcmp(format, "rgba") == 0)
+        animation.Format = FrameFormat_Rgba;
+    else
+    {
+        std::cout << "Unknown " << (isAnimating ? "frame" : "image") << " format " << format << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Keys the scenes KeyframeInterval apart in the order they are given and streams every frame from the first to the last
+static bool RenderAnimation(const std::vector<std::string>& scenePaths, const BatchRenderSettings& settings, const AnimationOptions& options, std::ostream& output)
+{
+    SceneAnimation animation;
+    Scene scene;
+    Scene keyframe;
+    for (size_t i = 0; i < scenePaths.size(); i++)
+    {
+        SceneFile sceneFile;
+        if (!sceneFile.Open(scenePaths[i]))
+        {
+            std::cout << "Failed to load " << scenePaths[i] << std::endl;
+            return false;
+        }
+
+        // The first scene also provides the settings the animation does not key
+        Scene& target = i == 0 ? scene : keyframe;
+        target.CopyFrom(sceneFile.GetView());
+        if (!animation.SetKeyframe(i * options.KeyframeInterval, target))
+        {
+            std::cout << scenePaths[i] << " does not have the curves of " << scenePaths[0] << std::endl;
+            return false;
+        }
+    }
+
+    FrameStreamSettings streamSettings;
+    streamSettings.Width = settings.Width;
+    streamSettings.Height = settings.Height;
+    streamSettings.FramesPerSecond = options.FramesPerSecond;
+    streamSettings.NumFrames = uint32_t(std::ceil(animation.GetEndTime() * options.FramesPerSecond)) + 1;
+    streamSettings.Format = options.Format;
+    streamSettings.NumThreads = settings.NumThreads;
+
+    FrameStreamStats stats;
+    if (!StreamAnimationFrames(animation, scene, streamSettings, output, stats))
+        return false;
+
+    std::cout << "Streamed " << stats.NumFrames << " frames of " << animation.GetNumKeyframes() << " keyframes at " << settings.Width << "x" << settings.Height <<
+        " to " << options.OutputPath << " in " << stats.TotalTime << " s: " << stats.FramesPerSecond << " fps, " << stats.NumBytes / (1024 * 1024) << " MB written" << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    BatchRenderSettings settings;
+    AnimationOptions animation;
+    std::vector<std::string> scenePaths;
+    if (!ParseArguments(argc, argv, settings, animation, scenePaths) || scenePaths.empty())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    if (animation.OutputPath == "-")
+    {
+#if defined(_WIN32)
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        // stdout only carries the frames, everything printed on the way goes to stderr
+        std::ostream output(std::cout.rdbuf());
+        std::streambuf* coutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+        bool succeeded = RenderAnimation(scenePaths, settings, animation, output);
+        std::cout.rdbuf(coutBuffer);
+        return succeeded ? 0 : 1;
+    }
+
+    if (!animation.OutputPath.empty())
+    {
+        std::ofstream file(animation.OutputPath, std::ios::binary);
+        if (!file)
+        {
+            std::cout << "Failed to open " << animation.OutputPath << std::endl;
+            return 1;
+        }
+
+        return RenderAnimation(scenePaths, settings, animation, file) ? 0 : 1;
+    }
+
+    BatchRenderStats stats;
+    bool succeeded = RenderSceneBatch(scenePaths, settings, stats);
+    if (stats.Scenes.empty() || stats.TotalTime == 0.0f)
+        return 1;
+
+    float renderTime = 0.0f;
+    for (const BatchSceneStats& scene : stats.Scenes)
+        renderTime += scene.LoadTime + scene.RenderTime + scene.WriteTime;
+
+    uint32_t numRenderedScenes = (uint32_t)stats.Scenes.size() - stats.NumFailed;
+    std::cout << "Rendered " << numRenderedScenes << " of " << stats.Scenes.size() << " scenes at " << settings.Width << "x" << settings.Height << " with " <<
+        stats.NumWorkers << " workers in " << stats.TotalTime << " s: " << stats.ScenesPerSecond << " scenes/s, " << stats.MegapixelsPerSecond <<
+        " megapixels/s, " << stats.NumBytes / (1024 * 1024) << " MB written" << std::endl;
+    std::cout << "Startup " << stats.StartupTime * 1000.0f << " ms, " << renderTime / std::max<size_t>(stats.Scenes.size(), 1) << " ms per scene on a worker, " <<
+        stats.BandBytes / (1024 * 1024) << " MB of bands, " << stats.PeakResidentBytes / (1024 * 1024) << " MB peak memory" << std::endl;
+
+    return succeeded ? 0 : 1;
+}
@@ -11,6 +11,10 @@ cbuffer BezierCurveConstants : register(b0)
     float T1;
     int DrawBezierCurve;
     int DrawPolar;
+    int PolarNumSamples;
+    // Scene to view transform, the view spans [-1, 1] over the texture
+    float2 ViewScale;
+    float2 ViewOffset;
 };
 
 struct BezierControlPoint
@@ -23,13 +27,18 @@ StructuredBuffer<BezierControlPoint> ControlPointsBezier : register(t0);
 StructuredBuffer<BezierControlPoint> ControlPointsPolar : register(t1);
 RWTexture2D<float4> RenderTexture : register(u0);
 
+float2 GetViewPosition(float2 position)
+{
+    return position * ViewScale + ViewOffset;
+}
+
 float2 GetBezierPoint(float t, StructuredBuffer<BezierControlPoint> controlPoints, int numControlPoints)
 {
     // Returns a Bezier Curve point based on t by using the de Casteljau algorithm
     float2 pointsCopy[MAX_CONTROL_POINTS];
     for (int i = 0; i < numControlPoints; i++)
     {
-        pointsCopy[i] = controlPoints[i].Position;
+        pointsCopy[i] = GetViewPosition(controlPoints[i].Position);
     }
     
     for (int n = 1; n < numControlPoints; n++)
@@ -71,17 +80,17 @@ float3 DrawBezier(float2 pixelPos, StructuredBuffer<BezierControlPoint> controlP
     float3 polygonColor = float3(0.0, 0.0, 0.0);
     for (int j = 0; j < numControlPoints; j++)
     {
-        polygonColor += DrawCircle(pixelPos, controlPoints[j].Position, 0.05, controlPoints[j].Color);
+        polygonColor += DrawCircle(pixelPos, GetViewPosition(controlPoints[j].Position), 0.05, controlPoints[j].Color);
     }
     
     for (int k = 0; k < numControlPoints - 1; k++)
     {
-        polygonColor += DrawLine(pixelPos, controlPoints[k].Position, controlPoints[k + 1].Position, polygonEdgeColor, 0.005);
+        polygonColor += DrawLine(pixelPos, GetViewPosition(controlPoints[k].Position), GetViewPosition(controlPoints[k + 1].Position), polygonEdgeColor, 0.005);
     }
     
     float3 bezierColor = float3(0.0, 0.0, 0.0);
     float2 currPoint;
-    float2 prevPoint = controlPoints[0].Position;
+    float2 prevPoint = GetViewPosition(controlPoints[0].Position);
     for (int i = 0; i < numSamples; i++)
     {
         float t = float(i) / float(numSamples - 1);
@@ -113,7 +122,7 @@ void CSMain(uint2 threadID : SV_DispatchThreadID)
     
     if (DrawPolar && NumControlPoints > 1)
     {
-        color += DrawBezier(pixelPos, ControlPointsPolar, NumSamples, NumControlPoints - 1, PolarColor, float3(0.1, 0.2, 0.8), PolarThickness * 0.005);
+        color += DrawBezier(pixelPos, ControlPointsPolar, PolarNumSamples, NumControlPoints - 1, PolarColor, float3(0.1, 0.2, 0.8), PolarThickness * 0.005);
     }
     
     RenderTexture[threadID] = float4(color, 1.0);
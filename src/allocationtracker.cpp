@@ -0,0 +1,218 @@
+#include "allocationtracker.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+// Every block starts with a header holding its size, so frees are counted in bytes even without sized delete. The
+// header keeps the default new alignment, over-aligned blocks use a header as large as their alignment
+#define ALLOCATION_HEADER_SIZE 16
+
+struct AllocationTagCounters
+{
+    std::atomic<const char*> Name{ nullptr };
+    std::atomic<uint64_t> NumAllocations{ 0 };
+    std::atomic<uint64_t> BytesAllocated{ 0 };
+    // Only accessed by AllocationTracker::Update
+    uint64_t LastNumAllocations = 0;
+    uint64_t LastBytesAllocated = 0;
+};
+
+static std::atomic<uint64_t> s_NumAllocations{ 0 };
+static std::atomic<uint64_t> s_NumFrees{ 0 };
+static std::atomic<uint64_t> s_BytesAllocated{ 0 };
+static std::atomic<uint64_t> s_BytesFreed{ 0 };
+// The last slot collects the tags that did not fit
+static AllocationTagCounters s_TagCounters[ALLOCATION_TRACKER_MAX_TAGS + 1];
+
+thread_local const char* AllocationTracker::s_ThreadTag = nullptr;
+AllocationStats AllocationTracker::s_LastTotalStats;
+AllocationStats AllocationTracker::s_FrameStats;
+std::vector<AllocationTagStats> AllocationTracker::s_TagStats;
+
+static AllocationTagCounters& GetTagCounters(const char* tag)
+{
+    for (uint32_t i = 0; i < ALLOCATION_TRACKER_MAX_TAGS; i++)
+    {
+        const char* name = s_TagCounters[i].Name.load(std::memory_order_acquire);
+        if (name == tag)
+            return s_TagCounters[i];
+
+        if (!name && (s_TagCounters[i].Name.compare_exchange_strong(name, tag, std::memory_order_acq_rel) || name == tag))
+            return s_TagCounters[i];
+    }
+
+    return s_TagCounters[ALLOCATION_TRACKER_MAX_TAGS];
+}
+
+void AllocationTracker::RecordAllocation(size_t size)
+{
+    s_NumAllocations.fetch_add(1, std::memory_order_relaxed);
+    s_BytesAllocated.fetch_add(size, std::memory_order_relaxed);
+
+    if (s_ThreadTag)
+    {
+        AllocationTagCounters& counters = GetTagCounters(s_ThreadTag);
+        counters.NumAllocations.fetch_add(1, std::memory_order_relaxed);
+        counters.BytesAllocated.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+void AllocationTracker::RecordFree(size_t size)
+{
+    s_NumFrees.fetch_add(1, std::memory_order_relaxed);
+    s_BytesFreed.fetch_add(size, std::memory_order_relaxed);
+}
+
+AllocationStats AllocationTracker::GetTotalStats()
+{
+    AllocationStats stats;
+    stats.NumAllocations = s_NumAllocations.load(std::memory_order_relaxed);
+    stats.NumFrees = s_NumFrees.load(std::memory_order_relaxed);
+    stats.BytesAllocated = s_BytesAllocated.load(std::memory_order_relaxed);
+    stats.BytesFreed = s_BytesFreed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void AllocationTracker::Update()
+{
+    // Reserved once, so the update itself does not show up in the frame statistics
+    if (s_TagStats.capacity() < ALLOCATION_TRACKER_MAX_TAGS + 1)
+        s_TagStats.reserve(ALLOCATION_TRACKER_MAX_TAGS + 1);
+
+    AllocationStats total = GetTotalStats();
+    s_FrameStats.NumAllocations = total.NumAllocations - s_LastTotalStats.NumAllocations;
+    s_FrameStats.NumFrees = total.NumFrees - s_LastTotalStats.NumFrees;
+    s_FrameStats.BytesAllocated = total.BytesAllocated - s_LastTotalStats.BytesAllocated;
+    s_FrameStats.BytesFreed = total.BytesFreed - s_LastTotalStats.BytesFreed;
+    s_LastTotalStats = total;
+
+    s_TagStats.clear();
+    for (AllocationTagCounters& counters : s_TagCounters)
+    {
+        const char* name = counters.Name.load(std::memory_order_acquire);
+        uint64_t numAllocations = counters.NumAllocations.load(std::memory_order_relaxed);
+        if (!name && numAllocations == 0)
+            continue;
+
+        uint64_t bytesAllocated = counters.BytesAllocated.load(std::memory_order_relaxed);
+
+        AllocationTagStats& stats = s_TagStats.emplace_back();
+        stats.Name = name ? name : "Other";
+        stats.NumAllocations = numAllocations;
+        stats.BytesAllocated = bytesAllocated;
+        stats.FrameAllocations = numAllocations - counters.LastNumAllocations;
+        stats.FrameBytes = bytesAllocated - counters.LastBytesAllocated;
+
+        counters.LastNumAllocations = numAllocations;
+        counters.LastBytesAllocated = bytesAllocated;
+    }
+
+    std::sort(s_TagStats.begin(), s_TagStats.end(), [](const AllocationTagStats& a, const AllocationTagStats& b)
+    {
+        return a.FrameAllocations != b.FrameAllocations ? a.FrameAllocations > b.FrameAllocations : a.NumAllocations > b.NumAllocations;
+    });
+}
+
+#if !defined(ALLOCATION_TRACKER_DISABLED)
+
+static void* AllocateBlock(size_t size, size_t alignment)
+{
+    size_t headerSize = std::max<size_t>(alignment, ALLOCATION_HEADER_SIZE);
+    if (size > SIZE_MAX - headerSize)
+        return nullptr;
+
+    uint8_t* block = nullptr;
+    if (alignment <= ALLOCATION_HEADER_SIZE)
+    {
+        block = (uint8_t*)malloc(size + headerSize);
+    }
+    else
+    {
+#if defined(_WIN32)
+        block = (uint8_t*)_aligned_malloc(size + headerSize, alignment);
+#else
+        void* pointer = nullptr;
+        if (posix_memalign(&pointer, alignment, size + headerSize) == 0)
+            block = (uint8_t*)pointer;
+#endif
+    }
+
+    if (!block)
+        return nullptr;
+
+    uint8_t* pointer = block + headerSize;
+    ((size_t*)pointer)[-1] = size;
+    AllocationTracker::RecordAllocation(size);
+    return pointer;
+}
+
+static void FreeBlock(void* pointer, size_t alignment)
+{
+    if (!pointer)
+        return;
+
+    size_t headerSize = std::max<size_t>(alignment, ALLOCATION_HEADER_SIZE);
+    AllocationTracker::RecordFree(((size_t*)pointer)[-1]);
+
+    uint8_t* block = (uint8_t*)pointer - headerSize;
+#if defined(_WIN32)
+    if (alignment > ALLOCATION_HEADER_SIZE)
+    {
+        _aligned_free(block);
+        return;
+    }
+#endif
+    free(block);
+}
+
+// Standard semantics: retry through the new handler, throw when there is none
+static void* AllocateOrThrow(size_t size, size_t alignment)
+{
+    while (true)
+    {
+        if (void* pointer = AllocateBlock(size, alignment))
+            return pointer;
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+static void* AllocateOrNull(size_t size, size_t alignment) noexcept
+{
+    try
+    {
+        return AllocateOrThrow(size, alignment);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new(size_t size) { return AllocateOrThrow(size, 0); }
+void* operator new[](size_t size) { return AllocateOrThrow(size, 0); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return AllocateOrNull(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return AllocateOrNull(size, 0); }
+void* operator new(size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, (size_t)alignment); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return AllocateOrNull(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return AllocateOrNull(size, (size_t)alignment); }
+
+void operator delete(void* pointer) noexcept { FreeBlock(pointer, 0); }
+void operator delete[](void* pointer) noexcept { FreeBlock(pointer, 0); }
+void operator delete(void* pointer, size_t) noexcept { FreeBlock(pointer, 0); }
+void operator delete[](void* pointer, size_t) noexcept { FreeBlock(pointer, 0); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { FreeBlock(pointer, 0); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { FreeBlock(pointer, 0); }
+void operator delete(void* pointer, std::align_val_t alignment) noexcept { FreeBlock(pointer, (size_t)alignment); }
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept { FreeBlock(pointer, (size_t)alignment); }
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept { FreeBlock(pointer, (size_t)alignment); }
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept { FreeBlock(pointer, (size_t)alignment); }
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { FreeBlock(pointer, (size_t)alignment); }
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { FreeBlock(pointer, (size_t)alignment); }
+
+#endif
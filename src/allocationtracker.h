@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define ALLOCATION_TRACKER_MAX_TAGS 64
+
+// Global operator new and delete are replaced to count heap allocations. With ALLOCATION_TRACKER_DISABLED the
+// replacements and tags are compiled out and the default operators are used
+#if defined(ALLOCATION_TRACKER_DISABLED)
+#define ALLOCATION_TAG(name)
+#else
+#define ALLOCATION_CONCATENATE_INTERNAL(a, b) a##b
+#define ALLOCATION_CONCATENATE(a, b) ALLOCATION_CONCATENATE_INTERNAL(a, b)
+#define ALLOCATION_TAG(name) AllocationTagScope ALLOCATION_CONCATENATE(allocationTag, __LINE__)(name)
+#endif
+
+struct AllocationStats
+{
+    uint64_t NumAllocations = 0;
+    uint64_t NumFrees = 0;
+    uint64_t BytesAllocated = 0;
+    uint64_t BytesFreed = 0;
+};
+
+// Allocations made inside an ALLOCATION_TAG scope are attributed to the tag. Like profiler zones, tags must be string
+// literals and are identified by the address of their name
+struct AllocationTagStats
+{
+    const char* Name = nullptr;
+    uint64_t NumAllocations = 0;
+    uint64_t BytesAllocated = 0;
+    // Totals of the last frame passed to AllocationTracker::Update
+    uint64_t FrameAllocations = 0;
+    uint64_t FrameBytes = 0;
+};
+
+class AllocationTracker
+{
+public:
+    static void RecordAllocation(size_t size);
+    static void RecordFree(size_t size);
+
+    static void SetThreadTag(const char* tag) { s_ThreadTag = tag; }
+    static const char* GetThreadTag() { return s_ThreadTag; }
+
+    // Takes the allocations made since the last update as the frame statistics, called once per frame
+    static void Update();
+    static AllocationStats GetTotalStats();
+    static const AllocationStats& GetFrameStats() { return s_FrameStats; }
+    // Tag statistics sorted by descending number of allocations in the last frame
+    static const std::vector<AllocationTagStats>& GetTagStats() { return s_TagStats; }
+private:
+    static thread_local const char* s_ThreadTag;
+    static AllocationStats s_LastTotalStats;
+    static AllocationStats s_FrameStats;
+    static std::vector<AllocationTagStats> s_TagStats;
+};
+
+class AllocationTagScope
+{
+public:
+    explicit AllocationTagScope(const char* name)
+        : m_PreviousTag(AllocationTracker::GetThreadTag())
+    {
+        AllocationTracker::SetThreadTag(name);
+    }
+
+    ~AllocationTagScope()
+    {
+        AllocationTracker::SetThreadTag(m_PreviousTag);
+    }
+
+    AllocationTagScope(const AllocationTagScope&) = delete;
+    AllocationTagScope& operator=(const AllocationTagScope&) = delete;
+private:
+    const char* m_PreviousTag;
+};
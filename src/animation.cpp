@@ -0,0 +1,165 @@
+#include "animation.h"
+
+#include <algorithm>
+#include <iostream>
+
+static bool HasSameCurves(const std::vector<SceneCurve>& curves, const Scene& scene)
+{
+    if (curves.size() != scene.Curves.size())
+        return false;
+
+    for (uint32_t i = 0; i < curves.size(); i++)
+    {
+        if (curves[i].FirstControlPoint != scene.Curves[i].FirstControlPoint || curves[i].NumControlPoints != scene.Curves[i].NumControlPoints)
+            return false;
+    }
+
+    return true;
+}
+
+// output = sum of poses[k] * weights[k] over numPoses poses of count floats each. The poses are flat arrays of floats,
+// so the loop vectorizes over the components of all control points at once
+static void BlendPoses(const float* const* poses, const float* weights, uint32_t numPoses, uint32_t count, float* output)
+{
+    if (numPoses == 2)
+    {
+        const float* a = poses[0];
+        const float* b = poses[1];
+        float wa = weights[0], wb = weights[1];
+        for (uint32_t i = 0; i < count; i++)
+            output[i] = a[i] * wa + b[i] * wb;
+        return;
+    }
+
+    const float* a = poses[0];
+    const float* b = poses[1];
+    const float* c = poses[2];
+    const float* d = poses[3];
+    float wa = weights[0], wb = weights[1], wc = weights[2], wd = weights[3];
+    for (uint32_t i = 0; i < count; i++)
+        output[i] = a[i] * wa + b[i] * wb + c[i] * wc + d[i] * wd;
+}
+
+bool SceneAnimation::SetKeyframe(float time, const Scene& scene)
+{
+    if (m_Times.empty())
+    {
+        m_Curves = scene.Curves;
+        m_NumControlPoints = (uint32_t)scene.Positions.size();
+    }
+    else if (!::HasSameCurves(m_Curves, scene))
+    {
+        std::cout << "Keyframe at " << time << " not set: the scene has different curves than the other keyframes" << std::endl;
+        return false;
+    }
+
+    uint32_t keyframe = uint32_t(std::lower_bound(m_Times.begin(), m_Times.end(), time) - m_Times.begin());
+    if (keyframe == m_Times.size() || m_Times[keyframe] != time)
+        InsertKeyframe(keyframe, time);
+
+    StorePose(keyframe, scene);
+    return true;
+}
+
+void SceneAnimation::RemoveKeyframe(uint32_t keyframe)
+{
+    m_Times.erase(m_Times.begin() + keyframe);
+    m_Positions.erase(m_Positions.begin() + (size_t)keyframe * m_NumControlPoints, m_Positions.begin() + (size_t)(keyframe + 1) * m_NumControlPoints);
+    m_Colors.erase(m_Colors.begin() + (size_t)keyframe * m_NumControlPoints, m_Colors.begin() + (size_t)(keyframe + 1) * m_NumControlPoints);
+    m_T1.erase(m_T1.begin() + keyframe);
+}
+
+void SceneAnimation::Clear()
+{
+    m_Curves.clear();
+    m_NumControlPoints = 0;
+    m_Times.clear();
+    m_Positions.clear();
+    m_Colors.clear();
+    m_T1.clear();
+}
+
+bool SceneAnimation::HasSameCurves(const Scene& scene) const
+{
+    return m_Times.empty() || ::HasSameCurves(m_Curves, scene);
+}
+
+void SceneAnimation::Evaluate(float time, Scene& scene) const
+{
+    if (m_Times.empty())
+        return;
+
+    if (!::HasSameCurves(m_Curves, scene))
+    {
+        scene.Curves = m_Curves;
+        scene.Positions.resize(m_NumControlPoints);
+        scene.Colors.resize(m_NumControlPoints);
+    }
+
+    // Span [t1, t2] between keyframes k1 and k2 = k1 + 1, with the keyframes k0 and k3 around it clamped to the ends
+    uint32_t numKeyframes = (uint32_t)m_Times.size();
+    uint32_t k2 = uint32_t(std::upper_bound(m_Times.begin(), m_Times.end(), time) - m_Times.begin());
+    if (k2 == 0 || k2 == numKeyframes)
+    {
+        uint32_t keyframe = k2 == 0 ? 0 : numKeyframes - 1;
+        std::copy_n(m_Positions.data() + (size_t)keyframe * m_NumControlPoints, m_NumControlPoints, scene.Positions.data());
+        std::copy_n(m_Colors.data() + (size_t)keyframe * m_NumControlPoints, m_NumControlPoints, scene.Colors.data());
+        scene.Settings.T1 = m_T1[keyframe];
+        return;
+    }
+
+    uint32_t k1 = k2 - 1;
+    uint32_t k0 = k1 > 0 ? k1 - 1 : k1;
+    uint32_t k3 = k2 + 1 < numKeyframes ? k2 + 1 : k2;
+    float t0 = m_Times[k0], t1 = m_Times[k1], t2 = m_Times[k2], t3 = m_Times[k3];
+    float span = t2 - t1;
+    float u = (time - t1) / span;
+
+    // Cubic Hermite basis with the tangents (p2 - p0) * span / (t2 - t0) and (p3 - p1) * span / (t3 - t1), expanded into
+    // one weight per keyframe. At the clamped ends the tangent becomes the chord of the span
+    float u2 = u * u;
+    float u3 = u2 * u;
+    float h00 = 2.0f * u3 - 3.0f * u2 + 1.0f;
+    float h10 = u3 - 2.0f * u2 + u;
+    float h01 = -2.0f * u3 + 3.0f * u2;
+    float h11 = u3 - u2;
+    float a = span / (t2 - t0);
+    float b = span / (t3 - t1);
+    float weights[4] = { -h10 * a, h00 - h11 * b, h01 + h10 * a, h11 * b };
+
+    const float* positions[4] =
+    {
+        reinterpret_cast<const float*>(m_Positions.data() + (size_t)k0 * m_NumControlPoints),
+        reinterpret_cast<const float*>(m_Positions.data() + (size_t)k1 * m_NumControlPoints),
+        reinterpret_cast<const float*>(m_Positions.data() + (size_t)k2 * m_NumControlPoints),
+        reinterpret_cast<const float*>(m_Positions.data() + (size_t)k3 * m_NumControlPoints),
+    };
+    BlendPoses(positions, weights, 4, m_NumControlPoints * 2, reinterpret_cast<float*>(scene.Positions.data()));
+
+    const float* colors[2] =
+    {
+        reinterpret_cast<const float*>(m_Colors.data() + (size_t)k1 * m_NumControlPoints),
+        reinterpret_cast<const float*>(m_Colors.data() + (size_t)k2 * m_NumControlPoints),
+    };
+    float colorWeights[2] = { 1.0f - u, u };
+    BlendPoses(colors, colorWeights, 2, m_NumControlPoints * 3, reinterpret_cast<float*>(scene.Colors.data()));
+
+    // The spline may overshoot, the polar parameter stays on the curve
+    float t1Value = m_T1[k0] * weights[0] + m_T1[k1] * weights[1] + m_T1[k2] * weights[2] + m_T1[k3] * weights[3];
+    scene.Settings.T1 = std::clamp(t1Value, 0.0f, 1.0f);
+}
+
+void SceneAnimation::InsertKeyframe(uint32_t keyframe, float time)
+{
+    m_Times.insert(m_Times.begin() + keyframe, time);
+    m_Positions.insert(m_Positions.begin() + (size_t)keyframe * m_NumControlPoints, m_NumControlPoints, glm::vec2(0.0f));
+    m_Colors.insert(m_Colors.begin() + (size_t)keyframe * m_NumControlPoints, m_NumControlPoints, glm::vec3(0.0f));
+    m_T1.insert(m_T1.begin() + keyframe, 0.0f);
+}
+
+void SceneAnimation::StorePose(uint32_t keyframe, const Scene& scene)
+{
+    std::copy_n(scene.Positions.data(), m_NumControlPoints, m_Positions.data() + (size_t)keyframe * m_NumControlPoints);
+    std::copy_n(scene.Colors.data(), m_NumControlPoints, m_Colors.data() + (size_t)keyframe * m_NumControlPoints);
+    m_T1[keyframe] = scene.Settings.T1;
+}
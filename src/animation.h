@@ -0,0 +1,48 @@
+#pragma once
+
+#include "scene.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Keyframed poses of a scene: the positions and colors of every control point and the polar parameter T1. All keyframes
+// share the curves of the first one, a pose is only keyed on a scene with the same curves and control point counts.
+// Poses are stored as one array per attribute with the keyframes one after another (SoA), so evaluating a frame looks up
+// its keyframe span once and then blends whole arrays
+class SceneAnimation
+{
+public:
+    // Keys the pose of scene at time, replacing the keyframe already at that time. Fails when scene has different curves
+    // than the keyframes already set
+    bool SetKeyframe(float time, const Scene& scene);
+    void RemoveKeyframe(uint32_t keyframe);
+    void Clear();
+
+    // True when scene has the curves of the keyframes, or when there are no keyframes yet
+    bool HasSameCurves(const Scene& scene) const;
+
+    uint32_t GetNumKeyframes() const { return (uint32_t)m_Times.size(); }
+    float GetKeyframeTime(uint32_t keyframe) const { return m_Times[keyframe]; }
+    float GetStartTime() const { return m_Times.empty() ? 0.0f : m_Times.front(); }
+    float GetEndTime() const { return m_Times.empty() ? 0.0f : m_Times.back(); }
+
+    // Writes the pose at time into scene. Positions and T1 follow a Catmull-Rom spline through the keyframes, whose
+    // tangents are scaled to the lengths of the neighbouring spans so unevenly spaced keyframes do not overshoot, colors
+    // are blended linearly. Times outside the keyframes hold the first or last pose. A scene with other curves is given the
+    // curves of the keyframes, the other settings of scene are left as they are
+    void Evaluate(float time, Scene& scene) const;
+private:
+    void InsertKeyframe(uint32_t keyframe, float time);
+    void StorePose(uint32_t keyframe, const Scene& scene);
+private:
+    std::vector<SceneCurve> m_Curves;
+    uint32_t m_NumControlPoints = 0;
+
+    std::vector<float> m_Times;
+    // numKeyframes * m_NumControlPoints values, keyframe k starts at k * m_NumControlPoints
+    std::vector<glm::vec2> m_Positions;
+    std::vector<glm::vec3> m_Colors;
+    std::vector<float> m_T1;
+};
@@ -1,5 +1,12 @@
 #include "application.h"
-
+#include "scenefile.h"
+#include "svgpath.h"
+#include "framestreamer.h"
+#include "stripexporter.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
 #include <fstream>
 #include <sstream>
 #include <glm/glm.hpp>
@@ -13,6 +20,59 @@
 EXTERN_C IMAGE_DOS_HEADER __ImageBase;
 static HINSTANCE s_hInstance;
 
+// The viewport image shows the [-1, 1] square of the view, y pointing up
+static glm::vec2 ViewportToScene(const ImVec2& position, const ImVec2& viewportMin, const ImVec2& viewportMax, const ViewTransform& view)
+{
+    return view.ViewToScene({ (position.x - viewportMin.x) / (viewportMax.x - viewportMin.x) * 2.0f - 1.0f, 1.0f - (position.y - viewportMin.y) / (viewportMax.y - viewportMin.y) * 2.0f });
+}
+
+static ImVec2 SceneToViewport(const glm::vec2& position, const ImVec2& viewportMin, const ImVec2& viewportMax, const ViewTransform& view)
+{
+    glm::vec2 viewPosition = view.SceneToView(position);
+    return { viewportMin.x + (viewPosition.x + 1.0f) * 0.5f * (viewportMax.x - viewportMin.x), viewportMin.y + (1.0f - viewPosition.y) * 0.5f * (viewportMax.y - viewportMin.y) };
+}
+
+static void UpdateBezierCurveBounds(BezierCurve& curve)
+{
+    if (!curve.NeedsBoundsUpdate)
+        return;
+
+    glm::vec2 positions[MAX_CONTROL_POINTS];
+    for (uint32_t i = 0; i < curve.ControlPoints.size(); i++)
+        positions[i] = curve.ControlPoints[i].Position;
+
+    GetBezierBounds(positions, curve.ControlPoints.size(), curve.BoundsMin, curve.BoundsMax);
+    curve.NeedsBoundsUpdate = false;
+}
+
+static void UpdateBezierCurveCurvature(BezierCurve& curve)
+{
+    if (!curve.NeedsCurvatureUpdate)
+        return;
+
+    glm::vec2 positions[MAX_CONTROL_POINTS];
+    for (uint32_t i = 0; i < curve.ControlPoints.size(); i++)
+        positions[i] = curve.ControlPoints[i].Position;
+
+    float parameters[CURVATURE_COMB_TEETH];
+    for (uint32_t i = 0; i < CURVATURE_COMB_TEETH; i++)
+        parameters[i] = float(i) / (CURVATURE_COMB_TEETH - 1);
+
+    curve.CurvatureFrames.resize(CURVATURE_COMB_TEETH);
+    EvaluateCurveFrames(positions, curve.ControlPoints.size(), parameters, CURVATURE_COMB_TEETH, curve.CurvatureFrames.data());
+    curve.NeedsCurvatureUpdate = false;
+}
+
+// Samples the shader takes along the curve so it stays within tolerance pixels of the curve in the viewport
+static uint32_t GetBezierCurveSampleCount(const BezierCurve& curve, const ViewTransform& view, uint32_t width, uint32_t height, float tolerance)
+{
+    glm::vec2 positions[MAX_CONTROL_POINTS];
+    for (uint32_t i = 0; i < curve.ControlPoints.size(); i++)
+        positions[i] = curve.ControlPoints[i].Position;
+
+    return GetViewSampleCount(positions, curve.ControlPoints.size(), view, width, height, tolerance);
+}
+
 static bool DrawVec2Control(const char* label, glm::vec2& values, float columnWidth = 150.0f)
 {
     ImGuiIO& io = ImGui::GetIO();
@@ -50,7 +110,7 @@ static bool DrawVec2Control(const char* label, glm::vec2& values, float columnWi
     ImGui::PopStyleColor(3);
 
     ImGui::SameLine();
-    edited |= ImGui::DragFloat("##X", &values.x, 0.01f, -1.0f, 1.0f, "%.2f");
+    edited |= ImGui::DragFloat("##X", &values.x, 0.01f, 0.0f, 0.0f, "%.2f");
     ImGui::PopItemWidth();
     ImGui::SameLine();
 
@@ -69,7 +129,7 @@ static bool DrawVec2Control(const char* label, glm::vec2& values, float columnWi
     ImGui::PopStyleColor(3);
 
     ImGui::SameLine();
-    edited |= ImGui::DragFloat("##Y", &values.y, 0.01f, -1.0f, 1.0f, "%.2f");
+    edited |= ImGui::DragFloat("##Y", &values.y, 0.01f, 0.0f, 0.0f, "%.2f");
     ImGui::PopItemWidth();
     ImGui::SameLine();
 
@@ -100,6 +160,45 @@ static bool DrawColorEdit(const char* label, glm::vec3& values, float columnWidt
     return edited;
 }
 
+static std::string OpenFileDialog(HWND owner, const char* filter)
+{
+    char filepath[MAX_PATH] = {};
+
+    OPENFILENAMEA ofn = {};
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = owner;
+    ofn.lpstrFile = filepath;
+    ofn.nMaxFile = sizeof(filepath);
+    ofn.lpstrFilter = filter;
+    ofn.nFilterIndex = 1;
+    ofn.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST | OFN_NOCHANGEDIR;
+
+    if (GetOpenFileNameA(&ofn))
+        return filepath;
+
+    return std::string();
+}
+
+static std::string SaveFileDialog(HWND owner, const char* filter, const char* defaultExtension)
+{
+    char filepath[MAX_PATH] = {};
+
+    OPENFILENAMEA ofn = {};
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = owner;
+    ofn.lpstrFile = filepath;
+    ofn.nMaxFile = sizeof(filepath);
+    ofn.lpstrFilter = filter;
+    ofn.nFilterIndex = 1;
+    ofn.lpstrDefExt = defaultExtension;
+    ofn.Flags = OFN_PATHMUSTEXIST | OFN_OVERWRITEPROMPT | OFN_NOCHANGEDIR;
+
+    if (GetSaveFileNameA(&ofn))
+        return filepath;
+
+    return std::string();
+}
+
 Application::Application(uint32_t windowWidth, uint32_t windowHeight)
 {
     m_GfxContext.WindowWidth = windowWidth;
@@ -108,22 +207,341 @@ Application::Application(uint32_t windowWidth, uint32_t windowHeight)
     InitializeGraphicsContext();
     InitializeBezierCurves();
     InitializeImGui();
+
+    // Autosave files are deleted on a clean exit, finding them means the previous session crashed
+    Scene recoveredScene;
+    if (AutosaveJournal::Recover(AUTOSAVE_DIRECTORY, recoveredScene))
+    {
+        if (recoveredScene.Curves.size() == BezierCurveType::NumTypes && recoveredScene.Curves[BezierCurveType::Original].NumControlPoints <= MAX_CONTROL_POINTS)
+        {
+            m_Scene = std::move(recoveredScene);
+            m_NeedsBezierCurvesUpdate = true;
+        }
+        else
+        {
+            std::cout << "Autosave does not contain an editor scene, ignoring it" << std::endl;
+        }
+    }
+
+    m_Journal.SetListener(&m_Autosave);
+    m_Autosave.Start(AUTOSAVE_DIRECTORY, m_Scene);
 }
 
 Application::~Application()
 {
+    m_Journal.SetListener(nullptr);
+    m_Autosave.Stop(true);
+    if (m_ExportThread.joinable())
+    {
+        if (IsExporting())
+            std::cout << "Waiting for the export of " << m_ExportDescription << " to finish" << std::endl;
+        m_ExportThread.join();
+    }
     ShutdownImGui();
 }
 
 void Application::Run()
 {
+    Profiler::SetThreadName("Main");
+
     m_Running = true;
     while (m_Running)
     {
+        // Statistics shown during a frame are the ones of the previous frame
+        Profiler::Update();
+        AllocationTracker::Update();
+
+#if defined(_DEBUG)
+        // An idle frame must not allocate, reported once per streak of allocating frames
+        static bool s_ReportedAllocations = false;
+        const AllocationStats& allocations = AllocationTracker::GetFrameStats();
+        if (!m_FrameChanged && allocations.NumAllocations > 0 && !s_ReportedAllocations)
+        {
+            const char* tag = AllocationTracker::GetTagStats().empty() ? "untagged" : AllocationTracker::GetTagStats()[0].Name;
+            std::cout << "Idle frame made " << allocations.NumAllocations << " heap allocations, most in " << tag << std::endl;
+        }
+        s_ReportedAllocations = !m_FrameChanged && allocations.NumAllocations > 0;
+#endif
+        m_FrameChanged = false;
+
+        PROFILE_SCOPE("Frame");
         OnEvent();
         OnUpdate();
         OnRender();
+
+        m_FrameArena.Reset();
+    }
+}
+
+bool Application::LoadScene(const std::string& filepath)
+{
+    SceneFile sceneFile;
+    if (!sceneFile.Open(filepath, SceneFileLoadFlags_VerifyChecksums))
+        return false;
+
+    const SceneView& scene = sceneFile.GetView();
+
+    // The editor works on a single curve, the first curve of the scene is the original and the second one only carries the polar style
+    m_Scene.Settings = scene.Settings;
+    for (uint32_t i = 0; i < BezierCurveType::NumTypes; i++)
+    {
+        SceneCurve& curve = m_Scene.Curves[i];
+        curve.Color = i < scene.NumCurves ? scene.Curves[i].Color : glm::vec3(1.0f);
+        curve.Thickness = i < scene.NumCurves ? scene.Curves[i].Thickness : 1.0f;
+    }
+
+    if (scene.NumCurves > 0)
+        SetOriginalControlPoints(scene.Positions + scene.Curves[0].FirstControlPoint, scene.Colors + scene.Curves[0].FirstControlPoint, scene.Curves[0].NumControlPoints);
+    else
+        SetOriginalControlPoints(nullptr, nullptr, 0);
+
+    return true;
+}
+
+bool Application::SaveScene(const std::string& filepath)
+{
+    return SaveSceneFile(filepath, m_Scene.GetView());
+}
+
+bool Application::ImportSvg(const std::string& filepath)
+{
+    Scene scene;
+    SceneSvgPathSink sink(scene);
+    if (!ImportSvgFile(filepath, sink))
+        return false;
+
+    if (scene.Curves.empty())
+    {
+        std::cout << "No path segments found in " << filepath << std::endl;
+        return false;
+    }
+
+    // SVG user space is y-down and unbounded, the first segment is fitted into the editor's [-1, 1] square
+    const SceneCurve& curve = scene.Curves[0];
+    glm::vec2* positions = scene.Positions.data() + curve.FirstControlPoint;
+
+    glm::vec2 boundsMin = positions[0];
+    glm::vec2 boundsMax = positions[0];
+    for (uint32_t i = 1; i < curve.NumControlPoints; i++)
+    {
+        boundsMin = glm::min(boundsMin, positions[i]);
+        boundsMax = glm::max(boundsMax, positions[i]);
+    }
+
+    glm::vec2 center = (boundsMin + boundsMax) * 0.5f;
+    float extent = std::max(boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y);
+    float scale = extent > 0.0f ? 1.8f / extent : 1.0f;
+
+    for (uint32_t i = 0; i < curve.NumControlPoints; i++)
+        positions[i] = (positions[i] - center) * glm::vec2(scale, -scale);
+
+    SetOriginalControlPoints(positions, scene.Colors.data() + curve.FirstControlPoint, curve.NumControlPoints);
+    return true;
+}
+
+bool Application::ExportSvg(const std::string& filepath)
+{
+    // Only the curves that are currently drawn in the viewport are exported
+    const bool drawCurve[BezierCurveType::NumTypes] = { m_Scene.Settings.DrawBezierCurve, m_Scene.Settings.DrawPolar };
+
+    Scene scene;
+    for (uint32_t i = 0; i < BezierCurveType::NumTypes; i++)
+    {
+        if (!drawCurve[i])
+            continue;
+
+        scene.AddCurve(m_Scene.Curves[i].Color, m_Scene.Curves[i].Thickness);
+
+        for (const BezierControlPoint& p : m_BezierCurves[i].ControlPoints)
+            scene.AddControlPoint(p.Position, p.Color);
+    }
+
+    return ExportSvgFile(filepath, scene.GetView());
+}
+
+bool Application::ExportAnimation(const std::string& filepath)
+{
+    if (m_Animation.GetNumKeyframes() == 0)
+    {
+        std::cout << "Failed to export " << filepath << ": the animation has no keyframes" << std::endl;
+        return false;
+    }
+
+    FrameStreamSettings settings;
+    settings.Width = ANIMATION_EXPORT_WIDTH;
+    settings.Height = ANIMATION_EXPORT_HEIGHT;
+    settings.FramesPerSecond = ANIMATION_EXPORT_FRAMES_PER_SECOND;
+    settings.NumFrames = uint32_t(std::ceil((m_Animation.GetEndTime() - m_Animation.GetStartTime()) * settings.FramesPerSecond)) + 1;
+    settings.StartTime = m_Animation.GetStartTime();
+    settings.Format = FrameFormat_Y4m;
+    // One hardware thread is left to the editor
+    settings.NumThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+    std::shared_ptr<std::ofstream> file = std::make_shared<std::ofstream>(filepath, std::ios::binary);
+    if (!*file)
+    {
+        std::cout << "Failed to open " << filepath << std::endl;
+        return false;
+    }
+
+    // The export renders copies, the editor may go on changing the scene and the keyframes while it runs
+    std::shared_ptr<const SceneAnimation> animation = std::make_shared<SceneAnimation>(m_Animation);
+    std::shared_ptr<const Scene> scene = std::make_shared<Scene>(m_PreviewAnimation ? m_AnimationRestPose : m_Scene);
+    return StartExport(filepath, [animation, scene, settings, file, filepath]()
+    {
+        FrameStreamStats stats;
+        if (!StreamAnimationFrames(*animation, *scene, settings, *file, stats))
+            return;
+
+        std::cout << "Exported " << stats.NumFrames << " frames to " << filepath << " in " << stats.TotalTime << " s, " << stats.FramesPerSecond << " fps" << std::endl;
+    });
+}
+
+bool Application::ExportImage(const std::string& filepath)
+{
+    StripExportSettings settings;
+    settings.Width = m_ImageExportSize.x;
+    settings.Height = m_ImageExportSize.y;
+    settings.Format = filepath.size() >= 4 && filepath.compare(filepath.size() - 4, 4, ".ppm") == 0 ? ImageFileFormat_Ppm : ImageFileFormat_Tga;
+    settings.View = m_Camera.GetViewTransform(settings.Width, settings.Height);
+    // Fixed sample counts look straight at print sizes, the export always follows the size of the curves
+    settings.SampleTolerance = m_SampleTolerance;
+    // One hardware thread is left to the editor
+    settings.NumThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+    std::shared_ptr<std::ofstream> file = std::make_shared<std::ofstream>(filepath, std::ios::binary);
+    if (!*file)
+    {
+        std::cout << "Failed to open " << filepath << std::endl;
+        return false;
+    }
+
+    // The snapshot is immutable, the editor may go on changing the scene while it is exported
+    std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(m_Scene);
+    return StartExport(filepath, [snapshot, settings, file, filepath]()
+    {
+        StripExportStats stats;
+        if (!ExportImageStrips(*snapshot, settings, *file, stats))
+            return;
+
+        std::cout << "Exported " << settings.Width << "x" << settings.Height << " image to " << filepath << " in " << stats.TotalTime << " s, " <<
+            stats.MegapixelsPerSecond << " megapixels/s, " << stats.PeakResidentBytes / (1024 * 1024) << " MB peak memory" << std::endl;
+    });
+}
+
+bool Application::StartExport(const std::string& description, std::function<void()> task)
+{
+    if (IsExporting())
+    {
+        std::cout << "Failed to export " << description << ": the export of " << m_ExportDescription << " is still running" << std::endl;
+        return false;
+    }
+
+    if (m_ExportThread.joinable())
+        m_ExportThread.join();
+
+    m_ExportDescription = description;
+    m_Exporting.store(true);
+    m_ExportThread = std::thread([this, task]()
+    {
+        Profiler::SetThreadName("Export");
+        task();
+        m_Exporting.store(false);
+    });
+
+    return true;
+}
+
+void Application::SetOriginalControlPoints(const glm::vec2* positions, const glm::vec3* colors, uint32_t numControlPoints)
+{
+    uint32_t numEditablePoints = std::min<uint32_t>(numControlPoints, MAX_CONTROL_POINTS);
+    if (numEditablePoints < numControlPoints)
+        std::cout << "Curve has " << numControlPoints << " control points, only the first " << MAX_CONTROL_POINTS << " are loaded" << std::endl;
+
+    m_Scene.SetControlPoints(BezierCurveType::Original, positions, colors, numEditablePoints);
+
+    // Loading replaces the document, the previous history no longer applies to it
+    m_Journal.Clear();
+    m_Autosave.Reset(m_Scene);
+    m_NeedsBezierCurvesUpdate = true;
+}
+
+// Replaces the original curve by its exact elevation or its reduction, as a single undo step. The control points keep the
+// color of the nearest old control point
+void Application::ChangeOriginalDegree(uint32_t numControlPoints)
+{
+    const SceneCurve& curve = m_Scene.Curves[BezierCurveType::Original];
+    uint32_t oldNumControlPoints = curve.NumControlPoints;
+    glm::vec2 oldPositions[MAX_CONTROL_POINTS];
+    glm::vec3 oldColors[MAX_CONTROL_POINTS];
+    for (uint32_t i = 0; i < oldNumControlPoints; i++)
+    {
+        oldPositions[i] = m_Scene.Positions[curve.FirstControlPoint + i];
+        oldColors[i] = m_Scene.Colors[curve.FirstControlPoint + i];
     }
+
+    glm::vec2 positions[MAX_CONTROL_POINTS + 1];
+    if (numControlPoints > oldNumControlPoints)
+        ElevateBezierDegree(oldPositions, oldNumControlPoints, numControlPoints, positions);
+    else
+        m_LastReductionError = ReduceBezierDegree(oldPositions, oldNumControlPoints, numControlPoints, CURVE_DEGREE_DEFAULT_CONTINUITY, positions);
+
+    while (curve.NumControlPoints < numControlPoints)
+        m_Journal.InsertControlPoint(m_Scene, BezierCurveType::Original, curve.NumControlPoints, glm::vec2(0.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    while (curve.NumControlPoints > numControlPoints)
+        m_Journal.RemoveControlPoint(m_Scene, BezierCurveType::Original, curve.NumControlPoints - 1);
+
+    for (uint32_t i = 0; i < numControlPoints; i++)
+    {
+        uint32_t nearest = numControlPoints > 1 ? (i * (oldNumControlPoints - 1) + (numControlPoints - 1) / 2) / (numControlPoints - 1) : 0;
+        m_Journal.SetControlPointPosition(m_Scene, BezierCurveType::Original, i, positions[i]);
+        m_Journal.SetControlPointColor(m_Scene, BezierCurveType::Original, i, oldColors[nearest]);
+    }
+
+    m_Journal.EndCommand(m_Scene);
+    m_NeedsBezierCurvesUpdate = true;
+}
+
+void Application::SetAnimationPreview(bool preview)
+{
+    if (preview == m_PreviewAnimation)
+        return;
+
+    if (preview)
+        m_AnimationRestPose = m_Scene;
+    else
+        m_Scene = m_AnimationRestPose;
+
+    m_PreviewAnimation = preview;
+    m_PlayAnimation = m_PlayAnimation && preview;
+    m_NeedsBezierCurvesUpdate = true;
+}
+
+void Application::UndoEdit()
+{
+    if (m_Journal.Undo(m_Scene))
+        m_NeedsBezierCurvesUpdate = true;
+}
+
+void Application::RedoEdit()
+{
+    if (m_Journal.Redo(m_Scene))
+        m_NeedsBezierCurvesUpdate = true;
+}
+
+void Application::PublishSceneSnapshot()
+{
+    PROFILE_FUNCTION();
+    ALLOCATION_TAG("Scene Snapshot");
+
+    // Background work reads the scene through published snapshots, a new version is only created when the scene changed
+    std::shared_ptr<const SceneSnapshot> snapshot = SceneSnapshot::Create(m_Scene, m_LastSceneSnapshot);
+    if (snapshot == m_LastSceneSnapshot)
+        return;
+
+    m_FrameChanged = true;
+    m_LastSceneSnapshot = snapshot;
+    m_SceneSnapshots.Publish(std::move(snapshot));
 }
 
 void Application::InitializeGraphicsContext()
@@ -220,6 +638,9 @@ void Application::InitializeBezierCurves()
 {
     for (uint32_t i = 0; i < BezierCurveType::NumTypes; i++)
     {
+        m_Scene.AddCurve();
+        m_BezierCurves[i].ControlPoints.reserve(MAX_CONTROL_POINTS);
+
         D3D11_BUFFER_DESC sbDesc = {};
         sbDesc.ByteWidth = MAX_CONTROL_POINTS * sizeof(BezierControlPoint);
         sbDesc.StructureByteStride = sizeof(BezierControlPoint);
@@ -240,6 +661,8 @@ void Application::InitializeBezierCurves()
 
         DXCall(m_GfxContext.Device->CreateShaderResourceView(m_BezierCurves[i].ControlPointsBuffer.Get(), &srvDesc, &m_BezierCurves[i].ControlPointsBufferSRV));
     }
+
+    m_NeedsBezierCurvesUpdate = true;
 }
 
 void Application::RecreateSwapChainRenderTarget()
@@ -291,22 +714,71 @@ void Application::RecreateViewportTexture()
     DXCall(m_GfxContext.Device->CreateUnorderedAccessView(m_GfxContext.ViewportTexture.Get(), &uavDesc, &m_GfxContext.ViewportTextureUAV));
 }
 
+void Application::UpdateBezierCurves()
+{
+    PROFILE_FUNCTION();
+
+    // The scene holds the document, the curves keep the control points in the layout the shader reads them
+    const SceneCurve& curve = m_Scene.Curves[BezierCurveType::Original];
+    BezierCurve& originalCurve = m_BezierCurves[BezierCurveType::Original];
+
+    originalCurve.ControlPoints.resize(curve.NumControlPoints);
+    for (uint32_t i = 0; i < curve.NumControlPoints; i++)
+    {
+        originalCurve.ControlPoints[i].Position = m_Scene.Positions[curve.FirstControlPoint + i];
+        originalCurve.ControlPoints[i].Color = m_Scene.Colors[curve.FirstControlPoint + i];
+    }
+
+    originalCurve.NeedsControlPointsBufferUpdate = true;
+    originalCurve.NeedsBoundsUpdate = true;
+    originalCurve.NeedsCurvatureUpdate = true;
+    m_NeedsOffsetUpdate = true;
+    m_NeedsConstantBufferUpdate = true;
+
+    m_CurveProjector.SetCurve(m_Scene.Positions.data() + curve.FirstControlPoint, curve.NumControlPoints);
+
+    RecalculateBezierCurvePolar();
+    RecalculatePolarIntersections();
+}
+
 void Application::RecalculateBezierCurvePolar()
 {
     const BezierCurve& originalCurve = m_BezierCurves[BezierCurveType::Original];
     BezierCurve& polarCurve = m_BezierCurves[BezierCurveType::Polar];
 
-    polarCurve.ControlPoints.clear();
-    for (int i = 0; i < originalCurve.ControlPoints.size() - 1; i++)
+    // Resized in place, the buffer is reserved for MAX_CONTROL_POINTS so dragging T1 never reallocates it
+    polarCurve.ControlPoints.resize(originalCurve.ControlPoints.empty() ? 0 : originalCurve.ControlPoints.size() - 1);
+    polarCurve.NeedsControlPointsBufferUpdate = true;
+    polarCurve.NeedsBoundsUpdate = true;
+    polarCurve.NeedsCurvatureUpdate = true;
+
+    for (int i = 0; i < polarCurve.ControlPoints.size(); i++)
     {
         glm::vec2 direction = originalCurve.ControlPoints[i + 1].Position - originalCurve.ControlPoints[i].Position;
 
-        BezierControlPoint& p = polarCurve.ControlPoints.emplace_back();
-        p.Position = originalCurve.ControlPoints[i].Position + direction * m_Settings.T1;
+        BezierControlPoint& p = polarCurve.ControlPoints[i];
+        p.Position = originalCurve.ControlPoints[i].Position + direction * m_Scene.Settings.T1;
         p.Color = { 0.1f, 0.2f, 0.8f };
     }
+}
 
-    polarCurve.NeedsControlPointsBufferUpdate = true;
+void Application::RecalculatePolarIntersections()
+{
+    PROFILE_FUNCTION();
+
+    const BezierCurve& originalCurve = m_BezierCurves[BezierCurveType::Original];
+    const BezierCurve& polarCurve = m_BezierCurves[BezierCurveType::Polar];
+
+    glm::vec2 originalPositions[MAX_CONTROL_POINTS];
+    glm::vec2 polarPositions[MAX_CONTROL_POINTS];
+    for (uint32_t i = 0; i < originalCurve.ControlPoints.size(); i++)
+        originalPositions[i] = originalCurve.ControlPoints[i].Position;
+    for (uint32_t i = 0; i < polarCurve.ControlPoints.size(); i++)
+        polarPositions[i] = polarCurve.ControlPoints[i].Position;
+
+    m_PolarIntersections.clear();
+    IntersectCurves(originalPositions, originalCurve.ControlPoints.size(), polarPositions, polarCurve.ControlPoints.size(), CURVE_INTERSECTION_DEFAULT_TOLERANCE,
+        m_PolarIntersections, m_IntersectionWorkspace);
 }
 
 void Application::InitializeImGui()
@@ -362,6 +834,9 @@ void Application::ShutdownImGui()
 
 void Application::RenderImGui()
 {
+    PROFILE_FUNCTION();
+    ALLOCATION_TAG("UI");
+
     ImGui_ImplDX11_NewFrame();
     ImGui_ImplWin32_NewFrame();
     ImGui::NewFrame();
@@ -388,124 +863,490 @@ void Application::RenderImGui()
     
     ImGui::DockSpace(ImGui::GetID("BezierCurveEditorDockspace"), ImVec2(0.0f, 0.0f));
 
+    if (ImGui::BeginMenuBar())
+    {
+        if (ImGui::BeginMenu("File"))
+        {
+            const char* sceneFilter = "Bezier Scene (*.bzscene)\0*.bzscene\0";
+
+            // The scene holds a preview pose while the animation is previewed, it is neither replaced nor saved
+            if (ImGui::MenuItem("Open Scene...", nullptr, false, !m_PreviewAnimation))
+            {
+                std::string filepath = OpenFileDialog(m_GfxContext.WindowHandle, sceneFilter);
+                if (!filepath.empty())
+                    LoadScene(filepath);
+            }
+
+            if (ImGui::MenuItem("Save Scene As...", nullptr, false, !m_PreviewAnimation))
+            {
+                std::string filepath = SaveFileDialog(m_GfxContext.WindowHandle, sceneFilter, "bzscene");
+                if (!filepath.empty())
+                    SaveScene(filepath);
+            }
+
+            ImGui::Separator();
+
+            const char* svgFilter = "SVG (*.svg)\0*.svg\0All Files (*.*)\0*.*\0";
+
+            if (ImGui::MenuItem("Import SVG...", nullptr, false, !m_PreviewAnimation))
+            {
+                std::string filepath = OpenFileDialog(m_GfxContext.WindowHandle, svgFilter);
+                if (!filepath.empty())
+                    ImportSvg(filepath);
+            }
+
+            if (ImGui::MenuItem("Export SVG..."))
+            {
+                std::string filepath = SaveFileDialog(m_GfxContext.WindowHandle, svgFilter, "svg");
+                if (!filepath.empty())
+                    ExportSvg(filepath);
+            }
+
+            ImGui::Separator();
+
+            const char* y4mFilter = "YUV4MPEG2 Video (*.y4m)\0*.y4m\0All Files (*.*)\0*.*\0";
+
+            if (ImGui::MenuItem("Export Animation...", nullptr, false, m_Animation.GetNumKeyframes() > 0 && !IsExporting()))
+            {
+                std::string filepath = SaveFileDialog(m_GfxContext.WindowHandle, y4mFilter, "y4m");
+                if (!filepath.empty())
+                    ExportAnimation(filepath);
+            }
+
+            const char* imageFilter = "TGA Image (*.tga)\0*.tga\0PPM Image (*.ppm)\0*.ppm\0All Files (*.*)\0*.*\0";
+
+            if (ImGui::MenuItem("Export Image...", nullptr, false, !IsExporting()))
+            {
+                std::string filepath = SaveFileDialog(m_GfxContext.WindowHandle, imageFilter, "tga");
+                if (!filepath.empty())
+                    ExportImage(filepath);
+            }
+
+            ImGui::EndMenu();
+        }
+
+        if (ImGui::BeginMenu("Edit"))
+        {
+            if (ImGui::MenuItem("Undo", "Ctrl+Z", false, m_Journal.CanUndo() && !m_PreviewAnimation))
+                UndoEdit();
+
+            if (ImGui::MenuItem("Redo", "Ctrl+Y", false, m_Journal.CanRedo() && !m_PreviewAnimation))
+                RedoEdit();
+
+            ImGui::EndMenu();
+        }
+
+        if (IsExporting())
+            ImGui::TextDisabled("Exporting %s...", m_ExportDescription.c_str());
+
+        ImGui::EndMenuBar();
+    }
+
+    if (io.KeyCtrl && !io.WantTextInput && !m_PreviewAnimation)
+    {
+        if (ImGui::IsKeyPressed(ImGuiKey_Z) && !io.KeyShift)
+            UndoEdit();
+        else if (ImGui::IsKeyPressed(ImGuiKey_Y) || (ImGui::IsKeyPressed(ImGuiKey_Z) && io.KeyShift))
+            RedoEdit();
+    }
+
     ImGui::Begin("Properties");
 
+    // Edits made during the preview would be lost once the edited pose is put back
+    ImGui::BeginDisabled(m_PreviewAnimation);
+
     if (ImGui::CollapsingHeader("Settings", ImGuiTreeNodeFlags_DefaultOpen))
     {
+        GlobalSettings settings = m_Scene.Settings;
+        bool settingsEdited = false;
+
         ImGui::Columns(2);
         ImGui::SetColumnWidth(0, 100.0f);
         ImGui::Text("Draw Bezier");
         ImGui::NextColumn();
-        m_NeedsConstantBufferUpdate |= ImGui::Checkbox("##DrawBezierCurve", &m_Settings.DrawBezierCurve);
+        settingsEdited |= ImGui::Checkbox("##DrawBezierCurve", &settings.DrawBezierCurve);
         ImGui::Columns(1);
 
         ImGui::Columns(2);
         ImGui::SetColumnWidth(0, 100.0f);
         ImGui::Text("Draw Polar");
         ImGui::NextColumn();
-        m_NeedsConstantBufferUpdate |= ImGui::Checkbox("##DrawPolar", &m_Settings.DrawPolar);
+        settingsEdited |= ImGui::Checkbox("##DrawPolar", &settings.DrawPolar);
         ImGui::Columns(1);
 
         ImGui::Columns(2);
         ImGui::SetColumnWidth(0, 100.0f);
         ImGui::Text("Num Samples");
         ImGui::NextColumn();
-        m_NeedsConstantBufferUpdate |= ImGui::DragInt("##NumSamples", &m_Settings.NumSamples, 1, 25, 100);
+        settingsEdited |= ImGui::DragInt("##NumSamples", &settings.NumSamples, 1, 25, 100);
         ImGui::Columns(1);
 
         ImGui::Columns(2);
         ImGui::SetColumnWidth(0, 100.0f);
         ImGui::Text("t1");
         ImGui::NextColumn();
-        if (ImGui::DragFloat("##t1", &m_Settings.T1, 0.01f, 0.0f, 1.0f))
-            RecalculateBezierCurvePolar();
+        settingsEdited |= ImGui::DragFloat("##t1", &settings.T1, 0.01f, 0.0f, 1.0f);
+        ImGui::Columns(1);
+
+        // Time the CPU renderer may spend on a frame, the rest of the image is refined over the following frames. Not part
+        // of the scene
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("Frame Budget");
+        ImGui::NextColumn();
+        if (ImGui::Checkbox("##ProgressiveRendering", &m_ProgressiveRendering))
+            m_ProgressiveRenderer.Restart();
+        ImGui::SameLine();
+        ImGui::PushItemWidth(80.0f);
+        if (ImGui::DragFloat("##FrameBudget", &m_FrameBudget, 0.1f, 1.0f, 100.0f, "%.1f ms"))
+            m_RenderTimeHistogram.Reset(4.0f * m_FrameBudget);
+        ImGui::PopItemWidth();
         ImGui::Columns(1);
+
+        if (settingsEdited)
+        {
+            m_Journal.SetSettings(m_Scene, settings);
+            m_NeedsBezierCurvesUpdate = true;
+        }
     }
 
     if (ImGui::CollapsingHeader("Bezier Curve", ImGuiTreeNodeFlags_DefaultOpen))
     {
-        BezierCurve& originalCurve = m_BezierCurves[BezierCurveType::Original];
+        glm::vec3 color = m_Scene.Curves[BezierCurveType::Original].Color;
+        float thickness = m_Scene.Curves[BezierCurveType::Original].Thickness;
 
         ImGui::Columns(2);
         ImGui::SetColumnWidth(0, 100.0f);
         ImGui::Text("Color");
         ImGui::NextColumn();
-        m_NeedsConstantBufferUpdate |= ImGui::ColorEdit3("##ColorBezierCurve", glm::value_ptr(originalCurve.Color));
+        if (ImGui::ColorEdit3("##ColorBezierCurve", glm::value_ptr(color)))
+        {
+            m_Journal.SetCurveColor(m_Scene, BezierCurveType::Original, color);
+            m_NeedsConstantBufferUpdate = true;
+        }
         ImGui::Columns(1);
 
         ImGui::Columns(2);
         ImGui::SetColumnWidth(0, 100.0f);
         ImGui::Text("Thickness");
         ImGui::NextColumn();
-        m_NeedsConstantBufferUpdate |= ImGui::DragFloat("##ThicknessBezierCurve", &originalCurve.Thickness, 0.1f, 1.0f, 3.0f);
+        if (ImGui::DragFloat("##ThicknessBezierCurve", &thickness, 0.1f, 1.0f, 3.0f))
+        {
+            m_Journal.SetCurveThickness(m_Scene, BezierCurveType::Original, thickness);
+            m_NeedsConstantBufferUpdate = true;
+        }
         ImGui::Columns(1);
     }
 
     if (ImGui::CollapsingHeader("Bezier Curve Polar", ImGuiTreeNodeFlags_DefaultOpen))
     {
-        BezierCurve& polarCurve = m_BezierCurves[BezierCurveType::Polar];
+        glm::vec3 color = m_Scene.Curves[BezierCurveType::Polar].Color;
+        float thickness = m_Scene.Curves[BezierCurveType::Polar].Thickness;
 
         ImGui::Columns(2);
         ImGui::SetColumnWidth(0, 100.0f);
         ImGui::Text("Color");
         ImGui::NextColumn();
-        m_NeedsConstantBufferUpdate |= ImGui::ColorEdit3("##ColorPolar", glm::value_ptr(polarCurve.Color));
+        if (ImGui::ColorEdit3("##ColorPolar", glm::value_ptr(color)))
+        {
+            m_Journal.SetCurveColor(m_Scene, BezierCurveType::Polar, color);
+            m_NeedsConstantBufferUpdate = true;
+        }
         ImGui::Columns(1);
 
         ImGui::Columns(2);
         ImGui::SetColumnWidth(0, 100.0f);
         ImGui::Text("Thickness");
         ImGui::NextColumn();
-        m_NeedsConstantBufferUpdate |= ImGui::DragFloat("##ThicknessPolar", &polarCurve.Thickness, 0.1f, 1.0f, 3.0f);
+        if (ImGui::DragFloat("##ThicknessPolar", &thickness, 0.1f, 1.0f, 3.0f))
+        {
+            m_Journal.SetCurveThickness(m_Scene, BezierCurveType::Polar, thickness);
+            m_NeedsConstantBufferUpdate = true;
+        }
         ImGui::Columns(1);
     }
 
     if (ImGui::CollapsingHeader("Control Points", ImGuiTreeNodeFlags_DefaultOpen))
     {
-        BezierCurve& originalCurve = m_BezierCurves[BezierCurveType::Original];
+        const SceneCurve& originalCurve = m_Scene.Curves[BezierCurveType::Original];
 
-        if (ImGui::Button("Add") && originalCurve.ControlPoints.size() < MAX_CONTROL_POINTS)
+        if (ImGui::Button("Add") && originalCurve.NumControlPoints < MAX_CONTROL_POINTS)
         {
-            originalCurve.ControlPoints.emplace_back();
-            originalCurve.NeedsControlPointsBufferUpdate = true;
-            m_NeedsConstantBufferUpdate = true;
-
-            RecalculateBezierCurvePolar();
+            m_Journal.InsertControlPoint(m_Scene, BezierCurveType::Original, originalCurve.NumControlPoints, glm::vec2(0.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+            m_NeedsBezierCurvesUpdate = true;
         }
 
-        std::vector<uint32_t> pointsToRemove;
-        for (uint32_t i = 0; i < originalCurve.ControlPoints.size(); i++)
+        // Elevation keeps the curve, reduction moves it by up to the error shown
+        ImGui::SameLine();
+        if (ImGui::Button("Elevate") && originalCurve.NumControlPoints > 0 && originalCurve.NumControlPoints < MAX_CONTROL_POINTS)
+            ChangeOriginalDegree(originalCurve.NumControlPoints + 1);
+        ImGui::SameLine();
+        if (ImGui::Button("Reduce") && originalCurve.NumControlPoints > 2)
+            ChangeOriginalDegree(originalCurve.NumControlPoints - 1);
+        ImGui::SameLine();
+        ImGui::Text("Reduction error: %.5f", m_LastReductionError);
+
+        FrameVector<uint32_t> pointsToRemove{ FrameArenaAllocator<uint32_t>(m_FrameArena) };
+        for (uint32_t i = 0; i < originalCurve.NumControlPoints; i++)
         {
+            glm::vec2 position = m_Scene.Positions[originalCurve.FirstControlPoint + i];
+            glm::vec3 color = m_Scene.Colors[originalCurve.FirstControlPoint + i];
+
             ImGui::Separator();
             ImGui::PushID(i);
-            if (ImGui::Button("X") && originalCurve.ControlPoints.size())
+            if (ImGui::Button("X"))
             {
                 pointsToRemove.push_back(i);
             }
-            if (DrawVec2Control("Position", originalCurve.ControlPoints[i].Position, 100.0f))
+            if (DrawVec2Control("Position", position, 100.0f))
             {
-                originalCurve.NeedsControlPointsBufferUpdate = true;
-                RecalculateBezierCurvePolar();
+                m_Journal.SetControlPointPosition(m_Scene, BezierCurveType::Original, i, position);
+                m_NeedsBezierCurvesUpdate = true;
+            }
+            if (DrawColorEdit("Color", color, 100.0f))
+            {
+                m_Journal.SetControlPointColor(m_Scene, BezierCurveType::Original, i, color);
+                m_NeedsBezierCurvesUpdate = true;
             }
-            originalCurve.NeedsControlPointsBufferUpdate |= DrawColorEdit("Color", originalCurve.ControlPoints[i].Color, 100.0f);
             ImGui::PopID();
         }
 
         if (!pointsToRemove.empty())
         {
-            for (uint32_t i : pointsToRemove)
-                originalCurve.ControlPoints.erase(originalCurve.ControlPoints.begin() + i);
+            // Remove from the back so the remaining indices stay valid
+            for (auto it = pointsToRemove.rbegin(); it != pointsToRemove.rend(); it++)
+                m_Journal.RemoveControlPoint(m_Scene, BezierCurveType::Original, *it);
+
+            m_NeedsBezierCurvesUpdate = true;
+        }
+    }
+
+    if (ImGui::CollapsingHeader("History"))
+    {
+        int step = m_Journal.GetCurrentStep();
+
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("Step");
+        ImGui::NextColumn();
+        if (ImGui::SliderInt("##HistoryStep", &step, m_Journal.GetFirstStep(), m_Journal.GetLastStep()) && m_Journal.JumpTo(m_Scene, step))
+            m_NeedsBezierCurvesUpdate = true;
+        ImGui::Columns(1);
+
+        ImGui::Text("Memory: %.1f / %.1f KB, %u keyframes", m_Journal.GetMemoryUsage() / 1024.0f, m_Journal.GetMemoryBudget() / 1024.0f, m_Journal.GetNumKeyframes());
+        if (m_Autosave.IsRunning())
+            ImGui::Text("Autosave: %llu edits, %u compactions, %u overflows", (unsigned long long)m_Autosave.GetNumRecordsWritten(), m_Autosave.GetNumCompactions(), m_Autosave.GetNumOverflows());
+        else
+            ImGui::TextUnformatted("Autosave: disabled");
+    }
+
+    if (ImGui::CollapsingHeader("Tools"))
+    {
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("Nearest Point");
+        ImGui::NextColumn();
+        ImGui::Checkbox("##ShowNearestPoint", &m_ShowNearestPoint);
+        ImGui::Columns(1);
+
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("Intersections");
+        ImGui::NextColumn();
+        ImGui::Checkbox("##ShowPolarIntersections", &m_ShowPolarIntersections);
+        ImGui::SameLine();
+        ImGui::Text("%u with polar", (uint32_t)m_PolarIntersections.size());
+        ImGui::Columns(1);
+
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("Bounds");
+        ImGui::NextColumn();
+        ImGui::Checkbox("##ShowBounds", &m_ShowBounds);
+        ImGui::Columns(1);
+
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("Curvature");
+        ImGui::NextColumn();
+        ImGui::Checkbox("##ShowCurvatureComb", &m_ShowCurvatureComb);
+        ImGui::SameLine();
+        ImGui::PushItemWidth(80.0f);
+        ImGui::DragFloat("##CurvatureCombScale", &m_CurvatureCombScale, 0.0005f, 0.0f, 1.0f, "%.4f");
+        ImGui::PopItemWidth();
+        ImGui::Columns(1);
+
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("Offset");
+        ImGui::NextColumn();
+        ImGui::Checkbox("##ShowOffset", &m_ShowOffset);
+        ImGui::SameLine();
+        ImGui::PushItemWidth(80.0f);
+        if (ImGui::DragFloat("##OffsetDistance", &m_OffsetDistance, 0.001f, 0.0f, 1.0f, "%.3f"))
+            m_NeedsOffsetUpdate = true;
+        ImGui::PopItemWidth();
+        ImGui::SameLine();
+        ImGui::Text("%u segments, %u cusps", m_OffsetStats.NumSegments, m_OffsetStats.NumCusps);
+        ImGui::Columns(1);
+
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("Sketch");
+        ImGui::NextColumn();
+        ImGui::Checkbox("##SketchMode", &m_SketchMode);
+        ImGui::SameLine();
+        ImGui::Text("%u segments", (uint32_t)m_Sketch.Curves.size());
+        ImGui::SameLine();
+        if (ImGui::Button("Clear##Sketch"))
+            m_Sketch.Clear();
+        ImGui::Columns(1);
+    }
+
+    ImGui::EndDisabled();
+
+    if (ImGui::CollapsingHeader("Animation"))
+    {
+        float endTime = std::max(m_Animation.GetEndTime(), 1.0f);
+
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("Time");
+        ImGui::NextColumn();
+        bool timeChanged = ImGui::SliderFloat("##AnimationTime", &m_AnimationTime, 0.0f, endTime, "%.2f s");
+        ImGui::Columns(1);
+
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("Keyframes");
+        ImGui::NextColumn();
+        ImGui::BeginDisabled(m_PreviewAnimation);
+        if (ImGui::Button("Set Key"))
+            m_Animation.SetKeyframe(m_AnimationTime, m_Scene);
+        ImGui::EndDisabled();
+        ImGui::SameLine();
+        if (ImGui::Button("Clear##Animation"))
+        {
+            SetAnimationPreview(false);
+            m_Animation.Clear();
+        }
+        ImGui::SameLine();
+        ImGui::Text("%u", m_Animation.GetNumKeyframes());
+        ImGui::Columns(1);
 
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("Preview");
+        ImGui::NextColumn();
+        bool preview = m_PreviewAnimation;
+        if (ImGui::Checkbox("##PreviewAnimation", &preview))
+        {
+            SetAnimationPreview(preview && m_Animation.GetNumKeyframes() > 0);
+            timeChanged = true;
+        }
+        ImGui::SameLine();
+        ImGui::BeginDisabled(!m_PreviewAnimation);
+        ImGui::Checkbox("Play", &m_PlayAnimation);
+        ImGui::EndDisabled();
+        ImGui::Columns(1);
+
+        if (m_PlayAnimation)
+        {
+            // Loops over the keyframes
+            m_AnimationTime += io.DeltaTime;
+            if (m_AnimationTime > m_Animation.GetEndTime())
+                m_AnimationTime = m_Animation.GetStartTime();
+            timeChanged = true;
+        }
+
+        if (m_PreviewAnimation && timeChanged)
+        {
+            m_Animation.Evaluate(m_AnimationTime, m_Scene);
+            m_NeedsBezierCurvesUpdate = true;
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Renderer"))
+    {
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("CPU Renderer");
+        ImGui::NextColumn();
+        // The GPU draws over the viewport texture, the CPU image is uploaded again once it is back
+        if (ImGui::Checkbox("##UseCpuRenderer", &m_UseCpuRenderer))
+            m_ProgressiveRenderer.Restart();
+        ImGui::Columns(1);
+
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("View");
+        ImGui::NextColumn();
+        ImGui::Text("Zoom %.3gx", m_Camera.Zoom);
+        ImGui::SameLine();
+        if (ImGui::Button("Reset##View"))
+        {
+            m_Camera = ViewCamera();
+            m_NeedsConstantBufferUpdate = true;
+        }
+        ImGui::Columns(1);
+
+        // Samples follow the size of the curves in the viewport instead of Num Samples, zooming in refines the curves
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("Adaptive");
+        ImGui::NextColumn();
+        if (ImGui::Checkbox("##AdaptiveSampling", &m_AdaptiveSampling))
+            m_NeedsConstantBufferUpdate = true;
+        ImGui::SameLine();
+        ImGui::PushItemWidth(80.0f);
+        if (ImGui::DragFloat("##SampleTolerance", &m_SampleTolerance, 0.01f, 0.05f, 4.0f, "%.2f px"))
             m_NeedsConstantBufferUpdate = true;
-            originalCurve.NeedsControlPointsBufferUpdate = true;
+        ImGui::PopItemWidth();
+        ImGui::Columns(1);
+
+        // Size of Export Image, TGA files take up to 65535 pixels on each side and PPM files any size
+        ImGui::Columns(2);
+        ImGui::SetColumnWidth(0, 100.0f);
+        ImGui::Text("Export Size");
+        ImGui::NextColumn();
+        ImGui::DragInt2("##ImageExportSize", glm::value_ptr(m_ImageExportSize), 16.0f, 1, IMAGE_EXPORT_MAX_SIZE);
+        ImGui::Columns(1);
+
+        if (m_UseCpuRenderer)
+        {
+            const CpuRenderStats& stats = m_ProgressiveRendering ? m_ProgressiveRenderer.GetRenderStats() : m_CpuRenderer.GetStats();
+            ImGui::Text("Threads: %u", m_JobSystem.GetNumThreads());
+            ImGui::Text("Evaluate: %.3f ms, %u samples", stats.EvaluateTime, stats.NumSamples);
+            ImGui::Text("Tessellate: %.3f ms, %u primitives", stats.TessellateTime, stats.NumPrimitives);
+            ImGui::Text("Bin: %.3f ms, %u tile entries", stats.BinTime, stats.NumBinnedPrimitives);
+            ImGui::Text("Culled: %u curves, %u polygons outside the image", stats.NumCulledCurves, stats.NumCulledPolygons);
+            ImGui::Text("Rasterize: %.3f ms", stats.RasterizeTime);
+
+            if (m_ProgressiveRendering)
+            {
+                const ProgressiveRenderStats& progressiveStats = m_ProgressiveRenderer.GetStats();
+                ImGui::Text("Progressive: 1/%u coarse pass over %u frames, %u of %u rows refined", progressiveStats.CoarseScale, progressiveStats.CoarsePassFrames,
+                    progressiveStats.NumRefinedRows, m_ProgressiveRenderer.GetImage().Height);
+            }
 
-            if (!originalCurve.ControlPoints.empty())
-                RecalculateBezierCurvePolar();
+            // Render time of every frame up to four times the budget, the last bar also counts longer frames
+            char overlay[64];
+            snprintf(overlay, sizeof(overlay), "p50 %.1f ms, p99 %.1f ms", m_RenderTimeHistogram.GetPercentile(0.5f), m_RenderTimeHistogram.GetPercentile(0.99f));
+            ImGui::PlotHistogram("##RenderTimes", m_RenderTimeHistogram.GetCounts(), m_RenderTimeHistogram.GetNumBuckets(), 0, overlay, 0.0f, FLT_MAX,
+                ImVec2(ImGui::GetContentRegionAvail().x, 60.0f));
+            if (ImGui::Button("Reset##RenderTimes"))
+                m_RenderTimeHistogram.Reset(4.0f * m_FrameBudget);
         }
     }
 
+    // Edits made while a widget is held (e.g. dragging a point) are merged into one undo step
+    if (!ImGui::IsAnyItemActive())
+        m_Journal.EndCommand(m_Scene);
+
     ImGui::End();
 
+    RenderProfilerPanel();
+
     // Scene viewport
     ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
     ImGui::Begin("Viewport", 0, ImGuiWindowFlags_NoScrollWithMouse | ImGuiWindowFlags_NoScrollbar);
@@ -518,6 +1359,7 @@ void Application::RenderImGui()
     }
     
     ImGui::Image((ImTextureID)m_GfxContext.ViewportTextureSRV.Get(), { m_ViewportSize.x, m_ViewportSize.y });
+    RenderViewportOverlay();
     ImGui::End();
     ImGui::PopStyleVar();
     
@@ -534,8 +1376,265 @@ void Application::RenderImGui()
     ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
 }
 
+void Application::RenderProfilerPanel()
+{
+    ImGui::Begin("Profiler");
+
+    bool enabled = Profiler::IsEnabled();
+    if (ImGui::Checkbox("Enabled", &enabled))
+        Profiler::SetEnabled(enabled);
+
+    ImGui::SameLine();
+    if (ImGui::Button("Reset"))
+        Profiler::ResetStats();
+
+    ImGui::SameLine();
+    if (ImGui::Button("Save Trace..."))
+    {
+        std::string filepath = SaveFileDialog(m_GfxContext.WindowHandle, "Chrome Trace (*.json)\0*.json\0", "json");
+        if (!filepath.empty())
+            Profiler::WriteChromeTrace(filepath);
+    }
+
+    const AllocationStats& allocations = AllocationTracker::GetFrameStats();
+    ImGui::Text("Allocations: %llu (%.1f KB), frees: %llu", (unsigned long long)allocations.NumAllocations, allocations.BytesAllocated / 1024.0f, (unsigned long long)allocations.NumFrees);
+    ImGui::Text("Frame arena: %.1f KB peak, %.1f KB reserved", m_FrameArena.GetPeakBytesUsed() / 1024.0f, m_FrameArena.GetCapacity() / 1024.0f);
+
+    if (ImGui::CollapsingHeader("Allocation Tags"))
+    {
+        if (ImGui::BeginTable("AllocationTags", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable))
+        {
+            ImGui::TableSetupColumn("Tag", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableSetupColumn("Frame");
+            ImGui::TableSetupColumn("Frame KB");
+            ImGui::TableSetupColumn("Total");
+            ImGui::TableHeadersRow();
+
+            for (const AllocationTagStats& stats : AllocationTracker::GetTagStats())
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(stats.Name);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", (unsigned long long)stats.FrameAllocations);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", stats.FrameBytes / 1024.0f);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", (unsigned long long)stats.NumAllocations);
+            }
+
+            ImGui::EndTable();
+        }
+    }
+
+    // GPU zones only measure the time to submit the work
+    const ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+    if (ImGui::BeginTable("ProfilerZones", 6, tableFlags))
+    {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Zone", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Frame ms");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("Avg ms");
+        ImGui::TableSetupColumn("Min ms");
+        ImGui::TableSetupColumn("Max ms");
+        ImGui::TableHeadersRow();
+
+        for (const ProfileZoneStats& stats : Profiler::GetZoneStats())
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(stats.Name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.FrameTime * 1e-6);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", stats.FrameCalls);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.TotalTime * 1e-6 / stats.NumCalls);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.MinTime * 1e-6);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.MaxTime * 1e-6);
+        }
+
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+// Drawn over the viewport image, which must be the last item submitted
+void Application::RenderViewportOverlay()
+{
+    PROFILE_FUNCTION();
+
+    ImVec2 viewportMin = ImGui::GetItemRectMin();
+    ImVec2 viewportMax = ImGui::GetItemRectMax();
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+    // The wheel zooms around the mouse, dragging with the middle button pans
+    ImGuiIO& io = ImGui::GetIO();
+    if (ImGui::IsItemHovered() && (io.MouseWheel != 0.0f || (ImGui::IsMouseDown(ImGuiMouseButton_Middle) && (io.MouseDelta.x != 0.0f || io.MouseDelta.y != 0.0f))))
+    {
+        uint32_t width = m_ViewportSize.x;
+        uint32_t height = m_ViewportSize.y;
+        if (io.MouseWheel != 0.0f)
+        {
+            glm::vec2 mouseView = glm::vec2((io.MousePos.x - viewportMin.x) / (viewportMax.x - viewportMin.x) * 2.0f - 1.0f, 1.0f - (io.MousePos.y - viewportMin.y) / (viewportMax.y - viewportMin.y) * 2.0f);
+            m_Camera.ZoomAt(mouseView, std::pow(1.2f, io.MouseWheel), width, height);
+        }
+        if (ImGui::IsMouseDown(ImGuiMouseButton_Middle))
+            m_Camera.Pan({ io.MouseDelta.x, io.MouseDelta.y }, width, height);
+
+        m_NeedsConstantBufferUpdate = true;
+        m_FrameChanged = true;
+    }
+
+    ViewTransform view = m_Camera.GetViewTransform(m_ViewportSize.x, m_ViewportSize.y);
+
+    if (m_SketchMode)
+    {
+        // Takes the mouse over the image, so dragging draws instead of moving the window. Samples are fitted as they come in
+        ImGui::SetCursorScreenPos(viewportMin);
+        ImGui::InvisibleButton("##SketchInput", { viewportMax.x - viewportMin.x, viewportMax.y - viewportMin.y });
+        if (ImGui::IsItemActivated())
+        {
+            m_SketchFitter.BeginStroke();
+            m_SketchStroke.clear();
+        }
+
+        if (ImGui::IsItemActive())
+        {
+            glm::vec2 sample = ViewportToScene(io.MousePos, viewportMin, viewportMax, view);
+            if (m_SketchStroke.empty() || m_SketchStroke.back() != sample)
+            {
+                m_SketchFitter.AddSample(sample);
+                m_SketchStroke.push_back(sample);
+            }
+        }
+
+        if (ImGui::IsItemDeactivated())
+        {
+            m_SketchFitter.EndStroke();
+            m_SketchStroke.clear();
+        }
+
+        for (const SceneCurve& curve : m_Sketch.Curves)
+        {
+            const glm::vec2* points = &m_Sketch.Positions[curve.FirstControlPoint];
+            drawList->AddBezierCubic(SceneToViewport(points[0], viewportMin, viewportMax, view), SceneToViewport(points[1], viewportMin, viewportMax, view),
+                SceneToViewport(points[2], viewportMin, viewportMax, view), SceneToViewport(points[3], viewportMin, viewportMax, view), IM_COL32(255, 150, 25, 255), 2.0f);
+        }
+
+        // The raw stroke stays visible until the samples held back by the fitter are fitted when the stroke ends
+        ImVec2* strokePoints = m_FrameArena.AllocateArray<ImVec2>(m_SketchStroke.size());
+        for (size_t i = 0; i < m_SketchStroke.size(); i++)
+            strokePoints[i] = SceneToViewport(m_SketchStroke[i], viewportMin, viewportMax, view);
+        drawList->AddPolyline(strokePoints, m_SketchStroke.size(), IM_COL32(255, 255, 255, 96), 0, 1.0f);
+    }
+
+    if (m_ShowBounds)
+    {
+        // Exact bounds of the drawn curves, with the looser bounds of their control points for comparison
+        bool isDrawn[BezierCurveType::NumTypes] = { m_Scene.Settings.DrawBezierCurve, m_Scene.Settings.DrawPolar };
+        for (uint32_t i = 0; i < BezierCurveType::NumTypes; i++)
+        {
+            BezierCurve& curve = m_BezierCurves[i];
+            if (!isDrawn[i] || curve.ControlPoints.empty())
+                continue;
+
+            glm::vec2 controlPointsMin = curve.ControlPoints[0].Position;
+            glm::vec2 controlPointsMax = curve.ControlPoints[0].Position;
+            for (const BezierControlPoint& controlPoint : curve.ControlPoints)
+            {
+                controlPointsMin = glm::min(controlPointsMin, controlPoint.Position);
+                controlPointsMax = glm::max(controlPointsMax, controlPoint.Position);
+            }
+
+            UpdateBezierCurveBounds(curve);
+            drawList->AddRect(SceneToViewport({ controlPointsMin.x, controlPointsMax.y }, viewportMin, viewportMax, view),
+                SceneToViewport({ controlPointsMax.x, controlPointsMin.y }, viewportMin, viewportMax, view), IM_COL32(255, 255, 255, 64));
+            drawList->AddRect(SceneToViewport({ curve.BoundsMin.x, curve.BoundsMax.y }, viewportMin, viewportMax, view),
+                SceneToViewport({ curve.BoundsMax.x, curve.BoundsMin.y }, viewportMin, viewportMax, view), IM_COL32(0, 255, 160, 255), 0.0f, 0, 1.5f);
+        }
+    }
+
+    if (m_ShowCurvatureComb)
+    {
+        // Teeth point away from the center of curvature, their tips are joined into the comb's envelope
+        bool isDrawn[BezierCurveType::NumTypes] = { m_Scene.Settings.DrawBezierCurve, m_Scene.Settings.DrawPolar };
+        for (uint32_t i = 0; i < BezierCurveType::NumTypes; i++)
+        {
+            BezierCurve& curve = m_BezierCurves[i];
+            if (!isDrawn[i] || curve.ControlPoints.size() < 2)
+                continue;
+
+            UpdateBezierCurveCurvature(curve);
+            ImVec2* tips = m_FrameArena.AllocateArray<ImVec2>(curve.CurvatureFrames.size());
+            for (size_t j = 0; j < curve.CurvatureFrames.size(); j++)
+            {
+                const CurveFrame& frame = curve.CurvatureFrames[j];
+                ImVec2 base = SceneToViewport(frame.Point, viewportMin, viewportMax, view);
+                tips[j] = SceneToViewport(frame.Point - frame.Normal * (frame.Curvature * m_CurvatureCombScale), viewportMin, viewportMax, view);
+                drawList->AddLine(base, tips[j], IM_COL32(255, 120, 200, 128));
+            }
+            drawList->AddPolyline(tips, curve.CurvatureFrames.size(), IM_COL32(255, 120, 200, 255), 0, 1.5f);
+        }
+    }
+
+    const BezierCurve& originalCurve = m_BezierCurves[BezierCurveType::Original];
+    if (m_ShowOffset && m_Scene.Settings.DrawBezierCurve && !originalCurve.ControlPoints.empty())
+    {
+        if (m_NeedsOffsetUpdate)
+        {
+            glm::vec2 positions[MAX_CONTROL_POINTS];
+            for (uint32_t i = 0; i < originalCurve.ControlPoints.size(); i++)
+                positions[i] = originalCurve.ControlPoints[i].Position;
+
+            m_OffsetSegments.clear();
+            m_OffsetStats = {};
+            OffsetBezier(positions, originalCurve.ControlPoints.size(), m_OffsetDistance, CURVE_OFFSET_DEFAULT_TOLERANCE, m_OffsetSegments, m_OffsetStats);
+            OffsetBezier(positions, originalCurve.ControlPoints.size(), -m_OffsetDistance, CURVE_OFFSET_DEFAULT_TOLERANCE, m_OffsetSegments, m_OffsetStats);
+            m_NeedsOffsetUpdate = false;
+        }
+
+        for (size_t i = 0; i + 3 < m_OffsetSegments.size(); i += 4)
+        {
+            const glm::vec2* points = &m_OffsetSegments[i];
+            drawList->AddBezierCubic(SceneToViewport(points[0], viewportMin, viewportMax, view), SceneToViewport(points[1], viewportMin, viewportMax, view),
+                SceneToViewport(points[2], viewportMin, viewportMax, view), SceneToViewport(points[3], viewportMin, viewportMax, view), IM_COL32(120, 200, 255, 255), 1.5f);
+        }
+    }
+
+    if (m_ShowPolarIntersections && m_Scene.Settings.DrawBezierCurve && m_Scene.Settings.DrawPolar)
+    {
+        // Overlaps are marked at their start, filled to tell them apart from crossings
+        for (const CurveIntersection& intersection : m_PolarIntersections)
+        {
+            ImVec2 center = SceneToViewport(intersection.Point, viewportMin, viewportMax, view);
+            if (intersection.IsOverlap)
+                drawList->AddCircleFilled(center, 6.0f, IM_COL32(255, 220, 0, 255));
+            else
+                drawList->AddCircle(center, 6.0f, IM_COL32(255, 220, 0, 255), 0, 2.0f);
+        }
+    }
+
+    if (m_ShowNearestPoint && ImGui::IsItemHovered() && !m_CurveProjector.IsEmpty())
+    {
+        ImVec2 mousePosition = io.MousePos;
+        CurveProjection projection = m_CurveProjector.Project(ViewportToScene(mousePosition, viewportMin, viewportMax, view));
+
+        ImVec2 nearestPoint = SceneToViewport(projection.Point, viewportMin, viewportMax, view);
+        drawList->AddLine(mousePosition, nearestPoint, IM_COL32(255, 255, 255, 128));
+        drawList->AddCircleFilled(nearestPoint, 4.0f, IM_COL32(255, 255, 255, 255));
+        ImGui::SetTooltip("t = %.4f\ndistance = %.4f", projection.T, projection.Distance);
+    }
+}
+
 void Application::RenderBezierCurves()
 {
+    PROFILE_FUNCTION();
+
     const uint32_t THREAD_COUNT_X = 8;
     const uint32_t THREAD_COUNT_Y = 8;
 
@@ -558,8 +1657,43 @@ void Application::RenderBezierCurves()
     m_GfxContext.DeviceContext->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
 }
 
+void Application::RenderBezierCurvesCpu()
+{
+    PROFILE_FUNCTION();
+    ALLOCATION_TAG("CPU Renderer");
+
+    std::shared_ptr<const SceneSnapshot> scene = m_SceneSnapshots.Acquire();
+    if (!scene)
+        return;
+
+    float sampleTolerance = m_AdaptiveSampling ? m_SampleTolerance : 0.0f;
+    ViewTransform view = m_Camera.GetViewTransform(m_ViewportSize.x, m_ViewportSize.y);
+    if (m_ProgressiveRendering)
+    {
+        // Frames with nothing left to refine leave the texture as it is
+        m_ProgressiveRenderer.SetFrameBudget(m_FrameBudget);
+        m_ProgressiveRenderer.SetSampleTolerance(sampleTolerance);
+        bool changed = m_ProgressiveRenderer.Update(scene, m_ViewportSize.x, m_ViewportSize.y, view);
+        m_RenderTimeHistogram.Add(m_ProgressiveRenderer.GetStats().FrameTime);
+        if (!changed)
+            return;
+
+        const CpuImage& image = m_ProgressiveRenderer.GetImage();
+        m_GfxContext.DeviceContext->UpdateSubresource(m_GfxContext.ViewportTexture.Get(), 0, nullptr, image.Pixels.data(), image.Width * sizeof(uint32_t), 0);
+        return;
+    }
+
+    m_CpuRenderer.SetSampleTolerance(sampleTolerance);
+    m_CpuRenderer.Render(*scene, m_ViewportSize.x, m_ViewportSize.y, m_CpuImage, view);
+    const CpuRenderStats& stats = m_CpuRenderer.GetStats();
+    m_RenderTimeHistogram.Add(stats.EvaluateTime + stats.TessellateTime + stats.BinTime + stats.RasterizeTime);
+    m_GfxContext.DeviceContext->UpdateSubresource(m_GfxContext.ViewportTexture.Get(), 0, nullptr, m_CpuImage.Pixels.data(), m_CpuImage.Width * sizeof(uint32_t), 0);
+}
+
 void Application::OnEvent()
 {
+    PROFILE_FUNCTION();
+
     MSG msg = {};
     while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
     {
@@ -573,24 +1707,52 @@ void Application::OnEvent()
 
 void Application::OnUpdate()
 {
+    PROFILE_FUNCTION();
+    ALLOCATION_TAG("Update");
+
     if (m_NeedsResize)
     {
         RecreateViewportTexture();
         m_NeedsResize = false;
+        m_NeedsConstantBufferUpdate = true;
+        m_FrameChanged = true;
     }
 
+    if (m_NeedsBezierCurvesUpdate)
+    {
+        UpdateBezierCurves();
+        m_NeedsBezierCurvesUpdate = false;
+    }
+
+    // The preview pose is not part of the document
+    if (!m_PreviewAnimation)
+        m_Autosave.Update(m_Scene);
+    PublishSceneSnapshot();
+
     if (m_NeedsConstantBufferUpdate)
     {
+        PROFILE_SCOPE("Upload Constant Buffer");
+
         BezierCurveShaderConstants constants;
-        constants.BezierColor = m_BezierCurves[BezierCurveType::Original].Color;
-        constants.BezierThickness = m_BezierCurves[BezierCurveType::Original].Thickness;
-        constants.PolarColor = m_BezierCurves[BezierCurveType::Polar].Color;
-        constants.PolarThickness = m_BezierCurves[BezierCurveType::Polar].Thickness;
+        constants.BezierColor = m_Scene.Curves[BezierCurveType::Original].Color;
+        constants.BezierThickness = m_Scene.Curves[BezierCurveType::Original].Thickness;
+        constants.PolarColor = m_Scene.Curves[BezierCurveType::Polar].Color;
+        constants.PolarThickness = m_Scene.Curves[BezierCurveType::Polar].Thickness;
         constants.NumControlPoints = m_BezierCurves[BezierCurveType::Original].ControlPoints.size();
-        constants.NumSamples = m_Settings.NumSamples;
-        constants.T1 = m_Settings.T1;
-        constants.DrawBezierCurve = m_Settings.DrawBezierCurve;
-        constants.DrawPolar = m_Settings.DrawPolar;
+        constants.NumSamples = m_Scene.Settings.NumSamples;
+        constants.PolarNumSamples = m_Scene.Settings.NumSamples;
+        constants.T1 = m_Scene.Settings.T1;
+        constants.DrawBezierCurve = m_Scene.Settings.DrawBezierCurve;
+        constants.DrawPolar = m_Scene.Settings.DrawPolar;
+
+        ViewTransform view = m_Camera.GetViewTransform(m_ViewportSize.x, m_ViewportSize.y);
+        constants.ViewScale = view.Scale;
+        constants.ViewOffset = view.Offset;
+        if (m_AdaptiveSampling)
+        {
+            constants.NumSamples = GetBezierCurveSampleCount(m_BezierCurves[BezierCurveType::Original], view, m_ViewportSize.x, m_ViewportSize.y, m_SampleTolerance);
+            constants.PolarNumSamples = GetBezierCurveSampleCount(m_BezierCurves[BezierCurveType::Polar], view, m_ViewportSize.x, m_ViewportSize.y, m_SampleTolerance);
+        }
 
         D3D11_MAPPED_SUBRESOURCE msr = {};
         m_GfxContext.DeviceContext->Map(m_GfxContext.BezierCurveConstantBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &msr);
@@ -604,6 +1766,8 @@ void Application::OnUpdate()
     {
         if (m_BezierCurves[i].NeedsControlPointsBufferUpdate)
         {
+            PROFILE_SCOPE("Upload Control Points Buffer");
+
             D3D11_MAPPED_SUBRESOURCE msr = {};
             m_GfxContext.DeviceContext->Map(m_BezierCurves[i].ControlPointsBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &msr);
             memcpy(msr.pData, m_BezierCurves[i].ControlPoints.data(), sizeof(BezierControlPoint) * m_BezierCurves[i].ControlPoints.size());
@@ -616,8 +1780,16 @@ void Application::OnUpdate()
 
 void Application::OnRender()
 {
-    RenderBezierCurves();
+    PROFILE_FUNCTION();
+
+    if (m_UseCpuRenderer)
+        RenderBezierCurvesCpu();
+    else
+        RenderBezierCurves();
+
     RenderImGui();
+
+    PROFILE_SCOPE("Present");
     DXCall(m_GfxContext.SwapChain->Present(1, 0));
 }
 
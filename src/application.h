@@ -1,10 +1,43 @@
 #pragma once
 
 #include "directx11.h"
+#include "scene.h"
+#include "editjournal.h"
+#include "autosave.h"
+#include "scenesnapshot.h"
+#include "jobsystem.h"
+#include "cpurenderer.h"
+#include "profiler.h"
+#include "allocationtracker.h"
+#include "framearena.h"
+#include "curveprojection.h"
+#include "curveintersection.h"
+#include "curvebounds.h"
+#include "curvefitter.h"
+#include "curveoffset.h"
+#include "curvedegree.h"
+#include "curvature.h"
+#include "animation.h"
+#include "viewcamera.h"
+#include "progressiverenderer.h"
 
 #include <glm/glm.hpp>
 
+#include <atomic>
+#include <functional>
+#include <thread>
+
 #define MAX_CONTROL_POINTS 5
+// Teeth of the curvature comb, at evenly spaced parameters
+#define CURVATURE_COMB_TEETH 128
+#define AUTOSAVE_DIRECTORY "autosave"
+// Frames written by Export Animation, from the first to the last keyframe
+#define ANIMATION_EXPORT_WIDTH 1920
+#define ANIMATION_EXPORT_HEIGHT 1080
+#define ANIMATION_EXPORT_FRAMES_PER_SECOND 30
+// Size of the images written by Export Image, which renders the viewport's view a band at a time whatever the size
+#define IMAGE_EXPORT_DEFAULT_SIZE 8192
+#define IMAGE_EXPORT_MAX_SIZE (1 << 18)
 
 struct GraphicsContext
 {
@@ -25,14 +58,6 @@ struct GraphicsContext
     ComPtr<ID3D11UnorderedAccessView> ViewportTextureUAV;
 };
 
-struct GlobalSettings
-{
-    bool DrawBezierCurve = true;
-    bool DrawPolar = true;
-    int NumSamples = 50;
-    float T1 = 0.5f;
-};
-
 struct BezierCurveShaderConstants
 {
     glm::vec3 BezierColor = glm::vec3(1.0f);
@@ -44,6 +69,9 @@ struct BezierCurveShaderConstants
     float T1 = 0.5f;
     int DrawBezierCurve = 1;
     int DrawPolar = 1;
+    int PolarNumSamples = 100;
+    glm::vec2 ViewScale = glm::vec2(1.0f);
+    glm::vec2 ViewOffset = glm::vec2(0.0f);
 };
 
 struct BezierControlPoint
@@ -59,12 +87,18 @@ enum BezierCurveType
     NumTypes
 };
 
+// GPU side of a curve, the curve style and the edited control points live in the application's scene
 struct BezierCurve
 {
-    glm::vec3 Color = glm::vec3(1.0f);
-    float Thickness = 1.0f;
     std::vector<BezierControlPoint> ControlPoints;
     bool NeedsControlPointsBufferUpdate = false;
+    // Exact bounds of the curve, recomputed on first use after the control points changed
+    glm::vec2 BoundsMin = glm::vec2(0.0f);
+    glm::vec2 BoundsMax = glm::vec2(0.0f);
+    bool NeedsBoundsUpdate = true;
+    // Frames of the curvature comb, recomputed on first use after the control points changed
+    std::vector<CurveFrame> CurvatureFrames;
+    bool NeedsCurvatureUpdate = true;
 
     ComPtr<ID3D11Buffer> ControlPointsBuffer;
     ComPtr<ID3D11ShaderResourceView> ControlPointsBufferSRV;
@@ -77,17 +111,38 @@ public:
     ~Application();
 
     void Run();
+    bool LoadScene(const std::string& filepath);
+    bool SaveScene(const std::string& filepath);
+    bool ImportSvg(const std::string& filepath);
+    bool ExportSvg(const std::string& filepath);
+    bool ExportAnimation(const std::string& filepath);
+    bool ExportImage(const std::string& filepath);
 private:
+    // Exports run one at a time on a thread of their own, the editor keeps going while they take minutes
+    bool StartExport(const std::string& description, std::function<void()> task);
+    bool IsExporting() const { return m_Exporting.load(); }
+
     void InitializeGraphicsContext();
     void InitializeBezierCurves();
     void RecreateSwapChainRenderTarget();
     void RecreateViewportTexture();
+    void UpdateBezierCurves();
     void RecalculateBezierCurvePolar();
+    void RecalculatePolarIntersections();
+    void SetOriginalControlPoints(const glm::vec2* positions, const glm::vec3* colors, uint32_t numControlPoints);
+    void ChangeOriginalDegree(uint32_t numControlPoints);
+    void UndoEdit();
+    void RedoEdit();
+    void SetAnimationPreview(bool preview);
+    void PublishSceneSnapshot();
 
     void InitializeImGui();
     void ShutdownImGui();
     void RenderImGui();
+    void RenderProfilerPanel();
+    void RenderViewportOverlay();
     void RenderBezierCurves();
+    void RenderBezierCurvesCpu();
 
     void OnEvent();
     void OnUpdate();
@@ -103,7 +158,65 @@ private:
     glm::vec2 m_ViewportSize = glm::vec2(1.0f);
     bool m_NeedsResize = false;
     bool m_NeedsConstantBufferUpdate = false;
-    GlobalSettings m_Settings;
+    bool m_NeedsBezierCurvesUpdate = false;
+    Scene m_Scene;
+    EditJournal m_Journal;
+    AutosaveJournal m_Autosave;
+    SceneSnapshotPublisher m_SceneSnapshots;
+    std::shared_ptr<const SceneSnapshot> m_LastSceneSnapshot;
+    JobSystem m_JobSystem;
+    CpuRenderer m_CpuRenderer{ m_JobSystem };
+    CpuImage m_CpuImage;
+    bool m_UseCpuRenderer = false;
+    // The CPU renderer draws a coarse image within the frame budget after every change and refines it over the next frames
+    ProgressiveRenderer m_ProgressiveRenderer{ m_JobSystem };
+    bool m_ProgressiveRendering = true;
+    float m_FrameBudget = PROGRESSIVE_DEFAULT_FRAME_BUDGET;
+    FrameTimeHistogram m_RenderTimeHistogram;
+    // Pan and zoom of the viewport, applied by both renderers and by everything drawn or picked over the viewport
+    ViewCamera m_Camera;
+    bool m_AdaptiveSampling = false;
+    float m_SampleTolerance = VIEW_DEFAULT_SAMPLE_TOLERANCE;
+    glm::ivec2 m_ImageExportSize = glm::ivec2(IMAGE_EXPORT_DEFAULT_SIZE);
+    std::thread m_ExportThread;
+    std::atomic<bool> m_Exporting{ false };
+    std::string m_ExportDescription;
+    // Closest point queries against the original curve, rebuilt whenever its control points change
+    CurveProjector m_CurveProjector;
+    bool m_ShowNearestPoint = true;
+    // Where the original curve meets its polar, updated together with the polar
+    std::vector<CurveIntersection> m_PolarIntersections;
+    CurveIntersectionWorkspace m_IntersectionWorkspace;
+    bool m_ShowPolarIntersections = true;
+    bool m_ShowBounds = false;
+    // Teeth along the normal of the drawn curves, as long as the curvature times the scale
+    bool m_ShowCurvatureComb = false;
+    float m_CurvatureCombScale = 0.02f;
+    // Offsets of the original curve on both sides, approximated by cubic segments once the curve or the distance changed
+    std::vector<glm::vec2> m_OffsetSegments;
+    CurveOffsetStats m_OffsetStats;
+    float m_OffsetDistance = 0.05f;
+    bool m_ShowOffset = false;
+    bool m_NeedsOffsetUpdate = true;
+    // Error bound of the last degree reduction of the original curve
+    float m_LastReductionError = 0.0f;
+    // Keyframed poses of the scene. The preview poses the scene at the current time without recording edits, the pose that
+    // was being edited is put back once the preview ends
+    SceneAnimation m_Animation;
+    Scene m_AnimationRestPose;
+    float m_AnimationTime = 0.0f;
+    bool m_PreviewAnimation = false;
+    bool m_PlayAnimation = false;
+    // Strokes drawn over the viewport, fitted into cubic segments that are kept apart from the edited scene
+    Scene m_Sketch;
+    SceneSvgPathSink m_SketchSink{ m_Sketch, glm::vec3(1.0f, 0.6f, 0.1f) };
+    CurveFitter m_SketchFitter{ m_SketchSink };
+    std::vector<glm::vec2> m_SketchStroke;
+    bool m_SketchMode = false;
+    // Transient data of the current frame, reset once the frame is presented
+    FrameArena m_FrameArena;
+    // Set by frames that changed the scene or the viewport, only the other frames are expected not to allocate
+    bool m_FrameChanged = false;
     BezierCurve m_BezierCurves[BezierCurveType::NumTypes];
     GraphicsContext m_GfxContext;
 };
\ No newline at end of file
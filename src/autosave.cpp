@@ -0,0 +1,410 @@
+#include "autosave.h"
+#include "scenefile.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+struct AutosaveControlPoint
+{
+    glm::vec2 Position;
+    glm::vec3 Color;
+};
+
+static_assert(sizeof(AutosaveControlPoint) <= sizeof(AutosaveRecord::Value), "Control point does not fit into an autosave record");
+
+static void SyncFile(FILE* file)
+{
+    fflush(file);
+#if defined(_WIN32)
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+
+static bool SyncFile(const std::string& filepath)
+{
+    FILE* file = fopen(filepath.c_str(), "rb+");
+    if (!file)
+        return false;
+
+    SyncFile(file);
+    fclose(file);
+    return true;
+}
+
+// A rename is only durable once the directory holding the file is synced as well. The CRT has no way to sync a directory on
+// Windows, NTFS journals the rename as metadata
+static bool SyncDirectory(const std::string& directory)
+{
+#if defined(_WIN32)
+    (void)directory;
+    return true;
+#else
+    int file = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (file < 0)
+        return false;
+
+    bool succeeded = fsync(file) == 0;
+    close(file);
+    return succeeded;
+#endif
+}
+
+// Records come from disk during recovery, so everything they address is validated before it is touched
+static bool ApplyRecord(Scene& scene, const AutosaveRecord& record)
+{
+    if (record.Curve >= scene.Curves.size() && !(record.Type == AutosaveRecord_SetField && record.Field <= EditDelta_T1))
+        return false;
+
+    switch (record.Type)
+    {
+        case AutosaveRecord_SetField:
+        {
+            EditDeltaType type = (EditDeltaType)record.Field;
+            if (type > EditDelta_ControlPointColor)
+                return false;
+
+            if (type >= EditDelta_ControlPointPosition && record.Index >= scene.Curves[record.Curve].NumControlPoints)
+                return false;
+
+            memcpy(GetSceneFieldPointer(scene, type, record.Curve, record.Index), record.Value, GetSceneFieldSize(type));
+            return true;
+        }
+        case AutosaveRecord_InsertControlPoint:
+        {
+            if (record.Index > scene.Curves[record.Curve].NumControlPoints)
+                return false;
+
+            AutosaveControlPoint point;
+            memcpy(&point, record.Value, sizeof(AutosaveControlPoint));
+            scene.InsertControlPoint(record.Curve, record.Index, point.Position, point.Color);
+            return true;
+        }
+        case AutosaveRecord_RemoveControlPoint:
+        {
+            if (record.Index >= scene.Curves[record.Curve].NumControlPoints)
+                return false;
+
+            scene.RemoveControlPoint(record.Curve, record.Index);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+AutosaveJournal::AutosaveJournal(uint32_t queueCapacity, uint32_t compactionThreshold)
+    : m_Queue(queueCapacity), m_CompactionThreshold(compactionThreshold)
+{
+}
+
+AutosaveJournal::~AutosaveJournal()
+{
+    Stop(false);
+}
+
+bool AutosaveJournal::Start(const std::string& directory, const Scene& scene)
+{
+    if (IsRunning())
+        return false;
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+    {
+        std::cout << "Failed to create autosave directory: " << directory << std::endl;
+        return false;
+    }
+
+    m_SnapshotPath = directory + "/autosave.bzscene";
+    m_JournalPath = directory + "/autosave.bzjournal";
+
+    // The thread is not running yet, so the replica can be initialized here and the first snapshot written synchronously
+    m_Replica = scene;
+    if (!Compact())
+        return false;
+
+    m_NeedsResync = false;
+    m_StopRequested.store(false, std::memory_order_relaxed);
+    m_Thread = std::thread(&AutosaveJournal::ThreadMain, this);
+    return true;
+}
+
+void AutosaveJournal::Stop(bool clean)
+{
+    if (!IsRunning())
+        return;
+
+    m_StopRequested.store(true, std::memory_order_release);
+    m_Thread.join();
+
+    if (m_JournalFile)
+    {
+        fclose(m_JournalFile);
+        m_JournalFile = nullptr;
+    }
+
+    if (clean)
+    {
+        std::error_code error;
+        std::filesystem::remove(m_JournalPath, error);
+        std::filesystem::remove(m_SnapshotPath, error);
+    }
+}
+
+void AutosaveJournal::Reset(const Scene& scene)
+{
+    if (!IsRunning())
+        return;
+
+    // Anything that could not be queued since the last overflow is covered by this snapshot as well
+    m_NeedsResync = !PushSnapshot(scene);
+}
+
+void AutosaveJournal::Update(const Scene& scene)
+{
+    if (m_NeedsResync)
+        Reset(scene);
+}
+
+bool AutosaveJournal::Recover(const std::string& directory, Scene& scene)
+{
+    SceneFile snapshot;
+    if (!std::filesystem::exists(directory + "/autosave.bzscene") || !snapshot.Open(directory + "/autosave.bzscene", SceneFileLoadFlags_VerifyChecksums))
+        return false;
+
+    scene.CopyFrom(snapshot.GetView());
+
+    FILE* file = fopen((directory + "/autosave.bzjournal").c_str(), "rb");
+    if (!file)
+        return true;
+
+    AutosaveJournalHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.Magic != AUTOSAVE_JOURNAL_MAGIC || header.Version != AUTOSAVE_JOURNAL_VERSION ||
+        header.SnapshotChecksum != snapshot.GetHeaderChecksum())
+    {
+        fclose(file);
+        return true;
+    }
+
+    // The tail of the journal may be torn by the crash, replay stops at the first record that was not written completely
+    uint32_t numRecords = 0;
+    AutosaveRecordFrame frame;
+    AutosaveRecord record;
+    while (fread(&frame, sizeof(frame), 1, file) == 1 && fread(&record, sizeof(record), 1, file) == 1)
+    {
+        if (frame.Sequence != numRecords || frame.Checksum != ComputeSceneFileChecksum(&record, sizeof(record)))
+            break;
+
+        if (!ApplyRecord(scene, record))
+        {
+            std::cout << "Autosave journal record " << numRecords << " does not apply to the recovered scene" << std::endl;
+            break;
+        }
+
+        numRecords++;
+    }
+
+    fclose(file);
+    std::cout << "Recovered autosave with " << numRecords << " journaled edits" << std::endl;
+    return true;
+}
+
+void AutosaveJournal::OnFieldChanged(EditDeltaType type, uint32_t curve, uint32_t index, const void* value, uint32_t valueSize)
+{
+    AutosaveRecord record = {};
+    record.Type = AutosaveRecord_SetField;
+    record.Field = type;
+    record.Curve = curve;
+    record.Index = index;
+    memcpy(record.Value, value, std::min<uint32_t>(valueSize, sizeof(record.Value)));
+    PushRecord(record);
+}
+
+void AutosaveJournal::OnControlPointInserted(uint32_t curve, uint32_t index, const glm::vec2& position, const glm::vec3& color)
+{
+    AutosaveControlPoint point = { position, color };
+
+    AutosaveRecord record = {};
+    record.Type = AutosaveRecord_InsertControlPoint;
+    record.Curve = curve;
+    record.Index = index;
+    memcpy(record.Value, &point, sizeof(point));
+    PushRecord(record);
+}
+
+void AutosaveJournal::OnControlPointRemoved(uint32_t curve, uint32_t index)
+{
+    AutosaveRecord record = {};
+    record.Type = AutosaveRecord_RemoveControlPoint;
+    record.Curve = curve;
+    record.Index = index;
+    PushRecord(record);
+}
+
+void AutosaveJournal::OnSceneReset(const Scene& scene)
+{
+    Reset(scene);
+}
+
+void AutosaveJournal::PushRecord(const AutosaveRecord& record)
+{
+    // After an overflow the I/O thread's scene is missing edits, later records are meaningless until a snapshot resynchronizes it
+    if (!IsRunning() || m_NeedsResync)
+        return;
+
+    AutosaveMessage message = { record, nullptr };
+    if (!m_Queue.Push(message))
+    {
+        m_NeedsResync = true;
+        m_NumOverflows++;
+    }
+}
+
+bool AutosaveJournal::PushSnapshot(const Scene& scene)
+{
+    AutosaveMessage message = {};
+    message.Snapshot = new Scene(scene);
+    if (m_Queue.Push(message))
+        return true;
+
+    delete message.Snapshot;
+    return false;
+}
+
+void AutosaveJournal::ThreadMain()
+{
+    Profiler::SetThreadName("Autosave");
+
+    using Clock = std::chrono::steady_clock;
+    const auto syncInterval = std::chrono::seconds(1);
+
+    auto lastSyncTime = Clock::now();
+    bool needsSync = false;
+
+    while (true)
+    {
+        // Read before draining, so everything pushed before Stop() is still written
+        bool stopRequested = m_StopRequested.load(std::memory_order_acquire);
+
+        uint32_t numMessages = 0;
+        AutosaveMessage message;
+        while (m_Queue.Pop(message))
+        {
+            if (message.Snapshot)
+            {
+                m_Replica = std::move(*message.Snapshot);
+                delete message.Snapshot;
+                Compact();
+            }
+            else
+            {
+                WriteRecord(message.Record);
+                if (m_NumRecordsSinceCompaction >= m_CompactionThreshold)
+                    Compact();
+            }
+
+            numMessages++;
+        }
+
+        // Records reach the OS after every batch so they survive an application crash, syncing to the disk to survive
+        // a power loss is rate limited since it can take several milliseconds
+        if (numMessages > 0 && m_JournalFile)
+        {
+            fflush(m_JournalFile);
+            needsSync = true;
+        }
+
+        if (needsSync && m_JournalFile && (stopRequested || Clock::now() - lastSyncTime >= syncInterval))
+        {
+            PROFILE_SCOPE("Sync Autosave Journal");
+            SyncFile(m_JournalFile);
+            lastSyncTime = Clock::now();
+            needsSync = false;
+        }
+
+        if (stopRequested)
+            break;
+
+        if (numMessages == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
+
+void AutosaveJournal::WriteRecord(const AutosaveRecord& record)
+{
+    if (!ApplyRecord(m_Replica, record) || !m_JournalFile)
+        return;
+
+    AutosaveRecordFrame frame;
+    frame.Sequence = m_NextSequence++;
+    frame.Checksum = ComputeSceneFileChecksum(&record, sizeof(record));
+
+    fwrite(&frame, sizeof(frame), 1, m_JournalFile);
+    fwrite(&record, sizeof(record), 1, m_JournalFile);
+
+    m_NumRecordsSinceCompaction++;
+    m_NumRecordsWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool AutosaveJournal::Compact()
+{
+    PROFILE_FUNCTION();
+
+    // The new snapshot only replaces the old one once it is completely on disk. A crash before the journal is recreated
+    // leaves the old journal behind, which no longer matches the snapshot checksum and is ignored on recovery
+    const std::string temporaryPath = m_SnapshotPath + ".tmp";
+
+    uint32_t snapshotChecksum = 0;
+    if (!SaveSceneFile(temporaryPath, m_Replica.GetView(), &snapshotChecksum) || !SyncFile(temporaryPath))
+        return false;
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, m_SnapshotPath, error);
+    if (error)
+    {
+        std::cout << "Failed to replace autosave snapshot: " << m_SnapshotPath << std::endl;
+        return false;
+    }
+
+    // Truncating the journal against a snapshot whose rename could still be lost in a crash would lose both
+    if (!SyncDirectory(std::filesystem::path(m_SnapshotPath).parent_path().string()))
+    {
+        std::cout << "Failed to sync autosave directory of " << m_SnapshotPath << std::endl;
+        return false;
+    }
+
+    if (m_JournalFile)
+        fclose(m_JournalFile);
+
+    m_JournalFile = fopen(m_JournalPath.c_str(), "wb");
+    if (!m_JournalFile)
+    {
+        std::cout << "Failed to create autosave journal: " << m_JournalPath << std::endl;
+        return false;
+    }
+
+    AutosaveJournalHeader header = {};
+    header.Magic = AUTOSAVE_JOURNAL_MAGIC;
+    header.Version = AUTOSAVE_JOURNAL_VERSION;
+    header.SnapshotChecksum = snapshotChecksum;
+    fwrite(&header, sizeof(header), 1, m_JournalFile);
+    SyncFile(m_JournalFile);
+
+    m_NextSequence = 0;
+    m_NumRecordsSinceCompaction = 0;
+    m_NumCompactions.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
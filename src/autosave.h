@@ -0,0 +1,121 @@
+#pragma once
+
+#include "scene.h"
+#include "editjournal.h"
+#include "spscqueue.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+// Autosave directory layout:
+//   autosave.bzscene    full scene snapshot in the binary scene format
+//   autosave.bzjournal  AutosaveJournalHeader followed by AutosaveRecordFrame + AutosaveRecord pairs
+// The journal names the snapshot it applies to by its header checksum, so a journal left behind by a crash during
+// compaction is detected and ignored instead of being replayed onto the wrong snapshot
+#define AUTOSAVE_JOURNAL_MAGIC 0x4A415A42 // "BZAJ"
+#define AUTOSAVE_JOURNAL_VERSION 1
+
+enum AutosaveRecordType : uint8_t
+{
+    AutosaveRecord_SetField = 0,
+    AutosaveRecord_InsertControlPoint,
+    AutosaveRecord_RemoveControlPoint,
+};
+
+struct AutosaveRecord
+{
+    uint8_t Type;
+    uint8_t Field; // EditDeltaType of AutosaveRecord_SetField records
+    uint16_t Reserved;
+    uint32_t Curve;
+    uint32_t Index;
+    uint8_t Value[20]; // Field value, or position and color of an inserted control point
+};
+
+struct AutosaveRecordFrame
+{
+    uint32_t Sequence;
+    uint32_t Checksum; // CRC-32C of the record
+};
+
+struct AutosaveJournalHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t SnapshotChecksum;
+    uint32_t Reserved;
+};
+
+static_assert(sizeof(AutosaveRecord) == 32, "Autosave record layout changed");
+static_assert(sizeof(AutosaveRecordFrame) == 8, "Autosave record frame layout changed");
+static_assert(sizeof(AutosaveJournalHeader) == 16, "Autosave journal header layout changed");
+
+// A record, or a whole scene that replaces the I/O thread's copy when Snapshot is set. The I/O thread takes ownership of the snapshot
+struct AutosaveMessage
+{
+    AutosaveRecord Record;
+    Scene* Snapshot;
+};
+
+// Crash recovery journal. Scene edits reported by the edit journal are handed to a dedicated I/O thread through a lock-free
+// queue, so the UI thread never waits on the disk. The I/O thread keeps its own copy of the scene, appends every edit to the
+// journal file and periodically compacts the journal into a fresh snapshot
+class AutosaveJournal : public EditJournalListener
+{
+public:
+    AutosaveJournal(uint32_t queueCapacity = 65536, uint32_t compactionThreshold = 16384);
+    ~AutosaveJournal();
+
+    AutosaveJournal(const AutosaveJournal&) = delete;
+    AutosaveJournal& operator=(const AutosaveJournal&) = delete;
+
+    bool Start(const std::string& directory, const Scene& scene);
+    // A clean stop deletes the autosave files, as there is nothing left to recover
+    void Stop(bool clean);
+
+    // Replaces the journaled scene, used when the document is replaced without going through the edit journal
+    void Reset(const Scene& scene);
+    // Called once per frame, resynchronizes the I/O thread with a snapshot after the queue overflowed
+    void Update(const Scene& scene);
+
+    // Loads the snapshot left in directory and replays the journal records that belong to it
+    static bool Recover(const std::string& directory, Scene& scene);
+
+    void OnFieldChanged(EditDeltaType type, uint32_t curve, uint32_t index, const void* value, uint32_t valueSize) override;
+    void OnControlPointInserted(uint32_t curve, uint32_t index, const glm::vec2& position, const glm::vec3& color) override;
+    void OnControlPointRemoved(uint32_t curve, uint32_t index) override;
+    void OnSceneReset(const Scene& scene) override;
+
+    bool IsRunning() const { return m_Thread.joinable(); }
+    uint64_t GetNumRecordsWritten() const { return m_NumRecordsWritten.load(std::memory_order_relaxed); }
+    uint32_t GetNumCompactions() const { return m_NumCompactions.load(std::memory_order_relaxed); }
+    uint32_t GetNumOverflows() const { return m_NumOverflows; }
+private:
+    void PushRecord(const AutosaveRecord& record);
+    bool PushSnapshot(const Scene& scene);
+
+    void ThreadMain();
+    void WriteRecord(const AutosaveRecord& record);
+    bool Compact();
+private:
+    SpscQueue<AutosaveMessage> m_Queue;
+    uint32_t m_CompactionThreshold;
+    std::string m_SnapshotPath;
+    std::string m_JournalPath;
+    std::thread m_Thread;
+    std::atomic<bool> m_StopRequested{ false };
+
+    // UI thread state
+    bool m_NeedsResync = false;
+    uint32_t m_NumOverflows = 0;
+
+    // I/O thread state
+    Scene m_Replica;
+    FILE* m_JournalFile = nullptr;
+    uint32_t m_NextSequence = 0;
+    uint32_t m_NumRecordsSinceCompaction = 0;
+    std::atomic<uint64_t> m_NumRecordsWritten{ 0 };
+    std::atomic<uint32_t> m_NumCompactions{ 0 };
+};
@@ -0,0 +1,218 @@
+#include "batchrender.h"
+#include "cpurenderer.h"
+#include "jobsystem.h"
+#include "scenefile.h"
+#include "scenesnapshot.h"
+#include "stripexporter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+static float GetMilliseconds(Clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+// Everything a worker keeps from one scene to the next
+struct BatchWorker
+{
+    explicit BatchWorker(uint32_t numThreads)
+        : Jobs(numThreads), Renderer(Jobs)
+    {
+    }
+
+    JobSystem Jobs;
+    CpuRenderer Renderer;
+    Scene SceneData;
+    CpuImage Band;
+    std::vector<uint8_t> Data;
+};
+
+static bool RenderScene(BatchWorker& worker, const BatchRenderSettings& settings, const std::vector<uint8_t>& header, BatchSceneStats& stats)
+{
+    Clock::time_point start = Clock::now();
+    std::shared_ptr<const SceneSnapshot> snapshot;
+    {
+        SceneFile sceneFile;
+        if (!sceneFile.Open(stats.ScenePath))
+            return false;
+
+        worker.SceneData.CopyFrom(sceneFile.GetView());
+        snapshot = SceneSnapshot::Create(worker.SceneData);
+    }
+
+    stats.NumCurves = (uint32_t)snapshot->Curves.size();
+    stats.LoadTime = GetMilliseconds(start);
+
+    std::ofstream file(stats.ImagePath, std::ios::binary);
+    if (!file)
+    {
+        std::cout << "Failed to open " << stats.ImagePath << std::endl;
+        return false;
+    }
+
+    worker.Data.assign(header.begin(), header.end());
+    ViewTransform view = ViewCamera().GetViewTransform(settings.Width, settings.Height);
+    for (uint32_t firstRow = 0; firstRow < settings.Height && file; firstRow += settings.BandHeight)
+    {
+        start = Clock::now();
+        uint32_t numRows = std::min(settings.BandHeight, settings.Height - firstRow);
+        worker.Renderer.RenderRows(*snapshot, settings.Width, settings.Height, firstRow, numRows, worker.Band, view);
+        if (settings.Format == ImageFileFormat_Tga)
+            EncodeTgaRows(worker.Band.Pixels.data(), worker.Band.Width, worker.Band.Height, worker.Data);
+        else
+            EncodePpmRows(worker.Band.Pixels.data(), worker.Band.Width, worker.Band.Height, worker.Data);
+        stats.RenderTime += GetMilliseconds(start);
+
+        start = Clock::now();
+        file.write(reinterpret_cast<const char*>(worker.Data.data()), worker.Data.size());
+        stats.NumBytes += worker.Data.size();
+        worker.Data.clear();
+        stats.WriteTime += GetMilliseconds(start);
+    }
+
+    start = Clock::now();
+    file.close();
+    stats.WriteTime += GetMilliseconds(start);
+    if (!file)
+    {
+        std::cout << "Failed to write " << stats.ImagePath << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool RenderSceneBatch(const std::vector<std::string>& scenePaths, const BatchRenderSettings& settings, BatchRenderStats& stats)
+{
+    stats = BatchRenderStats();
+    if (settings.Width == 0 || settings.Height == 0 || settings.BandHeight == 0)
+    {
+        std::cout << "Failed to render scenes: the image size and band height must not be zero" << std::endl;
+        return false;
+    }
+
+    if (settings.Width > BATCH_RENDER_MAX_SIZE || settings.Height > BATCH_RENDER_MAX_SIZE || settings.NumThreads > BATCH_RENDER_MAX_THREADS)
+    {
+        std::cout << "Failed to render scenes: images are at most " << BATCH_RENDER_MAX_SIZE << " pixels on each side and batches use at most " <<
+            BATCH_RENDER_MAX_THREADS << " threads" << std::endl;
+        return false;
+    }
+
+    // Every image has the same header
+    std::vector<uint8_t> header;
+    if (settings.Format == ImageFileFormat_Tga)
+    {
+        if (!EncodeTgaHeader(settings.Width, settings.Height, header))
+        {
+            std::cout << "Failed to render scenes: " << settings.Width << "x" << settings.Height << " is too large for a TGA file" << std::endl;
+            return false;
+        }
+    }
+    else
+    {
+        EncodePpmHeader(settings.Width, settings.Height, header);
+    }
+
+    // Scenes of the same name in different directories would overwrite each others' images
+    const char* extension = settings.Format == ImageFileFormat_Tga ? ".tga" : ".ppm";
+    stats.Scenes.resize(scenePaths.size());
+    std::set<std::string> imagePaths;
+    for (size_t i = 0; i < scenePaths.size(); i++)
+    {
+        BatchSceneStats& scene = stats.Scenes[i];
+        scene.ScenePath = scenePaths[i];
+        scene.ImagePath = (std::filesystem::path(settings.OutputDirectory) / std::filesystem::path(scenePaths[i]).stem()).string() + extension;
+        if (!imagePaths.insert(scene.ImagePath).second)
+        {
+            std::cout << "Failed to render scenes: more than one scene would be written to " << scene.ImagePath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(settings.OutputDirectory, error);
+    if (error)
+    {
+        std::cout << "Failed to create " << settings.OutputDirectory << ": " << error.message() << std::endl;
+        return false;
+    }
+
+    Clock::time_point start = Clock::now();
+    uint32_t numScenes = (uint32_t)scenePaths.size();
+    uint32_t numThreads = settings.NumThreads > 0 ? settings.NumThreads : std::max(std::thread::hardware_concurrency(), 1u);
+    uint32_t numWorkers = std::max(std::min(numThreads, numScenes), 1u);
+    stats.NumWorkers = numWorkers;
+
+    std::mutex mutex;
+    std::atomic<uint32_t> nextScene{ 0 };
+    uint32_t numDoneScenes = 0;
+    bool isStarted = false;
+
+    auto renderScenes = [&](uint32_t workerIndex)
+    {
+        // Threads left over by fewer scenes than threads go to the job systems of the workers
+        uint32_t numWorkerThreads = numThreads / numWorkers + (workerIndex < numThreads % numWorkers ? 1 : 0);
+        BatchWorker worker(numWorkerThreads);
+        worker.Renderer.SetSampleTolerance(settings.SampleTolerance);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!isStarted)
+                stats.StartupTime = std::chrono::duration<float>(Clock::now() - start).count();
+            isStarted = true;
+        }
+
+        for (uint32_t index = nextScene++; index < numScenes; index = nextScene++)
+        {
+            BatchSceneStats& scene = stats.Scenes[index];
+            scene.Succeeded = RenderScene(worker, settings, header, scene);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            numDoneScenes++;
+            if (!scene.Succeeded)
+                std::cout << "[" << numDoneScenes << "/" << numScenes << "] Failed to render " << scene.ScenePath << std::endl;
+            else if (settings.Verbose)
+                std::cout << "[" << numDoneScenes << "/" << numScenes << "] " << scene.ScenePath << " -> " << scene.ImagePath << ": " << scene.NumCurves <<
+                    " curves, load " << scene.LoadTime << " ms, render " << scene.RenderTime << " ms, write " << scene.WriteTime << " ms" << std::endl;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.BandBytes += worker.Band.Pixels.capacity() * sizeof(uint32_t) + worker.Data.capacity();
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < numWorkers; i++)
+        threads.emplace_back(renderScenes, i);
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    uint32_t numRenderedScenes = 0;
+    for (const BatchSceneStats& scene : stats.Scenes)
+    {
+        stats.NumBytes += scene.NumBytes;
+        if (scene.Succeeded)
+            numRenderedScenes++;
+        else
+            stats.NumFailed++;
+    }
+
+    stats.TotalTime = std::chrono::duration<float>(Clock::now() - start).count();
+    if (stats.TotalTime > 0.0f)
+    {
+        stats.ScenesPerSecond = numRenderedScenes / stats.TotalTime;
+        stats.MegapixelsPerSecond = float(double(settings.Width) * settings.Height * numRenderedScenes * 1e-6 / stats.TotalTime);
+    }
+
+    stats.PeakResidentBytes = GetPeakResidentBytes();
+    return stats.NumFailed == 0;
+}
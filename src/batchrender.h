@@ -0,0 +1,67 @@
+#pragma once
+
+#include "imagefile.h"
+#include "viewcamera.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Limits of the settings. A band of the default height at the largest width holds 256 MB of pixels, more threads are a typo
+#define BATCH_RENDER_MAX_SIZE (1 << 18)
+#define BATCH_RENDER_MAX_THREADS 1024
+
+struct BatchRenderSettings
+{
+    uint32_t Width = 1920;
+    uint32_t Height = 1080;
+    ImageFileFormat Format = ImageFileFormat_Tga;
+    // Images are written to OutputDirectory/<scene file name>.tga or .ppm, the directory is created if needed
+    std::string OutputDirectory = ".";
+    // Sample tolerance of the renderer in pixels of the image, 0 samples every curve NumSamples times
+    float SampleTolerance = VIEW_DEFAULT_SAMPLE_TOLERANCE;
+    // Rows a worker renders and encodes at once
+    uint32_t BandHeight = 256;
+    // Threads of the whole batch, 0 uses one per hardware thread
+    uint32_t NumThreads = 0;
+    // Prints a line per scene as it is done
+    bool Verbose = true;
+};
+
+struct BatchSceneStats
+{
+    std::string ScenePath;
+    std::string ImagePath;
+    bool Succeeded = false;
+    uint32_t NumCurves = 0;
+    // Milliseconds spent on each stage, encoding counts as rendering
+    float LoadTime = 0.0f;
+    float RenderTime = 0.0f;
+    float WriteTime = 0.0f;
+    uint64_t NumBytes = 0;
+};
+
+struct BatchRenderStats
+{
+    std::vector<BatchSceneStats> Scenes;
+    uint32_t NumFailed = 0;
+    uint32_t NumWorkers = 0;
+    // Seconds from the call to the first worker being ready to render, and to the last image being written
+    float StartupTime = 0.0f;
+    float TotalTime = 0.0f;
+    float ScenesPerSecond = 0.0f;
+    float MegapixelsPerSecond = 0.0f;
+    uint64_t NumBytes = 0;
+    // Band images and encoded bands of the workers, the memory the batch itself holds besides the scenes being rendered
+    uint64_t BandBytes = 0;
+    // Peak resident memory of the whole process once the batch is done, 0 where it is not known
+    uint64_t PeakResidentBytes = 0;
+};
+
+// Renders every scene file into an image of its own with the CPU renderer. The threads are split into workers that each
+// take the next scene as soon as they are done with the last one, one per thread as long as there are enough scenes and
+// fewer workers with more threads each otherwise. A worker keeps its renderer, scene and buffers from scene to scene and
+// renders, encodes and writes a band of BandHeight rows at a time, so memory stays within a scene and a few bands per worker
+// whatever the number of scenes and the size of the images. Scenes that fail to load or write are reported and skipped.
+// Returns false if any scene failed or the settings are out of range
+bool RenderSceneBatch(const std::vector<std::string>& scenePaths, const BatchRenderSettings& settings, BatchRenderStats& stats);
@@ -0,0 +1,396 @@
+#include "bezier.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#if defined(BEZIER_SIMD_ENABLED)
+#include <emmintrin.h>
+#endif
+
+#define BEZIER_GENERIC_STACK_POINTS 64
+
+static glm::vec2 Lerp(const glm::vec2& a, const glm::vec2& b, float t)
+{
+    return a + (b - a) * t;
+}
+
+static void GetBernsteinBasis(float t, float basis[4])
+{
+    float s = 1.0f - t;
+    basis[0] = s * s * s;
+    basis[1] = 3.0f * t * s * s;
+    basis[2] = 3.0f * t * t * s;
+    basis[3] = t * t * t;
+}
+
+glm::vec2 EvaluateBezier(const glm::vec2* controlPoints, uint32_t numControlPoints, float t, glm::vec2* scratch)
+{
+    for (uint32_t i = 0; i < numControlPoints; i++)
+        scratch[i] = controlPoints[i];
+
+    for (uint32_t n = 1; n < numControlPoints; n++)
+    {
+        for (uint32_t i = 0; i < numControlPoints - n; i++)
+            scratch[i] = Lerp(scratch[i], scratch[i + 1], t);
+    }
+
+    return scratch[0];
+}
+
+glm::vec2 EvaluateBezierDerivatives(const glm::vec2* controlPoints, uint32_t numControlPoints, float t, glm::vec2* scratch, glm::vec2& firstDerivative, glm::vec2& secondDerivative)
+{
+    firstDerivative = glm::vec2(0.0f);
+    secondDerivative = glm::vec2(0.0f);
+    if (numControlPoints < 3)
+    {
+        if (numControlPoints == 2)
+            firstDerivative = controlPoints[1] - controlPoints[0];
+        return numControlPoints == 2 ? Lerp(controlPoints[0], controlPoints[1], t) : controlPoints[0];
+    }
+
+    for (uint32_t i = 0; i < numControlPoints; i++)
+        scratch[i] = controlPoints[i];
+
+    // Stop at the last three points, the derivatives are differences of the final levels
+    for (uint32_t n = 1; n + 2 < numControlPoints; n++)
+    {
+        for (uint32_t i = 0; i < numControlPoints - n; i++)
+            scratch[i] = Lerp(scratch[i], scratch[i + 1], t);
+    }
+
+    float degree = float(numControlPoints - 1);
+    secondDerivative = (scratch[2] - 2.0f * scratch[1] + scratch[0]) * (degree * (degree - 1.0f));
+
+    glm::vec2 a = Lerp(scratch[0], scratch[1], t);
+    glm::vec2 b = Lerp(scratch[1], scratch[2], t);
+    firstDerivative = (b - a) * degree;
+    return Lerp(a, b, t);
+}
+
+void SplitBezier(const glm::vec2* controlPoints, uint32_t numControlPoints, float t, glm::vec2* left, glm::vec2* right)
+{
+    if (numControlPoints == 0)
+        return;
+
+    // right doubles as the scratch row, its last point is final after the first pass
+    for (uint32_t i = 0; i < numControlPoints; i++)
+        right[i] = controlPoints[i];
+
+    left[0] = right[0];
+    for (uint32_t n = 1; n < numControlPoints; n++)
+    {
+        for (uint32_t i = 0; i < numControlPoints - n; i++)
+            right[i] = Lerp(right[i], right[i + 1], t);
+        left[n] = right[0];
+    }
+}
+
+// Parameter of the whole curve mapped into the range [previous, 1] left over by the previous split. Nothing is left once the
+// previous split was at 1, the remaining pieces collapse to the end point
+static float GetRemainingParameter(float t, float previous)
+{
+    return previous < 1.0f ? (t - previous) / (1.0f - previous) : 0.0f;
+}
+
+void SubdivideBezier(const glm::vec2* controlPoints, uint32_t numControlPoints, const float* parameters, uint32_t numParameters, glm::vec2* pieces)
+{
+    if (numControlPoints == 0)
+        return;
+
+    if (numParameters == 0)
+    {
+        std::copy(controlPoints, controlPoints + numControlPoints, pieces);
+        return;
+    }
+
+    // The rest of the curve is split into the current piece and the next one. The first level of the triangle reads the
+    // rest and writes the next piece, which is the scratch row of the following levels like in SplitBezier, so the rest
+    // is never copied. The current piece receives the left edge of the triangle once the first level is done with it
+    float previous = 0.0f;
+    for (uint32_t i = 0; i < numParameters; i++)
+    {
+        glm::vec2* left = pieces + i * numControlPoints;
+        glm::vec2* right = left + numControlPoints;
+        const glm::vec2* rest = i > 0 ? left : controlPoints;
+
+        float t = GetRemainingParameter(parameters[i], previous);
+        previous = parameters[i];
+
+        right[numControlPoints - 1] = rest[numControlPoints - 1];
+        for (uint32_t j = 0; j + 1 < numControlPoints; j++)
+            right[j] = Lerp(rest[j], rest[j + 1], t);
+        left[0] = rest[0];
+        if (numControlPoints > 1)
+            left[1] = right[0];
+
+        for (uint32_t n = 2; n < numControlPoints; n++)
+        {
+            for (uint32_t j = 0; j < numControlPoints - n; j++)
+                right[j] = Lerp(right[j], right[j + 1], t);
+            left[n] = right[0];
+        }
+    }
+}
+
+#if defined(BEZIER_SIMD_ENABLED)
+// SubdivideBezier of four curves, one per lane. The triangle is built in registers and every piece is written as soon as
+// its edge is complete, x and y are interleaved back into points two lanes at a time
+static void SubdivideBezier4(const glm::vec2* const* controlPoints, uint32_t numControlPoints, const float* const* parameters, uint32_t numParameters,
+    glm::vec2* const* pieces)
+{
+    __m128 x[BEZIER_SIMD_MAX_POINTS];
+    __m128 y[BEZIER_SIMD_MAX_POINTS];
+    for (uint32_t j = 0; j < numControlPoints; j++)
+    {
+        x[j] = _mm_setr_ps(controlPoints[0][j].x, controlPoints[1][j].x, controlPoints[2][j].x, controlPoints[3][j].x);
+        y[j] = _mm_setr_ps(controlPoints[0][j].y, controlPoints[1][j].y, controlPoints[2][j].y, controlPoints[3][j].y);
+    }
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 previous = _mm_setzero_ps();
+    for (uint32_t i = 0; i <= numParameters; i++)
+    {
+        __m128 leftX[BEZIER_SIMD_MAX_POINTS];
+        __m128 leftY[BEZIER_SIMD_MAX_POINTS];
+        if (i < numParameters)
+        {
+            __m128 parameter = _mm_setr_ps(parameters[0][i], parameters[1][i], parameters[2][i], parameters[3][i]);
+            __m128 t = _mm_div_ps(_mm_sub_ps(parameter, previous), _mm_sub_ps(one, previous));
+            t = _mm_and_ps(t, _mm_cmplt_ps(previous, one));
+            previous = parameter;
+
+            leftX[0] = x[0];
+            leftY[0] = y[0];
+            for (uint32_t n = 1; n < numControlPoints; n++)
+            {
+                for (uint32_t j = 0; j < numControlPoints - n; j++)
+                {
+                    x[j] = _mm_add_ps(x[j], _mm_mul_ps(_mm_sub_ps(x[j + 1], x[j]), t));
+                    y[j] = _mm_add_ps(y[j], _mm_mul_ps(_mm_sub_ps(y[j + 1], y[j]), t));
+                }
+                leftX[n] = x[0];
+                leftY[n] = y[0];
+            }
+        }
+        else
+        {
+            // The last piece is the rest of the curve
+            std::copy(x, x + numControlPoints, leftX);
+            std::copy(y, y + numControlPoints, leftY);
+        }
+
+        for (uint32_t j = 0; j < numControlPoints; j++)
+        {
+            __m128 low = _mm_unpacklo_ps(leftX[j], leftY[j]);
+            __m128 high = _mm_unpackhi_ps(leftX[j], leftY[j]);
+            _mm_storel_pi((__m64*)&pieces[0][i * numControlPoints + j], low);
+            _mm_storeh_pi((__m64*)&pieces[1][i * numControlPoints + j], low);
+            _mm_storel_pi((__m64*)&pieces[2][i * numControlPoints + j], high);
+            _mm_storeh_pi((__m64*)&pieces[3][i * numControlPoints + j], high);
+        }
+    }
+}
+#endif
+
+void SubdivideBezierCurves(const glm::vec2* controlPoints, uint32_t numCurves, uint32_t numControlPoints, const float* parameters, uint32_t numParameters,
+    glm::vec2* pieces)
+{
+    uint32_t numPiecePoints = (numParameters + 1) * numControlPoints;
+    uint32_t first = 0;
+#if defined(BEZIER_SIMD_ENABLED)
+    if (numControlPoints <= BEZIER_SIMD_MAX_POINTS)
+    {
+        for (; first + 4 <= numCurves; first += 4)
+        {
+            const glm::vec2* curveControlPoints[4];
+            const float* curveParameters[4];
+            glm::vec2* curvePieces[4];
+            for (uint32_t lane = 0; lane < 4; lane++)
+            {
+                curveControlPoints[lane] = controlPoints + (size_t)(first + lane) * numControlPoints;
+                curveParameters[lane] = parameters + (size_t)(first + lane) * numParameters;
+                curvePieces[lane] = pieces + (size_t)(first + lane) * numPiecePoints;
+            }
+
+            SubdivideBezier4(curveControlPoints, numControlPoints, curveParameters, numParameters, curvePieces);
+        }
+    }
+#endif
+
+    for (uint32_t i = first; i < numCurves; i++)
+        SubdivideBezier(controlPoints + (size_t)i * numControlPoints, numControlPoints, parameters + (size_t)i * numParameters, numParameters, pieces + (size_t)i * numPiecePoints);
+}
+
+void ComputeBezierPolar(const glm::vec2* controlPoints, uint32_t numControlPoints, float t, glm::vec2* polarPoints)
+{
+    for (uint32_t i = 0; i + 1 < numControlPoints; i++)
+        polarPoints[i] = Lerp(controlPoints[i], controlPoints[i + 1], t);
+}
+
+void TessellateBezier(const glm::vec2* controlPoints, uint32_t numControlPoints, uint32_t numSamples, glm::vec2* samples)
+{
+    EvaluateBezierSamples(controlPoints, numControlPoints, numSamples, 0, numSamples, samples);
+}
+
+uint32_t GetBezierFlatteningSegments(const glm::vec2* controlPoints, uint32_t numControlPoints, const glm::vec2& scale, float tolerance)
+{
+    if (numControlPoints < 3)
+        return 1;
+
+    float maxSecondDifference = 0.0f;
+    for (uint32_t i = 0; i + 2 < numControlPoints; i++)
+    {
+        glm::vec2 secondDifference = (controlPoints[i + 2] - 2.0f * controlPoints[i + 1] + controlPoints[i]) * scale;
+        maxSecondDifference = std::max(maxSecondDifference, glm::length(secondDifference));
+    }
+
+    // The polyline through n + 1 evenly spaced samples is within d (d - 1) / (8 n^2) times the largest second difference
+    float degree = float(numControlPoints - 1);
+    float segments = std::ceil(std::sqrt(degree * (degree - 1.0f) * maxSecondDifference / (8.0f * tolerance)));
+    return segments >= 1.0f ? uint32_t(std::min(segments, 16777216.0f)) : 1;
+}
+
+template<int Degree>
+static void EvaluateBezierSamplesSpecialized(const glm::vec2* controlPoints, uint32_t numSamples, uint32_t firstSample, uint32_t count, glm::vec2* samples)
+{
+    glm::vec2 points[Degree + 1];
+    for (int i = 0; i <= Degree; i++)
+        points[i] = controlPoints[i];
+
+    for (uint32_t i = 0; i < count; i++)
+        samples[i] = EvaluateBezier<Degree>(points, float(firstSample + i) / float(numSamples - 1));
+}
+
+// Indexed by degree
+static const BezierSampleFunction s_SampleFunctions[BEZIER_MAX_SPECIALIZED_DEGREE + 1] =
+{
+    EvaluateBezierSamplesSpecialized<0>,
+    EvaluateBezierSamplesSpecialized<1>,
+    EvaluateBezierSamplesSpecialized<2>,
+    EvaluateBezierSamplesSpecialized<3>,
+    EvaluateBezierSamplesSpecialized<4>,
+    EvaluateBezierSamplesSpecialized<5>,
+    EvaluateBezierSamplesSpecialized<6>,
+    EvaluateBezierSamplesSpecialized<7>,
+    EvaluateBezierSamplesSpecialized<8>,
+};
+
+BezierSampleFunction GetBezierSampleFunction(uint32_t numControlPoints)
+{
+    if (numControlPoints == 0 || numControlPoints > BEZIER_MAX_SPECIALIZED_DEGREE + 1)
+        return nullptr;
+
+    return s_SampleFunctions[numControlPoints - 1];
+}
+
+void EvaluateBezierSamples(const glm::vec2* controlPoints, uint32_t numControlPoints, uint32_t numSamples, uint32_t firstSample, uint32_t count, glm::vec2* samples)
+{
+    if (BezierSampleFunction function = GetBezierSampleFunction(numControlPoints))
+        function(controlPoints, numSamples, firstSample, count, samples);
+    else
+        EvaluateBezierSamplesGeneric(controlPoints, numControlPoints, numSamples, firstSample, count, samples);
+}
+
+void EvaluateBezierSamplesGeneric(const glm::vec2* controlPoints, uint32_t numControlPoints, uint32_t numSamples, uint32_t firstSample, uint32_t count, glm::vec2* samples)
+{
+    if (numControlPoints == 0)
+        return;
+
+    // Only curves of very high degree need the heap for their scratch points
+    glm::vec2 stackScratch[BEZIER_GENERIC_STACK_POINTS];
+    std::vector<glm::vec2> heapScratch;
+    glm::vec2* scratch = stackScratch;
+    if (numControlPoints > BEZIER_GENERIC_STACK_POINTS)
+    {
+        heapScratch.resize(numControlPoints);
+        scratch = heapScratch.data();
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+        samples[i] = EvaluateBezier(controlPoints, numControlPoints, float(firstSample + i) / float(numSamples - 1), scratch);
+}
+
+float GetSegmentDistance(const glm::vec2& point, const glm::vec2& a, const glm::vec2& b)
+{
+    glm::vec2 ab = b - a;
+    float lengthSquared = glm::dot(ab, ab);
+    float t = lengthSquared > 0.0f ? std::clamp(glm::dot(point - a, ab) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+    return glm::distance(point, a + ab * t);
+}
+
+float GetPolylineDistance(const glm::vec2& point, const glm::vec2* points, uint32_t numPoints)
+{
+    if (numPoints == 1)
+        return glm::distance(point, points[0]);
+
+    float distance = FLT_MAX;
+    for (uint32_t i = 0; i + 1 < numPoints; i++)
+        distance = std::min(distance, GetSegmentDistance(point, points[i], points[i + 1]));
+
+    return distance;
+}
+
+void FitCubicBezier(const glm::vec2* samples, const float* parameters, uint32_t numSamples, const glm::vec2& startTangent, const glm::vec2& endTangent, glm::vec2* controlPoints)
+{
+    glm::vec2 start = samples[0];
+    glm::vec2 end = samples[numSamples - 1];
+
+    float c00 = 0.0f, c01 = 0.0f, c11 = 0.0f;
+    float x0 = 0.0f, x1 = 0.0f;
+    for (uint32_t i = 0; i < numSamples; i++)
+    {
+        float basis[4];
+        GetBernsteinBasis(parameters[i], basis);
+
+        glm::vec2 a0 = startTangent * basis[1];
+        glm::vec2 a1 = endTangent * basis[2];
+        c00 += glm::dot(a0, a0);
+        c01 += glm::dot(a0, a1);
+        c11 += glm::dot(a1, a1);
+
+        glm::vec2 residual = samples[i] - (start * (basis[0] + basis[1]) + end * (basis[2] + basis[3]));
+        x0 += glm::dot(a0, residual);
+        x1 += glm::dot(a1, residual);
+    }
+
+    float determinant = c00 * c11 - c01 * c01;
+    float alpha0 = determinant != 0.0f ? (x0 * c11 - x1 * c01) / determinant : 0.0f;
+    float alpha1 = determinant != 0.0f ? (c00 * x1 - c01 * x0) / determinant : 0.0f;
+
+    // Tangents that point the wrong way or vanish would make the curve loop, fall back to a third of the chord
+    float chordLength = glm::distance(start, end);
+    float epsilon = 1e-6f * chordLength;
+    if (alpha0 < epsilon || alpha1 < epsilon)
+        alpha0 = alpha1 = chordLength / 3.0f;
+
+    controlPoints[0] = start;
+    controlPoints[1] = start + startTangent * alpha0;
+    controlPoints[2] = end + endTangent * alpha1;
+    controlPoints[3] = end;
+}
+
+float GetCubicFitError(const glm::vec2* samples, const float* parameters, uint32_t numSamples, const glm::vec2* controlPoints)
+{
+    float maxError = 0.0f;
+    for (uint32_t i = 1; i + 1 < numSamples; i++)
+        maxError = std::max(maxError, glm::distance(EvaluateBezier<3>(controlPoints, parameters[i]), samples[i]));
+    return maxError;
+}
+
+void ReparameterizeCubicFit(const glm::vec2* samples, float* parameters, uint32_t numSamples, const glm::vec2* controlPoints)
+{
+    glm::vec2 scratch[4];
+    for (uint32_t i = 1; i + 1 < numSamples; i++)
+    {
+        float t = parameters[i];
+        glm::vec2 firstDerivative, secondDerivative;
+        glm::vec2 offset = EvaluateBezierDerivatives(controlPoints, 4, t, scratch, firstDerivative, secondDerivative) - samples[i];
+
+        float numerator = glm::dot(offset, firstDerivative);
+        float denominator = glm::dot(firstDerivative, firstDerivative) + glm::dot(offset, secondDerivative);
+        if (denominator > 0.0f)
+            parameters[i] = std::clamp(t - numerator / denominator, 0.0f, 1.0f);
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// Curve math shared by the CPU renderer and the tools. Interpolation is done as a + (b - a) * t, like HLSL lerp, so the
+// results match the compute shader
+
+// de Casteljau evaluation, scratch must hold numControlPoints points
+glm::vec2 EvaluateBezier(const glm::vec2* controlPoints, uint32_t numControlPoints, float t, glm::vec2* scratch);
+// Control points of the polar curve at t, which has one control point less than the curve
+void ComputeBezierPolar(const glm::vec2* controlPoints, uint32_t numControlPoints, float t, glm::vec2* polarPoints);
+// Point, first and second derivative at t in one de Casteljau pass, scratch must hold numControlPoints points
+glm::vec2 EvaluateBezierDerivatives(const glm::vec2* controlPoints, uint32_t numControlPoints, float t, glm::vec2* scratch, glm::vec2& firstDerivative, glm::vec2& secondDerivative);
+// Splits the curve at t into the control points of [0, t] and [t, 1], each numControlPoints long
+void SplitBezier(const glm::vec2* controlPoints, uint32_t numControlPoints, float t, glm::vec2* left, glm::vec2* right);
+// Splits the curve at numParameters parameters sorted in [0, 1] into numParameters + 1 pieces, written one after the other
+// with numControlPoints each. Every split continues on the right part of the previous one, at the parameter mapped into
+// its range, so the cost is one de Casteljau triangle per parameter and no piece is split off the whole curve twice
+void SubdivideBezier(const glm::vec2* controlPoints, uint32_t numControlPoints, const float* parameters, uint32_t numParameters, glm::vec2* pieces);
+// SubdivideBezier of numCurves curves with numControlPoints each, stored one after the other, every curve split at its own
+// numParameters parameters, also stored one after the other. The pieces of curve i start at pieces + i * (numParameters +
+// 1) * numControlPoints. With SIMD four curves are split at once, one curve per lane, with the same results
+void SubdivideBezierCurves(const glm::vec2* controlPoints, uint32_t numCurves, uint32_t numControlPoints, const float* parameters, uint32_t numParameters,
+    glm::vec2* pieces);
+// Evaluates the curve at numSamples (at least 2) parameters evenly spaced over [0, 1]
+void TessellateBezier(const glm::vec2* controlPoints, uint32_t numControlPoints, uint32_t numSamples, glm::vec2* samples);
+// Segments of a polyline through evenly spaced parameters that stays within tolerance of the curve, by Wang's formula from
+// the largest second difference of the control points. scale maps the control points into the units of the tolerance per
+// axis, e.g. pixels per scene unit. Lines need a single segment
+uint32_t GetBezierFlatteningSegments(const glm::vec2* controlPoints, uint32_t numControlPoints, const glm::vec2& scale, float tolerance);
+
+// Batches of curves are subdivided four at a time with SSE2, which every x64 target has. Curves with more control points
+// than fit in registers take the scalar path
+#if (defined(__SSE2__) || defined(_M_X64)) && !defined(BEZIER_NO_SIMD)
+#define BEZIER_SIMD_ENABLED
+#endif
+#define BEZIER_SIMD_MAX_POINTS 16
+
+// Curves up to this degree are evaluated by kernels specialized for their degree, higher degrees use the generic loop
+#define BEZIER_MAX_SPECIALIZED_DEGREE 8
+
+// Evaluates samples [firstSample, firstSample + count) of a curve tessellated into numSamples evenly spaced samples
+using BezierSampleFunction = void (*)(const glm::vec2* controlPoints, uint32_t numSamples, uint32_t firstSample, uint32_t count, glm::vec2* samples);
+
+// Kernel specialized for the degree of a curve with numControlPoints, nullptr when there is none
+BezierSampleFunction GetBezierSampleFunction(uint32_t numControlPoints);
+// Picks the specialized kernel when there is one and falls back to the generic evaluation otherwise
+void EvaluateBezierSamples(const glm::vec2* controlPoints, uint32_t numControlPoints, uint32_t numSamples, uint32_t firstSample, uint32_t count, glm::vec2* samples);
+void EvaluateBezierSamplesGeneric(const glm::vec2* controlPoints, uint32_t numControlPoints, uint32_t numSamples, uint32_t firstSample, uint32_t count, glm::vec2* samples);
+
+// de Casteljau evaluation with the degree known at compile time, so the loops are unrolled and the points stay in
+// registers. Performs the same operations in the same order as the generic version and gives bit identical results
+template<int Degree>
+inline glm::vec2 EvaluateBezier(const glm::vec2* controlPoints, float t)
+{
+    glm::vec2 points[Degree + 1];
+    for (int i = 0; i <= Degree; i++)
+        points[i] = controlPoints[i];
+
+    for (int n = 1; n <= Degree; n++)
+    {
+        for (int i = 0; i <= Degree - n; i++)
+            points[i] = points[i] + (points[i + 1] - points[i]) * t;
+    }
+
+    return points[0];
+}
+
+constexpr float GetBinomialCoefficient(int n, int k)
+{
+    float coefficient = 1.0f;
+    for (int i = 1; i <= k; i++)
+        coefficient = coefficient * (n - k + i) / i;
+    return coefficient;
+}
+
+template<int Degree>
+struct BezierBinomials
+{
+    float Values[Degree + 1] = {};
+
+    constexpr BezierBinomials()
+    {
+        for (int i = 0; i <= Degree; i++)
+            Values[i] = GetBinomialCoefficient(Degree, i);
+    }
+};
+
+// Bernstein form with compile-time binomial coefficients, linear instead of quadratic in the degree. Rounds differently
+// than de Casteljau, so the renderer, which has to match the shader, does not use it
+template<int Degree>
+inline glm::vec2 EvaluateBezierBernstein(const glm::vec2* controlPoints, float t)
+{
+    static constexpr BezierBinomials<Degree> binomials;
+
+    float s = 1.0f - t;
+    float powersOfT[Degree + 1];
+    powersOfT[0] = 1.0f;
+    for (int i = 1; i <= Degree; i++)
+        powersOfT[i] = powersOfT[i - 1] * t;
+
+    glm::vec2 point = glm::vec2(0.0f);
+    float powerOfS = 1.0f;
+    for (int i = Degree; i >= 0; i--)
+    {
+        point += controlPoints[i] * (binomials.Values[i] * powersOfT[i] * powerOfS);
+        powerOfS *= s;
+    }
+
+    return point;
+}
+
+float GetSegmentDistance(const glm::vec2& point, const glm::vec2& a, const glm::vec2& b);
+float GetPolylineDistance(const glm::vec2& point, const glm::vec2* points, uint32_t numPoints);
+
+// Least squares fit of a cubic through the first and last sample, after Schneider's "An Algorithm for Automatically
+// Fitting Digitized Curves". The inner control points lie along the unit tangents, startTangent points into the curve from
+// its start and endTangent from its end. parameters holds the curve parameter of every sample
+void FitCubicBezier(const glm::vec2* samples, const float* parameters, uint32_t numSamples, const glm::vec2& startTangent, const glm::vec2& endTangent, glm::vec2* controlPoints);
+// Largest distance between an inner sample and the curve point at its parameter, which bounds its distance from the curve
+float GetCubicFitError(const glm::vec2* samples, const float* parameters, uint32_t numSamples, const glm::vec2* controlPoints);
+// One Newton step per inner sample towards the parameter of the closest curve point
+void ReparameterizeCubicFit(const glm::vec2* samples, float* parameters, uint32_t numSamples, const glm::vec2* controlPoints);
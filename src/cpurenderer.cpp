@@ -0,0 +1,401 @@
+#include "cpurenderer.h"
+#include "profiler.h"
+#include "bezier.h"
+#include "curvebounds.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Constants of the Bezier curve shader
+static const glm::vec3 s_OriginalPolygonColor = glm::vec3(0.8f, 0.2f, 0.1f);
+static const glm::vec3 s_PolarPolygonColor = glm::vec3(0.1f, 0.2f, 0.8f);
+static const float s_ControlPointRadius = 0.05f;
+static const float s_PolygonThickness = 0.005f;
+static const float s_ThicknessScale = 0.005f;
+
+using Clock = std::chrono::steady_clock;
+
+static float GetMilliseconds(Clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+static float SmoothStep(float edge0, float edge1, float x)
+{
+    float t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+    return t * t * (3.0f - 2.0f * t);
+}
+
+static glm::vec3 ShadePrimitive(const CpuPrimitive& primitive, const glm::vec2& pixelPosition)
+{
+    if (primitive.Type == CpuPrimitive_Disc)
+    {
+        float d = glm::distance(primitive.A, pixelPosition);
+        return primitive.Color * (1.0f - SmoothStep(0.0f, primitive.Falloff, d));
+    }
+
+    // Same arithmetic as DrawLine in the shader, pixels that do not project onto the segment are not covered
+    glm::vec2 ap = pixelPosition - primitive.A;
+    glm::vec2 ab = primitive.B - primitive.A;
+    float apDotAB = glm::dot(ap, ab);
+
+    float lengthAB = glm::length(ab);
+    if (apDotAB / lengthAB > lengthAB || apDotAB / lengthAB < 0.0f)
+        return glm::vec3(0.0f);
+
+    float t = std::clamp(apDotAB / glm::dot(ab, ab), 0.0f, 1.0f);
+    glm::vec2 c = primitive.A + ab * t;
+    float d = glm::distance(c, pixelPosition);
+    return primitive.Color * (1.0f - SmoothStep(0.0f, primitive.Falloff, d));
+}
+
+static uint32_t PackColor(const glm::vec3& color)
+{
+    uint32_t r = (uint32_t)(std::clamp(color.r, 0.0f, 1.0f) * 255.0f + 0.5f);
+    uint32_t g = (uint32_t)(std::clamp(color.g, 0.0f, 1.0f) * 255.0f + 0.5f);
+    uint32_t b = (uint32_t)(std::clamp(color.b, 0.0f, 1.0f) * 255.0f + 0.5f);
+    return r | (g << 8) | (b << 16) | (255u << 24);
+}
+
+CpuRenderer::CpuRenderer(JobSystem& jobSystem, uint32_t tileSize)
+    : m_JobSystem(jobSystem), m_TileSize(tileSize)
+{
+}
+
+void CpuRenderer::Render(const SceneSnapshot& scene, uint32_t width, uint32_t height, CpuImage& image, const ViewTransform& view)
+{
+    RenderRows(scene, width, height, 0, height, image, view);
+}
+
+void CpuRenderer::RenderRows(const SceneSnapshot& scene, uint32_t width, uint32_t height, uint32_t firstRow, uint32_t numRows, CpuImage& image,
+    const ViewTransform& view)
+{
+    numRows = firstRow < height ? std::min(numRows, height - firstRow) : 0;
+    image.Width = width;
+    image.Height = numRows;
+    image.Pixels.resize((size_t)width * numRows);
+
+    m_Stats = CpuRenderStats();
+    if (width == 0 || numRows == 0)
+        return;
+
+    Clock::time_point start = Clock::now();
+    Evaluate(scene, width, height, firstRow, numRows, view);
+    m_Stats.EvaluateTime = GetMilliseconds(start);
+
+    start = Clock::now();
+    Tessellate();
+    m_Stats.TessellateTime = GetMilliseconds(start);
+
+    start = Clock::now();
+    Bin(width, height, firstRow, numRows);
+    m_Stats.BinTime = GetMilliseconds(start);
+
+    start = Clock::now();
+    Rasterize(height, firstRow, image);
+    m_Stats.RasterizeTime = GetMilliseconds(start);
+
+    m_Stats.NumSamples = m_Samples.size();
+    m_Stats.NumPrimitives = m_Primitives.size();
+    m_Stats.NumBinnedPrimitives = m_TilePrimitives.size();
+}
+
+void CpuRenderer::Evaluate(const SceneSnapshot& scene, uint32_t width, uint32_t height, uint32_t firstRow, uint32_t numRows, const ViewTransform& view)
+{
+    PROFILE_FUNCTION();
+
+    // The shader divides by NumSamples - 1
+    uint32_t sceneNumSamples = std::max(scene.Settings.NumSamples, 2);
+    m_Batches.clear();
+
+    // Control points of all drawn curves moved into the view, the batches point into it once it is filled
+    bool drawPolar = scene.Settings.DrawPolar && !scene.Curves.empty() && scene.Curves[0]->Positions.size() > 1;
+    uint32_t numViewPositions = drawPolar ? scene.Curves[0]->Positions.size() - 1 : 0;
+    if (scene.Settings.DrawBezierCurve)
+    {
+        for (const std::shared_ptr<const SceneSnapshotCurve>& curve : scene.Curves)
+            numViewPositions += curve->Positions.size();
+    }
+    m_ViewPositions.resize(numViewPositions);
+
+    // The image covers [-1, 1] of the view on both axes and the rendered rows a band of it, curves are culled against the band
+    // with a margin of two pixels for rounding
+    glm::vec2 margin = glm::vec2(4.0f / width, 4.0f / height);
+    glm::vec2 regionMin = glm::vec2(-1.0f, 1.0f - 2.0f * float(firstRow + numRows) / float(height));
+    glm::vec2 regionMax = glm::vec2(1.0f, 1.0f - 2.0f * float(firstRow) / float(height));
+    auto isInRegion = [&](const glm::vec2& boundsMin, const glm::vec2& boundsMax)
+    {
+        return boundsMax.x >= regionMin.x && boundsMax.y >= regionMin.y && boundsMin.x <= regionMax.x && boundsMin.y <= regionMax.y;
+    };
+
+    uint32_t numViewPositionsAdded = 0;
+    uint32_t numSamples = 0;
+    uint32_t numPrimitives = 0;
+    auto addBatch = [&](const glm::vec2* positions, const glm::vec3* colors, uint32_t numControlPoints, const glm::vec3& curveColor, const glm::vec3& polygonColor, float thickness,
+        const glm::vec2& boundsMin, const glm::vec2& boundsMax)
+    {
+        glm::vec2* viewPositions = &m_ViewPositions[numViewPositionsAdded];
+        for (uint32_t i = 0; i < numControlPoints; i++)
+            viewPositions[i] = view.SceneToView(positions[i]);
+        numViewPositionsAdded += numControlPoints;
+
+        CurveBatch& batch = m_Batches.emplace_back();
+        batch.Positions = viewPositions;
+        batch.Colors = colors;
+        batch.NumControlPoints = numControlPoints;
+        batch.CurveColor = curveColor;
+        batch.PolygonColor = polygonColor;
+        batch.Thickness = thickness * s_ThicknessScale;
+
+        // The curve's segments run between points on the curve and never leave its bounds, which the view only scales and moves
+        glm::vec2 visibleMin = view.SceneToView(boundsMin) - batch.Thickness - margin;
+        glm::vec2 visibleMax = view.SceneToView(boundsMax) + batch.Thickness + margin;
+        batch.IsCurveVisible = isInRegion(visibleMin, visibleMax);
+        m_Stats.NumCulledCurves += batch.IsCurveVisible ? 0 : 1;
+
+        // Discs and edges of the control polygon stay within the control points' bounds widened by the disc radius
+        glm::vec2 polygonMin = viewPositions[0];
+        glm::vec2 polygonMax = viewPositions[0];
+        for (uint32_t i = 1; i < numControlPoints; i++)
+        {
+            polygonMin = glm::min(polygonMin, viewPositions[i]);
+            polygonMax = glm::max(polygonMax, viewPositions[i]);
+        }
+        float polygonFalloff = std::max(s_ControlPointRadius, s_PolygonThickness);
+        bool isPolygonVisible = isInRegion(polygonMin - polygonFalloff - margin, polygonMax + polygonFalloff + margin);
+        batch.NumPolygonPrimitives = isPolygonVisible ? 2 * numControlPoints - 1 : 0;
+        m_Stats.NumCulledPolygons += isPolygonVisible ? 0 : 1;
+
+        // Culled curves are not sampled at all
+        batch.NumSamples = 0;
+        if (batch.IsCurveVisible)
+            batch.NumSamples = m_SampleTolerance > 0.0f ? GetViewSampleCount(viewPositions, numControlPoints, ViewTransform(), width, height, m_SampleTolerance) : sceneNumSamples;
+
+        batch.FirstSample = numSamples;
+        batch.FirstPrimitive = numPrimitives;
+        numSamples += batch.NumSamples;
+
+        // Control point discs, control polygon edges and one segment per sample, in the order the shader accumulates them
+        numPrimitives += batch.NumPolygonPrimitives + batch.NumSamples;
+    };
+
+    if (scene.Settings.DrawBezierCurve)
+    {
+        for (const std::shared_ptr<const SceneSnapshotCurve>& curve : scene.Curves)
+        {
+            if (!curve->Positions.empty())
+                addBatch(curve->Positions.data(), curve->Colors.data(), curve->Positions.size(), curve->Color, s_OriginalPolygonColor, curve->Thickness, curve->BoundsMin, curve->BoundsMax);
+        }
+    }
+
+    if (drawPolar)
+    {
+        const SceneSnapshotCurve& original = *scene.Curves[0];
+        uint32_t numPolarPoints = original.Positions.size() - 1;
+
+        m_PolarPositions.resize(numPolarPoints);
+        m_PolarColors.assign(numPolarPoints, s_PolarPolygonColor);
+        ComputeBezierPolar(original.Positions.data(), original.Positions.size(), scene.Settings.T1, m_PolarPositions.data());
+
+        glm::vec3 color = scene.Curves.size() > 1 ? scene.Curves[1]->Color : glm::vec3(1.0f);
+        float thickness = scene.Curves.size() > 1 ? scene.Curves[1]->Thickness : 1.0f;
+        glm::vec2 boundsMin, boundsMax;
+        GetBezierBounds(m_PolarPositions.data(), numPolarPoints, boundsMin, boundsMax);
+        addBatch(m_PolarPositions.data(), m_PolarColors.data(), numPolarPoints, color, s_PolarPolygonColor, thickness, boundsMin, boundsMax);
+    }
+
+    m_Samples.resize(numSamples);
+    m_Primitives.resize(numPrimitives);
+
+    m_JobSystem.ParallelFor(m_Samples.size(), 256, [this](uint32_t begin, uint32_t end)
+    {
+        auto batchCompare = [](uint32_t sample, const CurveBatch& batch) { return sample < batch.FirstSample; };
+        uint32_t batchIndex = std::upper_bound(m_Batches.begin(), m_Batches.end(), begin, batchCompare) - m_Batches.begin() - 1;
+
+        // Each run of samples of the same curve goes through the kernel specialized for the degree of the curve
+        uint32_t i = begin;
+        while (i < end)
+        {
+            while (i >= m_Batches[batchIndex].FirstSample + m_Batches[batchIndex].NumSamples)
+                batchIndex++;
+
+            const CurveBatch& batch = m_Batches[batchIndex];
+            uint32_t firstSample = i - batch.FirstSample;
+            uint32_t count = std::min(end - i, batch.NumSamples - firstSample);
+
+            EvaluateBezierSamples(batch.Positions, batch.NumControlPoints, batch.NumSamples, firstSample, count, &m_Samples[i]);
+            i += count;
+        }
+    });
+}
+
+void CpuRenderer::Tessellate()
+{
+    PROFILE_FUNCTION();
+
+    m_JobSystem.ParallelFor(m_Primitives.size(), 1024, [this](uint32_t begin, uint32_t end)
+    {
+        auto batchCompare = [](uint32_t primitive, const CurveBatch& batch) { return primitive < batch.FirstPrimitive; };
+        uint32_t batchIndex = std::upper_bound(m_Batches.begin(), m_Batches.end(), begin, batchCompare) - m_Batches.begin() - 1;
+
+        for (uint32_t i = begin; i < end; i++)
+        {
+            // Culled batches have no primitives and share their first one with the next batch
+            while (batchIndex + 1 < m_Batches.size() && i >= m_Batches[batchIndex + 1].FirstPrimitive)
+                batchIndex++;
+
+            const CurveBatch& batch = m_Batches[batchIndex];
+            uint32_t numControlPoints = batch.NumControlPoints;
+            uint32_t k = i - batch.FirstPrimitive;
+
+            CpuPrimitive& primitive = m_Primitives[i];
+            if (k < batch.NumPolygonPrimitives && k < numControlPoints)
+            {
+                primitive = { batch.Positions[k], batch.Positions[k], batch.Colors[k], s_ControlPointRadius, CpuPrimitive_Disc };
+            }
+            else if (k < batch.NumPolygonPrimitives)
+            {
+                k -= numControlPoints;
+                primitive = { batch.Positions[k], batch.Positions[k + 1], batch.PolygonColor, s_PolygonThickness, CpuPrimitive_Segment };
+            }
+            else
+            {
+                // The shader starts the polyline at the first control point, the zero length segment it produces draws a dot
+                k -= batch.NumPolygonPrimitives;
+                glm::vec2 current = m_Samples[batch.FirstSample + k];
+                glm::vec2 previous = k > 0 ? m_Samples[batch.FirstSample + k - 1] : batch.Positions[0];
+                primitive = { current, previous, batch.CurveColor, batch.Thickness, current == previous ? CpuPrimitive_Disc : CpuPrimitive_Segment };
+            }
+        }
+    });
+}
+
+void CpuRenderer::Bin(uint32_t width, uint32_t height, uint32_t firstRow, uint32_t numRows)
+{
+    PROFILE_FUNCTION();
+
+    // Tiles cover the rendered rows only, tile rows start at firstRow
+    m_NumTilesX = (width + m_TileSize - 1) / m_TileSize;
+    m_NumTilesY = (numRows + m_TileSize - 1) / m_TileSize;
+    uint32_t numTiles = m_NumTilesX * m_NumTilesY;
+
+    if (m_TileCountersCapacity < numTiles)
+    {
+        m_TileCounters.reset(new std::atomic<uint32_t>[numTiles]);
+        m_TileCountersCapacity = numTiles;
+    }
+
+    for (uint32_t i = 0; i < numTiles; i++)
+        m_TileCounters[i].store(0, std::memory_order_relaxed);
+
+    // Tile range covered by the primitive's bounds, widened by a pixel to absorb rounding
+    auto getTileRange = [this, width, height, firstRow, numRows](const CpuPrimitive& primitive, glm::uvec2& minTile, glm::uvec2& maxTile)
+    {
+        glm::vec2 boundsMin = glm::min(primitive.A, primitive.B) - primitive.Falloff;
+        glm::vec2 boundsMax = glm::max(primitive.A, primitive.B) + primitive.Falloff;
+
+        float minX = std::floor((boundsMin.x + 1.0f) * 0.5f * width) - 1.0f;
+        float maxX = std::ceil((boundsMax.x + 1.0f) * 0.5f * width) + 1.0f;
+        float minY = std::floor((1.0f - boundsMax.y) * 0.5f * height) - 1.0f - (float)firstRow;
+        float maxY = std::ceil((1.0f - boundsMin.y) * 0.5f * height) + 1.0f - (float)firstRow;
+
+        if (!(maxX >= 0.0f && maxY >= 0.0f && minX < (float)width && minY < (float)numRows))
+            return false;
+
+        minTile.x = (uint32_t)std::max(minX, 0.0f) / m_TileSize;
+        minTile.y = (uint32_t)std::max(minY, 0.0f) / m_TileSize;
+        maxTile.x = (uint32_t)std::min(maxX, (float)(width - 1)) / m_TileSize;
+        maxTile.y = (uint32_t)std::min(maxY, (float)(numRows - 1)) / m_TileSize;
+        return true;
+    };
+
+    m_JobSystem.ParallelFor(m_Primitives.size(), 1024, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            glm::uvec2 minTile, maxTile;
+            if (!getTileRange(m_Primitives[i], minTile, maxTile))
+                continue;
+
+            for (uint32_t y = minTile.y; y <= maxTile.y; y++)
+            {
+                for (uint32_t x = minTile.x; x <= maxTile.x; x++)
+                    m_TileCounters[y * m_NumTilesX + x].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    // Counters become the write cursors of the tiles
+    m_TileOffsets.resize(numTiles + 1);
+    m_TileOffsets[0] = 0;
+    for (uint32_t i = 0; i < numTiles; i++)
+    {
+        m_TileOffsets[i + 1] = m_TileOffsets[i] + m_TileCounters[i].load(std::memory_order_relaxed);
+        m_TileCounters[i].store(m_TileOffsets[i], std::memory_order_relaxed);
+    }
+
+    m_TilePrimitives.resize(m_TileOffsets[numTiles]);
+
+    m_JobSystem.ParallelFor(m_Primitives.size(), 1024, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            glm::uvec2 minTile, maxTile;
+            if (!getTileRange(m_Primitives[i], minTile, maxTile))
+                continue;
+
+            for (uint32_t y = minTile.y; y <= maxTile.y; y++)
+            {
+                for (uint32_t x = minTile.x; x <= maxTile.x; x++)
+                    m_TilePrimitives[m_TileCounters[y * m_NumTilesX + x].fetch_add(1, std::memory_order_relaxed)] = i;
+            }
+        }
+    });
+
+    // Restores primitive order within each tile, colors are summed in the same order as on the GPU and the image is deterministic
+    m_JobSystem.ParallelFor(numTiles, 16, [this](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+            std::sort(m_TilePrimitives.begin() + m_TileOffsets[i], m_TilePrimitives.begin() + m_TileOffsets[i + 1]);
+    });
+}
+
+void CpuRenderer::Rasterize(uint32_t height, uint32_t firstRow, CpuImage& image)
+{
+    PROFILE_FUNCTION();
+
+    uint32_t numTiles = m_NumTilesX * m_NumTilesY;
+    uint32_t granularity = std::max(numTiles / (m_JobSystem.GetNumThreads() * CPU_RENDERER_TILE_RANGES_PER_THREAD), 1u);
+    m_JobSystem.ParallelFor(numTiles, granularity, [this, height, firstRow, &image](uint32_t begin, uint32_t end)
+    {
+        PROFILE_SCOPE("Rasterize Tiles");
+
+        for (uint32_t tile = begin; tile < end; tile++)
+        {
+            uint32_t minX = (tile % m_NumTilesX) * m_TileSize;
+            uint32_t minY = (tile / m_NumTilesX) * m_TileSize;
+            uint32_t maxX = std::min(minX + m_TileSize, image.Width);
+            uint32_t maxY = std::min(minY + m_TileSize, image.Height);
+
+            const uint32_t* tilePrimitives = m_TilePrimitives.data() + m_TileOffsets[tile];
+            uint32_t numTilePrimitives = m_TileOffsets[tile + 1] - m_TileOffsets[tile];
+
+            for (uint32_t y = minY; y < maxY; y++)
+            {
+                for (uint32_t x = minX; x < maxX; x++)
+                {
+                    // Positions are those of the whole image, which the rows are a band of
+                    glm::vec2 pixelPosition = glm::vec2((float)x / (float)image.Width, (float)(firstRow + y) / (float)height) * 2.0f - 1.0f;
+                    pixelPosition.y = -pixelPosition.y;
+
+                    glm::vec3 color = glm::vec3(0.0f);
+                    for (uint32_t i = 0; i < numTilePrimitives; i++)
+                        color += ShadePrimitive(m_Primitives[tilePrimitives[i]], pixelPosition);
+
+                    image.Pixels[(size_t)y * image.Width + x] = PackColor(color);
+                }
+            }
+        }
+    });
+}
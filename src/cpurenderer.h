@@ -0,0 +1,119 @@
+#pragma once
+
+#include "jobsystem.h"
+#include "scenesnapshot.h"
+#include "viewcamera.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Tiles are rasterized in about this many ranges per thread, enough to balance uneven tiles without a job per tile at 4K
+#define CPU_RENDERER_TILE_RANGES_PER_THREAD 16
+
+// RGBA8 pixels, rows from top to bottom
+struct CpuImage
+{
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    std::vector<uint32_t> Pixels;
+};
+
+enum CpuPrimitiveType : uint32_t
+{
+    CpuPrimitive_Segment = 0,
+    CpuPrimitive_Disc,
+};
+
+// Shapes of the GPU shader: a segment without caps or a disc at A, both fading to black over Falloff
+struct CpuPrimitive
+{
+    glm::vec2 A;
+    glm::vec2 B;
+    glm::vec3 Color;
+    float Falloff;
+    CpuPrimitiveType Type;
+};
+
+struct CpuRenderStats
+{
+    float EvaluateTime = 0.0f;
+    float TessellateTime = 0.0f;
+    float BinTime = 0.0f;
+    float RasterizeTime = 0.0f;
+    uint32_t NumSamples = 0;
+    uint32_t NumPrimitives = 0;
+    uint32_t NumBinnedPrimitives = 0;
+    // Curves whose bounds are outside the image, only their control polygons are tessellated
+    uint32_t NumCulledCurves = 0;
+    // Control polygons outside the image, their discs and edges are not tessellated
+    uint32_t NumCulledPolygons = 0;
+};
+
+// Software renderer producing the same image as the Bezier curve compute shader. Every stage runs on the job system:
+// curves are evaluated at the sample parameters, tessellated into primitives, primitives are binned into screen tiles and
+// the tiles are rasterized independently. Every curve of the scene is drawn with its control polygon, the polar of the
+// first curve at T1 is drawn with the style of the second curve, as in the editor
+class CpuRenderer
+{
+public:
+    explicit CpuRenderer(JobSystem& jobSystem, uint32_t tileSize = 32);
+
+    // Curves are drawn through view, their control points are moved into the view before anything else so culling, binning and
+    // rasterization all work on the image's [-1, 1] square. Thicknesses and radii are in view units and keep their size on
+    // screen at any zoom
+    void Render(const SceneSnapshot& scene, uint32_t width, uint32_t height, CpuImage& image, const ViewTransform& view = ViewTransform());
+    // Renders the numRows rows of a width x height image starting at firstRow into image, which becomes width x numRows. The
+    // rows are the same as in the whole image, only the curves and control polygons crossing them are evaluated and binned
+    void RenderRows(const SceneSnapshot& scene, uint32_t width, uint32_t height, uint32_t firstRow, uint32_t numRows, CpuImage& image,
+        const ViewTransform& view = ViewTransform());
+
+    // 0 samples every curve NumSamples times as the shader does. Otherwise the sample count of each curve follows its size in
+    // the image, see GetViewSampleCount
+    void SetSampleTolerance(float tolerance) { m_SampleTolerance = tolerance; }
+    // Tiles are square, smaller tiles bin primitives more tightly at the cost of more tile entries
+    void SetTileSize(uint32_t tileSize) { m_TileSize = tileSize; }
+    uint32_t GetTileSize() const { return m_TileSize; }
+
+    const CpuRenderStats& GetStats() const { return m_Stats; }
+private:
+    struct CurveBatch
+    {
+        const glm::vec2* Positions;
+        const glm::vec3* Colors;
+        uint32_t NumControlPoints;
+        glm::vec3 CurveColor;
+        glm::vec3 PolygonColor;
+        float Thickness;
+        bool IsCurveVisible;
+        uint32_t NumPolygonPrimitives;
+        uint32_t NumSamples;
+        uint32_t FirstSample;
+        uint32_t FirstPrimitive;
+    };
+
+    void Evaluate(const SceneSnapshot& scene, uint32_t width, uint32_t height, uint32_t firstRow, uint32_t numRows, const ViewTransform& view);
+    void Tessellate();
+    void Bin(uint32_t width, uint32_t height, uint32_t firstRow, uint32_t numRows);
+    void Rasterize(uint32_t height, uint32_t firstRow, CpuImage& image);
+private:
+    JobSystem& m_JobSystem;
+    uint32_t m_TileSize;
+    float m_SampleTolerance = 0.0f;
+    uint32_t m_NumTilesX = 0;
+    uint32_t m_NumTilesY = 0;
+
+    // Kept between frames so steady state rendering does not allocate
+    std::vector<glm::vec2> m_PolarPositions;
+    std::vector<glm::vec2> m_ViewPositions;
+    std::vector<glm::vec3> m_PolarColors;
+    std::vector<CurveBatch> m_Batches;
+    std::vector<glm::vec2> m_Samples;
+    std::vector<CpuPrimitive> m_Primitives;
+    std::vector<uint32_t> m_TileOffsets;
+    std::vector<uint32_t> m_TilePrimitives;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_TileCounters;
+    uint32_t m_TileCountersCapacity = 0;
+
+    CpuRenderStats m_Stats;
+};
@@ -0,0 +1,139 @@
+#include "curvature.h"
+#include "bezier.h"
+
+#include <cmath>
+#include <vector>
+
+#if defined(CURVATURE_SIMD_ENABLED)
+#include <emmintrin.h>
+#endif
+
+static CurveFrame GetCurveFrame(const glm::vec2& point, const glm::vec2& firstDerivative, const glm::vec2& secondDerivative)
+{
+    CurveFrame frame = {};
+    frame.Point = point;
+
+    float speedSquared = glm::dot(firstDerivative, firstDerivative);
+    if (speedSquared > 0.0f)
+    {
+        float speed = std::sqrt(speedSquared);
+        frame.Tangent = firstDerivative / speed;
+        float cross = firstDerivative.x * secondDerivative.y - firstDerivative.y * secondDerivative.x;
+        frame.Curvature = cross / (speedSquared * speed);
+    }
+
+    frame.Normal = glm::vec2(-frame.Tangent.y, frame.Tangent.x);
+    return frame;
+}
+
+void ComputeBezierHodograph(const glm::vec2* controlPoints, uint32_t numControlPoints, glm::vec2* hodograph)
+{
+    float degree = float(numControlPoints - 1);
+    for (uint32_t i = 0; i + 1 < numControlPoints; i++)
+        hodograph[i] = (controlPoints[i + 1] - controlPoints[i]) * degree;
+}
+
+CurveFrame EvaluateCurveFrame(const glm::vec2* controlPoints, uint32_t numControlPoints, float t, glm::vec2* scratch)
+{
+    glm::vec2 firstDerivative, secondDerivative;
+    glm::vec2 point = EvaluateBezierDerivatives(controlPoints, numControlPoints, t, scratch, firstDerivative, secondDerivative);
+    return GetCurveFrame(point, firstDerivative, secondDerivative);
+}
+
+#if defined(CURVATURE_SIMD_ENABLED)
+static __m128 Lerp4(__m128 a, __m128 b, __m128 t)
+{
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+}
+
+// EvaluateCurveFrame at four parameters, one per lane, performing the same operations in the same order as
+// EvaluateBezierDerivatives and GetCurveFrame. Needs at least three control points
+static void EvaluateCurveFrames4(const glm::vec2* controlPoints, uint32_t numControlPoints, const float* parameters, CurveFrame* frames)
+{
+    __m128 t = _mm_loadu_ps(parameters);
+    __m128 x[CURVATURE_SIMD_MAX_POINTS];
+    __m128 y[CURVATURE_SIMD_MAX_POINTS];
+    for (uint32_t i = 0; i < numControlPoints; i++)
+    {
+        x[i] = _mm_set1_ps(controlPoints[i].x);
+        y[i] = _mm_set1_ps(controlPoints[i].y);
+    }
+
+    // Stop at the last three points, the derivatives are differences of the final levels
+    for (uint32_t n = 1; n + 2 < numControlPoints; n++)
+    {
+        for (uint32_t i = 0; i < numControlPoints - n; i++)
+        {
+            x[i] = Lerp4(x[i], x[i + 1], t);
+            y[i] = Lerp4(y[i], y[i + 1], t);
+        }
+    }
+
+    float degree = float(numControlPoints - 1);
+    __m128 degreeFactor = _mm_set1_ps(degree);
+    __m128 secondFactor = _mm_set1_ps(degree * (degree - 1.0f));
+    __m128 two = _mm_set1_ps(2.0f);
+    __m128 secondX = _mm_mul_ps(_mm_add_ps(_mm_sub_ps(x[2], _mm_mul_ps(two, x[1])), x[0]), secondFactor);
+    __m128 secondY = _mm_mul_ps(_mm_add_ps(_mm_sub_ps(y[2], _mm_mul_ps(two, y[1])), y[0]), secondFactor);
+
+    __m128 ax = Lerp4(x[0], x[1], t);
+    __m128 ay = Lerp4(y[0], y[1], t);
+    __m128 bx = Lerp4(x[1], x[2], t);
+    __m128 by = Lerp4(y[1], y[2], t);
+    __m128 firstX = _mm_mul_ps(_mm_sub_ps(bx, ax), degreeFactor);
+    __m128 firstY = _mm_mul_ps(_mm_sub_ps(by, ay), degreeFactor);
+    __m128 pointX = Lerp4(ax, bx, t);
+    __m128 pointY = Lerp4(ay, by, t);
+
+    // Lanes at stationary points divide by zero, the mask clears what they computed
+    __m128 speedSquared = _mm_add_ps(_mm_mul_ps(firstX, firstX), _mm_mul_ps(firstY, firstY));
+    __m128 isMoving = _mm_cmpgt_ps(speedSquared, _mm_setzero_ps());
+    __m128 speed = _mm_sqrt_ps(speedSquared);
+    __m128 tangentX = _mm_and_ps(_mm_div_ps(firstX, speed), isMoving);
+    __m128 tangentY = _mm_and_ps(_mm_div_ps(firstY, speed), isMoving);
+    __m128 cross = _mm_sub_ps(_mm_mul_ps(firstX, secondY), _mm_mul_ps(firstY, secondX));
+    __m128 curvature = _mm_and_ps(_mm_div_ps(cross, _mm_mul_ps(speedSquared, speed)), isMoving);
+
+    alignas(16) float values[5][4];
+    _mm_store_ps(values[0], pointX);
+    _mm_store_ps(values[1], pointY);
+    _mm_store_ps(values[2], tangentX);
+    _mm_store_ps(values[3], tangentY);
+    _mm_store_ps(values[4], curvature);
+    for (int lane = 0; lane < 4; lane++)
+    {
+        CurveFrame& frame = frames[lane];
+        frame.Point = glm::vec2(values[0][lane], values[1][lane]);
+        frame.Tangent = glm::vec2(values[2][lane], values[3][lane]);
+        frame.Normal = glm::vec2(-values[3][lane], values[2][lane]);
+        frame.Curvature = values[4][lane];
+    }
+}
+#endif
+
+void EvaluateCurveFrames(const glm::vec2* controlPoints, uint32_t numControlPoints, const float* parameters, uint32_t count, CurveFrame* frames)
+{
+    if (numControlPoints == 0)
+        return;
+
+    uint32_t first = 0;
+#if defined(CURVATURE_SIMD_ENABLED)
+    if (numControlPoints >= 3 && numControlPoints <= CURVATURE_SIMD_MAX_POINTS)
+    {
+        for (; first + 4 <= count; first += 4)
+            EvaluateCurveFrames4(controlPoints, numControlPoints, parameters + first, frames + first);
+    }
+#endif
+
+    glm::vec2 scratch[CURVATURE_SIMD_MAX_POINTS];
+    glm::vec2* scratchPoints = scratch;
+    std::vector<glm::vec2> heapScratch;
+    if (numControlPoints > CURVATURE_SIMD_MAX_POINTS)
+    {
+        heapScratch.resize(numControlPoints);
+        scratchPoints = heapScratch.data();
+    }
+
+    for (uint32_t i = first; i < count; i++)
+        frames[i] = EvaluateCurveFrame(controlPoints, numControlPoints, parameters[i], scratchPoints);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// Frames are evaluated four parameters at a time with SSE2, which every x64 target has. Curves with more control points
+// than fit in registers take the scalar path
+#if (defined(__SSE2__) || defined(_M_X64)) && !defined(CURVATURE_NO_SIMD)
+#define CURVATURE_SIMD_ENABLED
+#endif
+#define CURVATURE_SIMD_MAX_POINTS 16
+
+// Differential geometry of a curve at one parameter. Normal is the tangent turned a quarter to the left, curvature is
+// positive where the curve turns left. Stationary points, where the derivative vanishes, get a zero tangent, normal and
+// curvature
+struct CurveFrame
+{
+    glm::vec2 Point;
+    glm::vec2 Tangent;
+    glm::vec2 Normal;
+    float Curvature;
+};
+
+// Control points of the hodograph, the derivative of the curve as a curve of one degree less. hodograph receives
+// numControlPoints - 1 points, applying it twice gives the second derivative
+void ComputeBezierHodograph(const glm::vec2* controlPoints, uint32_t numControlPoints, glm::vec2* hodograph);
+
+// Frame at t from one de Casteljau pass, scratch must hold numControlPoints points
+CurveFrame EvaluateCurveFrame(const glm::vec2* controlPoints, uint32_t numControlPoints, float t, glm::vec2* scratch);
+// Frames at count parameters. With SIMD four parameters are evaluated at once, one per lane, with the same results as
+// EvaluateCurveFrame
+void EvaluateCurveFrames(const glm::vec2* controlPoints, uint32_t numControlPoints, const float* parameters, uint32_t count, CurveFrame* frames);
@@ -0,0 +1,406 @@
+#include "curvebounds.h"
+#include "bezier.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#if defined(CURVE_BOUNDS_SIMD_ENABLED)
+#include <emmintrin.h>
+#endif
+
+// de Casteljau evaluation of a polynomial in Bernstein form, scratch must hold numCoefficients values
+static float EvaluateBernstein(const float* coefficients, uint32_t numCoefficients, float t, float* scratch)
+{
+    for (uint32_t i = 0; i < numCoefficients; i++)
+        scratch[i] = coefficients[i];
+
+    for (uint32_t n = numCoefficients - 1; n > 0; n--)
+    {
+        for (uint32_t i = 0; i < n; i++)
+            scratch[i] = scratch[i] + (scratch[i + 1] - scratch[i]) * t;
+    }
+
+    return scratch[0];
+}
+
+// Horner's scheme on the Bernstein form, linear instead of quadratic in the degree but less accurate than de Casteljau.
+// Good enough to locate a root, t / (1 - t) or its inverse stays below 1 so the powers cannot overflow
+static float EvaluateBernsteinHorner(const float* coefficients, uint32_t numCoefficients, float t)
+{
+    uint32_t degree = numCoefficients - 1;
+    bool isReversed = t > 0.5f;
+    float s = isReversed ? t : 1.0f - t;
+    float u = isReversed ? (1.0f - t) / t : t / (1.0f - t);
+
+    float binomial = 1.0f;
+    float value = isReversed ? coefficients[0] : coefficients[degree];
+    float power = 1.0f;
+    for (uint32_t i = 1; i <= degree; i++)
+    {
+        binomial = binomial * (degree - i + 1) / i;
+        value = value * u + binomial * (isReversed ? coefficients[i] : coefficients[degree - i]);
+        power *= s;
+    }
+
+    return value * power;
+}
+
+// The number of sign changes of the Bernstein coefficients bounds the number of roots in the open interval and has the
+// same parity. No change means no root, a single change means exactly one. Zero coefficients do not change the sign
+static uint32_t CountSignChanges(const float* coefficients, uint32_t numCoefficients, float& firstNonZero)
+{
+    uint32_t changes = 0;
+    firstNonZero = 0.0f;
+    float previous = 0.0f;
+    for (uint32_t i = 0; i < numCoefficients; i++)
+    {
+        if (coefficients[i] == 0.0f)
+            continue;
+
+        if (previous == 0.0f)
+            firstNonZero = coefficients[i];
+        else if ((coefficients[i] > 0.0f) != (previous > 0.0f))
+            changes++;
+
+        previous = coefficients[i];
+    }
+
+    return changes;
+}
+
+// Root of a polynomial with exactly one root in (0, 1), by regula falsi with the Illinois modification. Falls back to
+// bisection while an end of the bracket is a root itself. Near 0 the polynomial has the sign of its first non-zero
+// coefficient, even if it starts at zero
+static float FindSingleRoot(const float* coefficients, uint32_t numCoefficients, float firstNonZero)
+{
+    float low = 0.0f;
+    float high = 1.0f;
+    float lowValue = coefficients[0];
+    float highValue = coefficients[numCoefficients - 1];
+    float t = 0.5f;
+    int lastSide = 0;
+    for (uint32_t iteration = 0; iteration < CURVE_BOUNDS_ROOT_ITERATIONS; iteration++)
+    {
+        float previous = t;
+        t = 0.5f * (low + high);
+        if (lowValue != 0.0f && highValue != 0.0f)
+        {
+            float secant = (low * highValue - high * lowValue) / (highValue - lowValue);
+            if (secant > low && secant < high)
+                t = secant;
+        }
+
+        float value = EvaluateBernsteinHorner(coefficients, numCoefficients, t);
+        if (value == 0.0f || (iteration > 0 && std::abs(t - previous) < CURVE_BOUNDS_ROOT_TOLERANCE))
+            break;
+
+        if ((value > 0.0f) == (firstNonZero > 0.0f))
+        {
+            low = t;
+            lowValue = value;
+            if (lastSide == -1)
+                highValue *= 0.5f;
+            lastSide = -1;
+        }
+        else
+        {
+            high = t;
+            highValue = value;
+            if (lastSide == 1)
+                lowValue *= 0.5f;
+            lastSide = 1;
+        }
+    }
+
+    return t;
+}
+
+// Extends [boundsMin, boundsMax] by one component of the curve over an interval, given by its Bernstein coefficients.
+// The end coefficients are points on the curve. The component's extrema inside the interval are the roots of its
+// derivative, whose coefficients are the differences of the component's. Intervals whose coefficients already lie within
+// the bounds cannot extend them and are skipped, the others are split until their derivative has at most one root.
+// scratch holds two rows of coefficients for every remaining level of subdivision
+static void ExtendComponentBounds(const float* coefficients, uint32_t numCoefficients, uint32_t depth, float* scratch, float& boundsMin, float& boundsMax)
+{
+    boundsMin = std::min({ boundsMin, coefficients[0], coefficients[numCoefficients - 1] });
+    boundsMax = std::max({ boundsMax, coefficients[0], coefficients[numCoefficients - 1] });
+
+    float hullMin = coefficients[0];
+    float hullMax = coefficients[0];
+    for (uint32_t i = 1; i < numCoefficients; i++)
+    {
+        hullMin = std::min(hullMin, coefficients[i]);
+        hullMax = std::max(hullMax, coefficients[i]);
+    }
+
+    if (hullMin >= boundsMin && hullMax <= boundsMax)
+        return;
+
+    float* derivative = scratch;
+    for (uint32_t i = 0; i + 1 < numCoefficients; i++)
+        derivative[i] = coefficients[i + 1] - coefficients[i];
+
+    float firstNonZero;
+    uint32_t changes = CountSignChanges(derivative, numCoefficients - 1, firstNonZero);
+    if (changes == 0)
+        return;
+
+    if (changes == 1)
+    {
+        float t = FindSingleRoot(derivative, numCoefficients - 1, firstNonZero);
+        float value = EvaluateBernstein(coefficients, numCoefficients, t, scratch + numCoefficients);
+        boundsMin = std::min(boundsMin, value);
+        boundsMax = std::max(boundsMax, value);
+        return;
+    }
+
+    // Only reached by extrema of high multiplicity, the coefficients are within rounding of the curve by now
+    if (depth == CURVE_BOUNDS_MAX_ROOT_DEPTH)
+    {
+        boundsMin = std::min(boundsMin, hullMin);
+        boundsMax = std::max(boundsMax, hullMax);
+        return;
+    }
+
+    // de Casteljau split at the middle, the left half is read off the first entries of each row, the right half is what
+    // remains of the last entries
+    float* left = scratch;
+    float* right = scratch + numCoefficients;
+    for (uint32_t i = 0; i < numCoefficients; i++)
+        right[i] = coefficients[i];
+
+    for (uint32_t n = 0; n < numCoefficients; n++)
+    {
+        left[n] = right[0];
+        for (uint32_t i = 0; i + n + 1 < numCoefficients; i++)
+            right[i] = right[i] + (right[i + 1] - right[i]) * 0.5f;
+    }
+
+    ExtendComponentBounds(left, numCoefficients, depth + 1, scratch + 2 * numCoefficients, boundsMin, boundsMax);
+    ExtendComponentBounds(right, numCoefficients, depth + 1, scratch + 2 * numCoefficients, boundsMin, boundsMax);
+}
+
+// Roots of the derivative of a cubic component in (0, 1). The stable form of the quadratic formula also gives the root
+// of a derivative that is linear, a = 0 turns the first root into an infinity that the range test rejects
+static uint32_t SolveCubicDerivative(float p0, float p1, float p2, float p3, float* roots)
+{
+    float d0 = p1 - p0;
+    float d1 = p2 - p1;
+    float d2 = p3 - p2;
+
+    float a = d0 - 2.0f * d1 + d2;
+    float b = 2.0f * (d1 - d0);
+    float c = d0;
+
+    float discriminant = b * b - 4.0f * a * c;
+    if (discriminant < 0.0f)
+        return 0;
+
+    float q = -0.5f * (b + std::copysign(std::sqrt(discriminant), b));
+    float candidates[2] = { q / a, c / q };
+
+    uint32_t numRoots = 0;
+    for (float t : candidates)
+    {
+        if (t > 0.0f && t < 1.0f)
+            roots[numRoots++] = t;
+    }
+
+    return numRoots;
+}
+
+void GetControlPointBounds(const glm::vec2* controlPoints, uint32_t numControlPoints, glm::vec2& boundsMin, glm::vec2& boundsMax)
+{
+    boundsMin = glm::vec2(FLT_MAX);
+    boundsMax = glm::vec2(-FLT_MAX);
+    for (uint32_t i = 0; i < numControlPoints; i++)
+    {
+        boundsMin = glm::min(boundsMin, controlPoints[i]);
+        boundsMax = glm::max(boundsMax, controlPoints[i]);
+    }
+}
+
+void GetBezierBounds(const glm::vec2* controlPoints, uint32_t numControlPoints, glm::vec2& boundsMin, glm::vec2& boundsMax)
+{
+    if (numControlPoints == 0)
+    {
+        boundsMin = glm::vec2(FLT_MAX);
+        boundsMax = glm::vec2(-FLT_MAX);
+        return;
+    }
+
+    const glm::vec2& start = controlPoints[0];
+    const glm::vec2& end = controlPoints[numControlPoints - 1];
+    boundsMin = glm::min(start, end);
+    boundsMax = glm::max(start, end);
+
+    if (numControlPoints == 3)
+    {
+        for (int axis = 0; axis < 2; axis++)
+        {
+            float d0 = controlPoints[1][axis] - controlPoints[0][axis];
+            float d1 = controlPoints[2][axis] - controlPoints[1][axis];
+            float t = d0 / (d0 - d1);
+            if (t > 0.0f && t < 1.0f)
+            {
+                glm::vec2 point = EvaluateBezier<2>(controlPoints, t);
+                boundsMin = glm::min(boundsMin, point);
+                boundsMax = glm::max(boundsMax, point);
+            }
+        }
+    }
+    else if (numControlPoints == 4)
+    {
+        // Same operations as the SIMD path of ComputeSceneBounds, both give the same bounds
+        for (int axis = 0; axis < 2; axis++)
+        {
+            float roots[2];
+            uint32_t numRoots = SolveCubicDerivative(controlPoints[0][axis], controlPoints[1][axis], controlPoints[2][axis], controlPoints[3][axis], roots);
+            for (uint32_t i = 0; i < numRoots; i++)
+            {
+                glm::vec2 point = EvaluateBezier<3>(controlPoints, roots[i]);
+                boundsMin = glm::min(boundsMin, point);
+                boundsMax = glm::max(boundsMax, point);
+            }
+        }
+    }
+    else if (numControlPoints > 4)
+    {
+        // The coefficients of the component and two rows for every level of subdivision
+        size_t scratchSize = (size_t)numControlPoints * (2 * CURVE_BOUNDS_MAX_ROOT_DEPTH + 3);
+
+        float stackScratch[CURVE_BOUNDS_STACK_POINTS * (2 * CURVE_BOUNDS_MAX_ROOT_DEPTH + 3)];
+        std::vector<float> heapScratch;
+        float* scratch = stackScratch;
+        if (numControlPoints > CURVE_BOUNDS_STACK_POINTS)
+        {
+            heapScratch.resize(scratchSize);
+            scratch = heapScratch.data();
+        }
+
+        // The components are independent, each is bounded on its own
+        for (int axis = 0; axis < 2; axis++)
+        {
+            float* coefficients = scratch;
+            for (uint32_t i = 0; i < numControlPoints; i++)
+                coefficients[i] = controlPoints[i][axis];
+
+            ExtendComponentBounds(coefficients, numControlPoints, 0, scratch + numControlPoints, boundsMin[axis], boundsMax[axis]);
+        }
+    }
+}
+
+#if defined(CURVE_BOUNDS_SIMD_ENABLED)
+// GetBezierBounds of four cubic curves at once, one curve per lane. Lanes whose root is outside (0, 1) evaluate the
+// curve at 0 instead, the start point is part of the bounds already
+static void GetCubicBounds4(const SceneView& scene, const uint32_t* curves, glm::vec2* boundsMin, glm::vec2* boundsMax)
+{
+    const glm::vec2* controlPoints[4];
+    for (int lane = 0; lane < 4; lane++)
+        controlPoints[lane] = scene.Positions + scene.Curves[curves[lane]].FirstControlPoint;
+
+    __m128 p[2][4];
+    for (int axis = 0; axis < 2; axis++)
+    {
+        for (int i = 0; i < 4; i++)
+            p[axis][i] = _mm_setr_ps(controlPoints[0][i][axis], controlPoints[1][i][axis], controlPoints[2][i][axis], controlPoints[3][i][axis]);
+    }
+
+    __m128 lo[2], hi[2];
+    for (int axis = 0; axis < 2; axis++)
+    {
+        lo[axis] = _mm_min_ps(p[axis][0], p[axis][3]);
+        hi[axis] = _mm_max_ps(p[axis][0], p[axis][3]);
+    }
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    for (int axis = 0; axis < 2; axis++)
+    {
+        __m128 d0 = _mm_sub_ps(p[axis][1], p[axis][0]);
+        __m128 d1 = _mm_sub_ps(p[axis][2], p[axis][1]);
+        __m128 d2 = _mm_sub_ps(p[axis][3], p[axis][2]);
+
+        __m128 a = _mm_add_ps(_mm_sub_ps(d0, _mm_mul_ps(_mm_set1_ps(2.0f), d1)), d2);
+        __m128 b = _mm_mul_ps(_mm_set1_ps(2.0f), _mm_sub_ps(d1, d0));
+        __m128 c = d0;
+
+        __m128 discriminant = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(4.0f), a), c));
+        __m128 hasRoots = _mm_cmpge_ps(discriminant, zero);
+        __m128 root = _mm_sqrt_ps(_mm_max_ps(discriminant, zero));
+        __m128 q = _mm_mul_ps(_mm_set1_ps(-0.5f), _mm_add_ps(b, _mm_or_ps(root, _mm_and_ps(b, signMask))));
+
+        __m128 candidates[2] = { _mm_div_ps(q, a), _mm_div_ps(c, q) };
+        for (__m128 t : candidates)
+        {
+            __m128 isInside = _mm_and_ps(hasRoots, _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmplt_ps(t, one)));
+            t = _mm_and_ps(isInside, t);
+
+            // de Casteljau on both components, in the order of EvaluateBezier<3>
+            for (int component = 0; component < 2; component++)
+            {
+                __m128 points[4] = { p[component][0], p[component][1], p[component][2], p[component][3] };
+                for (int n = 1; n <= 3; n++)
+                {
+                    for (int i = 0; i <= 3 - n; i++)
+                        points[i] = _mm_add_ps(points[i], _mm_mul_ps(_mm_sub_ps(points[i + 1], points[i]), t));
+                }
+
+                lo[component] = _mm_min_ps(lo[component], points[0]);
+                hi[component] = _mm_max_ps(hi[component], points[0]);
+            }
+        }
+    }
+
+    float values[4][4];
+    _mm_storeu_ps(values[0], lo[0]);
+    _mm_storeu_ps(values[1], lo[1]);
+    _mm_storeu_ps(values[2], hi[0]);
+    _mm_storeu_ps(values[3], hi[1]);
+    for (int lane = 0; lane < 4; lane++)
+    {
+        boundsMin[curves[lane]] = glm::vec2(values[0][lane], values[1][lane]);
+        boundsMax[curves[lane]] = glm::vec2(values[2][lane], values[3][lane]);
+    }
+}
+#endif
+
+void ComputeSceneBounds(const SceneView& scene, glm::vec2* boundsMin, glm::vec2* boundsMax)
+{
+#if defined(CURVE_BOUNDS_SIMD_ENABLED)
+    // Cubic curves are collected until four fill the lanes, all other degrees go through the scalar path right away
+    uint32_t pendingCurves[4];
+    uint32_t numPending = 0;
+    for (uint32_t i = 0; i < scene.NumCurves; i++)
+    {
+        const SceneCurve& curve = scene.Curves[i];
+        if (curve.NumControlPoints != 4)
+        {
+            GetBezierBounds(scene.Positions + curve.FirstControlPoint, curve.NumControlPoints, boundsMin[i], boundsMax[i]);
+            continue;
+        }
+
+        pendingCurves[numPending++] = i;
+        if (numPending == 4)
+        {
+            GetCubicBounds4(scene, pendingCurves, boundsMin, boundsMax);
+            numPending = 0;
+        }
+    }
+
+    for (uint32_t i = 0; i < numPending; i++)
+    {
+        const SceneCurve& curve = scene.Curves[pendingCurves[i]];
+        GetBezierBounds(scene.Positions + curve.FirstControlPoint, curve.NumControlPoints, boundsMin[pendingCurves[i]], boundsMax[pendingCurves[i]]);
+    }
+#else
+    for (uint32_t i = 0; i < scene.NumCurves; i++)
+    {
+        const SceneCurve& curve = scene.Curves[i];
+        GetBezierBounds(scene.Positions + curve.FirstControlPoint, curve.NumControlPoints, boundsMin[i], boundsMax[i]);
+    }
+#endif
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "scene.h"
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// Root isolation stops splitting an interval at this depth and bounds it by its coefficients, only reached by extrema of
+// high multiplicity
+#define CURVE_BOUNDS_MAX_ROOT_DEPTH 24
+// Refinement of an isolated root stops after this many steps or once a step moves it by less than the tolerance. An
+// extremum that is off by d only misses the curve's extent by the order of d squared
+#define CURVE_BOUNDS_ROOT_ITERATIONS 32
+#define CURVE_BOUNDS_ROOT_TOLERANCE 1e-6f
+// Curves with more control points need heap scratch memory for the root isolation
+#define CURVE_BOUNDS_STACK_POINTS 64
+
+// Cubic curves of a scene are bounded four at a time with SSE2, which every x64 target has
+#if (defined(__SSE2__) || defined(_M_X64)) && !defined(CURVE_BOUNDS_NO_SIMD)
+#define CURVE_BOUNDS_SIMD_ENABLED
+#endif
+
+// Bounds of the control points, which contain the curve but can be much larger than it
+void GetControlPointBounds(const glm::vec2* controlPoints, uint32_t numControlPoints, glm::vec2& boundsMin, glm::vec2& boundsMax);
+
+// Exact bounds of the curve: the end points and the points where a component of the derivative is zero. The derivative
+// roots of curves up to cubic are solved in closed form. Higher degrees isolate them by subdividing the Bernstein
+// coefficients of each component until its derivative changes sign at most once, then refine the single root
+void GetBezierBounds(const glm::vec2* controlPoints, uint32_t numControlPoints, glm::vec2& boundsMin, glm::vec2& boundsMax);
+
+// Exact bounds of every curve of the scene, boundsMin and boundsMax hold one entry per curve. Curves without control
+// points get empty bounds, min above max
+void ComputeSceneBounds(const SceneView& scene, glm::vec2* boundsMin, glm::vec2* boundsMax);
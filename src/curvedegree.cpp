@@ -0,0 +1,309 @@
+#include "curvedegree.h"
+#include "bezier.h"
+#include "jobsystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Row n of Pascal's triangle, binomials must hold n + 1 values
+static void GetBinomials(uint32_t n, double* binomials)
+{
+    binomials[0] = 1.0;
+    for (uint32_t k = 1; k <= n; k++)
+        binomials[k] = binomials[k - 1] * (n - k + 1) / k;
+}
+
+// Control points of a curve of degree m whose first continuity derivatives at t = 0 match those of a curve of degree n.
+// The j-th derivative at t = 0 is n! / (n - j)! times the j-th forward difference of the first control points, so the
+// j-th difference of the reduction is the one of the curve scaled by the ratio of the two factors, and the j-th control
+// point follows from it and the points before
+static void MatchStartDerivatives(const glm::vec2* controlPoints, uint32_t n, uint32_t m, uint32_t continuity, glm::vec2* matched)
+{
+    glm::vec2 differences[CURVE_DEGREE_MAX_POINTS];
+    for (uint32_t i = 0; i <= continuity; i++)
+        differences[i] = controlPoints[i];
+
+    matched[0] = controlPoints[0];
+    double scale = 1.0;
+    for (uint32_t j = 1; j <= continuity; j++)
+    {
+        for (uint32_t i = 0; i + j <= continuity; i++)
+            differences[i] = differences[i + 1] - differences[i];
+        scale *= double(n - j + 1) / double(m - j + 1);
+
+        // The j-th difference is the sum over i of (-1)^(j - i) C(j, i) R_i
+        glm::dvec2 point = scale * glm::dvec2(differences[0]);
+        double binomial = 1.0;
+        for (uint32_t i = 0; i < j; i++)
+        {
+            double sign = (j - i) % 2 ? -1.0 : 1.0;
+            point -= sign * binomial * glm::dvec2(matched[i]);
+            binomial = binomial * (j - i) / (i + 1);
+        }
+        matched[j] = glm::vec2(point);
+    }
+}
+
+void ElevateBezierDegree(const glm::vec2* controlPoints, uint32_t numControlPoints, glm::vec2* elevated)
+{
+    if (numControlPoints == 0)
+        return;
+
+    // Q_i = i / (n + 1) P_(i - 1) + (1 - i / (n + 1)) P_i, written from the back so elevated may alias controlPoints
+    elevated[numControlPoints] = controlPoints[numControlPoints - 1];
+    for (uint32_t i = numControlPoints - 1; i > 0; i--)
+    {
+        float alpha = float(i) / numControlPoints;
+        elevated[i] = alpha * controlPoints[i - 1] + (1.0f - alpha) * controlPoints[i];
+    }
+    elevated[0] = controlPoints[0];
+}
+
+void ElevateBezierDegree(const glm::vec2* controlPoints, uint32_t numControlPoints, uint32_t numElevatedPoints, glm::vec2* elevated)
+{
+    if (elevated != controlPoints)
+        std::copy(controlPoints, controlPoints + numControlPoints, elevated);
+
+    for (uint32_t n = numControlPoints; n > 0 && n < numElevatedPoints; n++)
+        ElevateBezierDegree(elevated, n, elevated);
+}
+
+float ReduceBezierDegree(const glm::vec2* controlPoints, uint32_t numControlPoints, uint32_t numReducedPoints, uint32_t continuity, glm::vec2* reduced)
+{
+    if (numReducedPoints >= numControlPoints)
+    {
+        ElevateBezierDegree(controlPoints, numControlPoints, numReducedPoints, reduced);
+        return 0.0f;
+    }
+
+    // A single point has no ends to match and the solver only holds CURVE_DEGREE_MAX_POINTS, reduced is left as it is
+    if (numReducedPoints < 2 || numControlPoints > CURVE_DEGREE_MAX_POINTS)
+        return std::numeric_limits<float>::infinity();
+
+    uint32_t n = numControlPoints - 1;
+    uint32_t m = numReducedPoints - 1;
+
+    // Both ends fix continuity + 1 control points, at least one of them is fixed at each end
+    continuity = std::min(continuity, numReducedPoints / 2 - 1);
+    MatchStartDerivatives(controlPoints, n, m, continuity, reduced);
+
+    glm::vec2 reversed[CURVE_DEGREE_MAX_POINTS];
+    glm::vec2 reversedMatched[CURVE_DEGREE_MAX_POINTS];
+    for (uint32_t i = 0; i <= continuity; i++)
+        reversed[i] = controlPoints[n - i];
+    MatchStartDerivatives(reversed, n, m, continuity, reversedMatched);
+    for (uint32_t i = 0; i <= continuity; i++)
+        reduced[m - i] = reversedMatched[i];
+
+    // Normal equations of the free control points. The integral over [0, 1] of the product of the Bernstein polynomials
+    // B_i^m and B_j^n is C(m, i) C(n, j) / ((m + n + 1) C(m + n, i + j)). The Gram matrix of the basis is symmetric positive
+    // definite, so elimination needs no pivoting
+    double binomialsM[CURVE_DEGREE_MAX_POINTS];
+    double binomialsN[CURVE_DEGREE_MAX_POINTS];
+    double binomialsMM[2 * CURVE_DEGREE_MAX_POINTS];
+    double binomialsMN[2 * CURVE_DEGREE_MAX_POINTS];
+    GetBinomials(m, binomialsM);
+    GetBinomials(n, binomialsN);
+    GetBinomials(2 * m, binomialsMM);
+    GetBinomials(m + n, binomialsMN);
+
+    uint32_t firstFree = continuity + 1;
+    uint32_t numFree = numReducedPoints - 2 * firstFree;
+    double matrix[CURVE_DEGREE_MAX_POINTS][CURVE_DEGREE_MAX_POINTS];
+    glm::dvec2 rightSide[CURVE_DEGREE_MAX_POINTS];
+    for (uint32_t a = 0; a < numFree; a++)
+    {
+        uint32_t i = firstFree + a;
+        double scaleMM = binomialsM[i] / (2 * m + 1);
+        for (uint32_t b = 0; b < numFree; b++)
+            matrix[a][b] = scaleMM * binomialsM[firstFree + b] / binomialsMM[i + firstFree + b];
+
+        double scaleMN = binomialsM[i] / (m + n + 1);
+        rightSide[a] = glm::dvec2(0.0);
+        for (uint32_t l = 0; l <= n; l++)
+            rightSide[a] += scaleMN * binomialsN[l] / binomialsMN[i + l] * glm::dvec2(controlPoints[l]);
+        for (uint32_t j = 0; j < firstFree; j++)
+        {
+            rightSide[a] -= scaleMM * binomialsM[j] / binomialsMM[i + j] * glm::dvec2(reduced[j]);
+            rightSide[a] -= scaleMM * binomialsM[m - j] / binomialsMM[i + m - j] * glm::dvec2(reduced[m - j]);
+        }
+    }
+
+    for (uint32_t a = 0; a < numFree; a++)
+    {
+        for (uint32_t b = a + 1; b < numFree; b++)
+        {
+            double factor = matrix[b][a] / matrix[a][a];
+            for (uint32_t c = a; c < numFree; c++)
+                matrix[b][c] -= factor * matrix[a][c];
+            rightSide[b] -= factor * rightSide[a];
+        }
+    }
+
+    for (uint32_t a = numFree; a-- > 0;)
+    {
+        glm::dvec2 point = rightSide[a];
+        for (uint32_t b = a + 1; b < numFree; b++)
+            point -= matrix[a][b] * glm::dvec2(reduced[firstFree + b]);
+        reduced[firstFree + a] = glm::vec2(point / matrix[a][a]);
+    }
+
+    glm::vec2 elevated[CURVE_DEGREE_MAX_POINTS];
+    ElevateBezierDegree(reduced, numReducedPoints, numControlPoints, elevated);
+    float maxDistanceSquared = 0.0f;
+    for (uint32_t i = 0; i <= n; i++)
+    {
+        glm::vec2 difference = elevated[i] - controlPoints[i];
+        maxDistanceSquared = std::max(maxDistanceSquared, glm::dot(difference, difference));
+    }
+
+    return std::sqrt(maxDistanceSquared);
+}
+
+void ConvertBezierDegree(const glm::vec2* controlPoints, uint32_t numControlPoints, uint32_t numTargetPoints, float tolerance, uint32_t continuity,
+    std::vector<glm::vec2>& segments, std::vector<float>& parameters, CurveDegreeStats& stats)
+{
+    if (numControlPoints == 0 || numTargetPoints < 2)
+        return;
+
+    if (numControlPoints > CURVE_DEGREE_MAX_POINTS || numTargetPoints > CURVE_DEGREE_MAX_POINTS)
+    {
+        segments.insert(segments.end(), controlPoints, controlPoints + numControlPoints);
+        parameters.push_back(0.0f);
+        stats.NumSegments++;
+        stats.NumSkippedCurves++;
+        return;
+    }
+
+    if (numTargetPoints >= numControlPoints)
+    {
+        size_t first = segments.size();
+        segments.resize(first + numTargetPoints);
+        ElevateBezierDegree(controlPoints, numControlPoints, numTargetPoints, &segments[first]);
+        parameters.push_back(0.0f);
+        stats.NumSegments++;
+        return;
+    }
+
+    // rest holds the curve from t0 to 1, candidates are split off its start
+    glm::vec2 rest[CURVE_DEGREE_MAX_POINTS];
+    glm::vec2 candidate[CURVE_DEGREE_MAX_POINTS];
+    glm::vec2 remainder[CURVE_DEGREE_MAX_POINTS];
+    glm::vec2 reduced[CURVE_DEGREE_MAX_POINTS];
+    std::copy(controlPoints, controlPoints + numControlPoints, rest);
+
+    float t0 = 0.0f;
+    while (true)
+    {
+        // Length of the candidate as a fraction of the rest of the curve
+        float length = 1.0f;
+        for (uint32_t step = 0; ; step++)
+        {
+            if (length < 1.0f)
+                SplitBezier(rest, numControlPoints, length, candidate, remainder);
+            else
+                std::copy(rest, rest + numControlPoints, candidate);
+
+            float error = ReduceBezierDegree(candidate, numControlPoints, numTargetPoints, continuity, reduced);
+            stats.NumReductions++;
+
+            bool isShortest = step + 1 == CURVE_DEGREE_SEARCH_STEPS || length * (1.0f - t0) < CURVE_DEGREE_MIN_SPAN;
+            if (error <= tolerance || isShortest)
+            {
+                stats.MaxError = std::max(stats.MaxError, error);
+                break;
+            }
+
+            // The error shrinks with about the numTargetPoints power of the length, aim a little short of the tolerance
+            float predicted = 0.9f * std::pow(tolerance / error, 1.0f / numTargetPoints);
+            length *= std::clamp(predicted, 0.1f, 0.9f);
+        }
+
+        segments.insert(segments.end(), reduced, reduced + numTargetPoints);
+        parameters.push_back(t0);
+        stats.NumSegments++;
+        if (length == 1.0f)
+            break;
+
+        t0 += length * (1.0f - t0);
+        std::copy(remainder, remainder + numControlPoints, rest);
+    }
+}
+
+void CurveDegreeConverter::ConvertScene(JobSystem& jobSystem, const SceneView& scene, uint32_t numTargetPoints, float tolerance, uint32_t continuity)
+{
+    m_CurveResults.resize(scene.NumCurves);
+    jobSystem.ParallelFor(scene.NumCurves, 16, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            const SceneCurve& curve = scene.Curves[i];
+            CurveResult& result = m_CurveResults[i];
+            result.ControlPoints.clear();
+            result.Parameters.clear();
+            result.Stats = CurveDegreeStats();
+            ConvertBezierDegree(scene.Positions + curve.FirstControlPoint, curve.NumControlPoints, numTargetPoints, tolerance, continuity,
+                result.ControlPoints, result.Parameters, result.Stats);
+        }
+    });
+
+    // Gathered in curve order, so the result does not depend on how the curves were scheduled
+    m_Stats = CurveDegreeStats();
+    m_FirstCurves.resize(scene.NumCurves + 1);
+    m_FirstControlPoints.resize(scene.NumCurves + 1);
+    uint32_t numCurves = 0;
+    uint32_t numControlPoints = 0;
+    for (uint32_t i = 0; i < scene.NumCurves; i++)
+    {
+        const CurveResult& result = m_CurveResults[i];
+        m_FirstCurves[i] = numCurves;
+        m_FirstControlPoints[i] = numControlPoints;
+        numCurves += result.Parameters.size();
+        numControlPoints += result.ControlPoints.size();
+
+        m_Stats.NumSegments += result.Stats.NumSegments;
+        m_Stats.NumReductions += result.Stats.NumReductions;
+        m_Stats.NumSkippedCurves += result.Stats.NumSkippedCurves;
+        m_Stats.MaxError = std::max(m_Stats.MaxError, result.Stats.MaxError);
+    }
+    m_FirstCurves[scene.NumCurves] = numCurves;
+    m_FirstControlPoints[scene.NumCurves] = numControlPoints;
+
+    m_Scene.Settings = scene.Settings;
+    m_Scene.Curves.resize(numCurves);
+    m_Scene.Positions.resize(numControlPoints);
+    m_Scene.Colors.resize(numControlPoints);
+    m_StartParameters.resize(numCurves);
+    jobSystem.ParallelFor(scene.NumCurves, 64, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            const SceneCurve& sourceCurve = scene.Curves[i];
+            const CurveResult& result = m_CurveResults[i];
+            uint32_t numSegments = result.Parameters.size();
+            uint32_t numSegmentPoints = numSegments ? result.ControlPoints.size() / numSegments : 0;
+            std::copy(result.ControlPoints.begin(), result.ControlPoints.end(), m_Scene.Positions.begin() + m_FirstControlPoints[i]);
+            std::copy(result.Parameters.begin(), result.Parameters.end(), m_StartParameters.begin() + m_FirstCurves[i]);
+
+            for (uint32_t segment = 0; segment < numSegments; segment++)
+            {
+                SceneCurve& curve = m_Scene.Curves[m_FirstCurves[i] + segment];
+                curve.Color = sourceCurve.Color;
+                curve.Thickness = sourceCurve.Thickness;
+                curve.FirstControlPoint = m_FirstControlPoints[i] + segment * numSegmentPoints;
+                curve.NumControlPoints = numSegmentPoints;
+
+                // Every control point takes the color of the source control point nearest to it in parameter
+                float t0 = result.Parameters[segment];
+                float t1 = segment + 1 < numSegments ? result.Parameters[segment + 1] : 1.0f;
+                for (uint32_t j = 0; j < numSegmentPoints; j++)
+                {
+                    float t = numSegmentPoints > 1 ? t0 + (t1 - t0) * j / (numSegmentPoints - 1) : t0;
+                    uint32_t nearest = std::min<uint32_t>(uint32_t(t * (sourceCurve.NumControlPoints - 1) + 0.5f), sourceCurve.NumControlPoints - 1);
+                    m_Scene.Colors[curve.FirstControlPoint + j] = scene.Colors[sourceCurve.FirstControlPoint + nearest];
+                }
+            }
+        }
+    });
+}
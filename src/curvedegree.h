@@ -0,0 +1,87 @@
+#pragma once
+
+#include "scene.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class JobSystem;
+
+// Largest distance between a point of the curve and the point of its reduction at the same parameter, in scene units. The
+// viewport spans 2 units, so about a quarter of a pixel
+#define CURVE_DEGREE_DEFAULT_TOLERANCE 0.0005f
+// Derivatives of the curve the reduction matches at both ends of every segment, 1 keeps the segments of a split curve
+// joined with the tangents of the curve
+#define CURVE_DEGREE_DEFAULT_CONTINUITY 1
+// Curves with more control points are not reduced, they are copied unchanged
+#define CURVE_DEGREE_MAX_POINTS 64
+// Candidate segments tried per emitted segment before the shortest one is taken whatever its error
+#define CURVE_DEGREE_SEARCH_STEPS 8
+// Segments shorter than this parameter range are emitted even if they miss the tolerance
+#define CURVE_DEGREE_MIN_SPAN 1e-4f
+
+struct CurveDegreeStats
+{
+    uint32_t NumSegments = 0;
+    // Candidate segments reduced, the work done
+    uint32_t NumReductions = 0;
+    // Curves copied unchanged because they have more than CURVE_DEGREE_MAX_POINTS control points
+    uint32_t NumSkippedCurves = 0;
+    float MaxError = 0.0f;
+};
+
+// Exact degree elevation by one, elevated receives numControlPoints + 1 points and may be the same array as controlPoints
+void ElevateBezierDegree(const glm::vec2* controlPoints, uint32_t numControlPoints, glm::vec2* elevated);
+// Repeated exact elevation up to numElevatedPoints control points, elevated may be the same array as controlPoints
+void ElevateBezierDegree(const glm::vec2* controlPoints, uint32_t numControlPoints, uint32_t numElevatedPoints, glm::vec2* elevated);
+
+// Least squares degree reduction to numReducedPoints control points. The first continuity derivatives of the curve are
+// matched exactly at both ends, the control points left free minimize the integral of the squared distance between the
+// curve and its reduction over the parameter range. A cubic that matches the tangents has no free control point left and
+// is the Hermite interpolant of the curve. Returns a bound on the distance between the curve and its reduction at the same
+// parameter: the reduction is elevated back to the degree of the curve, and the difference of the two curves lies in the
+// convex hull of the differences of their control points. Curves with fewer control points are elevated exactly, reductions
+// to fewer than two control points and curves of more than CURVE_DEGREE_MAX_POINTS write nothing and return infinity
+float ReduceBezierDegree(const glm::vec2* controlPoints, uint32_t numControlPoints, uint32_t numReducedPoints, uint32_t continuity, glm::vec2* reduced);
+
+// Converts a curve of any degree into segments with numTargetPoints control points that stay within the tolerance of it.
+// Segments are covered greedily from the start of the curve: the rest of the curve is reduced whole, and while the error
+// is above the tolerance the candidate is shortened by the length predicted from its error, which grows with the number of
+// control points power of the length. The segments are appended to segments, numTargetPoints control points each, and the
+// parameter of the curve where each one starts to parameters, it ends where the next one starts or at 1
+void ConvertBezierDegree(const glm::vec2* controlPoints, uint32_t numControlPoints, uint32_t numTargetPoints, float tolerance, uint32_t continuity,
+    std::vector<glm::vec2>& segments, std::vector<float>& parameters, CurveDegreeStats& stats);
+
+// Converts every curve of a scene into curves with the same number of control points, curves are processed in parallel on
+// the job system's threads. Each segment becomes a curve of its own with the color and thickness of the curve it comes from,
+// its control points take the color of the nearest control point of that curve. The memory of the result is kept between
+// calls, so converting a scene again does not allocate once the segment counts settle
+class CurveDegreeConverter
+{
+public:
+    void ConvertScene(JobSystem& jobSystem, const SceneView& scene, uint32_t numTargetPoints, float tolerance = CURVE_DEGREE_DEFAULT_TOLERANCE,
+        uint32_t continuity = CURVE_DEGREE_DEFAULT_CONTINUITY);
+
+    const Scene& GetScene() const { return m_Scene; }
+    // The curves converted from curve i of the source scene are [GetFirstCurve(i), GetFirstCurve(i + 1))
+    uint32_t GetFirstCurve(uint32_t curve) const { return m_FirstCurves[curve]; }
+    // Parameter of the source curve where a converted curve starts
+    float GetStartParameter(uint32_t curve) const { return m_StartParameters[curve]; }
+    const CurveDegreeStats& GetStats() const { return m_Stats; }
+private:
+    struct CurveResult
+    {
+        std::vector<glm::vec2> ControlPoints;
+        std::vector<float> Parameters;
+        CurveDegreeStats Stats;
+    };
+
+    std::vector<CurveResult> m_CurveResults;
+    std::vector<uint32_t> m_FirstCurves;
+    std::vector<uint32_t> m_FirstControlPoints;
+    std::vector<float> m_StartParameters;
+    Scene m_Scene;
+    CurveDegreeStats m_Stats;
+};
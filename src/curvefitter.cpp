@@ -0,0 +1,210 @@
+#include "curvefitter.h"
+#include "bezier.h"
+
+#include <algorithm>
+#include <cmath>
+
+static glm::vec2 Normalize(const glm::vec2& v)
+{
+    float length = glm::length(v);
+    return length > 0.0f ? v / length : glm::vec2(0.0f);
+}
+
+CurveFitter::CurveFitter(SvgPathSink& sink, float tolerance)
+    : m_Sink(sink), m_Tolerance(tolerance)
+{
+    m_Samples.reserve(CURVE_FITTER_MAX_SEGMENT_SAMPLES + 2 * CURVE_FITTER_TANGENT_SPAN + 1);
+    m_Parameters.resize(CURVE_FITTER_MAX_SEGMENT_SAMPLES);
+}
+
+void CurveFitter::BeginStroke()
+{
+    if (m_IsStrokeActive)
+        EndStroke();
+
+    m_IsStrokeActive = true;
+    m_Samples.clear();
+    m_NumFitted = 0;
+    m_StartTangent = glm::vec2(0.0f);
+}
+
+void CurveFitter::AddSample(const glm::vec2& sample)
+{
+    if (!m_IsStrokeActive)
+        BeginStroke();
+
+    m_Stats.NumSamples++;
+    if (!m_Samples.empty() && glm::distance(m_Samples.back(), sample) < 0.1f * m_Tolerance)
+    {
+        m_Stats.NumDroppedSamples++;
+        return;
+    }
+
+    m_Samples.push_back(sample);
+
+    // A sample is fitted once the turn of every sample within the tangent span of it is known
+    while (m_Samples.size() - m_NumFitted > 2 * CURVE_FITTER_TANGENT_SPAN)
+        FitSample(m_NumFitted, IsCorner(m_NumFitted));
+}
+
+void CurveFitter::EndStroke()
+{
+    if (!m_IsStrokeActive)
+        return;
+
+    while (m_NumFitted < m_Samples.size())
+        FitSample(m_NumFitted, IsCorner(m_NumFitted));
+
+    if (m_NumFitted > 1)
+        EmitSegment(m_LastFit);
+
+    m_Sink.OnSubpathEnd(false);
+    m_IsStrokeActive = false;
+    m_Samples.clear();
+    m_NumFitted = 0;
+}
+
+// Cosine of the turn at a sample, between the directions from the sample a tangent span before to the sample a span after
+float CurveFitter::GetTurnCosine(uint32_t index) const
+{
+    uint32_t last = m_Samples.size() - 1;
+    glm::vec2 incoming = Normalize(m_Samples[index] - m_Samples[index > CURVE_FITTER_TANGENT_SPAN ? index - CURVE_FITTER_TANGENT_SPAN : 0]);
+    glm::vec2 outgoing = Normalize(m_Samples[std::min(index + CURVE_FITTER_TANGENT_SPAN, last)] - m_Samples[index]);
+    return glm::dot(incoming, outgoing);
+}
+
+// The sample turns by more than the corner angle and more than its neighbors within the span, ties go to the first one
+bool CurveFitter::IsCorner(uint32_t index) const
+{
+    static const float s_CornerCosine = std::cos(glm::radians(CURVE_FITTER_CORNER_ANGLE));
+
+    uint32_t last = m_Samples.size() - 1;
+    if (index == 0 || index == last)
+        return false;
+
+    float turn = GetTurnCosine(index);
+    if (turn >= s_CornerCosine)
+        return false;
+
+    uint32_t first = index > CURVE_FITTER_TANGENT_SPAN ? index - CURVE_FITTER_TANGENT_SPAN : 1;
+    for (uint32_t i = first; i < index; i++)
+    {
+        if (GetTurnCosine(i) <= turn)
+            return false;
+    }
+
+    for (uint32_t i = index + 1; i <= std::min(index + CURVE_FITTER_TANGENT_SPAN, last - 1); i++)
+    {
+        if (GetTurnCosine(i) < turn)
+            return false;
+    }
+
+    return true;
+}
+
+// Unit tangent at a sample pointing back along the stroke. Centered on the sample, except at a corner where only the
+// samples before it count
+glm::vec2 CurveFitter::GetEndTangent(uint32_t index, bool isCorner) const
+{
+    uint32_t last = m_Samples.size() - 1;
+    uint32_t before = index > CURVE_FITTER_TANGENT_SPAN ? index - CURVE_FITTER_TANGENT_SPAN : 0;
+    uint32_t after = std::min(index + CURVE_FITTER_TANGENT_SPAN, last);
+
+    glm::vec2 tangent = Normalize(m_Samples[before] - m_Samples[after]);
+    if (isCorner || tangent == glm::vec2(0.0f))
+        tangent = Normalize(m_Samples[before] - m_Samples[index]);
+    return tangent;
+}
+
+void CurveFitter::FitSample(uint32_t index, bool isCorner)
+{
+    if (index == 0)
+    {
+        m_NumFitted = 1;
+        return;
+    }
+
+    Fit fit = FitSegment(index + 1, GetEndTangent(index, isCorner));
+    if (fit.Error > m_Tolerance)
+    {
+        // The previous sample was the last one the segment could take, the next segment starts there
+        EmitSegment(m_LastFit);
+        StartSegment(index - 1, true);
+        index = 1;
+        fit = FitSegment(index + 1, GetEndTangent(index, isCorner));
+    }
+
+    m_LastFit = fit;
+    m_NumFitted = index + 1;
+
+    if (isCorner)
+    {
+        m_Stats.NumCorners++;
+        EmitSegment(m_LastFit);
+        StartSegment(index, false);
+    }
+    else if (m_NumFitted == CURVE_FITTER_MAX_SEGMENT_SAMPLES)
+    {
+        EmitSegment(m_LastFit);
+        StartSegment(index, true);
+    }
+}
+
+CurveFitter::Fit CurveFitter::FitSegment(uint32_t numSamples, const glm::vec2& endTangent)
+{
+    const glm::vec2* samples = m_Samples.data();
+    glm::vec2 startTangent = m_StartTangent;
+    if (startTangent == glm::vec2(0.0f))
+        startTangent = Normalize(samples[std::min<uint32_t>(CURVE_FITTER_TANGENT_SPAN, numSamples - 1)] - samples[0]);
+
+    Fit fit;
+    fit.Error = 0.0f;
+    if (numSamples == 2)
+    {
+        float third = glm::distance(samples[0], samples[1]) / 3.0f;
+        fit.ControlPoints[0] = samples[0];
+        fit.ControlPoints[1] = samples[0] + startTangent * third;
+        fit.ControlPoints[2] = samples[1] + endTangent * third;
+        fit.ControlPoints[3] = samples[1];
+        return fit;
+    }
+
+    // Chord length parameters
+    float* parameters = m_Parameters.data();
+    parameters[0] = 0.0f;
+    for (uint32_t i = 1; i < numSamples; i++)
+        parameters[i] = parameters[i - 1] + glm::distance(samples[i], samples[i - 1]);
+    for (uint32_t i = 1; i < numSamples; i++)
+        parameters[i] /= parameters[numSamples - 1];
+
+    FitCubicBezier(samples, parameters, numSamples, startTangent, endTangent, fit.ControlPoints);
+    fit.Error = GetCubicFitError(samples, parameters, numSamples, fit.ControlPoints);
+
+    // Far misses are not worth improving, the segment gets shorter instead
+    if (fit.Error > m_Tolerance && fit.Error < m_Tolerance * CURVE_FITTER_REPARAMETERIZE_FACTOR)
+    {
+        for (uint32_t iteration = 0; iteration < CURVE_FITTER_REPARAMETERIZE_ITERATIONS && fit.Error > m_Tolerance; iteration++)
+        {
+            ReparameterizeCubicFit(samples, parameters, numSamples, fit.ControlPoints);
+            FitCubicBezier(samples, parameters, numSamples, startTangent, endTangent, fit.ControlPoints);
+            fit.Error = GetCubicFitError(samples, parameters, numSamples, fit.ControlPoints);
+        }
+    }
+
+    return fit;
+}
+
+void CurveFitter::EmitSegment(const Fit& fit)
+{
+    m_Sink.OnSegment(fit.ControlPoints, 4);
+    m_Stats.NumSegments++;
+}
+
+// The sample at index becomes the start of the next segment, which continues the tangent of the last one unless it
+// starts at a corner
+void CurveFitter::StartSegment(uint32_t index, bool keepTangent)
+{
+    m_StartTangent = keepTangent ? Normalize(m_LastFit.ControlPoints[3] - m_LastFit.ControlPoints[2]) : glm::vec2(0.0f);
+    m_Samples.erase(m_Samples.begin(), m_Samples.begin() + index);
+    m_NumFitted = 1;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "svgpath.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Largest distance of a sample from the fitted curve, in scene units. The viewport spans 2 units, so about a pixel
+#define CURVE_FITTER_DEFAULT_TOLERANCE 0.002f
+// A segment is finished once it covers this many samples, which bounds the work done per sample
+#define CURVE_FITTER_MAX_SEGMENT_SAMPLES 64
+// Directions at a sample are taken towards the samples this far before and after it, which smooths out jitter
+#define CURVE_FITTER_TANGENT_SPAN 3
+// The stroke has a corner where it turns by more than this many degrees within the tangent span
+#define CURVE_FITTER_CORNER_ANGLE 60.0f
+// Newton reparameterization runs when the first fit misses by less than this multiple of the tolerance
+#define CURVE_FITTER_REPARAMETERIZE_FACTOR 4.0f
+#define CURVE_FITTER_REPARAMETERIZE_ITERATIONS 4
+
+struct CurveFitterStats
+{
+    uint64_t NumSamples = 0;
+    // Samples closer than a tenth of the tolerance to the previous one, they are skipped
+    uint64_t NumDroppedSamples = 0;
+    uint32_t NumSegments = 0;
+    uint32_t NumCorners = 0;
+};
+
+// Streaming least squares fit of cubic Bezier segments to a stroke, after Schneider's "An Algorithm for Automatically
+// Fitting Digitized Curves". Samples are fitted greedily: every sample is added to the current segment, which is refitted
+// with chord length parameters improved by Newton iterations. When a sample cannot be fitted within the tolerance, the
+// last fit that could is finished and sent to the sink, the next segment starts at its end with the same tangent. Corners
+// end a segment without tangent continuity, they are found CURVE_FITTER_TANGENT_SPAN samples late, so every sample is
+// held back by 2 * CURVE_FITTER_TANGENT_SPAN samples before it is fitted. The work per sample only depends on the
+// segment length, which is capped at CURVE_FITTER_MAX_SEGMENT_SAMPLES, never on the length of the stroke
+class CurveFitter
+{
+public:
+    explicit CurveFitter(SvgPathSink& sink, float tolerance = CURVE_FITTER_DEFAULT_TOLERANCE);
+
+    void BeginStroke();
+    void AddSample(const glm::vec2& sample);
+    // Fits the samples still held back and ends the subpath
+    void EndStroke();
+
+    bool IsStrokeActive() const { return m_IsStrokeActive; }
+    const CurveFitterStats& GetStats() const { return m_Stats; }
+private:
+    struct Fit
+    {
+        glm::vec2 ControlPoints[4];
+        float Error;
+    };
+
+    void FitSample(uint32_t index, bool isCorner);
+    Fit FitSegment(uint32_t numSamples, const glm::vec2& endTangent);
+    float GetTurnCosine(uint32_t index) const;
+    bool IsCorner(uint32_t index) const;
+    glm::vec2 GetEndTangent(uint32_t index, bool isCorner) const;
+    void EmitSegment(const Fit& fit);
+    void StartSegment(uint32_t index, bool keepTangent);
+private:
+    SvgPathSink& m_Sink;
+    float m_Tolerance;
+    bool m_IsStrokeActive = false;
+
+    // Samples of the current segment, the first one is where it starts, followed by the samples held back
+    std::vector<glm::vec2> m_Samples;
+    uint32_t m_NumFitted = 0;
+    // Unit tangent the current segment has to start with, zero after a corner and at the start of the stroke
+    glm::vec2 m_StartTangent = glm::vec2(0.0f);
+    // Fit of the first m_NumFitted samples, valid once two samples are fitted
+    Fit m_LastFit = {};
+
+    // Scratch memory of the fit, sized for the longest segment up front
+    std::vector<float> m_Parameters;
+
+    CurveFitterStats m_Stats;
+};
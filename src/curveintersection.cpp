@@ -0,0 +1,465 @@
+#include "curveintersection.h"
+#include "bezier.h"
+#include "curvebounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+// Intervals of duplicate candidates overlap, this much slack also joins intervals that only touch up to rounding
+#define CURVE_INTERSECTION_MERGE_SLACK 1e-4f
+
+// Control points of the curve restricted to [t0, t1], scratch must hold 2 * numControlPoints points
+static void GetBezierRange(const glm::vec2* controlPoints, uint32_t numControlPoints, float t0, float t1, glm::vec2* range, glm::vec2* scratch)
+{
+    glm::vec2* left = scratch;
+    glm::vec2* right = scratch + numControlPoints;
+    SplitBezier(controlPoints, numControlPoints, t1, left, right);
+    SplitBezier(left, numControlPoints, t1 > 0.0f ? t0 / t1 : 0.0f, right, range);
+}
+
+static void GetBounds(const glm::vec2* points, uint32_t numPoints, glm::vec2& boundsMin, glm::vec2& boundsMax)
+{
+    boundsMin = points[0];
+    boundsMax = points[0];
+    for (uint32_t i = 1; i < numPoints; i++)
+    {
+        boundsMin = glm::min(boundsMin, points[i]);
+        boundsMax = glm::max(boundsMax, points[i]);
+    }
+}
+
+// Largest distance of the control points from the line through the first and the last one
+static float GetFlatness(const glm::vec2* points, uint32_t numPoints)
+{
+    glm::vec2 chord = points[numPoints - 1] - points[0];
+    float length = glm::length(chord);
+
+    float flatness = 0.0f;
+    for (uint32_t i = 1; i + 1 < numPoints; i++)
+    {
+        glm::vec2 offset = points[i] - points[0];
+        float distance = length > 0.0f ? std::abs(offset.x * chord.y - offset.y * chord.x) / length : glm::length(offset);
+        flatness = std::max(flatness, distance);
+    }
+
+    return flatness;
+}
+
+// Parameter range [u0, u1] of the clipped curve that can lie inside the fat line of the other curve, false when no part
+// of it can. The signed distances of the clipped curve's control points to the chord form a Bezier function over
+// (i / degree, distance), and the convex hull of those points bounds where the function can be inside the band
+static bool ClipToFatLine(const glm::vec2* line, uint32_t numLinePoints, const glm::vec2* clipped, uint32_t numClippedPoints, float tolerance, float& u0, float& u1)
+{
+    u0 = 0.0f;
+    u1 = 1.0f;
+
+    glm::vec2 origin = line[0];
+    glm::vec2 chord = line[numLinePoints - 1] - origin;
+    float length = glm::length(chord);
+
+    // Without a usable chord there is no band to clip against, the piece gets subdivided instead
+    if (length <= tolerance)
+        return true;
+
+    glm::vec2 normal = glm::vec2(-chord.y, chord.x) / length;
+    auto getDistance = [&](const glm::vec2& point) { return glm::dot(point - origin, normal); };
+
+    // Quadratics and cubics have tighter bands than the bounds of their control points (Sederberg and Nishita)
+    float distanceMin = 0.0f;
+    float distanceMax = 0.0f;
+    if (numLinePoints == 3)
+    {
+        float d = getDistance(line[1]) * 0.5f;
+        distanceMin = std::min(0.0f, d);
+        distanceMax = std::max(0.0f, d);
+    }
+    else if (numLinePoints == 4)
+    {
+        float d1 = getDistance(line[1]);
+        float d2 = getDistance(line[2]);
+        float scale = d1 * d2 > 0.0f ? 0.75f : 4.0f / 9.0f;
+        distanceMin = scale * std::min({ 0.0f, d1, d2 });
+        distanceMax = scale * std::max({ 0.0f, d1, d2 });
+    }
+    else
+    {
+        for (uint32_t i = 1; i + 1 < numLinePoints; i++)
+        {
+            float d = getDistance(line[i]);
+            distanceMin = std::min(distanceMin, d);
+            distanceMax = std::max(distanceMax, d);
+        }
+    }
+
+    // Rounding must not clip away intersections that lie exactly on the band
+    distanceMin -= tolerance * 0.5f;
+    distanceMax += tolerance * 0.5f;
+
+    if (numClippedPoints == 1)
+    {
+        float d = getDistance(clipped[0]);
+        return d >= distanceMin && d <= distanceMax;
+    }
+
+    // The hull inside the band is bounded by the parts of the hull edges inside the band. Edges between all pairs of
+    // points include the hull edges, the others lie inside the hull. The part of an edge inside the band is clamped
+    // instead of tested against the edge's ends, so an end lying on a band limit is not lost to rounding
+    float degree = float(numClippedPoints - 1);
+    float tMin = 1.0f;
+    float tMax = 0.0f;
+    for (uint32_t i = 0; i < numClippedPoints; i++)
+    {
+        float ti = i / degree;
+        float di = getDistance(clipped[i]);
+        for (uint32_t j = i + 1; j < numClippedPoints; j++)
+        {
+            float tj = j / degree;
+            float dj = getDistance(clipped[j]);
+
+            float sLow = 0.0f;
+            float sHigh = 1.0f;
+            if (di != dj)
+            {
+                float s0 = (distanceMin - di) / (dj - di);
+                float s1 = (distanceMax - di) / (dj - di);
+                sLow = std::max(0.0f, std::min(s0, s1));
+                sHigh = std::min(1.0f, std::max(s0, s1));
+            }
+            else if (di < distanceMin || di > distanceMax)
+            {
+                continue;
+            }
+
+            if (sLow > sHigh)
+                continue;
+
+            tMin = std::min(tMin, ti + (tj - ti) * sLow);
+            tMax = std::max(tMax, ti + (tj - ti) * sHigh);
+        }
+    }
+
+    if (tMin > tMax)
+        return false;
+
+    u0 = tMin;
+    u1 = tMax;
+    return true;
+}
+
+// Flat pieces that lie on one line coincide where their chords overlap. Returns false when the pieces are not on one
+// line, true when they are, whether or not their chords overlap
+static bool AddOverlap(const glm::vec2* pieceA, uint32_t numPointsA, const glm::vec2* pieceB, uint32_t numPointsB, const CurveIntersectionWorkspace::Task& task,
+    uint32_t curve0, uint32_t curve1, float tolerance, CurveIntersectionWorkspace& workspace)
+{
+    glm::vec2 startA = pieceA[0];
+    glm::vec2 chordA = pieceA[numPointsA - 1] - startA;
+    glm::vec2 startB = pieceB[0];
+    glm::vec2 endB = pieceB[numPointsB - 1];
+    glm::vec2 chordB = endB - startB;
+
+    float lengthSquaredA = glm::dot(chordA, chordA);
+    float lengthSquaredB = glm::dot(chordB, chordB);
+    if (lengthSquaredA <= tolerance * tolerance || lengthSquaredB <= tolerance * tolerance)
+        return false;
+
+    glm::vec2 normalA = glm::vec2(-chordA.y, chordA.x) / std::sqrt(lengthSquaredA);
+    if (std::abs(glm::dot(startB - startA, normalA)) > tolerance || std::abs(glm::dot(endB - startA, normalA)) > tolerance)
+        return false;
+
+    // Common part of the chords as parameters along the chord of A, extended by the tolerance so pieces that only meet
+    // at their ends still touch
+    float slack = tolerance / std::sqrt(lengthSquaredA);
+    float s0 = glm::dot(startB - startA, chordA) / lengthSquaredA;
+    float s1 = glm::dot(endB - startA, chordA) / lengthSquaredA;
+    float overlapStart = std::max(0.0f, std::min(s0, s1) - slack);
+    float overlapEnd = std::min(1.0f, std::max(s0, s1) + slack);
+    if (overlapStart > overlapEnd)
+        return true;
+
+    // The same part as parameters along the chord of B, which may run in the opposite direction
+    auto projectOnB = [&](float s)
+    {
+        glm::vec2 point = startA + chordA * s;
+        return std::clamp(glm::dot(point - startB, chordB) / lengthSquaredB, 0.0f, 1.0f);
+    };
+
+    CurveIntersectionWorkspace::Candidate& candidate = workspace.Candidates.emplace_back();
+    candidate.Curve0 = curve0;
+    candidate.Curve1 = curve1;
+    candidate.A0 = task.A0 + (task.A1 - task.A0) * overlapStart;
+    candidate.A1 = task.A0 + (task.A1 - task.A0) * overlapEnd;
+    candidate.B0 = task.B0 + (task.B1 - task.B0) * projectOnB(overlapStart);
+    candidate.B1 = task.B0 + (task.B1 - task.B0) * projectOnB(overlapEnd);
+    candidate.IsOverlap = true;
+    return true;
+}
+
+// Adds the candidates of the curves over [a0, a1] and [b0, b1] to the workspace
+static void IntersectRanges(const glm::vec2* controlPoints0, uint32_t numControlPoints0, const glm::vec2* controlPoints1, uint32_t numControlPoints1,
+    uint32_t curve0, uint32_t curve1, float a0, float a1, float b0, float b1, float tolerance, CurveIntersectionWorkspace& workspace)
+{
+    uint32_t maxControlPoints = std::max(numControlPoints0, numControlPoints1);
+    workspace.Points.resize(numControlPoints0 + numControlPoints1 + 2 * maxControlPoints);
+    glm::vec2* pieceA = workspace.Points.data();
+    glm::vec2* pieceB = pieceA + numControlPoints0;
+    glm::vec2* scratch = pieceB + numControlPoints1;
+
+    workspace.Tasks.clear();
+    workspace.Tasks.push_back({ a0, a1, b0, b1, 0 });
+
+    uint32_t numTasks = 0;
+    while (!workspace.Tasks.empty() && numTasks < CURVE_INTERSECTION_MAX_TASKS)
+    {
+        CurveIntersectionWorkspace::Task task = workspace.Tasks.back();
+        workspace.Tasks.pop_back();
+        numTasks++;
+
+        GetBezierRange(controlPoints0, numControlPoints0, task.A0, task.A1, pieceA, scratch);
+        GetBezierRange(controlPoints1, numControlPoints1, task.B0, task.B1, pieceB, scratch);
+
+        glm::vec2 minA, maxA, minB, maxB;
+        GetBounds(pieceA, numControlPoints0, minA, maxA);
+        GetBounds(pieceB, numControlPoints1, minB, maxB);
+        if (minA.x > maxB.x + tolerance || minB.x > maxA.x + tolerance || minA.y > maxB.y + tolerance || minB.y > maxA.y + tolerance)
+            continue;
+
+        float extentA = std::max(maxA.x - minA.x, maxA.y - minA.y);
+        float extentB = std::max(maxB.x - minB.x, maxB.y - minB.y);
+        if ((extentA <= tolerance && extentB <= tolerance) || task.Depth >= CURVE_INTERSECTION_MAX_DEPTH)
+        {
+            workspace.Candidates.push_back({ curve0, curve1, task.A0, task.A1, task.B0, task.B1, false });
+            continue;
+        }
+
+        // Coinciding pieces would be subdivided down to the tolerance without ever being clipped
+        if (GetFlatness(pieceA, numControlPoints0) <= tolerance && GetFlatness(pieceB, numControlPoints1) <= tolerance &&
+            AddOverlap(pieceA, numControlPoints0, pieceB, numControlPoints1, task, curve0, curve1, tolerance, workspace))
+            continue;
+
+        float u0, u1;
+        if (!ClipToFatLine(pieceA, numControlPoints0, pieceB, numControlPoints1, tolerance, u0, u1))
+            continue;
+
+        float clippedB0 = task.B0 + (task.B1 - task.B0) * u0;
+        float clippedB1 = task.B0 + (task.B1 - task.B0) * u1;
+        GetBezierRange(controlPoints1, numControlPoints1, clippedB0, clippedB1, pieceB, scratch);
+
+        if (!ClipToFatLine(pieceB, numControlPoints1, pieceA, numControlPoints0, tolerance, u0, u1))
+            continue;
+
+        float clippedA0 = task.A0 + (task.A1 - task.A0) * u0;
+        float clippedA1 = task.A0 + (task.A1 - task.A0) * u1;
+
+        // Clipping stalls on several intersections within one piece and near tangential contacts
+        bool stalled = clippedA1 - clippedA0 > CURVE_INTERSECTION_MIN_CLIP_REDUCTION * (task.A1 - task.A0) &&
+            clippedB1 - clippedB0 > CURVE_INTERSECTION_MIN_CLIP_REDUCTION * (task.B1 - task.B0);
+        if (!stalled)
+        {
+            workspace.Tasks.push_back({ clippedA0, clippedA1, clippedB0, clippedB1, task.Depth + 1 });
+        }
+        else if (extentA >= extentB)
+        {
+            float middle = 0.5f * (clippedA0 + clippedA1);
+            workspace.Tasks.push_back({ clippedA0, middle, clippedB0, clippedB1, task.Depth + 1 });
+            workspace.Tasks.push_back({ middle, clippedA1, clippedB0, clippedB1, task.Depth + 1 });
+        }
+        else
+        {
+            float middle = 0.5f * (clippedB0 + clippedB1);
+            workspace.Tasks.push_back({ clippedA0, clippedA1, clippedB0, middle, task.Depth + 1 });
+            workspace.Tasks.push_back({ clippedA0, clippedA1, middle, clippedB1, task.Depth + 1 });
+        }
+    }
+
+    workspace.NumTasks += numTasks;
+}
+
+// Joins candidates of the same curve pair whose intervals overlap on both curves, e.g. an intersection found on both
+// sides of a split or the chain of pieces along a tangential contact, and appends one intersection per group.
+// getControlPoints(curve, numControlPoints) returns the control points of a curve
+template<typename GetControlPoints>
+static void MergeCandidates(CurveIntersectionWorkspace& workspace, float tolerance, const GetControlPoints& getControlPoints, std::vector<CurveIntersection>& intersections)
+{
+    using Candidate = CurveIntersectionWorkspace::Candidate;
+    std::vector<Candidate>& candidates = workspace.Candidates;
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b)
+    {
+        if (a.Curve0 != b.Curve0)
+            return a.Curve0 < b.Curve0;
+        if (a.Curve1 != b.Curve1)
+            return a.Curve1 < b.Curve1;
+        return a.A0 < b.A0;
+    });
+
+    // Two curves whose curvatures differ by c stay within the tolerance e of each other for a stretch of about
+    // sqrt(8 e / c) around a tangential contact. Shorter overlaps are contacts for curvature differences down to 1/32
+    float minOverlapLength = 16.0f * std::sqrt(tolerance);
+
+    size_t first = 0;
+    while (first < candidates.size())
+    {
+        const Candidate& start = candidates[first];
+        float a0 = start.A0;
+        float a1 = start.A1;
+        float b0 = std::min(start.B0, start.B1);
+        float b1 = std::max(start.B0, start.B1);
+        bool isOverlap = start.IsOverlap;
+
+        size_t last = first + 1;
+        while (last < candidates.size())
+        {
+            const Candidate& next = candidates[last];
+            if (next.Curve0 != start.Curve0 || next.Curve1 != start.Curve1 || next.A0 > a1 + CURVE_INTERSECTION_MERGE_SLACK)
+                break;
+            if (std::min(next.B0, next.B1) > b1 + CURVE_INTERSECTION_MERGE_SLACK || std::max(next.B0, next.B1) < b0 - CURVE_INTERSECTION_MERGE_SLACK)
+                break;
+
+            a1 = std::max(a1, next.A1);
+            b0 = std::min(b0, std::min(next.B0, next.B1));
+            b1 = std::max(b1, std::max(next.B0, next.B1));
+            isOverlap |= next.IsOverlap;
+            last++;
+        }
+
+        uint32_t numControlPoints0;
+        const glm::vec2* controlPoints0 = getControlPoints(start.Curve0, numControlPoints0);
+        workspace.Points.resize(numControlPoints0);
+
+        CurveIntersection& intersection = intersections.emplace_back();
+        intersection.Curve0 = start.Curve0;
+        intersection.Curve1 = start.Curve1;
+
+        if (isOverlap)
+        {
+            glm::vec2 startPoint = EvaluateBezier(controlPoints0, numControlPoints0, a0, workspace.Points.data());
+            glm::vec2 endPoint = EvaluateBezier(controlPoints0, numControlPoints0, a1, workspace.Points.data());
+            isOverlap = glm::distance(startPoint, endPoint) >= minOverlapLength;
+        }
+
+        if (isOverlap)
+        {
+            // B runs against A when the group ends at a smaller parameter of B than it started
+            bool reversed = candidates[last - 1].B1 < start.B0;
+            intersection.IsOverlap = true;
+            intersection.T0 = a0;
+            intersection.T0End = a1;
+            intersection.T1 = reversed ? b1 : b0;
+            intersection.T1End = reversed ? b0 : b1;
+        }
+        else
+        {
+            intersection.T0 = 0.5f * (a0 + a1);
+            intersection.T1 = 0.5f * (b0 + b1);
+            intersection.T0End = intersection.T0;
+            intersection.T1End = intersection.T1;
+        }
+        intersection.Point = EvaluateBezier(controlPoints0, numControlPoints0, intersection.T0, workspace.Points.data());
+
+        first = last;
+    }
+}
+
+void IntersectCurves(const glm::vec2* controlPoints0, uint32_t numControlPoints0, const glm::vec2* controlPoints1, uint32_t numControlPoints1,
+    float tolerance, std::vector<CurveIntersection>& intersections, CurveIntersectionWorkspace& workspace)
+{
+    workspace.Candidates.clear();
+    workspace.NumTasks = 0;
+    if (numControlPoints0 == 0 || numControlPoints1 == 0)
+        return;
+
+    IntersectRanges(controlPoints0, numControlPoints0, controlPoints1, numControlPoints1, 0, 1, 0.0f, 1.0f, 0.0f, 1.0f, tolerance, workspace);
+
+    auto getControlPoints = [&](uint32_t curve, uint32_t& numControlPoints)
+    {
+        numControlPoints = curve == 0 ? numControlPoints0 : numControlPoints1;
+        return curve == 0 ? controlPoints0 : controlPoints1;
+    };
+    MergeCandidates(workspace, tolerance, getControlPoints, intersections);
+}
+
+void IntersectCurves(const glm::vec2* controlPoints0, uint32_t numControlPoints0, const glm::vec2* controlPoints1, uint32_t numControlPoints1,
+    float tolerance, std::vector<CurveIntersection>& intersections)
+{
+    CurveIntersectionWorkspace workspace;
+    IntersectCurves(controlPoints0, numControlPoints0, controlPoints1, numControlPoints1, tolerance, intersections, workspace);
+}
+
+void CurveIntersector::FindIntersections(const SceneView& scene, float tolerance, std::vector<CurveIntersection>& intersections)
+{
+    m_Stats = CurveIntersectionStats();
+    intersections.clear();
+    m_Spans.clear();
+    m_Workspace.Candidates.clear();
+    m_Workspace.NumTasks = 0;
+
+    // Exact span bounds are much smaller than the control point bounds of pieces that bulge. They are grown by half the
+    // tolerance each, so spans closer than the tolerance still overlap
+    for (uint32_t curve = 0; curve < scene.NumCurves; curve++)
+    {
+        const SceneCurve& sceneCurve = scene.Curves[curve];
+        uint32_t numControlPoints = sceneCurve.NumControlPoints;
+        if (numControlPoints == 0)
+            continue;
+
+        m_Workspace.Points.resize(3 * numControlPoints);
+        glm::vec2* piece = m_Workspace.Points.data();
+        glm::vec2* scratch = piece + numControlPoints;
+
+        for (uint32_t i = 0; i < CURVE_INTERSECTION_SPANS_PER_CURVE; i++)
+        {
+            SpanBounds& span = m_Spans.emplace_back();
+            span.Curve = curve;
+            span.T0 = float(i) / CURVE_INTERSECTION_SPANS_PER_CURVE;
+            span.T1 = float(i + 1) / CURVE_INTERSECTION_SPANS_PER_CURVE;
+
+            GetBezierRange(scene.Positions + sceneCurve.FirstControlPoint, numControlPoints, span.T0, span.T1, piece, scratch);
+            GetBezierBounds(piece, numControlPoints, span.Min, span.Max);
+            span.Min -= glm::vec2(tolerance * 0.5f);
+            span.Max += glm::vec2(tolerance * 0.5f);
+        }
+    }
+
+    // Sweep along x, a span only needs testing against the spans whose x range it enters
+    m_SortedSpans.resize(m_Spans.size());
+    std::iota(m_SortedSpans.begin(), m_SortedSpans.end(), 0);
+    std::sort(m_SortedSpans.begin(), m_SortedSpans.end(), [this](uint32_t a, uint32_t b) { return m_Spans[a].Min.x < m_Spans[b].Min.x; });
+
+    m_ActiveSpans.clear();
+    for (uint32_t index : m_SortedSpans)
+    {
+        const SpanBounds& span = m_Spans[index];
+        auto hasEnded = [&](uint32_t active) { return m_Spans[active].Max.x < span.Min.x; };
+        m_ActiveSpans.erase(std::remove_if(m_ActiveSpans.begin(), m_ActiveSpans.end(), hasEnded), m_ActiveSpans.end());
+
+        for (uint32_t active : m_ActiveSpans)
+        {
+            const SpanBounds& other = m_Spans[active];
+            if (other.Curve == span.Curve || other.Min.y > span.Max.y || span.Min.y > other.Max.y)
+                continue;
+
+            m_Stats.NumCandidatePairs++;
+
+            // Candidates are always stored with the lower curve index first, so duplicates sort next to each other
+            const SpanBounds& first = other.Curve < span.Curve ? other : span;
+            const SpanBounds& second = other.Curve < span.Curve ? span : other;
+            const SceneCurve& curve0 = scene.Curves[first.Curve];
+            const SceneCurve& curve1 = scene.Curves[second.Curve];
+            IntersectRanges(scene.Positions + curve0.FirstControlPoint, curve0.NumControlPoints, scene.Positions + curve1.FirstControlPoint, curve1.NumControlPoints,
+                first.Curve, second.Curve, first.T0, first.T1, second.T0, second.T1, tolerance, m_Workspace);
+        }
+
+        m_ActiveSpans.push_back(index);
+    }
+
+    auto getControlPoints = [&](uint32_t curve, uint32_t& numControlPoints)
+    {
+        numControlPoints = scene.Curves[curve].NumControlPoints;
+        return scene.Positions + scene.Curves[curve].FirstControlPoint;
+    };
+    MergeCandidates(m_Workspace, tolerance, getControlPoints, intersections);
+
+    m_Stats.NumSpans = m_Spans.size();
+    m_Stats.NumTasks = m_Workspace.NumTasks;
+    m_Stats.NumIntersections = intersections.size();
+}
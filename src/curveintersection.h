@@ -0,0 +1,104 @@
+#pragma once
+
+#include "scene.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#define CURVE_INTERSECTION_DEFAULT_TOLERANCE 1e-5f
+// Pieces stop being subdivided at this depth, which only tangential contacts come close to
+#define CURVE_INTERSECTION_MAX_DEPTH 40
+// Bounds the work spent on one pair of curves, e.g. on curves that run within the tolerance of each other for long
+#define CURVE_INTERSECTION_MAX_TASKS 20000
+// Clipping has to shrink a piece to this fraction of its parameter range, otherwise the piece is split in half
+#define CURVE_INTERSECTION_MIN_CLIP_REDUCTION 0.8f
+// The broad phase bounds each curve by this many parameter spans
+#define CURVE_INTERSECTION_SPANS_PER_CURVE 4
+
+// Curves cross at a point, or overlap over [T0, T0End] of the first and [T1, T1End] of the second curve. Curves that run
+// closer than the tolerance over a stretch too short to count as an overlap touch tangentially and are reported as a point
+struct CurveIntersection
+{
+    // Indices of the curves in scene queries
+    uint32_t Curve0 = 0;
+    uint32_t Curve1 = 0;
+    float T0 = 0.0f;
+    float T1 = 0.0f;
+    glm::vec2 Point = glm::vec2(0.0f);
+    bool IsOverlap = false;
+    float T0End = 0.0f;
+    float T1End = 0.0f;
+};
+
+struct CurveIntersectionStats
+{
+    uint32_t NumSpans = 0;
+    // Span pairs from different curves with overlapping bounds
+    uint32_t NumCandidatePairs = 0;
+    // Pieces of curve pairs examined by the narrow phase
+    uint32_t NumTasks = 0;
+    uint32_t NumIntersections = 0;
+};
+
+// Scratch memory of the narrow phase, kept between queries so repeated queries do not allocate
+struct CurveIntersectionWorkspace
+{
+    struct Task
+    {
+        float A0, A1;
+        float B0, B1;
+        uint32_t Depth;
+    };
+
+    // Intervals of the two curves that contain an intersection, before nearby ones are merged
+    struct Candidate
+    {
+        uint32_t Curve0, Curve1;
+        float A0, A1;
+        float B0, B1;
+        bool IsOverlap;
+    };
+
+    std::vector<Task> Tasks;
+    std::vector<Candidate> Candidates;
+    std::vector<glm::vec2> Points;
+    uint32_t NumTasks = 0;
+};
+
+// Intersections between two curves by Bezier clipping: each curve is clipped to the fat line around the other one, the
+// band of lines parallel to its chord that contains it, and pieces that clipping does not shrink enough are split in half.
+// Pieces smaller than the tolerance are intersections. Flat pieces that lie within the tolerance of each other's chord are
+// treated as overlapping instead of being subdivided further. Intersections are appended, ordered by T0
+void IntersectCurves(const glm::vec2* controlPoints0, uint32_t numControlPoints0, const glm::vec2* controlPoints1, uint32_t numControlPoints1,
+    float tolerance, std::vector<CurveIntersection>& intersections, CurveIntersectionWorkspace& workspace);
+void IntersectCurves(const glm::vec2* controlPoints0, uint32_t numControlPoints0, const glm::vec2* controlPoints1, uint32_t numControlPoints1,
+    float tolerance, std::vector<CurveIntersection>& intersections);
+
+// Intersections between all pairs of curves of a scene. Each curve is cut into a few parameter spans and a sweep over the
+// exact bounding boxes of the spans finds the pairs of spans whose boxes overlap, only those reach the narrow phase.
+// Curves are not intersected with themselves
+class CurveIntersector
+{
+public:
+    // intersections is replaced and ordered by curve pair, then by T0
+    void FindIntersections(const SceneView& scene, float tolerance, std::vector<CurveIntersection>& intersections);
+
+    const CurveIntersectionStats& GetStats() const { return m_Stats; }
+private:
+    struct SpanBounds
+    {
+        glm::vec2 Min;
+        glm::vec2 Max;
+        uint32_t Curve;
+        float T0;
+        float T1;
+    };
+private:
+    std::vector<SpanBounds> m_Spans;
+    std::vector<uint32_t> m_SortedSpans;
+    std::vector<uint32_t> m_ActiveSpans;
+    CurveIntersectionWorkspace m_Workspace;
+    CurveIntersectionStats m_Stats;
+};
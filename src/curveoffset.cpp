@@ -0,0 +1,528 @@
+#include "curveoffset.h"
+#include "bezier.h"
+#include "jobsystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+struct OffsetCurve
+{
+    const glm::vec2* ControlPoints;
+    uint32_t NumControlPoints;
+    float Distance;
+    float Tolerance;
+    // Speed below which the curve counts as stationary
+    float StationarySpeed;
+    // Bound on the length of the second derivative, which bounds how fast the speed changes
+    float MaxAcceleration;
+    glm::vec2* Scratch;
+};
+
+struct OffsetPoint
+{
+    glm::vec2 Point;
+    // Unit tangent of the curve in its direction of travel
+    glm::vec2 Tangent;
+};
+
+struct OffsetBreak
+{
+    float T;
+    bool IsStationary;
+};
+
+struct OffsetFit
+{
+    glm::vec2 ControlPoints[4];
+    float Error;
+};
+
+static glm::vec2 Normalize(const glm::vec2& v)
+{
+    float length = glm::length(v);
+    return length > 0.0f ? v / length : glm::vec2(0.0f);
+}
+
+static glm::vec2 GetLeftNormal(const glm::vec2& tangent)
+{
+    return glm::vec2(-tangent.y, tangent.x);
+}
+
+// Offset point at t. Where the curve is stationary its tangent is the direction of the second derivative, which the curve
+// leaves along after the point and arrives against before it, side picks the one (1 after, -1 before)
+static OffsetPoint EvaluateOffset(const OffsetCurve& curve, float t, float side)
+{
+    glm::vec2 firstDerivative, secondDerivative;
+    glm::vec2 point = EvaluateBezierDerivatives(curve.ControlPoints, curve.NumControlPoints, t, curve.Scratch, firstDerivative, secondDerivative);
+
+    glm::vec2 tangent = firstDerivative;
+    if (glm::length(firstDerivative) < curve.StationarySpeed && secondDerivative != glm::vec2(0.0f))
+        tangent = secondDerivative * side;
+
+    tangent = Normalize(tangent);
+    return { point + GetLeftNormal(tangent) * curve.Distance, tangent };
+}
+
+// The offset moves at the speed of the curve times 1 - distance * curvature, this has the sign of that factor and is
+// zero where the offset has a cusp
+static float GetCuspFunction(const OffsetCurve& curve, const glm::vec2& firstDerivative, const glm::vec2& secondDerivative)
+{
+    float speed = glm::length(firstDerivative);
+    float cross = firstDerivative.x * secondDerivative.y - firstDerivative.y * secondDerivative.x;
+    return speed * speed * speed - curve.Distance * cross;
+}
+
+static float GetCuspFunction(const OffsetCurve& curve, float t)
+{
+    glm::vec2 firstDerivative, secondDerivative;
+    EvaluateBezierDerivatives(curve.ControlPoints, curve.NumControlPoints, t, curve.Scratch, firstDerivative, secondDerivative);
+    return GetCuspFunction(curve, firstDerivative, secondDerivative);
+}
+
+static float GetSpeedSquared(const OffsetCurve& curve, float t)
+{
+    glm::vec2 firstDerivative, secondDerivative;
+    EvaluateBezierDerivatives(curve.ControlPoints, curve.NumControlPoints, t, curve.Scratch, firstDerivative, secondDerivative);
+    return glm::dot(firstDerivative, firstDerivative);
+}
+
+// Root of the cusp function in [t0, t1], which changes sign across it
+static float FindCusp(const OffsetCurve& curve, float t0, float t1)
+{
+    bool isNegativeAtT0 = GetCuspFunction(curve, t0) < 0.0f;
+    for (uint32_t iteration = 0; iteration < CURVE_OFFSET_ROOT_ITERATIONS; iteration++)
+    {
+        float t = 0.5f * (t0 + t1);
+        if ((GetCuspFunction(curve, t) < 0.0f) == isNegativeAtT0)
+            t0 = t;
+        else
+            t1 = t;
+    }
+
+    return 0.5f * (t0 + t1);
+}
+
+// Golden section search for the minimum of a function with a single minimum in [t0, t1]
+template<typename Function>
+static float FindMinimum(float t0, float t1, const Function& function)
+{
+    static const float s_GoldenRatio = 0.618034f;
+    float a = t1 - (t1 - t0) * s_GoldenRatio;
+    float b = t0 + (t1 - t0) * s_GoldenRatio;
+    float valueA = function(a);
+    float valueB = function(b);
+    for (uint32_t iteration = 0; iteration < CURVE_OFFSET_ROOT_ITERATIONS; iteration++)
+    {
+        if (valueA < valueB)
+        {
+            t1 = b;
+            b = a;
+            valueB = valueA;
+            a = t1 - (t1 - t0) * s_GoldenRatio;
+            valueA = function(a);
+        }
+        else
+        {
+            t0 = a;
+            a = b;
+            valueA = valueB;
+            b = t0 + (t1 - t0) * s_GoldenRatio;
+            valueB = function(b);
+        }
+    }
+
+    return 0.5f * (t0 + t1);
+}
+
+// Cusps of the offset and stationary points of the curve inside (0, 1), ordered by parameter. Both are searched between
+// evenly spaced samples. Cusps are found where the cusp function changes sign between two samples, and at its local
+// extrema where the parabola through the samples around them dips towards zero, a sign the function crosses zero twice
+// between the samples. Stationary points are found at local minima of the speed that are slow enough to reach zero
+// before the next sample
+static uint32_t FindBreaks(const OffsetCurve& curve, OffsetBreak* breaks)
+{
+    float cuspValues[CURVE_OFFSET_CUSP_SAMPLES + 1];
+    float speedsSquared[CURVE_OFFSET_CUSP_SAMPLES + 1];
+    for (uint32_t i = 0; i <= CURVE_OFFSET_CUSP_SAMPLES; i++)
+    {
+        glm::vec2 firstDerivative, secondDerivative;
+        EvaluateBezierDerivatives(curve.ControlPoints, curve.NumControlPoints, float(i) / CURVE_OFFSET_CUSP_SAMPLES, curve.Scratch, firstDerivative, secondDerivative);
+        cuspValues[i] = GetCuspFunction(curve, firstDerivative, secondDerivative);
+        speedsSquared[i] = glm::dot(firstDerivative, firstDerivative);
+    }
+
+    uint32_t numBreaks = 0;
+    for (uint32_t i = 0; i < CURVE_OFFSET_CUSP_SAMPLES; i++)
+    {
+        if ((cuspValues[i] < 0.0f) != (cuspValues[i + 1] < 0.0f))
+            breaks[numBreaks++] = { FindCusp(curve, float(i) / CURVE_OFFSET_CUSP_SAMPLES, float(i + 1) / CURVE_OFFSET_CUSP_SAMPLES), false };
+    }
+
+    for (uint32_t i = 1; i < CURVE_OFFSET_CUSP_SAMPLES; i++)
+    {
+        float t0 = float(i - 1) / CURVE_OFFSET_CUSP_SAMPLES;
+        float t1 = float(i + 1) / CURVE_OFFSET_CUSP_SAMPLES;
+
+        float sign = cuspValues[i] < 0.0f ? -1.0f : 1.0f;
+        float previous = cuspValues[i - 1] * sign;
+        float current = cuspValues[i] * sign;
+        float next = cuspValues[i + 1] * sign;
+        float curvature = next - 2.0f * current + previous;
+        bool isCuspExtremum = current <= previous && current < next && previous > 0.0f && next > 0.0f;
+        if (isCuspExtremum && current - (next - previous) * (next - previous) / (8.0f * curvature) < 0.5f * current)
+        {
+            float t = FindMinimum(t0, t1, [&](float t) { return GetCuspFunction(curve, t) * sign; });
+            if (GetCuspFunction(curve, t) * sign < 0.0f)
+            {
+                breaks[numBreaks++] = { FindCusp(curve, t0, t), false };
+                breaks[numBreaks++] = { FindCusp(curve, t, t1), false };
+            }
+        }
+
+        bool isSlowest = speedsSquared[i] <= speedsSquared[i - 1] && speedsSquared[i] < speedsSquared[i + 1];
+        if (isSlowest && std::sqrt(speedsSquared[i]) - curve.MaxAcceleration / CURVE_OFFSET_CUSP_SAMPLES < curve.StationarySpeed)
+        {
+            float t = FindMinimum(t0, t1, [&](float t) { return GetSpeedSquared(curve, t); });
+            if (GetSpeedSquared(curve, t) < curve.StationarySpeed * curve.StationarySpeed)
+                breaks[numBreaks++] = { t, true };
+        }
+    }
+
+    std::sort(breaks, breaks + numBreaks, [](const OffsetBreak& a, const OffsetBreak& b) { return a.T < b.T; });
+
+    // Breaks too close to each other or to the ends would leave spans too short to fit, a stationary point wins over a
+    // cusp next to it
+    uint32_t numMerged = 0;
+    for (uint32_t i = 0; i < numBreaks; i++)
+    {
+        if (breaks[i].T < CURVE_OFFSET_MIN_SPAN || breaks[i].T > 1.0f - CURVE_OFFSET_MIN_SPAN)
+            continue;
+
+        if (numMerged > 0 && breaks[i].T - breaks[numMerged - 1].T < CURVE_OFFSET_MIN_SPAN)
+        {
+            if (breaks[i].IsStationary)
+                breaks[numMerged - 1] = breaks[i];
+            continue;
+        }
+
+        breaks[numMerged++] = breaks[i];
+    }
+
+    return numMerged;
+}
+
+// Distance from a point to the closest point of a cubic near parameter t, found by a few Newton steps
+static float GetCubicDistance(const glm::vec2* controlPoints, const glm::vec2& point, float t)
+{
+    glm::vec2 scratch[4];
+    for (uint32_t iteration = 0; iteration < 2; iteration++)
+    {
+        glm::vec2 firstDerivative, secondDerivative;
+        glm::vec2 offset = EvaluateBezierDerivatives(controlPoints, 4, t, scratch, firstDerivative, secondDerivative) - point;
+
+        float numerator = glm::dot(offset, firstDerivative);
+        float denominator = glm::dot(firstDerivative, firstDerivative) + glm::dot(offset, secondDerivative);
+        if (denominator > 0.0f)
+            t = std::clamp(t - numerator / denominator, 0.0f, 1.0f);
+    }
+
+    return glm::distance(EvaluateBezier<3>(controlPoints, t), point);
+}
+
+// Fits a cubic to the offset over [t0, t1], which moves along the tangent of the curve or against it as direction says.
+// The samples start evenly spaced in the parameter of the curve, but the offset can sweep around a sharp turn of the curve
+// within a tiny part of the span, so intervals that are much longer than the others or turn too much are split until the
+// samples run out
+static OffsetFit FitSpan(const OffsetCurve& curve, float t0, float t1, float direction)
+{
+    static const float s_RefineCosine = std::cos(glm::radians(CURVE_OFFSET_REFINE_ANGLE));
+
+    float sampleT[CURVE_OFFSET_MAX_FIT_SAMPLES];
+    glm::vec2 samples[CURVE_OFFSET_MAX_FIT_SAMPLES];
+    glm::vec2 tangents[CURVE_OFFSET_MAX_FIT_SAMPLES];
+    float parameters[CURVE_OFFSET_MAX_FIT_SAMPLES];
+    bool isRefined[CURVE_OFFSET_MAX_FIT_SAMPLES];
+
+    // Samples in the first half are taken after the start, the others before the end, which only matters at stationary
+    // points at the ends of the span
+    float middle = 0.5f * (t0 + t1);
+    uint32_t numSamples = CURVE_OFFSET_FIT_SAMPLES + 2;
+    for (uint32_t i = 0; i < numSamples; i++)
+    {
+        sampleT[i] = i + 1 == numSamples ? t1 : t0 + (t1 - t0) * i / (numSamples - 1);
+        OffsetPoint sample = EvaluateOffset(curve, sampleT[i], i == 0 || sampleT[i] < middle ? 1.0f : -1.0f);
+        samples[i] = sample.Point;
+        tangents[i] = sample.Tangent;
+    }
+
+    while (numSamples < CURVE_OFFSET_MAX_FIT_SAMPLES)
+    {
+        float length = 0.0f;
+        for (uint32_t i = 0; i + 1 < numSamples; i++)
+            length += glm::distance(samples[i], samples[i + 1]);
+
+        float maxInterval = 2.0f * length / (numSamples - 1);
+        uint32_t numRefined = 0;
+        for (uint32_t i = 0; i + 1 < numSamples; i++)
+        {
+            isRefined[i] = numSamples + numRefined < CURVE_OFFSET_MAX_FIT_SAMPLES &&
+                (glm::distance(samples[i], samples[i + 1]) > maxInterval || glm::dot(tangents[i], tangents[i + 1]) < s_RefineCosine);
+            numRefined += isRefined[i];
+        }
+
+        if (numRefined == 0)
+            break;
+
+        // Moved towards the end in place, a sample is never overwritten before the interval in front of it is split
+        uint32_t next = numSamples + numRefined - 1;
+        for (uint32_t i = numSamples - 1; i > 0; i--)
+        {
+            sampleT[next] = sampleT[i];
+            samples[next] = samples[i];
+            tangents[next] = tangents[i];
+            next--;
+
+            if (isRefined[i - 1])
+            {
+                sampleT[next] = 0.5f * (sampleT[i - 1] + sampleT[i]);
+                OffsetPoint sample = EvaluateOffset(curve, sampleT[next], sampleT[next] < middle ? 1.0f : -1.0f);
+                samples[next] = sample.Point;
+                tangents[next] = sample.Tangent;
+                next--;
+            }
+        }
+
+        numSamples += numRefined;
+    }
+
+    // Chord length parameters, the offset may move much slower or faster than the curve
+    parameters[0] = 0.0f;
+    for (uint32_t i = 1; i < numSamples; i++)
+        parameters[i] = parameters[i - 1] + glm::distance(samples[i], samples[i - 1]);
+    for (uint32_t i = 1; i < numSamples; i++)
+        parameters[i] = parameters[numSamples - 1] > 0.0f ? parameters[i] / parameters[numSamples - 1] : float(i) / (numSamples - 1);
+
+    OffsetFit fit;
+    glm::vec2 startTangent = tangents[0] * direction;
+    glm::vec2 endTangent = -tangents[numSamples - 1] * direction;
+    FitCubicBezier(samples, parameters, numSamples, startTangent, endTangent, fit.ControlPoints);
+    fit.Error = GetCubicFitError(samples, parameters, numSamples, fit.ControlPoints);
+
+    // Far misses are not worth improving, the segment gets shorter instead
+    if (fit.Error > curve.Tolerance && fit.Error < curve.Tolerance * CURVE_OFFSET_REPARAMETERIZE_FACTOR)
+    {
+        for (uint32_t iteration = 0; iteration < CURVE_OFFSET_REPARAMETERIZE_ITERATIONS && fit.Error > curve.Tolerance; iteration++)
+        {
+            ReparameterizeCubicFit(samples, parameters, numSamples, fit.ControlPoints);
+            FitCubicBezier(samples, parameters, numSamples, startTangent, endTangent, fit.ControlPoints);
+            fit.Error = GetCubicFitError(samples, parameters, numSamples, fit.ControlPoints);
+        }
+    }
+
+    // A fit that passes is checked against the offset halfway between the samples too, so it cannot stray from the offset
+    // between them
+    for (uint32_t i = 0; i + 1 < numSamples && fit.Error <= curve.Tolerance; i++)
+    {
+        float t = 0.5f * (sampleT[i] + sampleT[i + 1]);
+        glm::vec2 point = EvaluateOffset(curve, t, t < middle ? 1.0f : -1.0f).Point;
+        fit.Error = std::max(fit.Error, GetCubicDistance(fit.ControlPoints, point, 0.5f * (parameters[i] + parameters[i + 1])));
+    }
+
+    return fit;
+}
+
+// Covers the offset over [t0, t1], which has no cusps and no stationary points inside, with as few segments as the search
+// finds. Each segment starts where the last one ended and is made as long as it can be while it fits
+static void CoverSpan(const OffsetCurve& curve, float t0, float t1, std::vector<glm::vec2>& segments, CurveOffsetStats& stats)
+{
+    float direction = GetCuspFunction(curve, 0.5f * (t0 + t1)) < 0.0f ? -1.0f : 1.0f;
+
+    float start = t0;
+    while (start < t1)
+    {
+        // Candidates ending at or before fitEnd fit, the ones ending at or after missEnd do not
+        float fitEnd = start;
+        float missEnd = t1;
+        float end = t1;
+        OffsetFit best = {};
+        bool hasBest = false;
+        for (uint32_t step = 0;; step++)
+        {
+            OffsetFit fit = FitSpan(curve, start, end, direction);
+            stats.NumFits++;
+            if (fit.Error <= curve.Tolerance)
+            {
+                best = fit;
+                hasBest = true;
+                fitEnd = end;
+                if (end == t1 || fit.Error >= curve.Tolerance * CURVE_OFFSET_ACCEPT_ERROR)
+                    break;
+            }
+            else
+            {
+                missEnd = end;
+                if (end - start <= CURVE_OFFSET_MIN_SPAN)
+                {
+                    best = fit;
+                    hasBest = true;
+                    fitEnd = end;
+                    break;
+                }
+            }
+
+            if (hasBest && step + 1 >= CURVE_OFFSET_SEARCH_STEPS)
+                break;
+
+            // The error grows with about the fifth power of the length, the next candidate aims a little below the
+            // tolerance and stays clear of the ends of the bracket so the search always makes progress
+            float scale = fit.Error > 0.0f ? std::pow(0.8f * curve.Tolerance / fit.Error, 0.2f) : 2.0f;
+            float margin = 0.1f * (missEnd - fitEnd);
+            end = std::clamp(start + (end - start) * scale, fitEnd + margin, missEnd - margin);
+        }
+
+        segments.insert(segments.end(), best.ControlPoints, best.ControlPoints + 4);
+        start = fitEnd;
+    }
+}
+
+// Round join around a stationary point at t, from the offset arriving at it to the one leaving it. The arc turns
+// towards the direction the curve arrives from, which is where the tip of the curve points
+static void AppendJoin(const OffsetCurve& curve, float t, std::vector<glm::vec2>& segments, CurveOffsetStats& stats)
+{
+    static const float s_TwoPi = 6.2831853f;
+
+    OffsetPoint arrival = EvaluateOffset(curve, t, -1.0f);
+    OffsetPoint departure = EvaluateOffset(curve, t, 1.0f);
+    if (glm::distance(arrival.Point, departure.Point) <= curve.Tolerance)
+        return;
+
+    glm::vec2 center = EvaluateBezier(curve.ControlPoints, curve.NumControlPoints, t, curve.Scratch);
+    glm::vec2 from = arrival.Point - center;
+    glm::vec2 to = departure.Point - center;
+
+    float startAngle = std::atan2(from.y, from.x);
+    float sweep = std::fmod(std::atan2(to.y, to.x) - startAngle + 2.0f * s_TwoPi, s_TwoPi);
+    float tipSweep = std::fmod(std::atan2(arrival.Tangent.y, arrival.Tangent.x) - startAngle + 2.0f * s_TwoPi, s_TwoPi);
+    if (tipSweep > sweep)
+        sweep -= s_TwoPi;
+
+    // Pieces of at most a quarter circle, with the handle length that puts the middle of each piece on the circle
+    uint32_t numPieces = std::max(1u, (uint32_t)std::ceil(std::abs(sweep) / (0.25f * s_TwoPi)));
+    float step = sweep / numPieces;
+    float handle = 4.0f / 3.0f * std::tan(0.25f * step);
+    for (uint32_t i = 0; i < numPieces; i++)
+    {
+        float angle0 = startAngle + step * i;
+        float angle1 = startAngle + step * (i + 1);
+        glm::vec2 radius0 = glm::vec2(std::cos(angle0), std::sin(angle0)) * std::abs(curve.Distance);
+        glm::vec2 radius1 = glm::vec2(std::cos(angle1), std::sin(angle1)) * std::abs(curve.Distance);
+
+        glm::vec2 start = i == 0 ? arrival.Point : center + radius0;
+        glm::vec2 end = i + 1 == numPieces ? departure.Point : center + radius1;
+        segments.push_back(start);
+        segments.push_back(start + GetLeftNormal(radius0) * handle);
+        segments.push_back(end - GetLeftNormal(radius1) * handle);
+        segments.push_back(end);
+    }
+
+    stats.NumJoins++;
+}
+
+void OffsetBezier(const glm::vec2* controlPoints, uint32_t numControlPoints, float distance, float tolerance, std::vector<glm::vec2>& segments,
+    CurveOffsetStats& stats)
+{
+    if (numControlPoints < 2)
+        return;
+
+    // The speed of the curve is at most the degree times its longest control polygon leg, the length of the second
+    // derivative at most the degree times the degree minus one times its longest second difference
+    float longestLeg = 0.0f;
+    float longestSecondDifference = 0.0f;
+    for (uint32_t i = 0; i + 1 < numControlPoints; i++)
+        longestLeg = std::max(longestLeg, glm::distance(controlPoints[i], controlPoints[i + 1]));
+    for (uint32_t i = 0; i + 2 < numControlPoints; i++)
+        longestSecondDifference = std::max(longestSecondDifference, glm::length(controlPoints[i + 2] - 2.0f * controlPoints[i + 1] + controlPoints[i]));
+    if (longestLeg == 0.0f)
+        return;
+
+    glm::vec2 stackScratch[CURVE_OFFSET_STACK_POINTS];
+    std::vector<glm::vec2> heapScratch;
+    glm::vec2* scratch = stackScratch;
+    if (numControlPoints > CURVE_OFFSET_STACK_POINTS)
+    {
+        heapScratch.resize(numControlPoints);
+        scratch = heapScratch.data();
+    }
+
+    OffsetCurve curve;
+    curve.ControlPoints = controlPoints;
+    curve.NumControlPoints = numControlPoints;
+    curve.Distance = distance;
+    curve.Tolerance = tolerance;
+    curve.StationarySpeed = CURVE_OFFSET_STATIONARY_SPEED * longestLeg * (numControlPoints - 1);
+    curve.MaxAcceleration = longestSecondDifference * (numControlPoints - 1) * (numControlPoints - 2);
+    curve.Scratch = scratch;
+
+    OffsetBreak breaks[4 * CURVE_OFFSET_CUSP_SAMPLES];
+    uint32_t numBreaks = FindBreaks(curve, breaks);
+
+    size_t firstPoint = segments.size();
+    float t0 = 0.0f;
+    for (uint32_t i = 0; i <= numBreaks; i++)
+    {
+        float t1 = i < numBreaks ? breaks[i].T : 1.0f;
+        CoverSpan(curve, t0, t1, segments, stats);
+
+        if (i < numBreaks && breaks[i].IsStationary)
+            AppendJoin(curve, t1, segments, stats);
+        else if (i < numBreaks)
+            stats.NumCusps++;
+        t0 = t1;
+    }
+
+    stats.NumSegments += (segments.size() - firstPoint) / 4;
+}
+
+void OffsetBezier(const glm::vec2* controlPoints, uint32_t numControlPoints, float distance, float tolerance, std::vector<glm::vec2>& segments)
+{
+    CurveOffsetStats stats;
+    OffsetBezier(controlPoints, numControlPoints, distance, tolerance, segments, stats);
+}
+
+void CurveOffsetter::OffsetScene(JobSystem& jobSystem, const SceneView& scene, float distance, float tolerance)
+{
+    m_CurveSegments.resize(scene.NumCurves);
+    m_CurveStats.assign(scene.NumCurves, CurveOffsetStats());
+    jobSystem.ParallelFor(scene.NumCurves, 16, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            const SceneCurve& curve = scene.Curves[i];
+            m_CurveSegments[i].clear();
+            OffsetBezier(scene.Positions + curve.FirstControlPoint, curve.NumControlPoints, distance, tolerance, m_CurveSegments[i], m_CurveStats[i]);
+        }
+    });
+
+    // Gathered in curve order, so the result does not depend on how the curves were scheduled
+    m_Stats = CurveOffsetStats();
+    m_FirstSegments.resize(scene.NumCurves + 1);
+    uint32_t numPoints = 0;
+    for (uint32_t i = 0; i < scene.NumCurves; i++)
+    {
+        m_FirstSegments[i] = numPoints / 4;
+        numPoints += m_CurveSegments[i].size();
+
+        m_Stats.NumSegments += m_CurveStats[i].NumSegments;
+        m_Stats.NumCusps += m_CurveStats[i].NumCusps;
+        m_Stats.NumJoins += m_CurveStats[i].NumJoins;
+        m_Stats.NumFits += m_CurveStats[i].NumFits;
+    }
+    m_FirstSegments[scene.NumCurves] = numPoints / 4;
+
+    m_ControlPoints.resize(numPoints);
+    jobSystem.ParallelFor(scene.NumCurves, 64, [this](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+            std::copy(m_CurveSegments[i].begin(), m_CurveSegments[i].end(), m_ControlPoints.begin() + 4 * m_FirstSegments[i]);
+    });
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "scene.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class JobSystem;
+
+// Largest distance between the offset and its approximation, in scene units. The viewport spans 2 units, so about a
+// quarter of a pixel
+#define CURVE_OFFSET_DEFAULT_TOLERANCE 0.0005f
+// Exact offset points inside a span that a candidate segment is fitted to and checked against. Intervals between them that
+// are more than twice as long as the average or along which the tangent turns by more than the angle are split, up to the
+// maximum number of samples
+#define CURVE_OFFSET_FIT_SAMPLES 16
+#define CURVE_OFFSET_MAX_FIT_SAMPLES 64
+#define CURVE_OFFSET_REFINE_ANGLE 15.0f
+// Cusps of the offset and stationary points of the curve are searched between this many evenly spaced parameters
+#define CURVE_OFFSET_CUSP_SAMPLES 32
+#define CURVE_OFFSET_ROOT_ITERATIONS 24
+// The curve is stationary where its speed drops below this fraction of the longest control polygon leg times the degree
+#define CURVE_OFFSET_STATIONARY_SPEED 1e-4f
+// Candidate segments tried per emitted segment before the longest one that fit is taken
+#define CURVE_OFFSET_SEARCH_STEPS 6
+// A segment that fits with an error above this fraction of the tolerance is close enough to the longest one possible
+#define CURVE_OFFSET_ACCEPT_ERROR 0.5f
+// Spans shorter than this are emitted even if they miss the tolerance, only reached at degenerate points
+#define CURVE_OFFSET_MIN_SPAN 1e-5f
+// Newton reparameterization runs when a candidate misses by less than this multiple of the tolerance
+#define CURVE_OFFSET_REPARAMETERIZE_FACTOR 4.0f
+#define CURVE_OFFSET_REPARAMETERIZE_ITERATIONS 4
+// Curves with more control points need heap scratch memory
+#define CURVE_OFFSET_STACK_POINTS 64
+
+struct CurveOffsetStats
+{
+    uint32_t NumSegments = 0;
+    // Points where the offset reverses direction, because the distance exceeds the radius of curvature
+    uint32_t NumCusps = 0;
+    // Round joins inserted at stationary points of the curve, where its tangent flips
+    uint32_t NumJoins = 0;
+    // Candidate segments fitted, the work done
+    uint32_t NumFits = 0;
+};
+
+// Approximates the offset of a curve, the curve moved by distance along its left normal, with cubic segments that stay
+// within the tolerance of it. Segments are appended to segments, four control points each, and join with G1 continuity
+// except at cusps. The counts of this curve are added to stats.
+// The curve is split where the offset has a cusp, where 1 - distance * curvature changes sign, and where the curve itself
+// is stationary. The offset of a stationary point is a half circle around it, approximated by a round join. Every span is
+// then covered greedily from its start: a candidate segment is fitted by least squares to exact offset points with the
+// exact offset tangents at both ends, and its length is predicted from the error of the previous candidate, which grows
+// with about the fifth power of the length. Offsets of loops are kept whole, including the loops that cusps form when the
+// distance exceeds the radius of curvature, trimming them is left to the caller
+void OffsetBezier(const glm::vec2* controlPoints, uint32_t numControlPoints, float distance, float tolerance, std::vector<glm::vec2>& segments,
+    CurveOffsetStats& stats);
+void OffsetBezier(const glm::vec2* controlPoints, uint32_t numControlPoints, float distance, float tolerance, std::vector<glm::vec2>& segments);
+
+// Offsets every curve of a scene, curves are processed in parallel on the job system's threads. The memory of the result
+// is kept between calls, so offsetting a scene again does not allocate once the segment counts settle
+class CurveOffsetter
+{
+public:
+    void OffsetScene(JobSystem& jobSystem, const SceneView& scene, float distance, float tolerance);
+
+    // Four control points per segment, the segments of curve i are [GetFirstSegment(i), GetFirstSegment(i + 1))
+    const std::vector<glm::vec2>& GetControlPoints() const { return m_ControlPoints; }
+    uint32_t GetFirstSegment(uint32_t curve) const { return m_FirstSegments[curve]; }
+    uint32_t GetNumSegments() const { return m_ControlPoints.size() / 4; }
+    const CurveOffsetStats& GetStats() const { return m_Stats; }
+private:
+    std::vector<std::vector<glm::vec2>> m_CurveSegments;
+    std::vector<CurveOffsetStats> m_CurveStats;
+    std::vector<glm::vec2> m_ControlPoints;
+    std::vector<uint32_t> m_FirstSegments;
+    CurveOffsetStats m_Stats;
+};
@@ -0,0 +1,222 @@
+#include "curveprojection.h"
+#include "bezier.h"
+#include "jobsystem.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// The tangent turns in one direction and by less than 90 degrees along the span when the control polygon is convex and no
+// two of its edges point away from each other. A span like that cannot wind back towards a query point a second time
+static bool IsSpanSimple(const glm::vec2* controlPoints, uint32_t numControlPoints)
+{
+    bool turnsLeft = false;
+    bool turnsRight = false;
+    for (uint32_t i = 0; i + 1 < numControlPoints; i++)
+    {
+        glm::vec2 edge = controlPoints[i + 1] - controlPoints[i];
+        for (uint32_t j = i + 1; j + 1 < numControlPoints; j++)
+        {
+            glm::vec2 otherEdge = controlPoints[j + 1] - controlPoints[j];
+            if (glm::dot(edge, otherEdge) < 0.0f)
+                return false;
+
+            if (j == i + 1)
+            {
+                float cross = edge.x * otherEdge.y - edge.y * otherEdge.x;
+                turnsLeft |= cross > 0.0f;
+                turnsRight |= cross < 0.0f;
+            }
+        }
+    }
+
+    return !(turnsLeft && turnsRight);
+}
+
+static float GetBoundsDistanceSquared(const glm::vec2& point, const glm::vec2& boundsMin, const glm::vec2& boundsMax)
+{
+    glm::vec2 offset = glm::max(glm::max(boundsMin - point, point - boundsMax), glm::vec2(0.0f));
+    return glm::dot(offset, offset);
+}
+
+static float GetDistanceSquared(const glm::vec2& a, const glm::vec2& b)
+{
+    glm::vec2 offset = a - b;
+    return glm::dot(offset, offset);
+}
+
+CurveProjector::CurveProjector(const glm::vec2* controlPoints, uint32_t numControlPoints)
+{
+    SetCurve(controlPoints, numControlPoints);
+}
+
+void CurveProjector::SetCurve(const glm::vec2* controlPoints, uint32_t numControlPoints)
+{
+    m_ControlPoints.assign(controlPoints, controlPoints + numControlPoints);
+    m_Spans.clear();
+    if (numControlPoints == 0)
+        return;
+
+    // Two rows of split points per subdivision level
+    std::vector<glm::vec2> scratch((size_t)numControlPoints * 2 * (CURVE_PROJECTION_MAX_DEPTH + 1));
+    Subdivide(controlPoints, 0.0f, 1.0f, 0, scratch.data());
+}
+
+void CurveProjector::Subdivide(const glm::vec2* controlPoints, float t0, float t1, uint32_t depth, glm::vec2* scratch)
+{
+    uint32_t numControlPoints = m_ControlPoints.size();
+    if (depth == CURVE_PROJECTION_MAX_DEPTH || IsSpanSimple(controlPoints, numControlPoints))
+    {
+        Span& span = m_Spans.emplace_back();
+        span.T0 = t0;
+        span.T1 = t1;
+        span.Start = controlPoints[0];
+        span.BoundsMin = controlPoints[0];
+        span.BoundsMax = controlPoints[0];
+        for (uint32_t i = 1; i < numControlPoints; i++)
+        {
+            span.BoundsMin = glm::min(span.BoundsMin, controlPoints[i]);
+            span.BoundsMax = glm::max(span.BoundsMax, controlPoints[i]);
+        }
+        return;
+    }
+
+    glm::vec2* left = scratch;
+    glm::vec2* right = scratch + numControlPoints;
+    SplitBezier(controlPoints, numControlPoints, 0.5f, left, right);
+
+    float tMid = 0.5f * (t0 + t1);
+    Subdivide(left, t0, tMid, depth + 1, scratch + 2 * numControlPoints);
+    Subdivide(right, tMid, t1, depth + 1, scratch + 2 * numControlPoints);
+}
+
+CurveProjection CurveProjector::Project(const glm::vec2& point) const
+{
+    CurveProjection result;
+    ProjectBatch(&point, 1, &result);
+    return result;
+}
+
+void CurveProjector::ProjectBatch(const glm::vec2* points, uint32_t count, CurveProjection* results) const
+{
+    if (m_ControlPoints.empty())
+        return;
+
+    // The scratch memory is shared by every query of the batch
+    glm::vec2 stackScratch[CURVE_PROJECTION_STACK_POINTS];
+    std::vector<glm::vec2> heapScratch;
+    glm::vec2* scratch = stackScratch;
+    if (m_ControlPoints.size() > CURVE_PROJECTION_STACK_POINTS)
+    {
+        heapScratch.resize(m_ControlPoints.size());
+        scratch = heapScratch.data();
+    }
+
+    const glm::vec2 end = m_ControlPoints.back();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const glm::vec2& point = points[i];
+
+        // The span end points give an upper bound that prunes most spans before any evaluation
+        CurveProjection best;
+        best.T = 1.0f;
+        best.Point = end;
+        best.Distance = GetDistanceSquared(point, end);
+        for (const Span& span : m_Spans)
+        {
+            float distance = GetDistanceSquared(point, span.Start);
+            if (distance < best.Distance)
+            {
+                best.T = span.T0;
+                best.Point = span.Start;
+                best.Distance = distance;
+            }
+        }
+
+        for (const Span& span : m_Spans)
+        {
+            if (GetBoundsDistanceSquared(point, span.BoundsMin, span.BoundsMax) < best.Distance)
+                RefineSpan(span, point, scratch, best);
+        }
+
+        best.Distance = std::sqrt(best.Distance);
+        results[i] = best;
+    }
+}
+
+void CurveProjector::ProjectBatch(JobSystem& jobSystem, const glm::vec2* points, uint32_t count, CurveProjection* results) const
+{
+    jobSystem.ParallelFor(count, 256, [&](uint32_t begin, uint32_t end)
+    {
+        ProjectBatch(points + begin, end - begin, results + begin);
+    });
+}
+
+// best holds the squared distance while the batch is being projected
+void CurveProjector::RefineSpan(const Span& span, const glm::vec2& point, glm::vec2* scratch, CurveProjection& best) const
+{
+    const glm::vec2* controlPoints = m_ControlPoints.data();
+    uint32_t numControlPoints = m_ControlPoints.size();
+
+    float step = (span.T1 - span.T0) / CURVE_PROJECTION_SPAN_SAMPLES;
+    float sampleT[CURVE_PROJECTION_SPAN_SAMPLES + 1];
+    float sampleDistances[CURVE_PROJECTION_SPAN_SAMPLES + 1];
+    for (uint32_t i = 0; i <= CURVE_PROJECTION_SPAN_SAMPLES; i++)
+    {
+        sampleT[i] = i == CURVE_PROJECTION_SPAN_SAMPLES ? span.T1 : span.T0 + step * i;
+        glm::vec2 sample = EvaluateBezier(controlPoints, numControlPoints, sampleT[i], scratch);
+        sampleDistances[i] = GetDistanceSquared(point, sample);
+        if (sampleDistances[i] < best.Distance)
+        {
+            best.T = sampleT[i];
+            best.Point = sample;
+            best.Distance = sampleDistances[i];
+        }
+    }
+
+    // Every sample closer than its neighbors seeds a search, neighbors bracket the minimum next to it
+    for (uint32_t i = 0; i <= CURVE_PROJECTION_SPAN_SAMPLES; i++)
+    {
+        bool isMinimum = (i == 0 || sampleDistances[i] <= sampleDistances[i - 1]) && (i == CURVE_PROJECTION_SPAN_SAMPLES || sampleDistances[i] <= sampleDistances[i + 1]);
+        if (!isMinimum)
+            continue;
+
+        // Newton on g(t) = (B(t) - P) . B'(t), whose sign tells on which side of t the minimum lies
+        float low = sampleT[i == 0 ? 0 : i - 1];
+        float high = sampleT[i == CURVE_PROJECTION_SPAN_SAMPLES ? i : i + 1];
+        float t = sampleT[i];
+        for (uint32_t iteration = 0; iteration < CURVE_PROJECTION_MAX_ITERATIONS; iteration++)
+        {
+            glm::vec2 firstDerivative, secondDerivative;
+            glm::vec2 curvePoint = EvaluateBezierDerivatives(controlPoints, numControlPoints, t, scratch, firstDerivative, secondDerivative);
+            glm::vec2 offset = curvePoint - point;
+
+            float distance = glm::dot(offset, offset);
+            if (distance < best.Distance)
+            {
+                best.T = t;
+                best.Point = curvePoint;
+                best.Distance = distance;
+            }
+
+            float g = glm::dot(offset, firstDerivative);
+            if (g == 0.0f)
+                break;
+
+            if (g > 0.0f)
+                high = t;
+            else
+                low = t;
+
+            float gDerivative = glm::dot(firstDerivative, firstDerivative) + glm::dot(offset, secondDerivative);
+            float next = gDerivative > 0.0f ? t - g / gDerivative : 0.5f * (low + high);
+            if (!(next > low && next < high))
+                next = 0.5f * (low + high);
+
+            if (std::abs(next - t) < CURVE_PROJECTION_TOLERANCE)
+                break;
+
+            t = next;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class JobSystem;
+
+// Subdivision stops at this depth even if a span still turns too much, which bounds the spans at 2^depth
+#define CURVE_PROJECTION_MAX_DEPTH 8
+// Evenly spaced samples per span that seed the Newton iteration
+#define CURVE_PROJECTION_SPAN_SAMPLES 4
+#define CURVE_PROJECTION_MAX_ITERATIONS 16
+// Newton stops once a step moves t by less than this
+#define CURVE_PROJECTION_TOLERANCE 1e-6f
+// Curves with more control points need heap scratch memory for each batch
+#define CURVE_PROJECTION_STACK_POINTS 64
+
+struct CurveProjection
+{
+    float T = 0.0f;
+    float Distance = 0.0f;
+    glm::vec2 Point = glm::vec2(0.0f);
+};
+
+// Closest point queries against one curve. SetCurve splits the curve into spans without inflections along which the
+// tangent turns by less than 90 degrees, so the distance to a query point has a single minimum per span in practice. A
+// query skips the spans whose bounding box is farther away than the best point found so far and refines the others with
+// Newton iterations on the derivative of the squared distance, kept inside a bracket that shrinks with every step and
+// bisected whenever Newton would leave it
+class CurveProjector
+{
+public:
+    CurveProjector() = default;
+    CurveProjector(const glm::vec2* controlPoints, uint32_t numControlPoints);
+
+    void SetCurve(const glm::vec2* controlPoints, uint32_t numControlPoints);
+
+    CurveProjection Project(const glm::vec2& point) const;
+    void ProjectBatch(const glm::vec2* points, uint32_t count, CurveProjection* results) const;
+    // Splits the batch into ranges projected on the job system's threads
+    void ProjectBatch(JobSystem& jobSystem, const glm::vec2* points, uint32_t count, CurveProjection* results) const;
+
+    bool IsEmpty() const { return m_ControlPoints.empty(); }
+    uint32_t GetNumSpans() const { return m_Spans.size(); }
+private:
+    struct Span
+    {
+        float T0;
+        float T1;
+        glm::vec2 Start;
+        // Bounds of the span's control points, which contain the span
+        glm::vec2 BoundsMin;
+        glm::vec2 BoundsMax;
+    };
+
+    void Subdivide(const glm::vec2* controlPoints, float t0, float t1, uint32_t depth, glm::vec2* scratch);
+    void RefineSpan(const Span& span, const glm::vec2& point, glm::vec2* scratch, CurveProjection& best) const;
+private:
+    std::vector<glm::vec2> m_ControlPoints;
+    std::vector<Span> m_Spans;
+};
@@ -0,0 +1,406 @@
+#include "editjournal.h"
+
+#include <cstring>
+
+// The deques keep their elements in blocks listed in a map of block pointers. An empty deque already holds a map and a block,
+// the map can grow to twice the size it needs and the blocks at both ends are only partly used. Two pointers on top of every
+// element and a few blocks per deque cover that for both libstdc++ and the Microsoft library
+#define EDIT_JOURNAL_ELEMENT_OVERHEAD (2 * sizeof(void*))
+#define EDIT_JOURNAL_DEQUE_OVERHEAD 2048
+#define EDIT_JOURNAL_EMPTY_MEMORY (2 * EDIT_JOURNAL_DEQUE_OVERHEAD)
+
+struct EditControlPoint
+{
+    glm::vec2 Position;
+    glm::vec3 Color;
+};
+
+void* GetSceneFieldPointer(Scene& scene, EditDeltaType type, uint32_t curve, uint32_t index)
+{
+    switch (type)
+    {
+        case EditDelta_DrawBezierCurve: return &scene.Settings.DrawBezierCurve;
+        case EditDelta_DrawPolar: return &scene.Settings.DrawPolar;
+        case EditDelta_NumSamples: return &scene.Settings.NumSamples;
+        case EditDelta_T1: return &scene.Settings.T1;
+        case EditDelta_CurveColor: return &scene.Curves[curve].Color;
+        case EditDelta_CurveThickness: return &scene.Curves[curve].Thickness;
+        case EditDelta_ControlPointPosition: return &scene.Positions[scene.Curves[curve].FirstControlPoint + index];
+        case EditDelta_ControlPointColor: return &scene.Colors[scene.Curves[curve].FirstControlPoint + index];
+        default: return nullptr;
+    }
+}
+
+uint32_t GetSceneFieldSize(EditDeltaType type)
+{
+    switch (type)
+    {
+        case EditDelta_DrawBezierCurve: return sizeof(bool);
+        case EditDelta_DrawPolar: return sizeof(bool);
+        case EditDelta_NumSamples: return sizeof(int);
+        case EditDelta_T1: return sizeof(float);
+        case EditDelta_CurveColor: return sizeof(glm::vec3);
+        case EditDelta_CurveThickness: return sizeof(float);
+        case EditDelta_ControlPointPosition: return sizeof(glm::vec2);
+        case EditDelta_ControlPointColor: return sizeof(glm::vec3);
+        default: return 0;
+    }
+}
+
+static uint64_t GetCommandMemory(const EditCommand& command)
+{
+    return sizeof(EditCommand) + EDIT_JOURNAL_ELEMENT_OVERHEAD + command.Deltas.capacity();
+}
+
+static uint64_t GetSceneMemory(const Scene& scene)
+{
+    return sizeof(Scene) + scene.Curves.capacity() * sizeof(SceneCurve) + scene.Positions.capacity() * sizeof(glm::vec2) + scene.Colors.capacity() * sizeof(glm::vec3);
+}
+
+static uint64_t GetKeyframeMemory(const EditKeyframe& keyframe)
+{
+    return sizeof(EditKeyframe) - sizeof(Scene) + EDIT_JOURNAL_ELEMENT_OVERHEAD + GetSceneMemory(keyframe.Snapshot);
+}
+
+EditJournal::EditJournal(uint64_t memoryBudget, uint32_t keyframeInterval)
+    : m_MemoryBudget(memoryBudget), m_KeyframeInterval(keyframeInterval), m_MemoryUsage(EDIT_JOURNAL_EMPTY_MEMORY)
+{
+}
+
+void EditJournal::SetSettings(Scene& scene, const GlobalSettings& settings)
+{
+    // Only the fields that actually changed produce deltas
+    SetField(scene, EditDelta_DrawBezierCurve, 0, 0, &settings.DrawBezierCurve);
+    SetField(scene, EditDelta_DrawPolar, 0, 0, &settings.DrawPolar);
+    SetField(scene, EditDelta_NumSamples, 0, 0, &settings.NumSamples);
+    SetField(scene, EditDelta_T1, 0, 0, &settings.T1);
+}
+
+void EditJournal::SetCurveColor(Scene& scene, uint32_t curve, const glm::vec3& color)
+{
+    SetField(scene, EditDelta_CurveColor, curve, 0, &color);
+}
+
+void EditJournal::SetCurveThickness(Scene& scene, uint32_t curve, float thickness)
+{
+    SetField(scene, EditDelta_CurveThickness, curve, 0, &thickness);
+}
+
+void EditJournal::SetControlPointPosition(Scene& scene, uint32_t curve, uint32_t index, const glm::vec2& position)
+{
+    SetField(scene, EditDelta_ControlPointPosition, curve, index, &position);
+}
+
+void EditJournal::SetControlPointColor(Scene& scene, uint32_t curve, uint32_t index, const glm::vec3& color)
+{
+    SetField(scene, EditDelta_ControlPointColor, curve, index, &color);
+}
+
+void EditJournal::InsertControlPoint(Scene& scene, uint32_t curve, uint32_t index, const glm::vec2& position, const glm::vec3& color)
+{
+    scene.InsertControlPoint(curve, index, position, color);
+    if (m_Listener)
+        m_Listener->OnControlPointInserted(curve, index, position, color);
+
+    EditControlPoint point = { position, color };
+    RecordDelta(EditDelta_InsertControlPoint, curve, index, &point, sizeof(EditControlPoint));
+}
+
+void EditJournal::RemoveControlPoint(Scene& scene, uint32_t curve, uint32_t index)
+{
+    uint32_t pointIndex = scene.Curves[curve].FirstControlPoint + index;
+    EditControlPoint point = { scene.Positions[pointIndex], scene.Colors[pointIndex] };
+
+    scene.RemoveControlPoint(curve, index);
+    if (m_Listener)
+        m_Listener->OnControlPointRemoved(curve, index);
+
+    RecordDelta(EditDelta_RemoveControlPoint, curve, index, &point, sizeof(EditControlPoint));
+}
+
+void EditJournal::EndCommand(const Scene& scene)
+{
+    if (!m_CommandOpen)
+        return;
+
+    m_CommandOpen = false;
+
+    EditCommand& command = m_Commands.back();
+    m_MemoryUsage -= GetCommandMemory(command);
+    command.Deltas.shrink_to_fit();
+    m_MemoryUsage += GetCommandMemory(command);
+
+    // Keyframes are skipped for scenes too large to keep a few copies of within the budget
+    uint64_t sceneMemory = GetSceneMemory(scene);
+    if (m_KeyframeInterval && GetCurrentStep() % m_KeyframeInterval == 0 && sceneMemory <= m_MemoryBudget / 4)
+    {
+        EditKeyframe& keyframe = m_Keyframes.emplace_back();
+        keyframe.Step = GetCurrentStep();
+        keyframe.Snapshot = scene;
+
+        uint64_t keyframeMemory = GetKeyframeMemory(keyframe);
+        m_MemoryUsage += keyframeMemory;
+        m_KeyframeMemoryUsage += keyframeMemory;
+    }
+
+    EnforceMemoryBudget();
+}
+
+bool EditJournal::Undo(Scene& scene)
+{
+    EndCommand(scene);
+
+    if (!CanUndo())
+        return false;
+
+    ApplyCommand(scene, m_Commands[m_NumApplied - 1], true);
+    m_NumApplied--;
+    return true;
+}
+
+bool EditJournal::Redo(Scene& scene)
+{
+    EndCommand(scene);
+
+    if (!CanRedo())
+        return false;
+
+    ApplyCommand(scene, m_Commands[m_NumApplied], false);
+    m_NumApplied++;
+    return true;
+}
+
+bool EditJournal::JumpTo(Scene& scene, uint64_t step)
+{
+    EndCommand(scene);
+
+    if (step < GetFirstStep() || step > GetLastStep())
+        return false;
+
+    uint64_t currentStep = GetCurrentStep();
+    uint64_t distance = step > currentStep ? step - currentStep : currentStep - step;
+
+    // Restoring a keyframe costs a scene copy, so it is only used when it saves replaying a considerable number of commands
+    const EditKeyframe* closestKeyframe = nullptr;
+    for (const EditKeyframe& keyframe : m_Keyframes)
+    {
+        if (keyframe.Step <= step && (!closestKeyframe || keyframe.Step > closestKeyframe->Step))
+            closestKeyframe = &keyframe;
+    }
+
+    if (closestKeyframe && step - closestKeyframe->Step + m_KeyframeInterval < distance)
+    {
+        scene = closestKeyframe->Snapshot;
+        m_NumApplied = closestKeyframe->Step - m_FirstStep;
+
+        if (m_Listener)
+            m_Listener->OnSceneReset(scene);
+    }
+
+    while (GetCurrentStep() < step)
+        Redo(scene);
+
+    while (GetCurrentStep() > step)
+        Undo(scene);
+
+    return true;
+}
+
+void EditJournal::Clear()
+{
+    m_Commands.clear();
+    m_Keyframes.clear();
+    m_FirstStep = 0;
+    m_NumApplied = 0;
+    m_CommandOpen = false;
+    m_LastDeltaOffset = 0;
+    m_MemoryUsage = EDIT_JOURNAL_EMPTY_MEMORY;
+    m_KeyframeMemoryUsage = 0;
+}
+
+void EditJournal::SetMemoryBudget(uint64_t memoryBudget)
+{
+    m_MemoryBudget = memoryBudget;
+    EnforceMemoryBudget();
+}
+
+void EditJournal::SetKeyframeInterval(uint32_t keyframeInterval)
+{
+    m_KeyframeInterval = keyframeInterval;
+}
+
+void EditJournal::SetField(Scene& scene, EditDeltaType type, uint32_t curve, uint32_t index, const void* value)
+{
+    uint32_t valueSize = GetSceneFieldSize(type);
+    void* field = GetSceneFieldPointer(scene, type, curve, index);
+    if (memcmp(field, value, valueSize) == 0)
+        return;
+
+    uint8_t payload[2 * sizeof(glm::vec3)];
+    memcpy(payload, field, valueSize);
+    memcpy(payload + valueSize, value, valueSize);
+    memcpy(field, value, valueSize);
+
+    if (m_Listener)
+        m_Listener->OnFieldChanged(type, curve, index, value, valueSize);
+
+    RecordDelta(type, curve, index, payload, 2 * valueSize);
+}
+
+void EditJournal::RecordDelta(EditDeltaType type, uint32_t curve, uint32_t index, const void* payload, uint32_t payloadSize)
+{
+    // A new edit invalidates everything that could have been redone
+    TrimRedo();
+
+    bool isValueDelta = type != EditDelta_InsertControlPoint && type != EditDelta_RemoveControlPoint;
+    if (m_CommandOpen && isValueDelta)
+    {
+        EditCommand& command = m_Commands.back();
+        EditDeltaHeader* lastDelta = (EditDeltaHeader*)(command.Deltas.data() + m_LastDeltaOffset);
+
+        // Coalesce with the previous delta: keep its "before" value and replace the "after" value
+        if (lastDelta->Type == type && lastDelta->Curve == curve && lastDelta->Index == index)
+        {
+            uint32_t valueSize = payloadSize / 2;
+            memcpy((uint8_t*)(lastDelta + 1) + valueSize, (const uint8_t*)payload + valueSize, valueSize);
+            return;
+        }
+    }
+
+    if (!m_CommandOpen)
+    {
+        m_Commands.emplace_back();
+        m_NumApplied++;
+        m_CommandOpen = true;
+        m_MemoryUsage += GetCommandMemory(m_Commands.back());
+    }
+
+    EditCommand& command = m_Commands.back();
+    m_MemoryUsage -= GetCommandMemory(command);
+
+    EditDeltaHeader header = {};
+    header.Type = type;
+    header.Size = sizeof(EditDeltaHeader) + payloadSize + 1;
+    header.Curve = curve;
+    header.Index = index;
+
+    m_LastDeltaOffset = command.Deltas.size();
+    command.Deltas.resize(command.Deltas.size() + header.Size);
+
+    uint8_t* delta = command.Deltas.data() + m_LastDeltaOffset;
+    memcpy(delta, &header, sizeof(EditDeltaHeader));
+    memcpy(delta + sizeof(EditDeltaHeader), payload, payloadSize);
+    delta[header.Size - 1] = header.Size;
+
+    command.NumDeltas++;
+    m_MemoryUsage += GetCommandMemory(command);
+}
+
+void EditJournal::ApplyCommand(Scene& scene, const EditCommand& command, bool undo) const
+{
+    const uint8_t* begin = command.Deltas.data();
+    const uint8_t* end = begin + command.Deltas.size();
+
+    if (undo)
+    {
+        while (end > begin)
+        {
+            end -= end[-1];
+            ApplyDelta(scene, end, true);
+        }
+    }
+    else
+    {
+        while (begin < end)
+        {
+            ApplyDelta(scene, begin, false);
+            begin += ((const EditDeltaHeader*)begin)->Size;
+        }
+    }
+}
+
+void EditJournal::ApplyDelta(Scene& scene, const uint8_t* delta, bool undo) const
+{
+    EditDeltaHeader header;
+    memcpy(&header, delta, sizeof(EditDeltaHeader));
+    const uint8_t* payload = delta + sizeof(EditDeltaHeader);
+
+    EditDeltaType type = (EditDeltaType)header.Type;
+    if (type == EditDelta_InsertControlPoint || type == EditDelta_RemoveControlPoint)
+    {
+        EditControlPoint point;
+        memcpy(&point, payload, sizeof(EditControlPoint));
+
+        if ((type == EditDelta_InsertControlPoint) != undo)
+        {
+            scene.InsertControlPoint(header.Curve, header.Index, point.Position, point.Color);
+            if (m_Listener)
+                m_Listener->OnControlPointInserted(header.Curve, header.Index, point.Position, point.Color);
+        }
+        else
+        {
+            scene.RemoveControlPoint(header.Curve, header.Index);
+            if (m_Listener)
+                m_Listener->OnControlPointRemoved(header.Curve, header.Index);
+        }
+
+        return;
+    }
+
+    uint32_t valueSize = GetSceneFieldSize(type);
+    const uint8_t* value = undo ? payload : payload + valueSize;
+    memcpy(GetSceneFieldPointer(scene, type, header.Curve, header.Index), value, valueSize);
+
+    if (m_Listener)
+        m_Listener->OnFieldChanged(type, header.Curve, header.Index, value, valueSize);
+}
+
+void EditJournal::TrimRedo()
+{
+    while (m_Commands.size() > m_NumApplied)
+    {
+        m_MemoryUsage -= GetCommandMemory(m_Commands.back());
+        m_Commands.pop_back();
+    }
+
+    while (!m_Keyframes.empty() && m_Keyframes.back().Step > GetCurrentStep())
+    {
+        uint64_t keyframeMemory = GetKeyframeMemory(m_Keyframes.back());
+        m_MemoryUsage -= keyframeMemory;
+        m_KeyframeMemoryUsage -= keyframeMemory;
+        m_Keyframes.pop_back();
+    }
+}
+
+void EditJournal::EnforceMemoryBudget()
+{
+    while (m_MemoryUsage > m_MemoryBudget)
+    {
+        // Keyframes only speed up jumps, they go first once they dominate the budget
+        if (!m_Keyframes.empty() && m_KeyframeMemoryUsage > m_MemoryBudget / 2)
+        {
+            uint64_t keyframeMemory = GetKeyframeMemory(m_Keyframes.front());
+            m_MemoryUsage -= keyframeMemory;
+            m_KeyframeMemoryUsage -= keyframeMemory;
+            m_Keyframes.pop_front();
+            continue;
+        }
+
+        // The open command and commands that can still be redone are never dropped
+        if (m_NumApplied == 0 || (m_CommandOpen && m_Commands.size() == 1))
+            break;
+
+        m_MemoryUsage -= GetCommandMemory(m_Commands.front());
+        m_Commands.pop_front();
+        m_FirstStep++;
+        m_NumApplied--;
+
+        while (!m_Keyframes.empty() && m_Keyframes.front().Step < m_FirstStep)
+        {
+            uint64_t keyframeMemory = GetKeyframeMemory(m_Keyframes.front());
+            m_MemoryUsage -= keyframeMemory;
+            m_KeyframeMemoryUsage -= keyframeMemory;
+            m_Keyframes.pop_front();
+        }
+    }
+}
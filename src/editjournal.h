@@ -0,0 +1,117 @@
+#pragma once
+
+#include "scene.h"
+
+#include <deque>
+#include <vector>
+
+enum EditDeltaType : uint8_t
+{
+    EditDelta_DrawBezierCurve = 0,
+    EditDelta_DrawPolar,
+    EditDelta_NumSamples,
+    EditDelta_T1,
+    EditDelta_CurveColor,
+    EditDelta_CurveThickness,
+    EditDelta_ControlPointPosition,
+    EditDelta_ControlPointColor,
+    EditDelta_InsertControlPoint,
+    EditDelta_RemoveControlPoint,
+    EditDelta_Count
+};
+
+// Deltas are packed back to back inside a command: the header, the field value before and after the edit (or the whole
+// control point for inserts and removals) and a trailing byte repeating the delta size so commands can be walked backwards
+struct EditDeltaHeader
+{
+    uint8_t Type;
+    uint8_t Size;
+    uint16_t Reserved;
+    uint32_t Curve;
+    uint32_t Index;
+};
+
+// Receives every change the journal makes to the scene, including the ones made by undo and redo
+class EditJournalListener
+{
+public:
+    virtual ~EditJournalListener() = default;
+
+    virtual void OnFieldChanged(EditDeltaType type, uint32_t curve, uint32_t index, const void* value, uint32_t valueSize) = 0;
+    virtual void OnControlPointInserted(uint32_t curve, uint32_t index, const glm::vec2& position, const glm::vec3& color) = 0;
+    virtual void OnControlPointRemoved(uint32_t curve, uint32_t index) = 0;
+    virtual void OnSceneReset(const Scene& scene) = 0;
+};
+
+struct EditCommand
+{
+    std::vector<uint8_t> Deltas;
+    uint32_t NumDeltas = 0;
+};
+
+struct EditKeyframe
+{
+    uint64_t Step = 0;
+    Scene Snapshot;
+};
+
+// Undo/redo history of scene edits. Edits are applied to the scene and recorded as field level deltas, so undo and redo cost
+// is proportional to the size of the edit. Full keyframe snapshots are taken every few commands to make long jumps through
+// the history cheap, and the oldest history is dropped once the memory budget is exceeded
+class EditJournal
+{
+public:
+    EditJournal(uint64_t memoryBudget = 64 * 1024 * 1024, uint32_t keyframeInterval = 256);
+
+    void SetSettings(Scene& scene, const GlobalSettings& settings);
+    void SetCurveColor(Scene& scene, uint32_t curve, const glm::vec3& color);
+    void SetCurveThickness(Scene& scene, uint32_t curve, float thickness);
+    void SetControlPointPosition(Scene& scene, uint32_t curve, uint32_t index, const glm::vec2& position);
+    void SetControlPointColor(Scene& scene, uint32_t curve, uint32_t index, const glm::vec3& color);
+    void InsertControlPoint(Scene& scene, uint32_t curve, uint32_t index, const glm::vec2& position, const glm::vec3& color);
+    void RemoveControlPoint(Scene& scene, uint32_t curve, uint32_t index);
+
+    // Seals the open command. Until then, consecutive edits of the same field are coalesced into a single delta
+    void EndCommand(const Scene& scene);
+
+    bool Undo(Scene& scene);
+    bool Redo(Scene& scene);
+    bool JumpTo(Scene& scene, uint64_t step);
+    void Clear();
+
+    void SetMemoryBudget(uint64_t memoryBudget);
+    void SetKeyframeInterval(uint32_t keyframeInterval);
+    void SetListener(EditJournalListener* listener) { m_Listener = listener; }
+
+    bool CanUndo() const { return m_NumApplied > 0; }
+    bool CanRedo() const { return m_NumApplied < m_Commands.size(); }
+    uint64_t GetFirstStep() const { return m_FirstStep; }
+    uint64_t GetCurrentStep() const { return m_FirstStep + m_NumApplied; }
+    uint64_t GetLastStep() const { return m_FirstStep + m_Commands.size(); }
+    uint64_t GetMemoryUsage() const { return m_MemoryUsage; }
+    uint64_t GetMemoryBudget() const { return m_MemoryBudget; }
+    uint32_t GetNumKeyframes() const { return m_Keyframes.size(); }
+private:
+    void SetField(Scene& scene, EditDeltaType type, uint32_t curve, uint32_t index, const void* value);
+    void RecordDelta(EditDeltaType type, uint32_t curve, uint32_t index, const void* payload, uint32_t payloadSize);
+    void ApplyCommand(Scene& scene, const EditCommand& command, bool undo) const;
+    void ApplyDelta(Scene& scene, const uint8_t* delta, bool undo) const;
+    void TrimRedo();
+    void EnforceMemoryBudget();
+private:
+    std::deque<EditCommand> m_Commands;
+    std::deque<EditKeyframe> m_Keyframes;
+    uint64_t m_FirstStep = 0;
+    uint32_t m_NumApplied = 0;
+    bool m_CommandOpen = false;
+    uint32_t m_LastDeltaOffset = 0;
+    uint64_t m_MemoryBudget;
+    uint32_t m_KeyframeInterval;
+    uint64_t m_MemoryUsage;
+    uint64_t m_KeyframeMemoryUsage = 0;
+    EditJournalListener* m_Listener = nullptr;
+};
+
+// Value fields addressed by the delta types up to EditDelta_ControlPointColor. Returns nullptr for structural deltas
+void* GetSceneFieldPointer(Scene& scene, EditDeltaType type, uint32_t curve, uint32_t index);
+uint32_t GetSceneFieldSize(EditDeltaType type);
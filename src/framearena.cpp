@@ -0,0 +1,98 @@
+#include "framearena.h"
+
+#include <algorithm>
+#include <cstring>
+
+FrameArena::FrameArena(size_t blockSize)
+    : m_BlockSize(blockSize)
+{
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+    if (m_Blocks.empty())
+        AddBlock(size + alignment);
+
+    size_t offset = GetAlignedOffset(m_Offset, alignment);
+    while (offset + size > m_Blocks[m_CurrentBlock].Size)
+    {
+        // Later blocks may be left over from a previous frame that needed more than this one so far
+        m_CurrentBlock++;
+        if (m_CurrentBlock == m_Blocks.size())
+            AddBlock(size + alignment);
+
+        m_Offset = 0;
+        offset = GetAlignedOffset(0, alignment);
+    }
+
+    m_BytesUsed += offset - m_Offset + size;
+    m_Offset = offset + size;
+    return m_Blocks[m_CurrentBlock].Memory.get() + offset;
+}
+
+void FrameArena::Free(void* pointer, size_t size)
+{
+    if (m_Blocks.empty())
+        return;
+
+    uint8_t* memory = m_Blocks[m_CurrentBlock].Memory.get();
+    if ((uint8_t*)pointer + size == memory + m_Offset)
+    {
+        m_Offset -= size;
+        m_BytesUsed -= size;
+    }
+}
+
+void FrameArena::Reset()
+{
+    m_PeakBytesUsed = std::max(m_PeakBytesUsed, m_BytesUsed);
+
+#if defined(FRAME_ARENA_POISON_ENABLED)
+    for (uint32_t i = 0; i < m_Blocks.size() && i <= m_CurrentBlock; i++)
+        memset(m_Blocks[i].Memory.get(), FRAME_ARENA_POISON, i == m_CurrentBlock ? m_Offset : m_Blocks[i].Size);
+#endif
+
+    // A frame that spilled into several blocks is served by a single block from now on
+    if (m_Blocks.size() > 1)
+    {
+        size_t capacity = GetCapacity();
+        m_Blocks.clear();
+        AddBlock(capacity);
+    }
+
+    m_CurrentBlock = 0;
+    m_Offset = 0;
+    m_BytesUsed = 0;
+}
+
+size_t FrameArena::GetAlignedOffset(size_t offset, size_t alignment) const
+{
+    uintptr_t address = (uintptr_t)m_Blocks[m_CurrentBlock].Memory.get() + offset;
+    return offset + ((alignment - address % alignment) % alignment);
+}
+
+size_t FrameArena::GetCapacity() const
+{
+    size_t capacity = 0;
+    for (const Block& block : m_Blocks)
+        capacity += block.Size;
+    return capacity;
+}
+
+void FrameArena::AddBlock(size_t minSize)
+{
+    Block& block = m_Blocks.emplace_back();
+    block.Size = std::max(m_BlockSize, minSize);
+    block.Memory.reset(new uint8_t[block.Size]);
+}
+
+DoubleBufferedFrameArena::DoubleBufferedFrameArena(size_t blockSize)
+    : m_Arenas{ FrameArena(blockSize), FrameArena(blockSize) }
+{
+}
+
+void DoubleBufferedFrameArena::Swap()
+{
+    m_Current ^= 1;
+    m_Arenas[m_Current].Reset();
+}
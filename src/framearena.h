@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#define FRAME_ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+#define FRAME_ARENA_POISON 0xDD
+
+// Memory released by Reset is overwritten with FRAME_ARENA_POISON in builds with asserts, so data used past the end of its
+// frame shows up as garbage instead of silently reading the next frame's values. NDEBUG rather than _DEBUG, which only the
+// MSVC runtime defines on its own
+#if !defined(NDEBUG) && !defined(FRAME_ARENA_NO_POISON)
+#define FRAME_ARENA_POISON_ENABLED
+#endif
+
+// Linear allocator for data that lives for exactly one frame. Allocations bump a pointer and are never freed one by one,
+// Reset releases everything at once. When a frame needed more than one block, Reset replaces the blocks with a single one
+// large enough for the whole frame, so a steady state frame only ever touches one block and never reaches the heap.
+// Not thread-safe, each thread needs its own arena
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t blockSize = FRAME_ARENA_DEFAULT_BLOCK_SIZE);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    // Gives the memory back only if it was the last allocation, which lets a growing vector extend in place
+    void Free(void* pointer, size_t size);
+    void Reset();
+
+    template<typename T>
+    T* AllocateArray(size_t count)
+    {
+        return (T*)Allocate(count * sizeof(T), alignof(T));
+    }
+
+    size_t GetBytesUsed() const { return m_BytesUsed; }
+    // Highest usage of any frame since the arena was created
+    size_t GetPeakBytesUsed() const { return m_PeakBytesUsed; }
+    size_t GetCapacity() const;
+private:
+    struct Block
+    {
+        std::unique_ptr<uint8_t[]> Memory;
+        size_t Size;
+    };
+
+    void AddBlock(size_t minSize);
+    size_t GetAlignedOffset(size_t offset, size_t alignment) const;
+private:
+    std::vector<Block> m_Blocks;
+    uint32_t m_CurrentBlock = 0;
+    size_t m_Offset = 0;
+    size_t m_BlockSize;
+    size_t m_BytesUsed = 0;
+    size_t m_PeakBytesUsed = 0;
+};
+
+// Two arenas used on alternate frames, for data written on the main thread during one frame and read by a worker thread
+// during the next. Swap resets the arena that was filled two frames ago, which no reader can still be using once the
+// readers of the previous frame have been waited on
+class DoubleBufferedFrameArena
+{
+public:
+    explicit DoubleBufferedFrameArena(size_t blockSize = FRAME_ARENA_DEFAULT_BLOCK_SIZE);
+
+    FrameArena& GetCurrent() { return m_Arenas[m_Current]; }
+    FrameArena& GetPrevious() { return m_Arenas[m_Current ^ 1]; }
+    void Swap();
+private:
+    FrameArena m_Arenas[2];
+    uint32_t m_Current = 0;
+};
+
+// Standard allocator over a frame arena, so standard containers can hold per-frame data. Containers must be destroyed
+// before the arena is reset
+template<typename T>
+class FrameArenaAllocator
+{
+public:
+    using value_type = T;
+
+    FrameArenaAllocator(FrameArena& arena) : m_Arena(&arena) {}
+
+    template<typename U>
+    FrameArenaAllocator(const FrameArenaAllocator<U>& other) : m_Arena(other.GetArena()) {}
+
+    T* allocate(size_t count) { return m_Arena->AllocateArray<T>(count); }
+    void deallocate(T* pointer, size_t count) { m_Arena->Free(pointer, count * sizeof(T)); }
+
+    FrameArena* GetArena() const { return m_Arena; }
+
+    template<typename U>
+    bool operator==(const FrameArenaAllocator<U>& other) const { return m_Arena == other.GetArena(); }
+    template<typename U>
+    bool operator!=(const FrameArenaAllocator<U>& other) const { return m_Arena != other.GetArena(); }
+private:
+    FrameArena* m_Arena;
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameArenaAllocator<T>>;
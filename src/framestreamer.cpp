@@ -0,0 +1,174 @@
+#include "framestreamer.h"
+#include "cpurenderer.h"
+#include "jobsystem.h"
+#include "orderedwriter.h"
+#include "scenesnapshot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const char s_Y4mFrameHeader[] = "FRAME\n";
+
+// What a thread keeps from one frame to the next. A job system per thread, the frames are the parallel work
+struct FrameWorker
+{
+    explicit FrameWorker(const Scene& scene)
+        : Jobs(1), Renderer(Jobs), FrameScene(scene)
+    {
+    }
+
+    JobSystem Jobs;
+    CpuRenderer Renderer;
+    Scene FrameScene;
+    CpuImage Image;
+};
+
+static size_t GetFrameSize(FrameFormat format, uint32_t width, uint32_t height)
+{
+    size_t numPixels = (size_t)width * height;
+    if (format == FrameFormat_Y4m)
+        return sizeof(s_Y4mFrameHeader) - 1 + numPixels + numPixels / 2;
+
+    return numPixels * 4;
+}
+
+// BT.601 limited range in 8-bit fixed point, Y in [16, 235] and chroma in [16, 240]
+static uint8_t GetLuma(uint32_t r, uint32_t g, uint32_t b)
+{
+    return uint8_t(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+}
+
+// Chroma of the sum of four pixels, the extra two bits of the sums are divided out with the rest
+static void GetChroma(int32_t r, int32_t g, int32_t b, uint8_t& u, uint8_t& v)
+{
+    u = uint8_t(((-38 * r - 74 * g + 112 * b + 512) >> 10) + 128);
+    v = uint8_t(((112 * r - 94 * g - 18 * b + 512) >> 10) + 128);
+}
+
+static void EncodeY4m(const CpuImage& image, uint8_t* output)
+{
+    std::memcpy(output, s_Y4mFrameHeader, sizeof(s_Y4mFrameHeader) - 1);
+    uint8_t* luma = output + sizeof(s_Y4mFrameHeader) - 1;
+    uint8_t* chromaU = luma + (size_t)image.Width * image.Height;
+    uint8_t* chromaV = chromaU + (size_t)image.Width * image.Height / 4;
+
+    // Every 2x2 block of pixels shares its chroma sample, centered between them as C420jpeg specifies
+    uint32_t chromaWidth = image.Width / 2;
+    for (uint32_t y = 0; y < image.Height; y += 2)
+    {
+        const uint32_t* row0 = &image.Pixels[(size_t)y * image.Width];
+        const uint32_t* row1 = row0 + image.Width;
+        uint8_t* luma0 = luma + (size_t)y * image.Width;
+        uint8_t* luma1 = luma0 + image.Width;
+        for (uint32_t x = 0; x < chromaWidth; x++)
+        {
+            int32_t r = 0, g = 0, b = 0;
+            const uint32_t block[4] = { row0[2 * x], row0[2 * x + 1], row1[2 * x], row1[2 * x + 1] };
+            uint8_t* blockLuma[4] = { &luma0[2 * x], &luma0[2 * x + 1], &luma1[2 * x], &luma1[2 * x + 1] };
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                uint32_t pixelR = block[i] & 0xFF;
+                uint32_t pixelG = (block[i] >> 8) & 0xFF;
+                uint32_t pixelB = (block[i] >> 16) & 0xFF;
+                *blockLuma[i] = GetLuma(pixelR, pixelG, pixelB);
+                r += pixelR;
+                g += pixelG;
+                b += pixelB;
+            }
+
+            size_t chromaIndex = (size_t)(y / 2) * chromaWidth + x;
+            GetChroma(r, g, b, chromaU[chromaIndex], chromaV[chromaIndex]);
+        }
+    }
+}
+
+static void EncodeRgba(const CpuImage& image, uint8_t* output)
+{
+    // Pixels are packed as R | G << 8 | B << 16 | A << 24, written byte by byte so the stream does not depend on endianness
+    for (uint32_t pixel : image.Pixels)
+    {
+        output[0] = uint8_t(pixel);
+        output[1] = uint8_t(pixel >> 8);
+        output[2] = uint8_t(pixel >> 16);
+        output[3] = uint8_t(pixel >> 24);
+        output += 4;
+    }
+}
+
+bool StreamAnimationFrames(const SceneAnimation& animation, const Scene& scene, const FrameStreamSettings& settings, std::ostream& output, FrameStreamStats& stats)
+{
+    stats = FrameStreamStats();
+    if (settings.Width == 0 || settings.Height == 0 || settings.FramesPerSecond == 0)
+    {
+        std::cout << "Failed to stream frames: the frame size and rate must not be zero" << std::endl;
+        return false;
+    }
+
+    if ((uint64_t)settings.Width * settings.Height > FRAME_STREAM_MAX_PIXELS)
+    {
+        std::cout << "Failed to stream frames: " << settings.Width << "x" << settings.Height << " is larger than " << FRAME_STREAM_MAX_PIXELS << " pixels" << std::endl;
+        return false;
+    }
+
+    if (settings.Format == FrameFormat_Y4m && (settings.Width % 2 != 0 || settings.Height % 2 != 0))
+    {
+        std::cout << "Failed to stream frames: Y4M frames need an even width and height, not " << settings.Width << "x" << settings.Height << std::endl;
+        return false;
+    }
+
+    Clock::time_point start = Clock::now();
+    if (settings.Format == FrameFormat_Y4m)
+    {
+        std::string header = "YUV4MPEG2 W" + std::to_string(settings.Width) + " H" + std::to_string(settings.Height) + " F" +
+            std::to_string(settings.FramesPerSecond) + ":1 Ip A1:1 C420jpeg\n";
+        output.write(header.data(), header.size());
+        stats.NumBytes += header.size();
+    }
+
+    uint32_t numThreads = settings.NumThreads > 0 ? settings.NumThreads : std::max(std::thread::hardware_concurrency(), 1u);
+    numThreads = std::max(std::min(numThreads, settings.NumFrames), 1u);
+    size_t frameSize = GetFrameSize(settings.Format, settings.Width, settings.Height);
+
+    // Created on the thread that uses them, a job system of one thread runs its jobs on the thread that created it
+    std::vector<std::unique_ptr<FrameWorker>> workers(numThreads);
+    auto encodeFrame = [&](uint32_t thread, uint32_t frame, std::vector<uint8_t>& data)
+    {
+        if (!workers[thread])
+            workers[thread] = std::make_unique<FrameWorker>(scene);
+
+        FrameWorker& worker = *workers[thread];
+        animation.Evaluate(settings.StartTime + float(frame) / settings.FramesPerSecond, worker.FrameScene);
+        worker.Renderer.Render(*SceneSnapshot::Create(worker.FrameScene), settings.Width, settings.Height, worker.Image);
+
+        data.resize(frameSize);
+        if (settings.Format == FrameFormat_Y4m)
+            EncodeY4m(worker.Image, data.data());
+        else
+            EncodeRgba(worker.Image, data.data());
+    };
+
+    OrderedWriteStats writeStats;
+    bool succeeded = WriteItemsInOrder(settings.NumFrames, numThreads, settings.MaxFramesInFlight, encodeFrame, output, writeStats);
+
+    uint32_t numWrittenFrames = writeStats.NumWritten;
+    stats.NumBytes += writeStats.NumBytes;
+    stats.PeakFramesInFlight = writeStats.PeakInFlight;
+    stats.NumFrames = numWrittenFrames;
+    stats.TotalTime = std::chrono::duration<float>(Clock::now() - start).count();
+    stats.FramesPerSecond = stats.TotalTime > 0.0f ? stats.NumFrames / stats.TotalTime : 0.0f;
+    if (!succeeded)
+    {
+        std::cout << "Failed to stream frames: the output failed after " << numWrittenFrames << " of " << settings.NumFrames << " frames" << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "animation.h"
+#include "scene.h"
+
+#include <cstdint>
+#include <ostream>
+
+// Largest frame, 256 MB of RGBA. Frames are rendered and buffered whole, a few of them per thread
+#define FRAME_STREAM_MAX_PIXELS (1u << 26)
+
+enum FrameFormat : uint32_t
+{
+    // YUV4MPEG2 with 4:2:0 chroma and BT.601 limited range, which ffmpeg and most players read from a pipe. Needs an even
+    // width and height
+    FrameFormat_Y4m = 0,
+    // Headerless RGBA8 frames, rows from top to bottom
+    FrameFormat_Rgba,
+};
+
+struct FrameStreamSettings
+{
+    uint32_t Width = 1920;
+    uint32_t Height = 1080;
+    uint32_t FramesPerSecond = 30;
+    uint32_t NumFrames = 0;
+    // Animation time of the first frame, frame i is at StartTime + i / FramesPerSecond
+    float StartTime = 0.0f;
+    FrameFormat Format = FrameFormat_Y4m;
+    // Frames rendered at once, 0 uses one per hardware thread
+    uint32_t NumThreads = 0;
+    // Frames rendered or encoded but not written yet, which bounds the memory in use. 0 uses two per thread
+    uint32_t MaxFramesInFlight = 0;
+};
+
+struct FrameStreamStats
+{
+    uint32_t NumFrames = 0;
+    float TotalTime = 0.0f;
+    float FramesPerSecond = 0.0f;
+    uint64_t NumBytes = 0;
+    uint32_t PeakFramesInFlight = 0;
+};
+
+// Renders frames of an animation with the CPU renderer and writes them to output in order. Each thread renders whole
+// frames with a renderer of its own and takes the next frame as soon as it is done, frames are encoded on the thread that
+// rendered them into one of MaxFramesInFlight buffers, and the calling thread writes the buffers out in frame order. A
+// thread that gets ahead of the output by MaxFramesInFlight frames waits for it, so a slow output holds back rendering
+// instead of filling memory. scene provides the curves and settings the animation does not key. Returns false if the
+// output fails, frames written until then stay written
+bool StreamAnimationFrames(const SceneAnimation& animation, const Scene& scene, const FrameStreamSettings& settings, std::ostream& output, FrameStreamStats& stats);
@@ -0,0 +1,224 @@
+#include "imagefile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#define TGA_HEADER_SIZE 18
+#define TGA_IMAGE_TYPE_TRUECOLOR 2
+#define TGA_IMAGE_TYPE_TRUECOLOR_RLE 10
+#define TGA_DESCRIPTOR_ALPHA_BITS 0x0F
+#define TGA_DESCRIPTOR_TOP_LEFT 0x20
+#define TGA_MAX_PACKET_PIXELS 128
+
+// Pixels are RGBA in memory and BGRA in the file
+static uint32_t SwapRedBlue(uint32_t pixel)
+{
+    return (pixel & 0xFF00FF00) | ((pixel & 0xFF) << 16) | ((pixel >> 16) & 0xFF);
+}
+
+static void WritePixel(std::vector<uint8_t>& data, uint32_t pixel)
+{
+    pixel = SwapRedBlue(pixel);
+    data.push_back(pixel & 0xFF);
+    data.push_back((pixel >> 8) & 0xFF);
+    data.push_back((pixel >> 16) & 0xFF);
+    data.push_back(pixel >> 24);
+}
+
+bool EncodeTgaHeader(uint32_t width, uint32_t height, std::vector<uint8_t>& data)
+{
+    if (width > 0xFFFF || height > 0xFFFF)
+        return false;
+
+    data.assign(TGA_HEADER_SIZE, 0);
+    data[2] = TGA_IMAGE_TYPE_TRUECOLOR_RLE;
+    data[12] = width & 0xFF;
+    data[13] = width >> 8;
+    data[14] = height & 0xFF;
+    data[15] = height >> 8;
+    data[16] = 32;
+    data[17] = TGA_DESCRIPTOR_TOP_LEFT | 8;
+    return true;
+}
+
+void EncodeTgaRows(const uint32_t* pixels, uint32_t width, uint32_t numRows, std::vector<uint8_t>& data)
+{
+    // Packets never cross rows, as the format requires
+    for (uint32_t y = 0; y < numRows; y++)
+    {
+        const uint32_t* row = pixels + (size_t)y * width;
+        uint32_t x = 0;
+        while (x < width)
+        {
+            uint32_t runLength = 1;
+            while (x + runLength < width && runLength < TGA_MAX_PACKET_PIXELS && row[x + runLength] == row[x])
+                runLength++;
+
+            if (runLength > 1)
+            {
+                data.push_back(0x80 | (runLength - 1));
+                WritePixel(data, row[x]);
+                x += runLength;
+                continue;
+            }
+
+            // Raw packet up to the start of the next run
+            uint32_t rawLength = 1;
+            while (x + rawLength < width && rawLength < TGA_MAX_PACKET_PIXELS && (x + rawLength + 1 >= width || row[x + rawLength] != row[x + rawLength + 1]))
+                rawLength++;
+
+            data.push_back(rawLength - 1);
+            for (uint32_t i = 0; i < rawLength; i++)
+                WritePixel(data, row[x + i]);
+            x += rawLength;
+        }
+    }
+}
+
+void EncodePpmHeader(uint32_t width, uint32_t height, std::vector<uint8_t>& data)
+{
+    std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    data.assign(header.begin(), header.end());
+}
+
+void EncodePpmRows(const uint32_t* pixels, uint32_t width, uint32_t numRows, std::vector<uint8_t>& data)
+{
+    size_t offset = data.size();
+    size_t numPixels = (size_t)width * numRows;
+    data.resize(offset + numPixels * 3);
+    uint8_t* output = data.data() + offset;
+    for (size_t i = 0; i < numPixels; i++)
+    {
+        output[0] = uint8_t(pixels[i]);
+        output[1] = uint8_t(pixels[i] >> 8);
+        output[2] = uint8_t(pixels[i] >> 16);
+        output += 3;
+    }
+}
+
+bool SaveImageTga(const std::string& filepath, const CpuImage& image)
+{
+    std::vector<uint8_t> data;
+    if (!EncodeTgaHeader(image.Width, image.Height, data))
+    {
+        std::cout << "Image is too large for a TGA file: " << filepath << std::endl;
+        return false;
+    }
+
+    EncodeTgaRows(image.Pixels.data(), image.Width, image.Height, data);
+
+    std::ofstream file(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cout << "Failed to create image file: " << filepath << std::endl;
+        return false;
+    }
+
+    file.write((const char*)data.data(), data.size());
+    if (!file.good())
+    {
+        std::cout << "Failed writing image file: " << filepath << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool LoadImageTga(const std::string& filepath, CpuImage& image)
+{
+    std::ifstream file(filepath, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cout << "Failed to open image file: " << filepath << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < TGA_HEADER_SIZE)
+    {
+        std::cout << "Invalid image file: " << filepath << std::endl;
+        return false;
+    }
+
+    uint32_t idLength = data[0];
+    uint32_t colorMapType = data[1];
+    uint32_t imageType = data[2];
+    uint32_t width = data[12] | (data[13] << 8);
+    uint32_t height = data[14] | (data[15] << 8);
+    uint32_t bitsPerPixel = data[16];
+    uint32_t descriptor = data[17];
+
+    if (colorMapType != 0 || (imageType != TGA_IMAGE_TYPE_TRUECOLOR && imageType != TGA_IMAGE_TYPE_TRUECOLOR_RLE) || (bitsPerPixel != 24 && bitsPerPixel != 32))
+    {
+        std::cout << "Unsupported TGA file, only 24 and 32-bit truecolor images are supported: " << filepath << std::endl;
+        return false;
+    }
+
+    uint32_t bytesPerPixel = bitsPerPixel / 8;
+    size_t offset = TGA_HEADER_SIZE + idLength;
+    size_t numPixels = (size_t)width * height;
+
+    image.Width = width;
+    image.Height = height;
+    image.Pixels.resize(numPixels);
+
+    auto readPixel = [&](uint32_t& pixel)
+    {
+        if (offset + bytesPerPixel > data.size())
+            return false;
+
+        uint32_t alpha = bytesPerPixel == 4 && (descriptor & TGA_DESCRIPTOR_ALPHA_BITS) ? data[offset + 3] : 0xFF;
+        pixel = SwapRedBlue(data[offset] | (data[offset + 1] << 8) | (data[offset + 2] << 16) | (alpha << 24));
+        offset += bytesPerPixel;
+        return true;
+    };
+
+    size_t i = 0;
+    bool truncated = false;
+    while (i < numPixels && !truncated)
+    {
+        uint32_t packetLength = 1;
+        bool isRun = false;
+        if (imageType == TGA_IMAGE_TYPE_TRUECOLOR_RLE)
+        {
+            if (offset >= data.size())
+            {
+                truncated = true;
+                break;
+            }
+
+            isRun = data[offset] & 0x80;
+            packetLength = std::min<size_t>((data[offset] & 0x7F) + 1, numPixels - i);
+            offset++;
+        }
+
+        uint32_t pixel = 0;
+        if (isRun && !readPixel(pixel))
+            truncated = true;
+
+        for (uint32_t j = 0; j < packetLength && !truncated; j++)
+        {
+            if (!isRun && !readPixel(pixel))
+                truncated = true;
+            else
+                image.Pixels[i++] = pixel;
+        }
+    }
+
+    if (truncated)
+    {
+        std::cout << "Truncated image file: " << filepath << std::endl;
+        return false;
+    }
+
+    // Rows are stored bottom to top unless the descriptor says otherwise
+    if (!(descriptor & TGA_DESCRIPTOR_TOP_LEFT))
+    {
+        for (uint32_t y = 0; y < height / 2; y++)
+            std::swap_ranges(image.Pixels.begin() + (size_t)y * width, image.Pixels.begin() + (size_t)(y + 1) * width, image.Pixels.begin() + (size_t)(height - 1 - y) * width);
+    }
+
+    return true;
+}
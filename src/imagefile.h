@@ -0,0 +1,28 @@
+#pragma once
+
+#include "cpurenderer.h"
+
+#include <string>
+#include <vector>
+
+enum ImageFileFormat : uint32_t
+{
+    // Run-length encoded 32-bit TGA as SaveImageTga writes it, at most 65535 pixels on each side
+    ImageFileFormat_Tga = 0,
+    // Binary PPM (P6), 8-bit RGB without alpha and without a size limit
+    ImageFileFormat_Ppm,
+};
+
+// Images are stored as run-length encoded 32-bit TGA files, which most image viewers open and which stay small for the
+// mostly black renders of the editor
+bool SaveImageTga(const std::string& filepath, const CpuImage& image);
+// Reads uncompressed and run-length encoded 24 and 32-bit TGA files
+bool LoadImageTga(const std::string& filepath, CpuImage& image);
+
+// Pieces of SaveImageTga for images written a few rows at a time. The header replaces the contents of data and fails when
+// the image is larger than TGA allows, the rows are appended to data and must come from top to bottom
+bool EncodeTgaHeader(uint32_t width, uint32_t height, std::vector<uint8_t>& data);
+void EncodeTgaRows(const uint32_t* pixels, uint32_t width, uint32_t numRows, std::vector<uint8_t>& data);
+// The same for PPM files, which take any size
+void EncodePpmHeader(uint32_t width, uint32_t height, std::vector<uint8_t>& data);
+void EncodePpmRows(const uint32_t* pixels, uint32_t width, uint32_t numRows, std::vector<uint8_t>& data);
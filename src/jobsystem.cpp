@@ -0,0 +1,283 @@
+#include "jobsystem.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+struct CurrentWorker
+{
+    JobSystem* System;
+    uint32_t Index;
+};
+
+static thread_local CurrentWorker s_CurrentWorker = { nullptr, 0 };
+
+JobDeque::JobDeque(uint32_t capacity)
+    : m_Jobs(new std::atomic<Job*>[capacity]), m_Mask(capacity - 1)
+{
+}
+
+bool JobDeque::Push(Job* job)
+{
+    int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+    int64_t top = m_Top.load(std::memory_order_acquire);
+    if (bottom - top > m_Mask)
+        return false;
+
+    m_Jobs[bottom & m_Mask].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+Job* JobDeque::Pop()
+{
+    int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+    m_Bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_Top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = m_Jobs[bottom & m_Mask].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        // Last job in the deque, race the thieves for it
+        if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            job = nullptr;
+
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    return job;
+}
+
+Job* JobDeque::Steal()
+{
+    int64_t top = m_Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom)
+        return nullptr;
+
+    Job* job = m_Jobs[top & m_Mask].load(std::memory_order_relaxed);
+    if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+
+    return job;
+}
+
+JobSystem::JobSystem(uint32_t numThreads)
+{
+    if (numThreads == 0)
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (uint32_t i = 0; i < numThreads; i++)
+    {
+        m_Workers.push_back(std::make_unique<Worker>());
+        m_Workers[i]->RandomState = 0x9E3779B9u * (i + 1);
+    }
+
+    s_CurrentWorker = { this, 0 };
+    for (uint32_t i = 1; i < numThreads; i++)
+        m_Workers[i]->Thread = std::thread(&JobSystem::WorkerMain, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_StopRequested.store(true);
+    }
+    m_SleepCondition.notify_all();
+
+    for (uint32_t i = 1; i < m_Workers.size(); i++)
+        m_Workers[i]->Thread.join();
+
+    if (s_CurrentWorker.System == this)
+        s_CurrentWorker = { nullptr, 0 };
+}
+
+Job* JobSystem::CreateJob(JobFunction function, const void* data, uint32_t dataSize)
+{
+    return CreateChildJob(nullptr, function, data, dataSize);
+}
+
+Job* JobSystem::CreateChildJob(Job* parent, JobFunction function, const void* data, uint32_t dataSize)
+{
+    if (parent)
+        parent->NumUnfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+
+    Job* job = AllocateJob();
+    job->Function = function;
+    job->Parent = parent;
+    job->NumUnfinishedJobs.store(1, std::memory_order_relaxed);
+    if (data)
+        memcpy(job->Data, data, std::min<uint32_t>(dataSize, JOB_DATA_SIZE));
+
+    return job;
+}
+
+void JobSystem::Run(Job* job)
+{
+    // A full deque means this thread is far ahead of the others, running the job right away keeps the work bounded
+    if (!GetCurrentWorker().Deque.Push(job))
+    {
+        Execute(job);
+        return;
+    }
+
+    m_NumQueuedJobs.fetch_add(1);
+    if (m_NumSleepingWorkers.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_SleepCondition.notify_one();
+    }
+}
+
+void JobSystem::Wait(const Job* job)
+{
+    Worker& worker = GetCurrentWorker();
+    while (job->NumUnfinishedJobs.load(std::memory_order_acquire) > 0)
+    {
+        if (Job* nextJob = FindJob(worker))
+            Execute(nextJob);
+        else
+            std::this_thread::yield();
+    }
+}
+
+JobSystem::Worker& JobSystem::GetCurrentWorker()
+{
+    return *m_Workers[s_CurrentWorker.System == this ? s_CurrentWorker.Index : 0];
+}
+
+Job* JobSystem::AllocateJob()
+{
+    // Slots are handed out in ring order, skipping the ones whose jobs are unfinished. A ParallelFor only keeps the halves
+    // still to split and their parents unfinished, O(log(count)^2) jobs, so the next slot is nearly always free
+    Worker& worker = GetCurrentWorker();
+    for (uint32_t i = 0; i < MAX_JOBS_PER_THREAD; i++)
+    {
+        Job* job = &worker.Jobs[worker.NextJob++ & (MAX_JOBS_PER_THREAD - 1)];
+        if (job->NumUnfinishedJobs.load(std::memory_order_acquire) == 0)
+            return job;
+    }
+
+    // Reusing an unfinished job would drop its work and whatever waits on it would return early
+    std::cout << "Job system: more than " << MAX_JOBS_PER_THREAD << " unfinished jobs on one thread" << std::endl;
+    std::abort();
+}
+
+Job* JobSystem::FindJob(Worker& worker)
+{
+    Job* job = worker.Deque.Pop();
+    if (!job)
+    {
+        // Start stealing at a random victim so idle workers do not all hammer the same deque
+        uint32_t numWorkers = m_Workers.size();
+        worker.RandomState ^= worker.RandomState << 13;
+        worker.RandomState ^= worker.RandomState >> 17;
+        worker.RandomState ^= worker.RandomState << 5;
+
+        uint32_t first = worker.RandomState % numWorkers;
+        for (uint32_t i = 0; i < numWorkers && !job; i++)
+        {
+            Worker& victim = *m_Workers[(first + i) % numWorkers];
+            if (&victim != &worker)
+                job = victim.Deque.Steal();
+        }
+    }
+
+    if (job)
+        m_NumQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+    return job;
+}
+
+void JobSystem::Execute(Job* job)
+{
+    job->Function(*job, job->Data);
+    Finish(job);
+}
+
+void JobSystem::Finish(Job* job)
+{
+    // Once the count drops to zero the slot may be handed out again, the parent has to be read before
+    Job* parent = job->Parent;
+    if (job->NumUnfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) == 1 && parent)
+        Finish(parent);
+}
+
+void JobSystem::WorkerMain(uint32_t workerIndex)
+{
+    s_CurrentWorker = { this, workerIndex };
+    Profiler::SetThreadName("Job Worker " + std::to_string(workerIndex));
+
+    Worker& worker = *m_Workers[workerIndex];
+
+    const uint32_t NUM_SPINS_BEFORE_SLEEP = 64;
+    uint32_t numFailedAttempts = 0;
+
+    while (!m_StopRequested.load(std::memory_order_relaxed))
+    {
+        if (Job* job = FindJob(worker))
+        {
+            Execute(job);
+            numFailedAttempts = 0;
+            continue;
+        }
+
+        if (++numFailedAttempts < NUM_SPINS_BEFORE_SLEEP)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Run() only notifies when it sees a sleeping worker, registering before checking the queue count avoids missed wakeups
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_NumSleepingWorkers.fetch_add(1);
+        m_SleepCondition.wait(lock, [this]() { return m_NumQueuedJobs.load() > 0 || m_StopRequested.load(); });
+        m_NumSleepingWorkers.fetch_sub(1);
+        numFailedAttempts = 0;
+    }
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t granularity, void (*function)(uint32_t begin, uint32_t end, const void* userData), const void* userData)
+{
+    if (count == 0)
+        return;
+
+    ParallelForData data = { this, function, userData, 0, count, std::max(granularity, 1u) };
+    Job* root = CreateJob(ParallelForJob, &data, sizeof(data));
+    Run(root);
+    Wait(root);
+}
+
+void JobSystem::ParallelForJob(Job& job, void* data)
+{
+    static_assert(sizeof(ParallelForData) <= JOB_DATA_SIZE, "Parallel for range does not fit into the job data");
+
+    ParallelForData& range = *(ParallelForData*)data;
+
+    // Ranges are halved until they fit the granularity, each half is a child so waiting on the root covers all of them
+    while (range.End - range.Begin > range.Granularity)
+    {
+        uint32_t middle = range.Begin + (range.End - range.Begin) / 2;
+
+        ParallelForData upperHalf = range;
+        upperHalf.Begin = middle;
+        range.End = middle;
+
+        range.System->Run(range.System->CreateChildJob(&job, ParallelForJob, &upperHalf, sizeof(upperHalf)));
+    }
+
+    range.Function(range.Begin, range.End, range.UserData);
+}
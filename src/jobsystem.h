@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define JOB_DATA_SIZE 40
+#define MAX_JOBS_PER_THREAD 4096
+
+struct Job;
+using JobFunction = void (*)(Job& job, void* data);
+
+// A job counts itself and its unfinished children, it is finished once the count drops to zero. Jobs are allocated from
+// per-thread rings of MAX_JOBS_PER_THREAD slots and a slot is only handed out again once its job is finished, so a job must
+// not be referenced after it finished. A thread may hold at most MAX_JOBS_PER_THREAD unfinished jobs
+struct alignas(64) Job
+{
+    JobFunction Function;
+    Job* Parent;
+    std::atomic<int32_t> NumUnfinishedJobs{ 0 };
+    alignas(8) uint8_t Data[JOB_DATA_SIZE];
+};
+
+static_assert(sizeof(Job) == 64, "Jobs should fit into a single cache line");
+
+// Chase-Lev work-stealing deque. The owning thread pushes and pops at the bottom, other threads steal from the top
+class JobDeque
+{
+public:
+    explicit JobDeque(uint32_t capacity);
+
+    bool Push(Job* job);
+    Job* Pop();
+    Job* Steal();
+private:
+    std::unique_ptr<std::atomic<Job*>[]> m_Jobs;
+    int64_t m_Mask;
+    alignas(64) std::atomic<int64_t> m_Top{ 0 };
+    alignas(64) std::atomic<int64_t> m_Bottom{ 0 };
+};
+
+// Work-stealing scheduler. The thread that creates the job system acts as worker 0 while it waits on jobs, the other workers
+// run on their own threads and sleep when there is nothing to steal. Jobs may only be created and run from the creating
+// thread or from inside other jobs
+class JobSystem
+{
+public:
+    // numThreads includes the creating thread, 0 uses one thread per hardware thread
+    explicit JobSystem(uint32_t numThreads = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    Job* CreateJob(JobFunction function, const void* data = nullptr, uint32_t dataSize = 0);
+    // The parent is not finished before all of its children are
+    Job* CreateChildJob(Job* parent, JobFunction function, const void* data = nullptr, uint32_t dataSize = 0);
+    void Run(Job* job);
+    // Executes other jobs until job is finished
+    void Wait(const Job* job);
+
+    // Calls function(begin, end) on disjoint ranges covering [0, count), each at most granularity long, and waits for all of them
+    template<typename Function>
+    void ParallelFor(uint32_t count, uint32_t granularity, const Function& function);
+
+    uint32_t GetNumThreads() const { return m_Workers.size(); }
+private:
+    struct Worker
+    {
+        JobDeque Deque{ MAX_JOBS_PER_THREAD };
+        std::unique_ptr<Job[]> Jobs{ new Job[MAX_JOBS_PER_THREAD] };
+        uint32_t NextJob = 0;
+        uint32_t RandomState = 0;
+        std::thread Thread;
+    };
+
+    struct ParallelForData
+    {
+        JobSystem* System;
+        void (*Function)(uint32_t begin, uint32_t end, const void* userData);
+        const void* UserData;
+        uint32_t Begin;
+        uint32_t End;
+        uint32_t Granularity;
+    };
+
+    Worker& GetCurrentWorker();
+    Job* AllocateJob();
+    Job* FindJob(Worker& worker);
+    void Execute(Job* job);
+    void Finish(Job* job);
+    void WorkerMain(uint32_t workerIndex);
+    void ParallelFor(uint32_t count, uint32_t granularity, void (*function)(uint32_t begin, uint32_t end, const void* userData), const void* userData);
+
+    static void ParallelForJob(Job& job, void* data);
+private:
+    std::vector<std::unique_ptr<Worker>> m_Workers;
+    std::atomic<uint32_t> m_NumQueuedJobs{ 0 };
+    std::atomic<uint32_t> m_NumSleepingWorkers{ 0 };
+    std::atomic<bool> m_StopRequested{ false };
+    std::mutex m_SleepMutex;
+    std::condition_variable m_SleepCondition;
+};
+
+template<typename Function>
+void JobSystem::ParallelFor(uint32_t count, uint32_t granularity, const Function& function)
+{
+    auto invoke = [](uint32_t begin, uint32_t end, const void* userData)
+    {
+        (*(const Function*)userData)(begin, end);
+    };
+
+    ParallelFor(count, granularity, invoke, &function);
+}
@@ -8,5 +8,9 @@ int main(int argc, char** argv)
 #endif
 
     Application app(1280, 720);
+
+    if (argc > 1)
+        app.LoadScene(argv[1]);
+
     app.Run();
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "orderedwriter.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+bool WriteItemsInOrder(uint32_t numItems, uint32_t numThreads, uint32_t numSlots, const OrderedItemEncoder& encode, std::ostream& output, OrderedWriteStats& stats)
+{
+    stats = OrderedWriteStats();
+    numThreads = std::max(numThreads, 1u);
+    if (numSlots == 0)
+        numSlots = 2 * numThreads;
+
+    // Item i is encoded into slot i % numSlots once item i - numSlots has been written. ReadyItem is the item a slot holds
+    // once its encoding is done
+    struct Slot
+    {
+        std::vector<uint8_t> Data;
+        int64_t ReadyItem = -1;
+    };
+
+    std::vector<Slot> slots(numSlots);
+    std::mutex mutex;
+    std::condition_variable itemReady;
+    std::condition_variable itemWritten;
+    uint32_t nextItem = 0;
+    uint32_t numWrittenItems = 0;
+    bool failed = false;
+
+    auto encodeItems = [&](uint32_t thread)
+    {
+        for (;;)
+        {
+            uint32_t item;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (nextItem >= numItems || failed)
+                    return;
+
+                item = nextItem++;
+                itemWritten.wait(lock, [&]() { return item < numWrittenItems + numSlots || failed; });
+                if (failed)
+                    return;
+
+                stats.PeakInFlight = std::max(stats.PeakInFlight, item - numWrittenItems + 1);
+            }
+
+            Slot& slot = slots[item % numSlots];
+            encode(thread, item, slot.Data);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.ReadyItem = item;
+            itemReady.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < numThreads; i++)
+        threads.emplace_back(encodeItems, i);
+
+    for (uint32_t item = 0; item < numItems && output; item++)
+    {
+        Slot& slot = slots[item % numSlots];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            itemReady.wait(lock, [&]() { return slot.ReadyItem == item; });
+        }
+
+        // The slot is not touched again before numWrittenItems moves past it
+        output.write(reinterpret_cast<const char*>(slot.Data.data()), slot.Data.size());
+        stats.NumBytes += slot.Data.size();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        numWrittenItems = item + 1;
+        itemWritten.notify_all();
+    }
+
+    output.flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = !output;
+        itemWritten.notify_all();
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    for (const Slot& slot : slots)
+        stats.SlotBytes += slot.Data.capacity();
+
+    stats.NumWritten = numWrittenItems;
+    return !failed;
+}
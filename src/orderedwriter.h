@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+struct OrderedWriteStats
+{
+    uint32_t NumWritten = 0;
+    uint64_t NumBytes = 0;
+    uint32_t PeakInFlight = 0;
+    // Capacity of the slot buffers once the writes are done, they only grow so it is the most they held
+    uint64_t SlotBytes = 0;
+};
+
+// Encodes item into data on the thread of the given index, 0 to numThreads - 1. data still holds an earlier item of its slot,
+// the encoder clears or overwrites it. A thread only ever passes its own index, state kept per index needs no locking
+using OrderedItemEncoder = std::function<void(uint32_t thread, uint32_t item, std::vector<uint8_t>& data)>;
+
+// Writes numItems items to output in order while numThreads threads encode them. Each thread takes the next item as soon as
+// it is done with the last one and encodes it into one of numSlots buffers, and the calling thread writes the buffers out in
+// item order. A thread that gets ahead of the output by numSlots items waits for it, so a slow output holds back the threads
+// instead of filling memory. 0 slots uses two per thread. Returns false if the output fails, items written until then stay
+// written
+bool WriteItemsInOrder(uint32_t numItems, uint32_t numThreads, uint32_t numSlots, const OrderedItemEncoder& encode, std::ostream& output, OrderedWriteStats& stats);
@@ -0,0 +1,234 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+struct ProfilerThreadBuffer
+{
+    std::string Name;
+    uint32_t ThreadId = 0;
+    std::unique_ptr<ProfileEvent[]> Events{ new ProfileEvent[PROFILER_EVENTS_PER_THREAD] };
+    std::atomic<uint64_t> NumEvents{ 0 };
+    std::atomic<bool> InUse{ false };
+    uint64_t NumCollected = 0;
+};
+
+// Returns the buffer to the pool when its thread exits, so short lived threads do not pile up buffers
+struct ProfilerThreadBufferHandle
+{
+    ProfilerThreadBuffer* Buffer = nullptr;
+    std::string Name;
+
+    ~ProfilerThreadBufferHandle()
+    {
+        if (Buffer)
+            Buffer->InUse.store(false, std::memory_order_release);
+    }
+};
+
+std::atomic<bool> Profiler::s_Enabled{ false };
+
+static std::mutex s_BuffersMutex;
+static std::vector<std::unique_ptr<ProfilerThreadBuffer>> s_Buffers;
+static thread_local ProfilerThreadBufferHandle s_ThreadBuffer;
+
+static std::unordered_map<const char*, uint32_t> s_ZoneIndices;
+static std::vector<ProfileZoneStats> s_ZoneStats;
+static std::vector<ProfileZoneStats> s_SortedZoneStats;
+static std::vector<ProfileEvent> s_CollectedEvents;
+
+static const std::chrono::steady_clock::time_point s_StartTime = std::chrono::steady_clock::now();
+
+static ProfilerThreadBuffer& GetThreadBuffer()
+{
+    if (s_ThreadBuffer.Buffer)
+        return *s_ThreadBuffer.Buffer;
+
+    std::lock_guard<std::mutex> lock(s_BuffersMutex);
+
+    ProfilerThreadBuffer* buffer = nullptr;
+    for (std::unique_ptr<ProfilerThreadBuffer>& candidate : s_Buffers)
+    {
+        if (!candidate->InUse.load(std::memory_order_acquire))
+        {
+            buffer = candidate.get();
+            break;
+        }
+    }
+
+    if (!buffer)
+    {
+        s_Buffers.push_back(std::make_unique<ProfilerThreadBuffer>());
+        buffer = s_Buffers.back().get();
+        buffer->ThreadId = s_Buffers.size();
+    }
+
+    buffer->InUse.store(true, std::memory_order_relaxed);
+    buffer->Name = s_ThreadBuffer.Name.empty() ? "Thread " + std::to_string(buffer->ThreadId) : s_ThreadBuffer.Name;
+    s_ThreadBuffer.Buffer = buffer;
+    return *buffer;
+}
+
+// Copies the events of a buffer in [first, NumEvents) that were not overwritten while being copied. The owning thread
+// keeps recording meanwhile, events it may have overwritten are detected from its counter and dropped
+static uint64_t CopyEvents(const ProfilerThreadBuffer& buffer, uint64_t first, std::vector<ProfileEvent>& events)
+{
+    uint64_t numEvents = buffer.NumEvents.load(std::memory_order_acquire);
+    first = std::max(first, numEvents > PROFILER_EVENTS_PER_THREAD ? numEvents - PROFILER_EVENTS_PER_THREAD : 0);
+
+    events.clear();
+    for (uint64_t i = first; i < numEvents; i++)
+        events.push_back(buffer.Events[i % PROFILER_EVENTS_PER_THREAD]);
+
+    uint64_t numEventsAfterCopy = buffer.NumEvents.load(std::memory_order_acquire);
+    if (numEventsAfterCopy > first + PROFILER_EVENTS_PER_THREAD)
+    {
+        uint64_t numOverwritten = std::min<uint64_t>(numEventsAfterCopy - PROFILER_EVENTS_PER_THREAD - first, events.size());
+        events.erase(events.begin(), events.begin() + numOverwritten);
+    }
+
+    return numEvents;
+}
+
+void Profiler::SetEnabled(bool enabled)
+{
+    s_Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::SetThreadName(const std::string& name)
+{
+    s_ThreadBuffer.Name = name;
+    if (s_ThreadBuffer.Buffer)
+    {
+        std::lock_guard<std::mutex> lock(s_BuffersMutex);
+        s_ThreadBuffer.Buffer->Name = name;
+    }
+}
+
+uint64_t Profiler::GetTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_StartTime).count();
+}
+
+void Profiler::RecordEvent(const char* name, uint64_t start, uint64_t end)
+{
+    ProfilerThreadBuffer& buffer = GetThreadBuffer();
+    uint64_t index = buffer.NumEvents.load(std::memory_order_relaxed);
+    buffer.Events[index % PROFILER_EVENTS_PER_THREAD] = { name, start, end };
+    buffer.NumEvents.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::Update()
+{
+    for (ProfileZoneStats& stats : s_ZoneStats)
+    {
+        stats.FrameCalls = 0;
+        stats.FrameTime = 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_BuffersMutex);
+        for (std::unique_ptr<ProfilerThreadBuffer>& buffer : s_Buffers)
+        {
+            buffer->NumCollected = CopyEvents(*buffer, buffer->NumCollected, s_CollectedEvents);
+
+            for (const ProfileEvent& event : s_CollectedEvents)
+            {
+                auto it = s_ZoneIndices.find(event.Name);
+                if (it == s_ZoneIndices.end())
+                {
+                    it = s_ZoneIndices.emplace(event.Name, (uint32_t)s_ZoneStats.size()).first;
+                    s_ZoneStats.emplace_back().Name = event.Name;
+                }
+
+                ProfileZoneStats& stats = s_ZoneStats[it->second];
+                uint64_t time = event.End - event.Start;
+                stats.NumCalls++;
+                stats.TotalTime += time;
+                stats.MinTime = std::min(stats.MinTime, time);
+                stats.MaxTime = std::max(stats.MaxTime, time);
+                stats.FrameCalls++;
+                stats.FrameTime += time;
+            }
+        }
+    }
+
+    s_SortedZoneStats = s_ZoneStats;
+    std::sort(s_SortedZoneStats.begin(), s_SortedZoneStats.end(), [](const ProfileZoneStats& a, const ProfileZoneStats& b) { return a.TotalTime > b.TotalTime; });
+}
+
+void Profiler::ResetStats()
+{
+    s_ZoneIndices.clear();
+    s_ZoneStats.clear();
+    s_SortedZoneStats.clear();
+}
+
+const std::vector<ProfileZoneStats>& Profiler::GetZoneStats()
+{
+    return s_SortedZoneStats;
+}
+
+static void WriteJsonString(std::ostream& stream, const std::string& string)
+{
+    stream << '"';
+    for (char c : string)
+    {
+        if (c == '"' || c == '\\')
+            stream << '\\';
+
+        if ((unsigned char)c >= 0x20)
+            stream << c;
+    }
+    stream << '"';
+}
+
+bool Profiler::WriteChromeTrace(const std::string& filepath)
+{
+    std::ofstream file(filepath, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cout << "Failed to create trace file: " << filepath << std::endl;
+        return false;
+    }
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    std::vector<ProfileEvent> events;
+
+    std::lock_guard<std::mutex> lock(s_BuffersMutex);
+    for (std::unique_ptr<ProfilerThreadBuffer>& buffer : s_Buffers)
+    {
+        file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->ThreadId << ",\"args\":{\"name\":";
+        WriteJsonString(file, buffer->Name);
+        file << "}}";
+        first = false;
+
+        CopyEvents(*buffer, 0, events);
+        for (const ProfileEvent& event : events)
+        {
+            // Timestamps are in microseconds
+            file << ",\n{\"name\":";
+            WriteJsonString(file, event.Name);
+            file << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->ThreadId << ",\"ts\":" << event.Start / 1000.0 << ",\"dur\":" << (event.End - event.Start) / 1000.0 << "}";
+        }
+    }
+
+    file << "\n]}\n";
+
+    if (!file.good())
+    {
+        std::cout << "Failed writing trace file: " << filepath << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define PROFILER_EVENTS_PER_THREAD 65536
+
+// Zones are compiled out entirely with PROFILER_DISABLED, otherwise a disabled profiler costs one branch per zone
+#if defined(PROFILER_DISABLED)
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#else
+#define PROFILE_CONCATENATE_INTERNAL(a, b) a##b
+#define PROFILE_CONCATENATE(a, b) PROFILE_CONCATENATE_INTERNAL(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCATENATE(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#endif
+
+// Zone names must be string literals, zones are identified by the address of their name
+struct ProfileEvent
+{
+    const char* Name;
+    uint64_t Start;
+    uint64_t End;
+};
+
+struct ProfileZoneStats
+{
+    const char* Name = nullptr;
+    uint32_t NumCalls = 0;
+    uint64_t TotalTime = 0;
+    uint64_t MinTime = UINT64_MAX;
+    uint64_t MaxTime = 0;
+    // Totals of the last frame passed to Profiler::Update
+    uint32_t FrameCalls = 0;
+    uint64_t FrameTime = 0;
+};
+
+class Profiler
+{
+public:
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled() { return s_Enabled.load(std::memory_order_relaxed); }
+    static void SetThreadName(const std::string& name);
+
+    // Nanoseconds of a monotonic clock
+    static uint64_t GetTime();
+    static void RecordEvent(const char* name, uint64_t start, uint64_t end);
+
+    // Aggregates the events recorded since the last update into the zone statistics, called once per frame
+    static void Update();
+    static void ResetStats();
+    // Zone statistics sorted by descending total time
+    static const std::vector<ProfileZoneStats>& GetZoneStats();
+
+    // Writes the events still held in the ring buffers in the Chrome trace event format, which Perfetto also reads
+    static bool WriteChromeTrace(const std::string& filepath);
+private:
+    static std::atomic<bool> s_Enabled;
+};
+
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name)
+        : m_Name(Profiler::IsEnabled() ? name : nullptr), m_Start(m_Name ? Profiler::GetTime() : 0)
+    {
+    }
+
+    ~ProfileScope()
+    {
+        if (m_Name)
+            Profiler::RecordEvent(m_Name, m_Start, Profiler::GetTime());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+private:
+    const char* m_Name;
+    uint64_t m_Start;
+};
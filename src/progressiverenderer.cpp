@@ -0,0 +1,236 @@
+#include "progressiverenderer.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using Clock = std::chrono::steady_clock;
+
+static float GetMilliseconds(Clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+ProgressiveRenderer::ProgressiveRenderer(JobSystem& jobSystem)
+    : m_Renderer(jobSystem), m_CoarseRenderer(jobSystem)
+{
+    m_CoarseRenderer.SetSampleTolerance(PROGRESSIVE_COARSE_SAMPLE_TOLERANCE);
+    m_CoarseRenderer.SetTileSize(PROGRESSIVE_COARSE_TILE_SIZE);
+}
+
+bool ProgressiveRenderer::Update(const std::shared_ptr<const SceneSnapshot>& scene, uint32_t width, uint32_t height, const ViewTransform& view)
+{
+    PROFILE_FUNCTION();
+
+    Clock::time_point start = Clock::now();
+    bool resize = width != m_Image.Width || height != m_Image.Height;
+    bool restart = scene != m_Scene || resize || view.Scale != m_View.Scale || view.Offset != m_View.Offset || m_SampleTolerance != m_RenderedSampleTolerance;
+
+    m_Stats.CoarseTime = 0.0f;
+    if (restart)
+    {
+        m_Scene = scene;
+        m_View = view;
+        m_RenderedSampleTolerance = m_SampleTolerance;
+        if (resize)
+        {
+            // Rows the coarse pass has not got to yet stay black, a coarse image of the old size is of no use
+            m_Image.Width = width;
+            m_Image.Height = height;
+            m_Image.Pixels.assign((size_t)width * height, 0);
+            m_CoarseImageScale = 0;
+        }
+
+        m_NextRow = 0;
+        m_NumCoarseRowsLeft = 0;
+        m_MaxRefineRows = PROGRESSIVE_MIN_REFINE_ROWS;
+        m_RefineTime = 0.0f;
+        m_Stats.NumRestarts++;
+        m_Stats.NumFramesSinceRestart = 0;
+
+        // Scenes whose last image was refined well within the budget are not worth a coarse pass
+        m_Stats.CoarseScale = 1;
+        if (!scene || width == 0 || height == 0)
+        {
+            m_NextRow = height;
+        }
+        else if (m_ImageMillisecondsPerRow == 0.0f || m_ImageMillisecondsPerRow * height > 0.5f * m_FrameBudget)
+        {
+            // A pass at another scale starts a new coarse image from the top, one at the same scale goes on where it is
+            if (m_CoarseImageScale != m_CoarseScale)
+            {
+                m_CoarseImageScale = m_CoarseScale;
+                m_NextCoarseRow = 0;
+                m_CoarseMillisecondsPerRow = 0.0f;
+                m_PassMillisecondsPerRow = 0.0f;
+                m_MaxCoarseRows = PROGRESSIVE_MIN_COARSE_ROWS;
+                m_PassTime = 0.0f;
+                m_NumPassRows = 0;
+                m_NumPassFrames = 0;
+            }
+
+            m_NumCoarseRowsLeft = (height + m_CoarseImageScale - 1) / m_CoarseImageScale;
+            m_Stats.CoarseScale = m_CoarseImageScale;
+        }
+    }
+    else
+    {
+        m_Stats.NumFramesSinceRestart++;
+    }
+
+    // The coarse rows come first, as many as the budget allows and at least a few per frame. Like refined rows, the number
+    // of rows at once at most doubles
+    bool changed = restart;
+    bool renderedCoarse = false;
+    while (m_NumCoarseRowsLeft > 0)
+    {
+        float remainingTime = m_FrameBudget - GetMilliseconds(start);
+        float millisecondsPerRow = std::max(m_CoarseMillisecondsPerRow, m_PassMillisecondsPerRow);
+        uint32_t numRows = 0;
+        if (remainingTime > 0.0f)
+            numRows = millisecondsPerRow > 0.0f ? uint32_t(std::min(remainingTime / millisecondsPerRow, float(m_NumCoarseRowsLeft))) : PROGRESSIVE_MIN_COARSE_ROWS;
+        numRows = std::min(numRows, m_MaxCoarseRows);
+
+        if (numRows < PROGRESSIVE_MIN_COARSE_ROWS)
+        {
+            if (renderedCoarse)
+                break;
+            numRows = PROGRESSIVE_MIN_COARSE_ROWS;
+        }
+
+        if (!renderedCoarse)
+            m_NumPassFrames++;
+
+        RenderCoarse(std::min(numRows, m_NumCoarseRowsLeft));
+        m_MaxCoarseRows = 2 * numRows;
+        changed = true;
+        renderedCoarse = true;
+    }
+
+    bool refined = false;
+    while (m_NumCoarseRowsLeft == 0 && m_NextRow < height)
+    {
+        // A frame that restarted or drew coarse rows stops at the budget, the others refine at least a few rows so the image
+        // gets done. Without a coarse pass there is nothing else to show, the whole image is rendered at once. Rows vary a lot
+        // in cost, the number of rows at once at most doubles so a run of empty rows does not send a dense band over the budget
+        float remainingTime = m_FrameBudget - GetMilliseconds(start);
+        uint32_t numRows = height;
+        if (!restart || m_Stats.CoarseScale > 1)
+        {
+            float millisecondsPerRow = std::max(m_MillisecondsPerRow, m_ImageMillisecondsPerRow);
+            numRows = 0;
+            if (remainingTime > 0.0f)
+                numRows = millisecondsPerRow > 0.0f ? uint32_t(std::min(remainingTime / millisecondsPerRow, float(height))) : PROGRESSIVE_MIN_REFINE_ROWS;
+            numRows = std::min(numRows, m_MaxRefineRows);
+        }
+
+        if (numRows < PROGRESSIVE_MIN_REFINE_ROWS)
+        {
+            if (restart || renderedCoarse || refined)
+                break;
+            numRows = PROGRESSIVE_MIN_REFINE_ROWS;
+        }
+
+        Refine(std::min(numRows, height - m_NextRow));
+        m_MaxRefineRows = 2 * numRows;
+        changed = true;
+        refined = true;
+    }
+
+    if (refined && m_NextRow >= height)
+        m_ImageMillisecondsPerRow = m_RefineTime / height;
+
+    m_Stats.NumRefinedRows = m_NextRow;
+    m_Stats.FrameTime = GetMilliseconds(start);
+    return changed;
+}
+
+void ProgressiveRenderer::RenderCoarse(uint32_t numRows)
+{
+    PROFILE_FUNCTION();
+
+    Clock::time_point start = Clock::now();
+    uint32_t scale = m_CoarseImageScale;
+    uint32_t coarseWidth = (m_Image.Width + scale - 1) / scale;
+    uint32_t coarseHeight = (m_Image.Height + scale - 1) / scale;
+    uint32_t firstRow = m_NextCoarseRow;
+    numRows = std::min(numRows, coarseHeight - firstRow);
+    m_CoarseRenderer.RenderRows(*m_Scene, coarseWidth, coarseHeight, firstRow, numRows, m_CoarseImage, m_View);
+
+    // Each coarse pixel covers a scale x scale block of the image
+    uint32_t endRow = std::min((firstRow + numRows) * scale, m_Image.Height);
+    for (uint32_t y = firstRow * scale; y < endRow; y++)
+    {
+        const uint32_t* coarseRow = &m_CoarseImage.Pixels[(size_t)(y / scale - firstRow) * coarseWidth];
+        uint32_t* row = &m_Image.Pixels[(size_t)y * m_Image.Width];
+        for (uint32_t x = 0; x < m_Image.Width; x++)
+            row[x] = coarseRow[x / scale];
+    }
+
+    float time = GetMilliseconds(start);
+    m_Stats.CoarseTime += time;
+    m_CoarseMillisecondsPerRow = std::max(time / numRows, 1e-6f);
+    m_NextCoarseRow = (firstRow + numRows) % coarseHeight;
+    m_NumCoarseRowsLeft -= numRows;
+    m_PassTime += time;
+    m_NumPassRows += numRows;
+    if (m_NumPassRows < coarseHeight)
+        return;
+
+    // The next pass gets coarser when this one took most of the budget and finer again when it was cheap
+    m_Stats.CoarsePassFrames = m_NumPassFrames;
+    m_PassMillisecondsPerRow = m_PassTime / m_NumPassRows;
+    if (m_PassTime > 0.5f * m_FrameBudget && m_CoarseScale < PROGRESSIVE_MAX_COARSE_SCALE)
+        m_CoarseScale *= 2;
+    else if (m_PassTime < 0.125f * m_FrameBudget && m_CoarseScale > 2)
+        m_CoarseScale /= 2;
+
+    m_PassTime = 0.0f;
+    m_NumPassRows = 0;
+    m_NumPassFrames = 0;
+}
+
+void ProgressiveRenderer::Refine(uint32_t numRows)
+{
+    PROFILE_FUNCTION();
+
+    Clock::time_point start = Clock::now();
+    m_Renderer.SetSampleTolerance(m_SampleTolerance);
+    m_Renderer.RenderRows(*m_Scene, m_Image.Width, m_Image.Height, m_NextRow, numRows, m_Rows, m_View);
+    std::memcpy(&m_Image.Pixels[(size_t)m_NextRow * m_Image.Width], m_Rows.Pixels.data(), m_Rows.Pixels.size() * sizeof(uint32_t));
+
+    float time = GetMilliseconds(start);
+    m_NextRow += numRows;
+    m_RefineTime += time;
+    m_MillisecondsPerRow = std::max(time / numRows, 1e-6f);
+}
+
+void FrameTimeHistogram::Reset(float maxTime)
+{
+    m_Counts.fill(0.0f);
+    m_MaxTime = maxTime;
+    m_NumFrames = 0;
+    m_LongestFrame = 0.0f;
+}
+
+void FrameTimeHistogram::Add(float milliseconds)
+{
+    uint32_t bucket = uint32_t(std::max(milliseconds, 0.0f) / m_MaxTime * FRAME_TIME_HISTOGRAM_BUCKETS);
+    m_Counts[std::min(bucket, FRAME_TIME_HISTOGRAM_BUCKETS - 1u)] += 1.0f;
+    m_NumFrames++;
+    m_LongestFrame = std::max(m_LongestFrame, milliseconds);
+}
+
+float FrameTimeHistogram::GetPercentile(float fraction) const
+{
+    float count = 0.0f;
+    for (uint32_t i = 0; i + 1 < FRAME_TIME_HISTOGRAM_BUCKETS; i++)
+    {
+        count += m_Counts[i];
+        if (count >= fraction * m_NumFrames)
+            return m_MaxTime * (i + 1) / FRAME_TIME_HISTOGRAM_BUCKETS;
+    }
+
+    return m_LongestFrame;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "cpurenderer.h"
+
+#include <array>
+#include <memory>
+
+// Milliseconds a frame of the viewport may spend rendering
+#define PROGRESSIVE_DEFAULT_FRAME_BUDGET 8.0f
+// Sample tolerance of the coarse pass, in pixels of the coarse image
+#define PROGRESSIVE_COARSE_SAMPLE_TOLERANCE 1.0f
+// The coarse pass is rendered at 1 / 2 of the resolution, down to 1 / PROGRESSIVE_MAX_COARSE_SCALE for scenes it does not fit
+#define PROGRESSIVE_MAX_COARSE_SCALE 32
+// Tiles of the coarse pass in coarse pixels. Control point discs and curves keep their size in the view at any scale, so a
+// coarse pixel is near more primitives than a full one and small tiles shade the fewest of them
+#define PROGRESSIVE_COARSE_TILE_SIZE 4
+// Fewest coarse rows drawn at once, a frame always draws them so the coarse image keeps up with the edits
+#define PROGRESSIVE_MIN_COARSE_ROWS 2
+// Fewest rows refined at once, refining fewer pays the evaluation of the crossing curves for too few pixels
+#define PROGRESSIVE_MIN_REFINE_ROWS 8
+#define FRAME_TIME_HISTOGRAM_BUCKETS 40
+
+struct ProgressiveRenderStats
+{
+    // Time spent in the last Update, in milliseconds
+    float FrameTime = 0.0f;
+    float CoarseTime = 0.0f;
+    // Resolution divisor of the last coarse pass, 1 when the image was rendered at full quality right away
+    uint32_t CoarseScale = 0;
+    // Frames the last whole coarse image was drawn over
+    uint32_t CoarsePassFrames = 0;
+    // Rows of the image at full quality, from the top
+    uint32_t NumRefinedRows = 0;
+    uint32_t NumRestarts = 0;
+    uint32_t NumFramesSinceRestart = 0;
+};
+
+// Renders the viewport within a time budget per frame. A change of the scene, the view or the image size restarts the
+// image with a coarse pass at a fraction of the resolution and with fewer samples, stretched over the image, and the
+// following frames replace it by full quality rows from the top down, as many as the rest of their budget allows. Once
+// every row is refined the image is the one CpuRenderer::Render produces and frames cost nothing until the next change.
+// The coarse pass is drawn in bands of rows that fit the budget too. A scene too heavy for the budget gets a coarser pass,
+// and one still too heavy at the coarsest scale is spread over several frames: a restart carries on from the row the pass
+// got to, so while edits keep coming every part of the image is updated in turn. Frames that refine always refine a few
+// rows so the image converges whatever the budget
+class ProgressiveRenderer
+{
+public:
+    explicit ProgressiveRenderer(JobSystem& jobSystem);
+
+    void SetFrameBudget(float milliseconds) { m_FrameBudget = milliseconds; }
+    // Sample tolerance of the refined image, see CpuRenderer::SetSampleTolerance
+    void SetSampleTolerance(float tolerance) { m_SampleTolerance = tolerance; }
+
+    // Renders as much of the image as the budget allows, returns true if the image changed. Snapshots are compared by
+    // identity, the publisher hands out the same one until the scene changes
+    bool Update(const std::shared_ptr<const SceneSnapshot>& scene, uint32_t width, uint32_t height, const ViewTransform& view = ViewTransform());
+    // The next Update starts over with a coarse pass
+    void Restart() { m_Scene.reset(); }
+
+    bool IsComplete() const { return m_Scene && m_NextRow >= m_Image.Height; }
+    const CpuImage& GetImage() const { return m_Image; }
+    const ProgressiveRenderStats& GetStats() const { return m_Stats; }
+    // Stages of the last refined rows
+    const CpuRenderStats& GetRenderStats() const { return m_Renderer.GetStats(); }
+private:
+    void RenderCoarse(uint32_t numRows);
+    void Refine(uint32_t numRows);
+private:
+    CpuRenderer m_Renderer;
+    CpuRenderer m_CoarseRenderer;
+    float m_FrameBudget = PROGRESSIVE_DEFAULT_FRAME_BUDGET;
+    float m_SampleTolerance = 0.0f;
+
+    // What the image shows
+    std::shared_ptr<const SceneSnapshot> m_Scene;
+    ViewTransform m_View;
+    float m_RenderedSampleTolerance = 0.0f;
+    uint32_t m_NextRow = 0;
+
+    // Scale of the next coarse pass and of the one being drawn, which goes on at its next row after a restart
+    uint32_t m_CoarseScale = 2;
+    uint32_t m_CoarseImageScale = 0;
+    uint32_t m_NextCoarseRow = 0;
+    uint32_t m_NumCoarseRowsLeft = 0;
+    // Cost of the last coarse rows and the average of the last whole coarse image, the larger one sizes the next rows
+    float m_CoarseMillisecondsPerRow = 0.0f;
+    float m_PassMillisecondsPerRow = 0.0f;
+    uint32_t m_MaxCoarseRows = PROGRESSIVE_MIN_COARSE_ROWS;
+    // Cost of the coarse rows drawn since the coarse image was last whole, it decides the scale of the next pass
+    float m_PassTime = 0.0f;
+    uint32_t m_NumPassRows = 0;
+    uint32_t m_NumPassFrames = 0;
+    // Cost of the last refined rows and the average of the last image refined whole, the larger one sizes the next rows
+    float m_MillisecondsPerRow = 0.0f;
+    float m_ImageMillisecondsPerRow = 0.0f;
+    float m_RefineTime = 0.0f;
+    uint32_t m_MaxRefineRows = PROGRESSIVE_MIN_REFINE_ROWS;
+
+    CpuImage m_Image;
+    CpuImage m_CoarseImage;
+    CpuImage m_Rows;
+    ProgressiveRenderStats m_Stats;
+};
+
+// Frame times in buckets of equal width up to a maximum time, the last bucket also counts every longer frame. Counts are
+// floats so they can be plotted as they are
+class FrameTimeHistogram
+{
+public:
+    explicit FrameTimeHistogram(float maxTime = 4.0f * PROGRESSIVE_DEFAULT_FRAME_BUDGET) { Reset(maxTime); }
+
+    void Reset(float maxTime);
+    void Add(float milliseconds);
+
+    const float* GetCounts() const { return m_Counts.data(); }
+    uint32_t GetNumBuckets() const { return FRAME_TIME_HISTOGRAM_BUCKETS; }
+    float GetMaxTime() const { return m_MaxTime; }
+    uint32_t GetNumFrames() const { return m_NumFrames; }
+    float GetLongestFrame() const { return m_LongestFrame; }
+    // Upper edge of the bucket holding the given fraction of the frames, the longest frame for the last bucket
+    float GetPercentile(float fraction) const;
+private:
+    std::array<float, FRAME_TIME_HISTOGRAM_BUCKETS> m_Counts;
+    float m_MaxTime = 0.0f;
+    uint32_t m_NumFrames = 0;
+    float m_LongestFrame = 0.0f;
+};
@@ -0,0 +1,88 @@
+#include "scene.h"
+
+uint32_t Scene::AddCurve(const glm::vec3& color, float thickness)
+{
+    SceneCurve& curve = Curves.emplace_back();
+    curve.Color = color;
+    curve.Thickness = thickness;
+    curve.FirstControlPoint = Positions.size();
+    curve.NumControlPoints = 0;
+    return Curves.size() - 1;
+}
+
+void Scene::AddControlPoint(const glm::vec2& position, const glm::vec3& color)
+{
+    // Control points are always appended to the last curve so the SoA arrays stay contiguous per curve
+    if (Curves.empty())
+        AddCurve();
+
+    Positions.push_back(position);
+    Colors.push_back(color);
+    Curves.back().NumControlPoints++;
+}
+
+void Scene::InsertControlPoint(uint32_t curve, uint32_t index, const glm::vec2& position, const glm::vec3& color)
+{
+    uint32_t pointIndex = Curves[curve].FirstControlPoint + index;
+    Positions.insert(Positions.begin() + pointIndex, position);
+    Colors.insert(Colors.begin() + pointIndex, color);
+
+    Curves[curve].NumControlPoints++;
+    for (uint32_t i = curve + 1; i < Curves.size(); i++)
+        Curves[i].FirstControlPoint++;
+}
+
+void Scene::RemoveControlPoint(uint32_t curve, uint32_t index)
+{
+    uint32_t pointIndex = Curves[curve].FirstControlPoint + index;
+    Positions.erase(Positions.begin() + pointIndex);
+    Colors.erase(Colors.begin() + pointIndex);
+
+    Curves[curve].NumControlPoints--;
+    for (uint32_t i = curve + 1; i < Curves.size(); i++)
+        Curves[i].FirstControlPoint--;
+}
+
+void Scene::SetControlPoints(uint32_t curve, const glm::vec2* positions, const glm::vec3* colors, uint32_t numControlPoints)
+{
+    SceneCurve& sceneCurve = Curves[curve];
+    uint32_t first = sceneCurve.FirstControlPoint;
+
+    Positions.erase(Positions.begin() + first, Positions.begin() + first + sceneCurve.NumControlPoints);
+    Colors.erase(Colors.begin() + first, Colors.begin() + first + sceneCurve.NumControlPoints);
+    Positions.insert(Positions.begin() + first, positions, positions + numControlPoints);
+    Colors.insert(Colors.begin() + first, colors, colors + numControlPoints);
+
+    int32_t difference = (int32_t)numControlPoints - (int32_t)sceneCurve.NumControlPoints;
+    sceneCurve.NumControlPoints = numControlPoints;
+    for (uint32_t i = curve + 1; i < Curves.size(); i++)
+        Curves[i].FirstControlPoint += difference;
+}
+
+void Scene::Clear()
+{
+    Settings = GlobalSettings();
+    Curves.clear();
+    Positions.clear();
+    Colors.clear();
+}
+
+void Scene::CopyFrom(const SceneView& view)
+{
+    Settings = view.Settings;
+    Curves.assign(view.Curves, view.Curves + view.NumCurves);
+    Positions.assign(view.Positions, view.Positions + view.NumControlPoints);
+    Colors.assign(view.Colors, view.Colors + view.NumControlPoints);
+}
+
+SceneView Scene::GetView() const
+{
+    SceneView view;
+    view.Settings = Settings;
+    view.Curves = Curves.data();
+    view.NumCurves = Curves.size();
+    view.Positions = Positions.data();
+    view.Colors = Colors.data();
+    view.NumControlPoints = Positions.size();
+    return view;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+struct GlobalSettings
+{
+    bool DrawBezierCurve = true;
+    bool DrawPolar = true;
+    int NumSamples = 50;
+    float T1 = 0.5f;
+};
+
+struct SceneCurve
+{
+    glm::vec3 Color = glm::vec3(1.0f);
+    float Thickness = 1.0f;
+    uint32_t FirstControlPoint = 0;
+    uint32_t NumControlPoints = 0;
+};
+
+// Non-owning view over a scene. Control point attributes are stored as separate arrays (SoA) indexed by
+// SceneCurve::FirstControlPoint, so the same view can point either into a Scene or into a mapped scene file
+struct SceneView
+{
+    GlobalSettings Settings;
+    const SceneCurve* Curves = nullptr;
+    uint32_t NumCurves = 0;
+    const glm::vec2* Positions = nullptr;
+    const glm::vec3* Colors = nullptr;
+    uint32_t NumControlPoints = 0;
+};
+
+struct Scene
+{
+    GlobalSettings Settings;
+    std::vector<SceneCurve> Curves;
+    std::vector<glm::vec2> Positions;
+    std::vector<glm::vec3> Colors;
+
+    uint32_t AddCurve(const glm::vec3& color = glm::vec3(1.0f), float thickness = 1.0f);
+    void AddControlPoint(const glm::vec2& position, const glm::vec3& color = glm::vec3(1.0f, 0.0f, 0.0f));
+    void InsertControlPoint(uint32_t curve, uint32_t index, const glm::vec2& position, const glm::vec3& color);
+    void RemoveControlPoint(uint32_t curve, uint32_t index);
+    void SetControlPoints(uint32_t curve, const glm::vec2* positions, const glm::vec3* colors, uint32_t numControlPoints);
+    void Clear();
+    void CopyFrom(const SceneView& view);
+    SceneView GetView() const;
+};
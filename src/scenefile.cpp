@@ -0,0 +1,437 @@
+#include "scenefile.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+struct CRC32CTable
+{
+    uint32_t Data[8][256];
+
+    CRC32CTable()
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t crc = i;
+            for (uint32_t bit = 0; bit < 8; bit++)
+                crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+
+            Data[0][i] = crc;
+        }
+
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            for (uint32_t slice = 1; slice < 8; slice++)
+                Data[slice][i] = (Data[slice - 1][i] >> 8) ^ Data[0][Data[slice - 1][i] & 0xFF];
+        }
+    }
+};
+
+uint32_t ComputeSceneFileChecksum(const void* data, uint64_t size, uint32_t seed)
+{
+    static const CRC32CTable s_Table;
+    const uint32_t(&table)[8][256] = s_Table.Data;
+
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint32_t crc = ~seed;
+
+    while (size && ((uintptr_t)bytes & 7))
+    {
+        crc = table[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+        size--;
+    }
+
+    // Slicing-by-8, the file format is little-endian so the words can be loaded directly
+    while (size >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, bytes, sizeof(word));
+        word ^= crc;
+
+        crc = table[7][word & 0xFF] ^
+              table[6][(word >> 8) & 0xFF] ^
+              table[5][(word >> 16) & 0xFF] ^
+              table[4][(word >> 24) & 0xFF] ^
+              table[3][(word >> 32) & 0xFF] ^
+              table[2][(word >> 40) & 0xFF] ^
+              table[1][(word >> 48) & 0xFF] ^
+              table[0][word >> 56];
+
+        bytes += 8;
+        size -= 8;
+    }
+
+    while (size--)
+        crc = table[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+static uint32_t ComputeHeaderChecksum(const SceneFileHeader& header, const SceneFileChunk* chunks)
+{
+    SceneFileHeader headerCopy = header;
+    headerCopy.HeaderChecksum = 0;
+
+    uint32_t checksum = ComputeSceneFileChecksum(&headerCopy, sizeof(SceneFileHeader));
+    return ComputeSceneFileChecksum(chunks, sizeof(SceneFileChunk) * header.NumChunks, checksum);
+}
+
+SceneFile::~SceneFile()
+{
+    Close();
+}
+
+bool SceneFile::Open(const std::string& filepath, uint32_t flags)
+{
+    Close();
+
+    if (!MapFile(filepath))
+        return false;
+
+    if (!ParseChunks(filepath))
+    {
+        Close();
+        return false;
+    }
+
+    if ((flags & SceneFileLoadFlags_VerifyChecksums) && !VerifyChecksums())
+    {
+        std::cout << "Scene file checksum mismatch: " << filepath << std::endl;
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void SceneFile::Close()
+{
+    UnmapFile();
+    m_View = SceneView();
+}
+
+bool SceneFile::VerifyChecksums() const
+{
+    if (!m_Data)
+        return false;
+
+    const SceneFileHeader* header = (const SceneFileHeader*)m_Data;
+    const SceneFileChunk* chunks = (const SceneFileChunk*)(m_Data + sizeof(SceneFileHeader));
+
+    for (uint32_t i = 0; i < header->NumChunks; i++)
+    {
+        if (ComputeSceneFileChecksum(m_Data + chunks[i].Offset, chunks[i].Size) != chunks[i].Checksum)
+            return false;
+    }
+
+    return true;
+}
+
+bool SceneFile::MapFile(const std::string& filepath)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        std::cout << "Failed to open scene file: " << filepath << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize = {};
+    GetFileSizeEx(file, &fileSize);
+    if (fileSize.QuadPart < (LONGLONG)sizeof(SceneFileHeader))
+    {
+        std::cout << "Invalid scene file: " << filepath << std::endl;
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data)
+    {
+        std::cout << "Failed to map scene file: " << filepath << std::endl;
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_FileHandle = file;
+    m_MappingHandle = mapping;
+    m_Data = (const uint8_t*)data;
+    m_Size = fileSize.QuadPart;
+#else
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cout << "Failed to open scene file: " << filepath << std::endl;
+        return false;
+    }
+
+    struct stat fileStat = {};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t)sizeof(SceneFileHeader))
+    {
+        std::cout << "Invalid scene file: " << filepath << std::endl;
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        std::cout << "Failed to map scene file: " << filepath << std::endl;
+        close(fd);
+        return false;
+    }
+
+    m_FileDescriptor = fd;
+    m_Data = (const uint8_t*)data;
+    m_Size = fileStat.st_size;
+#endif
+
+    return true;
+}
+
+void SceneFile::UnmapFile()
+{
+    if (!m_Data)
+        return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(m_Data);
+    CloseHandle(m_MappingHandle);
+    CloseHandle(m_FileHandle);
+    m_FileHandle = nullptr;
+    m_MappingHandle = nullptr;
+#else
+    munmap((void*)m_Data, m_Size);
+    close(m_FileDescriptor);
+    m_FileDescriptor = -1;
+#endif
+
+    m_Data = nullptr;
+    m_Size = 0;
+}
+
+bool SceneFile::ParseChunks(const std::string& filepath)
+{
+    const SceneFileHeader* header = (const SceneFileHeader*)m_Data;
+
+    if (header->Magic != SCENE_FILE_MAGIC)
+    {
+        std::cout << "Not a scene file: " << filepath << std::endl;
+        return false;
+    }
+
+    if (header->EndianTag != SCENE_FILE_ENDIAN_TAG)
+    {
+        std::cout << "Scene file endianness does not match the host: " << filepath << std::endl;
+        return false;
+    }
+
+    // Minor versions only add chunks, which older readers skip
+    if (header->VersionMajor != SCENE_FILE_VERSION_MAJOR)
+    {
+        std::cout << "Unsupported scene file version " << header->VersionMajor << "." << header->VersionMinor << ": " << filepath << std::endl;
+        return false;
+    }
+
+    // The arrays are read in place through typed pointers, chunks aligned to less than their elements would misalign them
+    const uint32_t minAlignment = (uint32_t)std::max({ alignof(SceneFileSettings), alignof(SceneCurve), alignof(glm::vec2), alignof(glm::vec3) });
+    uint64_t chunkTableEnd = sizeof(SceneFileHeader) + (uint64_t)header->NumChunks * sizeof(SceneFileChunk);
+    if (header->FileSize != m_Size || chunkTableEnd > m_Size || header->Alignment < minAlignment || (header->Alignment & (header->Alignment - 1)))
+    {
+        std::cout << "Corrupted scene file header: " << filepath << std::endl;
+        return false;
+    }
+
+    const SceneFileChunk* chunks = (const SceneFileChunk*)(m_Data + sizeof(SceneFileHeader));
+    if (ComputeHeaderChecksum(*header, chunks) != header->HeaderChecksum)
+    {
+        std::cout << "Scene file header checksum mismatch: " << filepath << std::endl;
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header->NumChunks; i++)
+    {
+        const SceneFileChunk& chunk = chunks[i];
+        if (chunk.Offset < chunkTableEnd || chunk.Offset > m_Size || chunk.Size > m_Size - chunk.Offset || (chunk.Offset & (header->Alignment - 1)))
+        {
+            std::cout << "Scene file chunk " << i << " is out of bounds: " << filepath << std::endl;
+            return false;
+        }
+    }
+
+    struct ChunkRequirement
+    {
+        uint32_t Type;
+        uint32_t ElementSize;
+    };
+
+    const ChunkRequirement requiredChunks[] = {
+        { SceneFileChunk_Settings, sizeof(SceneFileSettings) },
+        { SceneFileChunk_Curves, sizeof(SceneCurve) },
+        { SceneFileChunk_Positions, sizeof(glm::vec2) },
+        { SceneFileChunk_Colors, sizeof(glm::vec3) },
+    };
+
+    for (const ChunkRequirement& requirement : requiredChunks)
+    {
+        const SceneFileChunk* chunk = FindChunk(requirement.Type);
+        if (!chunk || chunk->ElementSize != requirement.ElementSize || chunk->Size % requirement.ElementSize)
+        {
+            std::cout << "Scene file is missing a valid chunk of type " << std::string((const char*)&requirement.Type, 4) << ": " << filepath << std::endl;
+            return false;
+        }
+    }
+
+    const SceneFileChunk* settingsChunk = FindChunk(SceneFileChunk_Settings);
+    const SceneFileChunk* curvesChunk = FindChunk(SceneFileChunk_Curves);
+    const SceneFileChunk* positionsChunk = FindChunk(SceneFileChunk_Positions);
+    const SceneFileChunk* colorsChunk = FindChunk(SceneFileChunk_Colors);
+
+    if (settingsChunk->Size != sizeof(SceneFileSettings) || positionsChunk->Size / sizeof(glm::vec2) != colorsChunk->Size / sizeof(glm::vec3) ||
+        curvesChunk->Size / sizeof(SceneCurve) > UINT32_MAX || positionsChunk->Size / sizeof(glm::vec2) > UINT32_MAX)
+    {
+        std::cout << "Scene file chunk sizes are inconsistent: " << filepath << std::endl;
+        return false;
+    }
+
+    SceneFileSettings settings;
+    memcpy(&settings, m_Data + settingsChunk->Offset, sizeof(SceneFileSettings));
+    if (settings.NumSamples < 2 || !(settings.T1 >= 0.0f && settings.T1 <= 1.0f))
+    {
+        std::cout << "Scene file settings are out of range, " << settings.NumSamples << " samples and T1 " << settings.T1 << ": " << filepath << std::endl;
+        return false;
+    }
+
+    m_View.Settings.DrawBezierCurve = settings.Flags & SceneFileSettingsFlags_DrawBezierCurve;
+    m_View.Settings.DrawPolar = settings.Flags & SceneFileSettingsFlags_DrawPolar;
+    m_View.Settings.NumSamples = settings.NumSamples;
+    m_View.Settings.T1 = settings.T1;
+
+    // The SoA arrays are used in place, no copies are made
+    m_View.NumCurves = curvesChunk->Size / sizeof(SceneCurve);
+    m_View.Curves = m_View.NumCurves ? (const SceneCurve*)(m_Data + curvesChunk->Offset) : nullptr;
+    m_View.NumControlPoints = positionsChunk->Size / sizeof(glm::vec2);
+    m_View.Positions = m_View.NumControlPoints ? (const glm::vec2*)(m_Data + positionsChunk->Offset) : nullptr;
+    m_View.Colors = m_View.NumControlPoints ? (const glm::vec3*)(m_Data + colorsChunk->Offset) : nullptr;
+
+    for (uint32_t i = 0; i < m_View.NumCurves; i++)
+    {
+        const SceneCurve& curve = m_View.Curves[i];
+        if (curve.FirstControlPoint > m_View.NumControlPoints || curve.NumControlPoints > m_View.NumControlPoints - curve.FirstControlPoint)
+        {
+            std::cout << "Scene file curve " << i << " references control points out of range: " << filepath << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const SceneFileChunk* SceneFile::FindChunk(uint32_t type) const
+{
+    const SceneFileHeader* header = (const SceneFileHeader*)m_Data;
+    const SceneFileChunk* chunks = (const SceneFileChunk*)(m_Data + sizeof(SceneFileHeader));
+
+    for (uint32_t i = 0; i < header->NumChunks; i++)
+    {
+        if (chunks[i].Type == type)
+            return &chunks[i];
+    }
+
+    return nullptr;
+}
+
+bool SaveSceneFile(const std::string& filepath, const SceneView& scene, uint32_t* headerChecksum)
+{
+    std::ofstream file(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cout << "Failed to create scene file: " << filepath << std::endl;
+        return false;
+    }
+
+    SceneFileSettings settings = {};
+    settings.Flags |= scene.Settings.DrawBezierCurve ? (uint32_t)SceneFileSettingsFlags_DrawBezierCurve : 0;
+    settings.Flags |= scene.Settings.DrawPolar ? (uint32_t)SceneFileSettingsFlags_DrawPolar : 0;
+    settings.NumSamples = scene.Settings.NumSamples;
+    settings.T1 = scene.Settings.T1;
+
+    struct ChunkSource
+    {
+        uint32_t Type;
+        uint32_t ElementSize;
+        const void* Data;
+        uint64_t Size;
+    };
+
+    const ChunkSource sources[] = {
+        { SceneFileChunk_Settings, sizeof(SceneFileSettings), &settings, sizeof(SceneFileSettings) },
+        { SceneFileChunk_Curves, sizeof(SceneCurve), scene.Curves, (uint64_t)scene.NumCurves * sizeof(SceneCurve) },
+        { SceneFileChunk_Positions, sizeof(glm::vec2), scene.Positions, (uint64_t)scene.NumControlPoints * sizeof(glm::vec2) },
+        { SceneFileChunk_Colors, sizeof(glm::vec3), scene.Colors, (uint64_t)scene.NumControlPoints * sizeof(glm::vec3) },
+    };
+    const uint32_t numChunks = sizeof(sources) / sizeof(sources[0]);
+
+    SceneFileChunk chunks[numChunks] = {};
+    uint64_t offset = sizeof(SceneFileHeader) + sizeof(chunks);
+    for (uint32_t i = 0; i < numChunks; i++)
+    {
+        offset = (offset + SCENE_FILE_ALIGNMENT - 1) & ~(uint64_t)(SCENE_FILE_ALIGNMENT - 1);
+
+        chunks[i].Type = sources[i].Type;
+        chunks[i].ElementSize = sources[i].ElementSize;
+        chunks[i].Offset = offset;
+        chunks[i].Size = sources[i].Size;
+        chunks[i].Checksum = ComputeSceneFileChecksum(sources[i].Data, sources[i].Size);
+
+        offset += sources[i].Size;
+    }
+
+    SceneFileHeader header = {};
+    header.Magic = SCENE_FILE_MAGIC;
+    header.VersionMajor = SCENE_FILE_VERSION_MAJOR;
+    header.VersionMinor = SCENE_FILE_VERSION_MINOR;
+    header.EndianTag = SCENE_FILE_ENDIAN_TAG;
+    header.NumChunks = numChunks;
+    header.FileSize = offset;
+    header.Alignment = SCENE_FILE_ALIGNMENT;
+    header.HeaderChecksum = ComputeHeaderChecksum(header, chunks);
+
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)chunks, sizeof(chunks));
+
+    const char padding[SCENE_FILE_ALIGNMENT] = {};
+    uint64_t written = sizeof(header) + sizeof(chunks);
+    for (uint32_t i = 0; i < numChunks; i++)
+    {
+        file.write(padding, chunks[i].Offset - written);
+        file.write((const char*)sources[i].Data, sources[i].Size);
+        written = chunks[i].Offset + chunks[i].Size;
+    }
+
+    if (!file.good())
+    {
+        std::cout << "Failed writing scene file: " << filepath << std::endl;
+        return false;
+    }
+
+    if (headerChecksum)
+        *headerChecksum = header.HeaderChecksum;
+
+    return true;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "scene.h"
+
+#include <string>
+
+// Binary scene file layout (all values little-endian):
+//   SceneFileHeader
+//   SceneFileChunk[NumChunks]
+//   chunk data, each chunk starting at a multiple of SCENE_FILE_ALIGNMENT
+// Chunk payloads are stored exactly as their in-memory arrays so a mapped file can be used through a SceneView directly
+#define SCENE_FILE_MAGIC 0x43535A42 // "BZSC"
+#define SCENE_FILE_VERSION_MAJOR 1
+#define SCENE_FILE_VERSION_MINOR 0
+#define SCENE_FILE_ENDIAN_TAG 0x01020304
+#define SCENE_FILE_ALIGNMENT 64
+
+constexpr uint32_t SceneFileFourCC(char a, char b, char c, char d)
+{
+    return (uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24);
+}
+
+enum SceneFileChunkType : uint32_t
+{
+    SceneFileChunk_Settings = SceneFileFourCC('S', 'E', 'T', 'T'),
+    SceneFileChunk_Curves = SceneFileFourCC('C', 'U', 'R', 'V'),
+    SceneFileChunk_Positions = SceneFileFourCC('C', 'P', 'O', 'S'),
+    SceneFileChunk_Colors = SceneFileFourCC('C', 'C', 'O', 'L'),
+};
+
+enum SceneFileLoadFlags : uint32_t
+{
+    SceneFileLoadFlags_None = 0,
+    SceneFileLoadFlags_VerifyChecksums = 1 << 0,
+};
+
+struct SceneFileHeader
+{
+    uint32_t Magic;
+    uint16_t VersionMajor;
+    uint16_t VersionMinor;
+    uint32_t EndianTag;
+    uint32_t NumChunks;
+    uint64_t FileSize;
+    uint32_t Alignment;
+    uint32_t HeaderChecksum; // Covers the header (with this field zeroed) and the chunk table
+};
+
+struct SceneFileChunk
+{
+    uint32_t Type;
+    uint32_t ElementSize;
+    uint64_t Offset;
+    uint64_t Size;
+    uint32_t Checksum;
+    uint32_t Reserved;
+};
+
+struct SceneFileSettings
+{
+    uint32_t Flags;
+    int32_t NumSamples;
+    float T1;
+    uint32_t Reserved;
+};
+
+enum SceneFileSettingsFlags : uint32_t
+{
+    SceneFileSettingsFlags_DrawBezierCurve = 1 << 0,
+    SceneFileSettingsFlags_DrawPolar = 1 << 1,
+};
+
+static_assert(sizeof(SceneFileHeader) == 32, "Scene file header layout changed");
+static_assert(sizeof(SceneFileChunk) == 32, "Scene file chunk layout changed");
+static_assert(sizeof(SceneFileSettings) == 16, "Scene file settings layout changed");
+static_assert(sizeof(SceneCurve) == 24, "SceneCurve is stored verbatim in scene files");
+static_assert(sizeof(glm::vec2) == 8 && sizeof(glm::vec3) == 12, "Control point attributes are stored verbatim in scene files");
+
+// Read-only memory mapping of a scene file. The view returned by GetView() points into the mapping and is only valid while the file is open
+class SceneFile
+{
+public:
+    SceneFile() = default;
+    ~SceneFile();
+
+    SceneFile(const SceneFile&) = delete;
+    SceneFile& operator=(const SceneFile&) = delete;
+
+    bool Open(const std::string& filepath, uint32_t flags = SceneFileLoadFlags_None);
+    void Close();
+    bool VerifyChecksums() const;
+
+    bool IsOpen() const { return m_Data != nullptr; }
+    uint64_t GetFileSize() const { return m_Size; }
+    uint32_t GetHeaderChecksum() const { return ((const SceneFileHeader*)m_Data)->HeaderChecksum; }
+    const SceneView& GetView() const { return m_View; }
+private:
+    bool MapFile(const std::string& filepath);
+    void UnmapFile();
+    bool ParseChunks(const std::string& filepath);
+    const SceneFileChunk* FindChunk(uint32_t type) const;
+private:
+    const uint8_t* m_Data = nullptr;
+    uint64_t m_Size = 0;
+    SceneView m_View;
+#if defined(_WIN32)
+    void* m_FileHandle = nullptr;
+    void* m_MappingHandle = nullptr;
+#else
+    int m_FileDescriptor = -1;
+#endif
+};
+
+// headerChecksum optionally receives the checksum of the written header, which identifies the file contents
+bool SaveSceneFile(const std::string& filepath, const SceneView& scene, uint32_t* headerChecksum = nullptr);
+
+// CRC-32C, can be chained by passing the previous result as the seed
+uint32_t ComputeSceneFileChecksum(const void* data, uint64_t size, uint32_t seed = 0);
@@ -0,0 +1,124 @@
+#include "scenesnapshot.h"
+#include "curvebounds.h"
+
+#include <cstring>
+#include <thread>
+
+static bool IsSameCurve(const SceneSnapshotCurve& snapshotCurve, const Scene& scene, const SceneCurve& curve)
+{
+    if (snapshotCurve.Color != curve.Color || snapshotCurve.Thickness != curve.Thickness || snapshotCurve.Positions.size() != curve.NumControlPoints)
+        return false;
+
+    uint32_t first = curve.FirstControlPoint;
+    return memcmp(snapshotCurve.Positions.data(), scene.Positions.data() + first, curve.NumControlPoints * sizeof(glm::vec2)) == 0 &&
+           memcmp(snapshotCurve.Colors.data(), scene.Colors.data() + first, curve.NumControlPoints * sizeof(glm::vec3)) == 0;
+}
+
+static bool IsSameSettings(const GlobalSettings& a, const GlobalSettings& b)
+{
+    return a.DrawBezierCurve == b.DrawBezierCurve && a.DrawPolar == b.DrawPolar && a.NumSamples == b.NumSamples && a.T1 == b.T1;
+}
+
+static bool IsSameScene(const SceneSnapshot& snapshot, const Scene& scene)
+{
+    if (snapshot.Curves.size() != scene.Curves.size() || !IsSameSettings(snapshot.Settings, scene.Settings))
+        return false;
+
+    for (uint32_t i = 0; i < scene.Curves.size(); i++)
+    {
+        if (!IsSameCurve(*snapshot.Curves[i], scene, scene.Curves[i]))
+            return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<const SceneSnapshot> SceneSnapshot::Create(const Scene& scene, const std::shared_ptr<const SceneSnapshot>& previous)
+{
+    // Checked before anything is allocated, the editor calls this every frame and most frames change nothing
+    if (previous && IsSameScene(*previous, scene))
+        return previous;
+
+    std::shared_ptr<SceneSnapshot> snapshot = std::make_shared<SceneSnapshot>();
+    snapshot->Version = previous ? previous->Version + 1 : 1;
+    snapshot->Settings = scene.Settings;
+    snapshot->Curves.reserve(scene.Curves.size());
+
+    // Curves are matched by index, an insertion or removal of a curve only shares the curves in front of it
+    for (uint32_t i = 0; i < scene.Curves.size(); i++)
+    {
+        const SceneCurve& curve = scene.Curves[i];
+        if (previous && i < previous->Curves.size() && IsSameCurve(*previous->Curves[i], scene, curve))
+        {
+            snapshot->Curves.push_back(previous->Curves[i]);
+            continue;
+        }
+
+        std::shared_ptr<SceneSnapshotCurve> snapshotCurve = std::make_shared<SceneSnapshotCurve>();
+        snapshotCurve->Color = curve.Color;
+        snapshotCurve->Thickness = curve.Thickness;
+        snapshotCurve->Positions.assign(scene.Positions.begin() + curve.FirstControlPoint, scene.Positions.begin() + curve.FirstControlPoint + curve.NumControlPoints);
+        snapshotCurve->Colors.assign(scene.Colors.begin() + curve.FirstControlPoint, scene.Colors.begin() + curve.FirstControlPoint + curve.NumControlPoints);
+        GetBezierBounds(snapshotCurve->Positions.data(), snapshotCurve->Positions.size(), snapshotCurve->BoundsMin, snapshotCurve->BoundsMax);
+        snapshot->Curves.push_back(std::move(snapshotCurve));
+    }
+
+    return snapshot;
+}
+
+void SceneSnapshot::CopyTo(Scene& scene) const
+{
+    scene.Clear();
+    scene.Settings = Settings;
+    scene.Positions.reserve(GetNumControlPoints());
+    scene.Colors.reserve(GetNumControlPoints());
+
+    for (const std::shared_ptr<const SceneSnapshotCurve>& curve : Curves)
+    {
+        scene.AddCurve(curve->Color, curve->Thickness);
+        scene.Positions.insert(scene.Positions.end(), curve->Positions.begin(), curve->Positions.end());
+        scene.Colors.insert(scene.Colors.end(), curve->Colors.begin(), curve->Colors.end());
+        scene.Curves.back().NumControlPoints = curve->Positions.size();
+    }
+}
+
+uint32_t SceneSnapshot::GetNumControlPoints() const
+{
+    uint32_t numControlPoints = 0;
+    for (const std::shared_ptr<const SceneSnapshotCurve>& curve : Curves)
+        numControlPoints += curve->Positions.size();
+
+    return numControlPoints;
+}
+
+void SceneSnapshotPublisher::Publish(std::shared_ptr<const SceneSnapshot> snapshot)
+{
+    // Readers only stay registered on a slot while copying its shared_ptr, so this wait is short. A reader that registers
+    // after the check sees the slot is no longer current and backs off without touching it
+    uint32_t slot = m_Current.load(std::memory_order_relaxed) ^ 1;
+    while (m_NumReaders[slot].load() != 0)
+        std::this_thread::yield();
+
+    m_Slots[slot] = std::move(snapshot);
+    m_Current.store(slot);
+}
+
+std::shared_ptr<const SceneSnapshot> SceneSnapshotPublisher::Acquire() const
+{
+    while (true)
+    {
+        uint32_t slot = m_Current.load();
+        m_NumReaders[slot].fetch_add(1);
+
+        // The slot may have been retired and handed to the writer between the two loads
+        if (m_Current.load() != slot)
+        {
+            m_NumReaders[slot].fetch_sub(1);
+            continue;
+        }
+
+        std::shared_ptr<const SceneSnapshot> snapshot = m_Slots[slot];
+        m_NumReaders[slot].fetch_sub(1, std::memory_order_release);
+        return snapshot;
+    }
+}
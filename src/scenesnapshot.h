@@ -0,0 +1,52 @@
+#pragma once
+
+#include "scene.h"
+
+#include <atomic>
+#include <memory>
+
+// Control points of a snapshot curve are stored per curve, so unchanged curves can be shared between snapshot versions
+struct SceneSnapshotCurve
+{
+    glm::vec3 Color = glm::vec3(1.0f);
+    float Thickness = 1.0f;
+    std::vector<glm::vec2> Positions;
+    std::vector<glm::vec3> Colors;
+    // Exact bounds of the curve, computed once when the curve is created and shared along with it
+    glm::vec2 BoundsMin = glm::vec2(0.0f);
+    glm::vec2 BoundsMax = glm::vec2(0.0f);
+};
+
+// Immutable version of a scene. Snapshots are only accessed through shared_ptr<const SceneSnapshot>, so any thread can
+// keep reading a version for as long as it holds on to it, no matter how many versions the editor commits in the meantime
+struct SceneSnapshot
+{
+    uint64_t Version = 0;
+    GlobalSettings Settings;
+    std::vector<std::shared_ptr<const SceneSnapshotCurve>> Curves;
+
+    // Curves identical to the ones in previous are shared instead of copied. Returns previous itself when nothing changed
+    static std::shared_ptr<const SceneSnapshot> Create(const Scene& scene, const std::shared_ptr<const SceneSnapshot>& previous = nullptr);
+
+    void CopyTo(Scene& scene) const;
+    uint32_t GetNumControlPoints() const;
+};
+
+// Latest published snapshot, written by a single editor thread and read by any number of threads. Publishing flips an
+// atomic index between two slots, readers never wait for the writer and only retry when a publish overtakes them
+class SceneSnapshotPublisher
+{
+public:
+    SceneSnapshotPublisher() = default;
+
+    SceneSnapshotPublisher(const SceneSnapshotPublisher&) = delete;
+    SceneSnapshotPublisher& operator=(const SceneSnapshotPublisher&) = delete;
+
+    // Only ever called from the editor thread
+    void Publish(std::shared_ptr<const SceneSnapshot> snapshot);
+    std::shared_ptr<const SceneSnapshot> Acquire() const;
+private:
+    std::shared_ptr<const SceneSnapshot> m_Slots[2];
+    std::atomic<uint32_t> m_Current{ 0 };
+    mutable std::atomic<uint32_t> m_NumReaders[2] = {};
+};
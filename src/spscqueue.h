@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread. Push and Pop never block, Push fails when the queue is full
+template<typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(uint32_t capacity)
+    {
+        uint32_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+
+        m_Buffer.resize(size);
+        m_Mask = size - 1;
+    }
+
+    bool Push(const T& value)
+    {
+        uint32_t tail = m_Tail.load(std::memory_order_relaxed);
+        if (tail - m_CachedHead > m_Mask)
+        {
+            m_CachedHead = m_Head.load(std::memory_order_acquire);
+            if (tail - m_CachedHead > m_Mask)
+                return false;
+        }
+
+        m_Buffer[tail & m_Mask] = value;
+        m_Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(T& value)
+    {
+        uint32_t head = m_Head.load(std::memory_order_relaxed);
+        if (head == m_CachedTail)
+        {
+            m_CachedTail = m_Tail.load(std::memory_order_acquire);
+            if (head == m_CachedTail)
+                return false;
+        }
+
+        value = m_Buffer[head & m_Mask];
+        m_Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint32_t GetCapacity() const { return m_Mask + 1; }
+private:
+    std::vector<T> m_Buffer;
+    uint32_t m_Mask = 0;
+
+    // Producer and consumer state live on separate cache lines, each side caches the other's index to avoid touching the shared line on every call
+    alignas(64) std::atomic<uint32_t> m_Tail{ 0 };
+    uint32_t m_CachedHead = 0;
+    alignas(64) std::atomic<uint32_t> m_Head{ 0 };
+    uint32_t m_CachedTail = 0;
+};
@@ -0,0 +1,136 @@
+#include "stripexporter.h"
+#include "cpurenderer.h"
+#include "imagefile.h"
+#include "jobsystem.h"
+#include "orderedwriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// What a thread keeps from one band to the next. A job system per thread, the bands are the parallel work
+struct StripWorker
+{
+    StripWorker()
+        : Jobs(1), Renderer(Jobs)
+    {
+    }
+
+    JobSystem Jobs;
+    CpuRenderer Renderer;
+    CpuImage Image;
+};
+
+uint64_t GetPeakResidentBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+    // Bytes on macOS, kilobytes everywhere else
+#if defined(__APPLE__)
+    return uint64_t(usage.ru_maxrss);
+#else
+    return uint64_t(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+bool ExportImageStrips(const SceneSnapshot& scene, const StripExportSettings& settings, std::ostream& output, StripExportStats& stats)
+{
+    stats = StripExportStats();
+    if (settings.Width == 0 || settings.Height == 0 || settings.BandHeight == 0)
+    {
+        std::cout << "Failed to export image: the image size and band height must not be zero" << std::endl;
+        return false;
+    }
+
+    Clock::time_point start = Clock::now();
+    std::vector<uint8_t> header;
+    if (settings.Format == ImageFileFormat_Tga)
+    {
+        if (!EncodeTgaHeader(settings.Width, settings.Height, header))
+        {
+            std::cout << "Failed to export image: " << settings.Width << "x" << settings.Height << " is too large for a TGA file" << std::endl;
+            return false;
+        }
+    }
+    else
+    {
+        EncodePpmHeader(settings.Width, settings.Height, header);
+    }
+
+    output.write(reinterpret_cast<const char*>(header.data()), header.size());
+    stats.NumBytes += header.size();
+
+    uint32_t numBands = (settings.Height + settings.BandHeight - 1) / settings.BandHeight;
+    uint32_t numThreads = settings.NumThreads > 0 ? settings.NumThreads : std::max(std::thread::hardware_concurrency(), 1u);
+    numThreads = std::max(std::min(numThreads, numBands), 1u);
+
+    // Created on the thread that uses them, a job system of one thread runs its jobs on the thread that created it
+    std::vector<std::unique_ptr<StripWorker>> workers(numThreads);
+    auto encodeBand = [&](uint32_t thread, uint32_t band, std::vector<uint8_t>& data)
+    {
+        if (!workers[thread])
+        {
+            workers[thread] = std::make_unique<StripWorker>();
+            workers[thread]->Renderer.SetSampleTolerance(settings.SampleTolerance);
+        }
+
+        StripWorker& worker = *workers[thread];
+        worker.Renderer.RenderRows(scene, settings.Width, settings.Height, band * settings.BandHeight, settings.BandHeight, worker.Image, settings.View);
+
+        data.clear();
+        if (settings.Format == ImageFileFormat_Tga)
+            EncodeTgaRows(worker.Image.Pixels.data(), worker.Image.Width, worker.Image.Height, data);
+        else
+            EncodePpmRows(worker.Image.Pixels.data(), worker.Image.Width, worker.Image.Height, data);
+    };
+
+    OrderedWriteStats writeStats;
+    bool succeeded = WriteItemsInOrder(numBands, numThreads, settings.MaxBandsInFlight, encodeBand, output, writeStats);
+
+    stats.BandBytes = writeStats.SlotBytes;
+    for (const std::unique_ptr<StripWorker>& worker : workers)
+    {
+        if (worker)
+            stats.BandBytes += worker->Image.Pixels.capacity() * sizeof(uint32_t);
+    }
+
+    uint32_t numWrittenBands = writeStats.NumWritten;
+    stats.NumBytes += writeStats.NumBytes;
+    stats.PeakBandsInFlight = writeStats.PeakInFlight;
+    stats.NumBands = numWrittenBands;
+    stats.TotalTime = std::chrono::duration<float>(Clock::now() - start).count();
+    uint64_t numWrittenRows = std::min<uint64_t>(uint64_t(numWrittenBands) * settings.BandHeight, settings.Height);
+    stats.MegapixelsPerSecond = stats.TotalTime > 0.0f ? float(double(settings.Width) * numWrittenRows * 1e-6 / stats.TotalTime) : 0.0f;
+    stats.PeakResidentBytes = GetPeakResidentBytes();
+    if (!succeeded)
+    {
+        std::cout << "Failed to export image: the output failed after " << numWrittenBands << " of " << numBands << " bands" << std::endl;
+        return false;
+    }
+
+    return true;
+}
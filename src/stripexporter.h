@@ -0,0 +1,48 @@
+#pragma once
+
+#include "imagefile.h"
+#include "scenesnapshot.h"
+#include "viewcamera.h"
+
+#include <cstdint>
+#include <ostream>
+
+struct StripExportSettings
+{
+    uint32_t Width = 8192;
+    uint32_t Height = 8192;
+    // Rows rendered at once by a thread
+    uint32_t BandHeight = 256;
+    ImageFileFormat Format = ImageFileFormat_Tga;
+    ViewTransform View;
+    // Sample tolerance of the renderer in pixels of the exported image, 0 samples every curve NumSamples times
+    float SampleTolerance = VIEW_DEFAULT_SAMPLE_TOLERANCE;
+    // Bands rendered at once, 0 uses one per hardware thread
+    uint32_t NumThreads = 0;
+    // Bands rendered or encoded but not written yet, which bounds the memory in use. 0 uses two per thread
+    uint32_t MaxBandsInFlight = 0;
+};
+
+struct StripExportStats
+{
+    uint32_t NumBands = 0;
+    float TotalTime = 0.0f;
+    float MegapixelsPerSecond = 0.0f;
+    uint64_t NumBytes = 0;
+    uint32_t PeakBandsInFlight = 0;
+    // Band images of the threads and encoded bands waiting to be written, the memory the export itself holds
+    uint64_t BandBytes = 0;
+    // Peak resident memory of the whole process once the export is done, 0 where it is not known
+    uint64_t PeakResidentBytes = 0;
+};
+
+// Renders an image too large to hold in memory, a band of BandHeight rows at a time, and writes it to output from top to
+// bottom. Each thread renders whole bands with a renderer of its own, which only evaluates and bins the curves crossing the
+// band, encodes them into one of MaxBandsInFlight buffers, and the calling thread writes the buffers out in order. A thread
+// that gets ahead of the output by MaxBandsInFlight bands waits for it, so memory stays within a few bands whatever the size
+// of the image. The image is the same as CpuRenderer::Render of the whole size would produce. Returns false if the output
+// fails, bands written until then stay written
+bool ExportImageStrips(const SceneSnapshot& scene, const StripExportSettings& settings, std::ostream& output, StripExportStats& stats);
+
+// Peak resident memory of the process in bytes, 0 where it is not known
+uint64_t GetPeakResidentBytes();
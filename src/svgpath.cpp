@@ -0,0 +1,781 @@
+#include "svgpath.h"
+
+#include <iostream>
+#include <fstream>
+#include <charconv>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+
+static bool IsWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+static bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static char ToUpper(char c)
+{
+    return (c >= 'a' && c <= 'z') ? c - 'a' + 'A' : c;
+}
+
+static uint32_t GetCommandArgumentCount(char command)
+{
+    switch (ToUpper(command))
+    {
+        case 'M': return 2;
+        case 'L': return 2;
+        case 'H': return 1;
+        case 'V': return 1;
+        case 'C': return 6;
+        case 'S': return 4;
+        case 'Q': return 4;
+        case 'T': return 2;
+        case 'A': return 7;
+        case 'Z': return 0;
+    }
+
+    return UINT32_MAX;
+}
+
+SceneSvgPathSink::SceneSvgPathSink(Scene& scene, const glm::vec3& color, float thickness)
+    : m_Scene(scene), m_Color(color), m_Thickness(thickness)
+{
+}
+
+void SceneSvgPathSink::OnSegment(const glm::vec2* controlPoints, uint32_t numControlPoints)
+{
+    m_Scene.AddCurve(m_Color, m_Thickness);
+    for (uint32_t i = 0; i < numControlPoints; i++)
+        m_Scene.AddControlPoint(controlPoints[i]);
+}
+
+SvgPathParser::SvgPathParser(SvgPathSink& sink)
+    : m_Sink(sink)
+{
+}
+
+bool SvgPathParser::Parse(const char* data, size_t size)
+{
+    if (m_Error)
+        return false;
+
+    for (size_t i = 0; i < size; i++, m_Offset++)
+    {
+        if (!ProcessChar(data[i]))
+        {
+            m_Error = true;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SvgPathParser::Finish()
+{
+    if (m_Error)
+        return false;
+
+    if (m_NumberState != NumberState::None && !EndNumber())
+    {
+        m_Error = true;
+        return false;
+    }
+
+    // A command missing some of its arguments invalidates the whole path
+    if (m_NumArgs != 0)
+    {
+        m_Error = true;
+        return false;
+    }
+
+    EndSubpath(false);
+    return true;
+}
+
+void SvgPathParser::Reset()
+{
+    m_Command = 0;
+    m_LastCommand = 0;
+    m_NumArgs = 0;
+    m_NumberLength = 0;
+    m_NumberState = NumberState::None;
+    m_CurrentPoint = glm::vec2(0.0f);
+    m_SubpathStart = glm::vec2(0.0f);
+    m_LastControlPoint = glm::vec2(0.0f);
+    m_SubpathOpen = false;
+    m_Error = false;
+    m_Offset = 0;
+}
+
+bool SvgPathParser::ProcessChar(char c)
+{
+    if (m_NumberState != NumberState::None)
+    {
+        if (ContinueNumber(c))
+            return true;
+
+        if (m_Error || !EndNumber())
+            return false;
+    }
+
+    if (IsWhitespace(c) || c == ',')
+        return true;
+
+    if (IsDigit(c) || c == '-' || c == '+' || c == '.')
+    {
+        if (!m_Command)
+            return false;
+
+        // Arc flags are single characters and may be written without separators, e.g. "a1 1 0 011 1"
+        if (ToUpper(m_Command) == 'A' && (m_NumArgs == 3 || m_NumArgs == 4))
+        {
+            if (c != '0' && c != '1')
+                return false;
+
+            return PushArgument(c - '0');
+        }
+
+        m_Number[0] = c;
+        m_NumberLength = 1;
+        m_NumberState = IsDigit(c) ? NumberState::Integer : (c == '.' ? NumberState::LeadingPoint : NumberState::Sign);
+        return true;
+    }
+
+    if (GetCommandArgumentCount(c) == UINT32_MAX || m_NumArgs != 0)
+        return false;
+
+    // Path data must start with a moveto
+    if (!m_Command && ToUpper(c) != 'M')
+        return false;
+
+    m_Command = c;
+    if (ToUpper(c) == 'Z')
+        ExecuteCommand();
+
+    return true;
+}
+
+bool SvgPathParser::ContinueNumber(char c)
+{
+    NumberState nextState = NumberState::None;
+
+    switch (m_NumberState)
+    {
+        case NumberState::Sign:
+            nextState = IsDigit(c) ? NumberState::Integer : (c == '.' ? NumberState::LeadingPoint : NumberState::None);
+            break;
+        case NumberState::Integer:
+            nextState = IsDigit(c) ? NumberState::Integer : (c == '.' ? NumberState::Point : ((c == 'e' || c == 'E') ? NumberState::Exponent : NumberState::None));
+            break;
+        case NumberState::Point:
+        case NumberState::Fraction:
+            nextState = IsDigit(c) ? NumberState::Fraction : ((c == 'e' || c == 'E') ? NumberState::Exponent : NumberState::None);
+            break;
+        case NumberState::LeadingPoint:
+            nextState = IsDigit(c) ? NumberState::Fraction : NumberState::None;
+            break;
+        case NumberState::Exponent:
+            nextState = IsDigit(c) ? NumberState::ExponentDigits : ((c == '-' || c == '+') ? NumberState::ExponentSign : NumberState::None);
+            break;
+        case NumberState::ExponentSign:
+        case NumberState::ExponentDigits:
+            nextState = IsDigit(c) ? NumberState::ExponentDigits : NumberState::None;
+            break;
+        default:
+            break;
+    }
+
+    if (nextState == NumberState::None)
+        return false;
+
+    // Fraction digits past the buffer cannot change the float, either the digits kept hold all it can represent or the value
+    // is far below its smallest. Longer integers and exponents would, those fail the parse rather than split the number
+    if (m_NumberLength >= sizeof(m_Number))
+    {
+        if (nextState == NumberState::Fraction)
+        {
+            m_NumberState = nextState;
+            return true;
+        }
+
+        m_Error = true;
+        return false;
+    }
+
+    m_Number[m_NumberLength++] = c;
+    m_NumberState = nextState;
+    return true;
+}
+
+bool SvgPathParser::EndNumber()
+{
+    NumberState state = m_NumberState;
+    m_NumberState = NumberState::None;
+
+    if (state != NumberState::Integer && state != NumberState::Point && state != NumberState::Fraction && state != NumberState::ExponentDigits)
+        return false;
+
+    // from_chars does not accept a leading '+'
+    const char* begin = m_Number[0] == '+' ? m_Number + 1 : m_Number;
+
+    float value = 0.0f;
+    std::from_chars_result result = std::from_chars(begin, m_Number + m_NumberLength, value);
+    if (result.ec != std::errc() && result.ec != std::errc::result_out_of_range)
+        return false;
+
+    return PushArgument(value);
+}
+
+bool SvgPathParser::PushArgument(float value)
+{
+    uint32_t argumentCount = GetCommandArgumentCount(m_Command);
+    if (argumentCount == 0)
+        return false;
+
+    m_Args[m_NumArgs++] = value;
+    if (m_NumArgs == argumentCount)
+    {
+        ExecuteCommand();
+        m_NumArgs = 0;
+
+        // Extra coordinate pairs after a moveto are implicit lineto commands
+        if (m_Command == 'M')
+            m_Command = 'L';
+        else if (m_Command == 'm')
+            m_Command = 'l';
+    }
+
+    return true;
+}
+
+void SvgPathParser::ExecuteCommand()
+{
+    char command = ToUpper(m_Command);
+    glm::vec2 base = (m_Command != command) ? m_CurrentPoint : glm::vec2(0.0f);
+    glm::vec2 points[4];
+
+    switch (command)
+    {
+        case 'M':
+        {
+            EndSubpath(false);
+            m_CurrentPoint = base + glm::vec2(m_Args[0], m_Args[1]);
+            m_SubpathStart = m_CurrentPoint;
+            break;
+        }
+        case 'L':
+        case 'H':
+        case 'V':
+        {
+            points[0] = m_CurrentPoint;
+            points[1] = m_CurrentPoint;
+            if (command == 'L')
+                points[1] = base + glm::vec2(m_Args[0], m_Args[1]);
+            else if (command == 'H')
+                points[1].x = base.x + m_Args[0];
+            else
+                points[1].y = base.y + m_Args[0];
+
+            EmitSegment(points, 2);
+            break;
+        }
+        case 'C':
+        case 'S':
+        {
+            points[0] = m_CurrentPoint;
+            if (command == 'C')
+            {
+                points[1] = base + glm::vec2(m_Args[0], m_Args[1]);
+                points[2] = base + glm::vec2(m_Args[2], m_Args[3]);
+                points[3] = base + glm::vec2(m_Args[4], m_Args[5]);
+            }
+            else
+            {
+                // The first control point is the reflection of the previous cubic's second control point
+                points[1] = (m_LastCommand == 'C' || m_LastCommand == 'S') ? 2.0f * m_CurrentPoint - m_LastControlPoint : m_CurrentPoint;
+                points[2] = base + glm::vec2(m_Args[0], m_Args[1]);
+                points[3] = base + glm::vec2(m_Args[2], m_Args[3]);
+            }
+
+            m_LastControlPoint = points[2];
+            EmitSegment(points, 4);
+            break;
+        }
+        case 'Q':
+        case 'T':
+        {
+            points[0] = m_CurrentPoint;
+            if (command == 'Q')
+            {
+                points[1] = base + glm::vec2(m_Args[0], m_Args[1]);
+                points[2] = base + glm::vec2(m_Args[2], m_Args[3]);
+            }
+            else
+            {
+                points[1] = (m_LastCommand == 'Q' || m_LastCommand == 'T') ? 2.0f * m_CurrentPoint - m_LastControlPoint : m_CurrentPoint;
+                points[2] = base + glm::vec2(m_Args[0], m_Args[1]);
+            }
+
+            m_LastControlPoint = points[1];
+            EmitSegment(points, 3);
+            break;
+        }
+        case 'A':
+        {
+            EmitArc({ m_Args[0], m_Args[1] }, m_Args[2], m_Args[3] != 0.0f, m_Args[4] != 0.0f, base + glm::vec2(m_Args[5], m_Args[6]));
+            break;
+        }
+        case 'Z':
+        {
+            if (m_SubpathOpen && m_CurrentPoint != m_SubpathStart)
+            {
+                points[0] = m_CurrentPoint;
+                points[1] = m_SubpathStart;
+                EmitSegment(points, 2);
+            }
+
+            EndSubpath(true);
+            m_CurrentPoint = m_SubpathStart;
+            break;
+        }
+    }
+
+    m_LastCommand = command;
+}
+
+void SvgPathParser::EmitSegment(const glm::vec2* controlPoints, uint32_t numControlPoints)
+{
+    m_Sink.OnSegment(controlPoints, numControlPoints);
+    m_CurrentPoint = controlPoints[numControlPoints - 1];
+    m_SubpathOpen = true;
+}
+
+void SvgPathParser::EmitArc(glm::vec2 radius, float angle, bool largeArc, bool sweep, const glm::vec2& end)
+{
+    // Endpoint to center parameterization conversion from the SVG implementation notes (F.6.5), each part of at most 90 degrees becomes a cubic
+    const double pi = 3.14159265358979323846;
+
+    glm::dvec2 start = m_CurrentPoint;
+    if (start == glm::dvec2(end))
+        return;
+
+    double rx = std::abs(radius.x);
+    double ry = std::abs(radius.y);
+    if (rx == 0.0 || ry == 0.0)
+    {
+        glm::vec2 points[2] = { m_CurrentPoint, end };
+        EmitSegment(points, 2);
+        return;
+    }
+
+    double phi = angle * pi / 180.0;
+    double cosPhi = std::cos(phi);
+    double sinPhi = std::sin(phi);
+
+    glm::dvec2 halfDelta = (start - glm::dvec2(end)) * 0.5;
+    double x1 = cosPhi * halfDelta.x + sinPhi * halfDelta.y;
+    double y1 = -sinPhi * halfDelta.x + cosPhi * halfDelta.y;
+
+    double lambda = (x1 * x1) / (rx * rx) + (y1 * y1) / (ry * ry);
+    if (lambda > 1.0)
+    {
+        rx *= std::sqrt(lambda);
+        ry *= std::sqrt(lambda);
+    }
+
+    double numerator = rx * rx * ry * ry - rx * rx * y1 * y1 - ry * ry * x1 * x1;
+    double denominator = rx * rx * y1 * y1 + ry * ry * x1 * x1;
+    double coefficient = std::sqrt(std::max(0.0, numerator / denominator)) * (largeArc == sweep ? -1.0 : 1.0);
+
+    double cx1 = coefficient * rx * y1 / ry;
+    double cy1 = -coefficient * ry * x1 / rx;
+    glm::dvec2 center = glm::dvec2(cosPhi * cx1 - sinPhi * cy1, sinPhi * cx1 + cosPhi * cy1) + (start + glm::dvec2(end)) * 0.5;
+
+    glm::dvec2 u = { (x1 - cx1) / rx, (y1 - cy1) / ry };
+    glm::dvec2 v = { (-x1 - cx1) / rx, (-y1 - cy1) / ry };
+    double theta = std::atan2(u.y, u.x);
+    double deltaTheta = std::atan2(u.x * v.y - u.y * v.x, u.x * v.x + u.y * v.y);
+
+    if (!sweep && deltaTheta > 0.0)
+        deltaTheta -= 2.0 * pi;
+    else if (sweep && deltaTheta < 0.0)
+        deltaTheta += 2.0 * pi;
+
+    uint32_t numSegments = std::max(1, (int)std::ceil(std::abs(deltaTheta) / (pi * 0.5) - 1e-7));
+    double segmentAngle = deltaTheta / numSegments;
+    double k = 4.0 / 3.0 * std::tan(segmentAngle * 0.25);
+
+    auto mapPoint = [&](double x, double y) {
+        return glm::vec2(center.x + rx * cosPhi * x - ry * sinPhi * y, center.y + rx * sinPhi * x + ry * cosPhi * y);
+    };
+
+    for (uint32_t i = 0; i < numSegments; i++)
+    {
+        double t0 = theta + segmentAngle * i;
+        double t1 = t0 + segmentAngle;
+
+        glm::vec2 points[4];
+        points[0] = m_CurrentPoint;
+        points[1] = mapPoint(std::cos(t0) - k * std::sin(t0), std::sin(t0) + k * std::cos(t0));
+        points[2] = mapPoint(std::cos(t1) + k * std::sin(t1), std::sin(t1) - k * std::cos(t1));
+        points[3] = (i == numSegments - 1) ? end : mapPoint(std::cos(t1), std::sin(t1));
+
+        EmitSegment(points, 4);
+    }
+}
+
+void SvgPathParser::EndSubpath(bool closed)
+{
+    if (!m_SubpathOpen)
+        return;
+
+    m_Sink.OnSubpathEnd(closed);
+    m_SubpathOpen = false;
+}
+
+SvgPathWriter::SvgPathWriter(std::ostream& stream)
+    : m_Stream(stream)
+{
+}
+
+void SvgPathWriter::BeginDocument(const glm::vec2& boundsMin, const glm::vec2& boundsMax)
+{
+    // Scene space is y-up, the content is flipped inside a group so coordinates are written unchanged
+    glm::vec2 size = glm::max(boundsMax - boundsMin, glm::vec2(1e-6f));
+    m_Tolerance = std::max(size.x, size.y) * 1e-4f;
+
+    m_Stream << "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"";
+    WriteNumber(boundsMin.x);
+    m_Stream << ' ';
+    WriteNumber(-boundsMax.y);
+    m_Stream << ' ';
+    WriteNumber(size.x);
+    m_Stream << ' ';
+    WriteNumber(size.y);
+    m_Stream << "\">\n<g transform=\"scale(1 -1)\" fill=\"none\" stroke-linecap=\"round\">\n";
+}
+
+void SvgPathWriter::WriteCurve(const glm::vec2* controlPoints, uint32_t numControlPoints, const glm::vec3& color, float thickness)
+{
+    if (numControlPoints < 2)
+        return;
+
+    glm::ivec3 rgb = glm::clamp(glm::ivec3(color * 255.0f + 0.5f), 0, 255);
+    char colorString[8];
+    snprintf(colorString, sizeof(colorString), "#%02x%02x%02x", rgb.r, rgb.g, rgb.b);
+
+    m_Stream << "<path stroke=\"" << colorString << "\" stroke-width=\"";
+    WriteNumber(thickness * 0.01f);
+    m_Stream << "\" d=\"M";
+    WritePoint(controlPoints[0]);
+
+    switch (numControlPoints)
+    {
+        case 2:
+            m_Stream << 'L';
+            WritePoint(controlPoints[1]);
+            break;
+        case 3:
+            m_Stream << 'Q';
+            WritePoint(controlPoints[1]);
+            WritePoint(controlPoints[2]);
+            break;
+        case 4:
+            m_Stream << 'C';
+            WritePoint(controlPoints[1]);
+            WritePoint(controlPoints[2]);
+            WritePoint(controlPoints[3]);
+            break;
+        default:
+            WriteFlattenedCurve(controlPoints, numControlPoints);
+            break;
+    }
+
+    m_Stream << "\"/>\n";
+}
+
+void SvgPathWriter::EndDocument()
+{
+    m_Stream << "</g>\n</svg>\n";
+    m_Stream.flush();
+}
+
+void SvgPathWriter::WriteNumber(float value)
+{
+    char buffer[32];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    m_Stream.write(buffer, result.ptr - buffer);
+}
+
+void SvgPathWriter::WritePoint(const glm::vec2& p)
+{
+    m_Stream << ' ';
+    WriteNumber(p.x);
+    m_Stream << ' ';
+    WriteNumber(p.y);
+}
+
+void SvgPathWriter::WriteFlattenedCurve(const glm::vec2* controlPoints, uint32_t numControlPoints)
+{
+    // SVG has no segments above cubic, so higher degrees are written as a polyline. The segment count comes from the
+    // standard flattening bound: error <= n(n-1)/8 * max|P[i+2] - 2P[i+1] + P[i]| / segments^2
+    uint32_t degree = numControlPoints - 1;
+
+    float maxSecondDifference = 0.0f;
+    for (uint32_t i = 0; i + 2 < numControlPoints; i++)
+        maxSecondDifference = std::max(maxSecondDifference, glm::length(controlPoints[i + 2] - 2.0f * controlPoints[i + 1] + controlPoints[i]));
+
+    float bound = degree * (degree - 1) * maxSecondDifference / (8.0f * m_Tolerance);
+    uint32_t numSegments = glm::clamp((uint32_t)std::ceil(std::sqrt(bound)), 1u, 1024u);
+
+    m_Scratch.resize(numControlPoints);
+    m_Stream << 'L';
+    for (uint32_t s = 1; s <= numSegments; s++)
+    {
+        float t = float(s) / float(numSegments);
+
+        std::copy(controlPoints, controlPoints + numControlPoints, m_Scratch.begin());
+        for (uint32_t n = 1; n < numControlPoints; n++)
+        {
+            for (uint32_t i = 0; i < numControlPoints - n; i++)
+                m_Scratch[i] = glm::mix(m_Scratch[i], m_Scratch[i + 1], t);
+        }
+
+        WritePoint(m_Scratch[0]);
+    }
+}
+
+bool ImportSvgFile(const std::string& filepath, SvgPathSink& sink)
+{
+    std::ifstream file(filepath, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cout << "Failed to open SVG file: " << filepath << std::endl;
+        return false;
+    }
+
+    enum ScannerState
+    {
+        Detect,
+        RawPathData,
+        Text,
+        TagName,
+        PathTagNameEnd,
+        OtherTag,
+        PathTag,
+        QuotedAttribute,
+        PathDataAttributeName,
+        PathDataAttributeEquals,
+        PathData
+    };
+
+    // The document is scanned in fixed size blocks, path data is forwarded to the parser without being buffered
+    const size_t blockSize = 64 * 1024;
+    std::vector<char> block(blockSize);
+
+    SvgPathParser parser(sink);
+    ScannerState state = ScannerState::Detect;
+    uint32_t tagNameMatch = 0;
+    char quote = 0;
+    bool previousWhitespace = false;
+
+    auto reportError = [&]() {
+        std::cout << "Invalid SVG path data at offset " << parser.GetOffset() << " of path in " << filepath << std::endl;
+        return false;
+    };
+
+    while (file)
+    {
+        file.read(block.data(), blockSize);
+        size_t size = file.gcount();
+        const char* data = block.data();
+
+        for (size_t i = 0; i < size; i++)
+        {
+            char c = data[i];
+            switch (state)
+            {
+                case ScannerState::Detect:
+                {
+                    if (IsWhitespace(c))
+                        break;
+
+                    state = (c == '<') ? ScannerState::Text : ScannerState::RawPathData;
+                    i--;
+                    break;
+                }
+                case ScannerState::RawPathData:
+                {
+                    if (!parser.Parse(data + i, size - i))
+                        return reportError();
+
+                    i = size;
+                    break;
+                }
+                case ScannerState::Text:
+                {
+                    if (c == '<')
+                    {
+                        state = ScannerState::TagName;
+                        tagNameMatch = 0;
+                    }
+                    break;
+                }
+                case ScannerState::TagName:
+                {
+                    if (c == "path"[tagNameMatch])
+                    {
+                        if (++tagNameMatch == 4)
+                            state = ScannerState::PathTagNameEnd;
+                    }
+                    else
+                    {
+                        state = (c == '>') ? ScannerState::Text : ScannerState::OtherTag;
+                    }
+                    break;
+                }
+                case ScannerState::PathTagNameEnd:
+                {
+                    state = IsWhitespace(c) ? ScannerState::PathTag : (c == '>' ? ScannerState::Text : ScannerState::OtherTag);
+                    previousWhitespace = true;
+                    break;
+                }
+                case ScannerState::OtherTag:
+                {
+                    if (c == '>')
+                        state = ScannerState::Text;
+                    break;
+                }
+                case ScannerState::PathTag:
+                {
+                    if (c == '>')
+                    {
+                        state = ScannerState::Text;
+                    }
+                    else if (c == '"' || c == '\'')
+                    {
+                        quote = c;
+                        state = ScannerState::QuotedAttribute;
+                    }
+                    else if (c == 'd' && previousWhitespace)
+                    {
+                        state = ScannerState::PathDataAttributeName;
+                    }
+
+                    previousWhitespace = IsWhitespace(c);
+                    break;
+                }
+                case ScannerState::QuotedAttribute:
+                {
+                    if (c == quote)
+                        state = ScannerState::PathTag;
+                    break;
+                }
+                case ScannerState::PathDataAttributeName:
+                {
+                    if (c == '=')
+                        state = ScannerState::PathDataAttributeEquals;
+                    else if (!IsWhitespace(c))
+                        state = ScannerState::PathTag;
+                    break;
+                }
+                case ScannerState::PathDataAttributeEquals:
+                {
+                    if (c == '"' || c == '\'')
+                    {
+                        quote = c;
+                        state = ScannerState::PathData;
+                        parser.Reset();
+                    }
+                    else if (!IsWhitespace(c))
+                    {
+                        state = ScannerState::PathTag;
+                    }
+                    break;
+                }
+                case ScannerState::PathData:
+                {
+                    const char* end = (const char*)memchr(data + i, quote, size - i);
+                    size_t length = end ? end - (data + i) : size - i;
+
+                    if (!parser.Parse(data + i, length))
+                        return reportError();
+
+                    if (end)
+                    {
+                        if (!parser.Finish())
+                            return reportError();
+
+                        state = ScannerState::PathTag;
+                        previousWhitespace = false;
+                    }
+
+                    i += end ? length : length - 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (state == ScannerState::RawPathData && !parser.Finish())
+        return reportError();
+
+    if (state == ScannerState::PathData)
+    {
+        std::cout << "Unterminated path data in " << filepath << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool ExportSvgFile(const std::string& filepath, const SceneView& scene)
+{
+    std::ofstream file(filepath, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cout << "Failed to create SVG file: " << filepath << std::endl;
+        return false;
+    }
+
+    // Curves lie inside the hull of their control points, so the control point bounds contain the whole drawing
+    glm::vec2 boundsMin = glm::vec2(-1.0f);
+    glm::vec2 boundsMax = glm::vec2(1.0f);
+    if (scene.NumControlPoints > 0)
+    {
+        boundsMin = boundsMax = scene.Positions[0];
+        for (uint32_t i = 1; i < scene.NumControlPoints; i++)
+        {
+            boundsMin = glm::min(boundsMin, scene.Positions[i]);
+            boundsMax = glm::max(boundsMax, scene.Positions[i]);
+        }
+
+        glm::vec2 padding = glm::max((boundsMax - boundsMin) * 0.05f, glm::vec2(0.05f));
+        boundsMin -= padding;
+        boundsMax += padding;
+    }
+
+    SvgPathWriter writer(file);
+    writer.BeginDocument(boundsMin, boundsMax);
+
+    for (uint32_t i = 0; i < scene.NumCurves; i++)
+    {
+        const SceneCurve& curve = scene.Curves[i];
+        writer.WriteCurve(scene.Positions + curve.FirstControlPoint, curve.NumControlPoints, curve.Color, curve.Thickness);
+    }
+
+    writer.EndDocument();
+
+    if (!file.good())
+    {
+        std::cout << "Failed writing SVG file: " << filepath << std::endl;
+        return false;
+    }
+
+    return true;
+}
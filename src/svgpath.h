@@ -0,0 +1,105 @@
+#pragma once
+
+#include "scene.h"
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+class SvgPathSink
+{
+public:
+    virtual ~SvgPathSink() = default;
+
+    // Every path segment is reported as a Bezier curve: 2 control points for lines, 3 for quadratics, 4 for cubics and arcs
+    virtual void OnSegment(const glm::vec2* controlPoints, uint32_t numControlPoints) = 0;
+    virtual void OnSubpathEnd(bool /*closed*/) {}
+};
+
+// Appends every segment to the scene as a separate curve
+class SceneSvgPathSink : public SvgPathSink
+{
+public:
+    SceneSvgPathSink(Scene& scene, const glm::vec3& color = glm::vec3(1.0f), float thickness = 1.0f);
+
+    virtual void OnSegment(const glm::vec2* controlPoints, uint32_t numControlPoints) override;
+private:
+    Scene& m_Scene;
+    glm::vec3 m_Color;
+    float m_Thickness;
+};
+
+// Incremental parser for SVG path data ("M 0 0 C ..."). Parse() can be called with consecutive pieces of the data split at any byte,
+// segments are reported to the sink as soon as their last argument is read
+class SvgPathParser
+{
+public:
+    SvgPathParser(SvgPathSink& sink);
+
+    bool Parse(const char* data, size_t size);
+    bool Finish();
+    void Reset();
+
+    bool HasError() const { return m_Error; }
+    uint64_t GetOffset() const { return m_Offset; }
+private:
+    enum NumberState
+    {
+        None = 0,
+        Sign,
+        Integer,
+        Point,
+        LeadingPoint,
+        Fraction,
+        Exponent,
+        ExponentSign,
+        ExponentDigits
+    };
+
+    bool ProcessChar(char c);
+    bool ContinueNumber(char c);
+    bool EndNumber();
+    bool PushArgument(float value);
+    void ExecuteCommand();
+    void EmitSegment(const glm::vec2* controlPoints, uint32_t numControlPoints);
+    void EmitArc(glm::vec2 radius, float angle, bool largeArc, bool sweep, const glm::vec2& end);
+    void EndSubpath(bool closed);
+private:
+    SvgPathSink& m_Sink;
+    char m_Command = 0;
+    char m_LastCommand = 0;
+    float m_Args[7];
+    uint32_t m_NumArgs = 0;
+    char m_Number[64];
+    uint32_t m_NumberLength = 0;
+    NumberState m_NumberState = NumberState::None;
+    glm::vec2 m_CurrentPoint = glm::vec2(0.0f);
+    glm::vec2 m_SubpathStart = glm::vec2(0.0f);
+    glm::vec2 m_LastControlPoint = glm::vec2(0.0f);
+    bool m_SubpathOpen = false;
+    bool m_Error = false;
+    uint64_t m_Offset = 0;
+};
+
+// Writes curves as <path> elements straight to the stream, nothing besides the current curve is kept in memory
+class SvgPathWriter
+{
+public:
+    SvgPathWriter(std::ostream& stream);
+
+    void BeginDocument(const glm::vec2& boundsMin, const glm::vec2& boundsMax);
+    void WriteCurve(const glm::vec2* controlPoints, uint32_t numControlPoints, const glm::vec3& color, float thickness);
+    void EndDocument();
+private:
+    void WriteNumber(float value);
+    void WritePoint(const glm::vec2& p);
+    void WriteFlattenedCurve(const glm::vec2* controlPoints, uint32_t numControlPoints);
+private:
+    std::ostream& m_Stream;
+    float m_Tolerance = 1e-3f;
+    std::vector<glm::vec2> m_Scratch;
+};
+
+// Accepts either an SVG document, in which case the d attribute of every <path> element is parsed, or a file with raw path data
+bool ImportSvgFile(const std::string& filepath, SvgPathSink& sink);
+bool ExportSvgFile(const std::string& filepath, const SceneView& scene);
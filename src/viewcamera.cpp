@@ -0,0 +1,41 @@
+#include "viewcamera.h"
+#include "bezier.h"
+
+#include <algorithm>
+
+ViewTransform ViewCamera::GetViewTransform(uint32_t width, uint32_t height) const
+{
+    // The shorter side spans [-1, 1] of the view, the longer one is scaled down by the aspect ratio
+    float shortSide = float(std::max(std::min(width, height), 1u));
+    glm::vec2 aspectScale = glm::vec2(shortSide / float(std::max(width, 1u)), shortSide / float(std::max(height, 1u)));
+
+    ViewTransform view;
+    view.Scale = aspectScale * Zoom;
+    view.Offset = -Center * view.Scale;
+    return view;
+}
+
+void ViewCamera::Pan(const glm::vec2& delta, uint32_t width, uint32_t height)
+{
+    // Pixels are y-down, the view spans 2 units over the image
+    ViewTransform view = GetViewTransform(width, height);
+    glm::vec2 viewDelta = glm::vec2(delta.x * 2.0f / float(std::max(width, 1u)), -delta.y * 2.0f / float(std::max(height, 1u)));
+    Center -= viewDelta / view.Scale;
+}
+
+void ViewCamera::ZoomAt(const glm::vec2& viewPosition, float factor, uint32_t width, uint32_t height)
+{
+    glm::vec2 anchor = GetViewTransform(width, height).ViewToScene(viewPosition);
+    Zoom = std::clamp(Zoom * factor, VIEW_CAMERA_MIN_ZOOM, VIEW_CAMERA_MAX_ZOOM);
+
+    // Shift the center by what the anchor moved in the zoomed view
+    ViewTransform view = GetViewTransform(width, height);
+    Center += (view.SceneToView(anchor) - viewPosition) / view.Scale;
+}
+
+uint32_t GetViewSampleCount(const glm::vec2* controlPoints, uint32_t numControlPoints, const ViewTransform& view, uint32_t width, uint32_t height, float tolerance)
+{
+    glm::vec2 pixelScale = view.Scale * glm::vec2(float(width), float(height)) * 0.5f;
+    uint32_t segments = GetBezierFlatteningSegments(controlPoints, numControlPoints, pixelScale, tolerance);
+    return std::clamp<uint32_t>(segments, 1, VIEW_MAX_CURVE_SAMPLES - 1) + 1;
+}
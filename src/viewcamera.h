@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// Zoom range of the editor camera, 1 fits the [-1, 1] square of the scene into the image
+#define VIEW_CAMERA_MIN_ZOOM 1e-3f
+#define VIEW_CAMERA_MAX_ZOOM 1e4f
+// Largest distance in pixels between a drawn curve and the polyline it is drawn as, when the sample count follows the view
+#define VIEW_DEFAULT_SAMPLE_TOLERANCE 0.25f
+// Sample counts that follow the view are clamped to [2, VIEW_MAX_CURVE_SAMPLES]
+#define VIEW_MAX_CURVE_SAMPLES 1024
+
+// Maps scene positions into the view, the [-1, 1] square covering the whole image with y pointing up. The default maps the
+// [-1, 1] square of the scene onto the image, stretched to its aspect ratio
+struct ViewTransform
+{
+    glm::vec2 Scale = glm::vec2(1.0f);
+    glm::vec2 Offset = glm::vec2(0.0f);
+
+    glm::vec2 SceneToView(const glm::vec2& position) const { return position * Scale + Offset; }
+    glm::vec2 ViewToScene(const glm::vec2& position) const { return (position - Offset) / Scale; }
+};
+
+// Pan and zoom of the editor viewport. Center is the scene position in the middle of the image and the shorter side of the
+// image spans 2 / Zoom scene units, scene units are square on screen whatever the aspect ratio of the image
+struct ViewCamera
+{
+    glm::vec2 Center = glm::vec2(0.0f);
+    float Zoom = 1.0f;
+
+    ViewTransform GetViewTransform(uint32_t width, uint32_t height) const;
+    // Moves the camera so the scene follows a mouse moved by delta pixels
+    void Pan(const glm::vec2& delta, uint32_t width, uint32_t height);
+    // Zooms by factor, keeping the scene position under the view position where it is
+    void ZoomAt(const glm::vec2& viewPosition, float factor, uint32_t width, uint32_t height);
+};
+
+// Samples of a curve whose polyline stays within tolerance pixels of the curve once drawn through view into a width x
+// height image. Zooming in refines the curve and zooming out coarsens it, the count is clamped to [2, VIEW_MAX_CURVE_SAMPLES]
+uint32_t GetViewSampleCount(const glm::vec2* controlPoints, uint32_t numControlPoints, const ViewTransform& view, uint32_t width, uint32_t height,
+    float tolerance = VIEW_DEFAULT_SAMPLE_TOLERANCE);